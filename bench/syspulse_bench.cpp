@@ -0,0 +1,289 @@
+/**
+ * @file syspulse_bench.cpp
+ * @brief Microbenchmarks de los colectores y de la ruta de almacenamiento.
+ *
+ * @details
+ * Mide el costo de las piezas que se ejecutan en cada ciclo del servicio:
+ *  - CpuMonitor::collect + RateEngine::derive (el cociente que produce CPU/Usage)
+ *  - RamMonitor::collect + RateEngine::derive
+ *  - DatabaseManager::insertMetric (una fila por transacción implícita)
+ *  - DatabaseManager::insertMetrics (lotes de 1 a 10 000 filas)
+ *
+ * Las inserciones se repiten para cada perfil de PRAGMA y tanto para una base
+ * en memoria (":memory:") como para un archivo en disco.
+ *
+ * "allocs_per_op" suma las reservas de memoria de C++ (operator new) y las
+ * del asignador interno de SQLite.
+ *
+ * La salida es JSON Lines (un objeto por línea) para poder guardarla y
+ * compararla entre versiones con cualquier herramienta:
+ * @code
+ * {"case":"DatabaseManager::insertMetrics","storage":"disk","pragmas":"wal_normal","batch":1000,"rows":20000,"ns_per_op":812.4,"allocs_per_op":0.00,"rows_per_s":1230900.1}
+ * @endcode
+ *
+ * Uso: syspulse_bench [--rows N] [--disk-path ruta.db]
+ *
+ * @author Sergio Gonzalez
+ * @date 2026-01-24
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+#include "db_manager.hpp"
+#include "monitor.hpp"
+#include "rate_engine.hpp"
+
+// ---------------------------------------------------------------------------
+// Conteo de asignaciones
+// ---------------------------------------------------------------------------
+// Reemplazamos el operator new global para contar cuántas veces se pide memoria
+// al heap. Así "allocs_per_op" refleja exactamente lo que hace el código medido.
+static std::atomic<unsigned long long> gAllocations{0};
+
+void* operator new(std::size_t size) {
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+// SQLite no usa operator new sino su propio asignador. Lo envolvemos con
+// SQLITE_CONFIG_MALLOC para que sus reservas también cuenten.
+static sqlite3_mem_methods gSqliteDefaultMem;
+
+static void* countingSqliteMalloc(int size) {
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    return gSqliteDefaultMem.xMalloc(size);
+}
+
+static void* countingSqliteRealloc(void* p, int size) {
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    return gSqliteDefaultMem.xRealloc(p, size);
+}
+
+/**
+ * @brief Instala el asignador contador de SQLite (antes de abrir cualquier conexión).
+ */
+static void installSqliteAllocationCounter() {
+    sqlite3_config(SQLITE_CONFIG_GETMALLOC, &gSqliteDefaultMem);
+    sqlite3_mem_methods counting = gSqliteDefaultMem;
+    counting.xMalloc = countingSqliteMalloc;
+    counting.xRealloc = countingSqliteRealloc;
+    sqlite3_config(SQLITE_CONFIG_MALLOC, &counting);
+}
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @struct PragmaProfile
+ * @brief Conjunto de PRAGMA que se aplica a la conexión antes de medir.
+ */
+struct PragmaProfile {
+    const char* name;
+    std::vector<std::string> pragmas;
+};
+
+/**
+ * @struct BenchOptions
+ * @brief Parámetros de la corrida tomados de la línea de comandos.
+ */
+struct BenchOptions {
+    long long rows = 20000;                        ///< Filas objetivo por caso de inserción.
+    std::string diskPath = "data/bench.db";        ///< Archivo temporal para los casos en disco.
+    long long diskTransactionCap = 200;            ///< Límite de transacciones por caso en disco (cada una es un fsync).
+};
+
+/**
+ * @brief Borra el archivo de base de datos y sus archivos auxiliares (journal/WAL).
+ */
+void removeDatabaseFiles(const std::string& path) {
+    std::remove(path.c_str());
+    std::remove((path + "-journal").c_str());
+    std::remove((path + "-wal").c_str());
+    std::remove((path + "-shm").c_str());
+}
+
+/**
+ * @brief Genera una métrica sintética con strings cortos (como las reales).
+ */
+Metric makeMetric(long long i) {
+    Metric m;
+    m.component = (i & 1) ? "RAM" : "CPU";
+    m.metric = "Usage";
+    m.value = static_cast<double>(i % 100);
+    m.unit = "%";
+    m.timestamp = 1767225600 + i;
+    return m;
+}
+
+/**
+ * @brief Mide un colector como lo usa el servicio: collect() y luego RateEngine::derive().
+ *
+ * @details
+ * En un bucle cerrado todas las lecturas caerían en el mismo segundo y derive()
+ * no calcularía ninguna tasa, así que cada iteración recibe su propio segundo
+ * virtual. El buffer del lote se reutiliza, como en el bucle principal.
+ *
+ * @tparam Monitor CpuMonitor o RamMonitor.
+ * @param ratios Cocientes del colector, registrados como en main().
+ */
+template <typename Monitor>
+void benchCollector(const char* name, long long iterations, const std::vector<RateRatio>& ratios) {
+    Monitor monitor;
+    RateEngine rates;
+    for (const RateRatio& ratio : ratios) rates.addRatio(ratio);
+
+    std::vector<Metric> batch;
+    auto cycle = [&](long long second) {
+        batch.clear();
+        monitor.collect(batch);
+        for (Metric& m : batch) m.timestamp = second;
+        rates.derive(batch);
+    };
+    cycle(0); // Primera lectura: RateEngine guarda la línea base de cada contador.
+
+    unsigned long long allocsBefore = gAllocations.load();
+    auto start = Clock::now();
+    long long metrics = 0;
+    for (long long i = 0; i < iterations; ++i) {
+        cycle(i + 1);
+        metrics += static_cast<long long>(batch.size());
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    unsigned long long allocs = gAllocations.load() - allocsBefore;
+
+    std::printf("{\"case\":\"%s\",\"iterations\":%lld,\"metrics_per_op\":%.2f,\"ns_per_op\":%.1f,\"allocs_per_op\":%.2f}\n",
+                name, iterations, static_cast<double>(metrics) / iterations, elapsed / iterations,
+                static_cast<double>(allocs) / iterations);
+}
+
+/**
+ * @brief Mide una combinación almacenamiento × PRAGMA × tamaño de lote.
+ *
+ * @param batch 0 mide insertMetric (fila a fila); >0 mide insertMetrics con ese tamaño de lote.
+ */
+void benchInsert(const BenchOptions& opt, bool onDisk, const PragmaProfile& profile, long long batch) {
+    std::string path = onDisk ? opt.diskPath : ":memory:";
+    if (onDisk) removeDatabaseFiles(path);
+
+    long long rows;
+    {
+        DatabaseManager db;
+        if (!db.connect(path)) {
+            std::cerr << "[ERROR] No se pudo abrir " << path << std::endl;
+            return;
+        }
+        for (const std::string& pragma : profile.pragmas) {
+            if (!db.applyPragma(pragma)) {
+                std::cerr << "[ERROR] PRAGMA rechazado: " << pragma << std::endl;
+                return;
+            }
+        }
+
+        // Cuántas transacciones ejecutar: en disco cada una implica sincronizar,
+        // así que se limitan para que los lotes pequeños no tarden minutos.
+        long long perTransaction = batch == 0 ? 1 : batch;
+        long long transactions = opt.rows / perTransaction;
+        if (transactions < 1) transactions = 1;
+        if (onDisk && transactions > opt.diskTransactionCap) transactions = opt.diskTransactionCap;
+        rows = transactions * perTransaction;
+
+        // Los datos se preparan fuera de la medición.
+        std::vector<Metric> metrics;
+        metrics.reserve(static_cast<size_t>(perTransaction));
+        for (long long i = 0; i < perTransaction; ++i) {
+            metrics.push_back(makeMetric(i));
+        }
+
+        unsigned long long allocsBefore = gAllocations.load();
+        auto start = Clock::now();
+        for (long long t = 0; t < transactions; ++t) {
+            bool ok = batch == 0 ? db.insertMetric(metrics[0]) : db.insertMetrics(metrics);
+            if (!ok) {
+                std::cerr << "[ERROR] Fallo de inserción durante el benchmark." << std::endl;
+                return;
+            }
+        }
+        double elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        unsigned long long allocs = gAllocations.load() - allocsBefore;
+
+        std::printf("{\"case\":\"%s\",\"storage\":\"%s\",\"pragmas\":\"%s\",\"batch\":%lld,\"rows\":%lld,"
+                    "\"ns_per_op\":%.1f,\"allocs_per_op\":%.2f,\"rows_per_s\":%.1f}\n",
+                    batch == 0 ? "DatabaseManager::insertMetric" : "DatabaseManager::insertMetrics",
+                    onDisk ? "disk" : "memory", profile.name, perTransaction, rows,
+                    elapsed / rows, static_cast<double>(allocs) / rows, rows / (elapsed / 1e9));
+    }
+    if (onDisk) removeDatabaseFiles(path);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchOptions opt;
+    const char* usage = "Uso: syspulse_bench [--rows N] [--disk-path ruta.db]";
+    for (int i = 1; i < argc; i += 2) {
+        std::string arg = argv[i];
+        // Toda opción lleva valor: una opción suelta al final es un error, no se ignora.
+        if (i + 1 >= argc || (arg != "--rows" && arg != "--disk-path")) {
+            std::cerr << usage << std::endl;
+            return 1;
+        }
+        if (arg == "--rows") {
+            opt.rows = std::atoll(argv[i + 1]);
+            if (opt.rows <= 0) {
+                std::cerr << usage << std::endl;
+                return 1;
+            }
+        } else {
+            opt.diskPath = argv[i + 1];
+        }
+    }
+
+    // El directorio del archivo en disco (data/ por defecto) puede no existir todavía.
+    std::filesystem::path diskParent = std::filesystem::path(opt.diskPath).parent_path();
+    if (!diskParent.empty()) {
+        std::error_code ec;
+        std::filesystem::create_directories(diskParent, ec);
+        if (ec) {
+            std::cerr << "[ERROR] No se pudo crear " << diskParent.string() << ": " << ec.message() << std::endl;
+            return 1;
+        }
+    }
+
+    installSqliteAllocationCounter();
+
+    benchCollector<CpuMonitor>("CpuMonitor::collect", 10000, CpuMonitor::ratios());
+    benchCollector<RamMonitor>("RamMonitor::collect", 10000, {});
+
+    const std::vector<PragmaProfile> profiles = {
+        {"default", {}},
+        {"wal_normal", {"journal_mode=WAL", "synchronous=NORMAL"}},
+        {"wal_full", {"journal_mode=WAL", "synchronous=FULL"}},
+        {"memory_journal_off", {"journal_mode=MEMORY", "synchronous=OFF"}},
+    };
+    const long long batches[] = {1, 10, 100, 1000, 10000};
+
+    for (bool onDisk : {false, true}) {
+        for (const PragmaProfile& profile : profiles) {
+            benchInsert(opt, onDisk, profile, 0);
+            for (long long batch : batches) {
+                benchInsert(opt, onDisk, profile, batch);
+            }
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,278 @@
+/**
+ * @file agent_protocol.cpp
+ * @brief Codificación y decodificación de las tramas agente <-> agregador.
+ * @author Sergio Gonzalez
+ * @date 2026-05-16
+ */
+
+#include "agent_protocol.hpp"
+#include <cstring>
+#include "series_index.hpp"
+#include "varint.hpp"
+
+namespace {
+
+/// Flags de la definición de una serie.
+constexpr unsigned char kSeriesCounter = 0x01;
+
+/// Bit del byte de control: la muestra trae histograma.
+constexpr unsigned char kControlHistogram = 0x80;
+
+/// Cabecera de trama: longitud (4 bytes) + tipo (1 byte).
+constexpr std::size_t kHeaderSize = 5;
+
+/// Una muestra ocupa al menos 3 bytes (id, delta de timestamp, control).
+constexpr std::size_t kMinSampleSize = 3;
+
+void putString(std::string& out, const std::string& text) {
+    varint::put(out, text.size());
+    out.append(text);
+}
+
+bool getString(varint::Reader& in, std::string& text) {
+    std::uint64_t size;
+    const char* data;
+    if (!in.get(size) || size > in.remaining() || !in.getBytes(data, static_cast<std::size_t>(size))) return false;
+    text.assign(data, static_cast<std::size_t>(size));
+    return true;
+}
+
+std::uint64_t doubleBits(double value) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+double bitsDouble(std::uint64_t bits) {
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/**
+ * @brief Escribe el byte de control y los bytes significativos de @p x (XOR con el valor anterior).
+ */
+void putXor(std::string& out, std::uint64_t x, unsigned char control) {
+    if (x == 0) {
+        out.push_back(static_cast<char>(control));
+        return;
+    }
+    int leading = 0;
+    while (leading < 7 && (x >> (56 - 8 * leading)) == 0) ++leading;
+    int trailing = 0;
+    while ((x >> (8 * trailing) & 0xFF) == 0) ++trailing;
+    int length = 8 - leading - trailing;
+    out.push_back(static_cast<char>(control | leading << 4 | length));
+    for (int i = 0; i < length; ++i) {
+        out.push_back(static_cast<char>(x >> (8 * (trailing + i)) & 0xFF));
+    }
+}
+
+bool getXor(varint::Reader& in, unsigned char control, std::uint64_t& x) {
+    int leading = control >> 4 & 0x07;
+    int length = control & 0x0F;
+    if (leading + length > 8) return false;
+    int trailing = 8 - leading - length;
+    const char* bytes;
+    if (!in.getBytes(bytes, static_cast<std::size_t>(length))) return false;
+    x = 0;
+    for (int i = 0; i < length; ++i) {
+        x |= static_cast<std::uint64_t>(static_cast<unsigned char>(bytes[i])) << (8 * (trailing + i));
+    }
+    return true;
+}
+
+/**
+ * @brief Reserva la cabecera de una trama; finishFrame() completa la longitud.
+ * @return Posición de la cabecera dentro de @p out.
+ */
+std::size_t beginFrame(std::string& out, FrameType type) {
+    std::size_t start = out.size();
+    out.append(4, '\0');
+    out.push_back(static_cast<char>(type));
+    return start;
+}
+
+void finishFrame(std::string& out, std::size_t start) {
+    std::uint32_t length = static_cast<std::uint32_t>(out.size() - start - 4);
+    for (int i = 0; i < 4; ++i) {
+        out[start + static_cast<std::size_t>(i)] = static_cast<char>((length >> (8 * i)) & 0xFF);
+    }
+}
+
+} // namespace
+
+void encodeHello(std::string& out, const std::string& agent, std::uint64_t session) {
+    std::size_t start = beginFrame(out, FrameType::Hello);
+    varint::put(out, kAgentProtocolVersion);
+    putString(out, agent);
+    varint::put(out, session);
+    finishFrame(out, start);
+}
+
+void encodeAck(std::string& out, std::uint64_t sequence) {
+    std::size_t start = beginFrame(out, FrameType::Ack);
+    varint::put(out, sequence);
+    finishFrame(out, start);
+}
+
+FrameStatus nextFrame(const char* data, std::size_t size, Frame& frame) {
+    if (size < kHeaderSize) return FrameStatus::Incomplete;
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+    std::size_t length = static_cast<std::size_t>(bytes[0]) | static_cast<std::size_t>(bytes[1]) << 8 |
+                         static_cast<std::size_t>(bytes[2]) << 16 | static_cast<std::size_t>(bytes[3]) << 24;
+    if (length == 0 || length > kMaxFrameSize) return FrameStatus::Invalid;
+    if (size < 4 + length) return FrameStatus::Incomplete;
+
+    frame.type = static_cast<FrameType>(bytes[4]);
+    frame.payload = data + kHeaderSize;
+    frame.payloadSize = length - 1;
+    frame.totalSize = 4 + length;
+    return FrameStatus::Complete;
+}
+
+bool decodeHello(const Frame& frame, std::uint64_t& version, std::string& agent, std::uint64_t& session) {
+    if (frame.type != FrameType::Hello) return false;
+    varint::Reader in(frame.payload, frame.payloadSize);
+    return in.get(version) && getString(in, agent) && in.get(session) && in.remaining() == 0;
+}
+
+bool decodeAck(const Frame& frame, std::uint64_t& sequence) {
+    if (frame.type != FrameType::Ack) return false;
+    varint::Reader in(frame.payload, frame.payloadSize);
+    return in.get(sequence) && in.remaining() == 0;
+}
+
+BatchEncoder::BatchEncoder() : previousTimestamp(0) {}
+
+void BatchEncoder::reset() {
+    ids.clear();
+    previousBits.clear();
+    previousTimestamp = 0;
+}
+
+/**
+ * @details Dos pasadas: la primera asigna ids (las series nuevas se definen
+ * antes que las muestras), la segunda escribe las muestras.
+ */
+void BatchEncoder::encode(std::string& out, std::uint64_t sequence, const std::vector<Metric>& batch) {
+    std::size_t start = beginFrame(out, FrameType::Batch);
+    varint::put(out, sequence);
+
+    const std::uint32_t firstNew = static_cast<std::uint32_t>(previousBits.size());
+    sampleIds.clear();
+    for (const Metric& m : batch) {
+        SeriesIndex::seriesKey(keyBuffer, m.component, m.metric, m.labels);
+        auto inserted = ids.emplace(keyBuffer, static_cast<std::uint32_t>(previousBits.size()));
+        if (inserted.second) previousBits.push_back(0);
+        sampleIds.push_back(inserted.first->second);
+    }
+
+    varint::put(out, previousBits.size() - firstNew);
+    std::uint32_t defined = firstNew;
+    for (std::size_t i = 0; i < batch.size() && defined < previousBits.size(); ++i) {
+        if (sampleIds[i] != defined) continue;  // Ya definida, o repetida dentro del lote.
+        const Metric& m = batch[i];
+        putString(out, m.component);
+        putString(out, m.metric);
+        putString(out, m.unit);
+        out.push_back(static_cast<char>(m.kind == MetricKind::Counter ? kSeriesCounter : 0));
+        varint::put(out, m.labels.size());
+        for (const auto& label : m.labels) {
+            putString(out, label.first);
+            putString(out, label.second);
+        }
+        ++defined;
+    }
+
+    varint::put(out, batch.size());
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+        const Metric& m = batch[i];
+        std::uint32_t id = sampleIds[i];
+        varint::put(out, id);
+        varint::putSigned(out, m.timestamp - previousTimestamp);
+        previousTimestamp = m.timestamp;
+
+        std::uint64_t bits = doubleBits(m.value);
+        bool histogram = m.histogram && m.histogram->count() > 0;
+        putXor(out, bits ^ previousBits[id], histogram ? kControlHistogram : 0);
+        previousBits[id] = bits;
+        if (histogram) {
+            putString(out, m.histogram->serialize());
+        }
+    }
+    finishFrame(out, start);
+}
+
+BatchDecoder::BatchDecoder() : previousTimestamp(0) {}
+
+bool BatchDecoder::decode(const Frame& frame, std::uint64_t& sequence, std::vector<Metric>& out) {
+    if (frame.type != FrameType::Batch) return false;
+    varint::Reader in(frame.payload, frame.payloadSize);
+
+    std::uint64_t newSeries;
+    // Cada definición ocupa al menos 5 bytes: un conteo mayor es un contenido corrupto.
+    if (!in.get(sequence) || !in.get(newSeries) || newSeries > in.remaining() / 5) return false;
+    for (std::uint64_t i = 0; i < newSeries; ++i) {
+        Series s;
+        unsigned char flags;
+        std::uint64_t labelCount;
+        bool ok = getString(in, s.component) && getString(in, s.metric) && getString(in, s.unit) &&
+                  in.getByte(flags) && in.get(labelCount) && labelCount <= in.remaining() / 2;
+        for (std::uint64_t j = 0; ok && j < labelCount; ++j) {
+            std::pair<std::string, std::string> label;
+            ok = getString(in, label.first) && getString(in, label.second);
+            s.labels.push_back(std::move(label));
+        }
+        if (!ok) return false;
+        s.kind = (flags & kSeriesCounter) ? MetricKind::Counter : MetricKind::Gauge;
+        series.push_back(std::move(s));
+        previousBits.push_back(0);
+    }
+
+    std::uint64_t count;
+    if (!in.get(count) || count > in.remaining() / kMinSampleSize) return false;
+
+    std::size_t before = out.size();
+    out.reserve(before + static_cast<std::size_t>(count));
+    for (std::uint64_t i = 0; i < count; ++i) {
+        std::uint64_t id;
+        std::int64_t delta;
+        unsigned char control;
+        std::uint64_t x;
+        bool ok = in.get(id) && id < series.size() && in.getSigned(delta) && in.getByte(control) &&
+                  getXor(in, control, x);
+        std::shared_ptr<Histogram> histogram;
+        if (ok && (control & kControlHistogram)) {
+            std::uint64_t size;
+            const char* blob;
+            histogram = std::make_shared<Histogram>();
+            ok = in.get(size) && in.getBytes(blob, static_cast<std::size_t>(size)) &&
+                 histogram->deserialize(blob, static_cast<std::size_t>(size));
+        }
+        if (!ok) {
+            out.resize(before);
+            return false;
+        }
+
+        const Series& s = series[static_cast<std::size_t>(id)];
+        previousTimestamp += delta;
+        previousBits[static_cast<std::size_t>(id)] ^= x;
+
+        Metric m;
+        m.component = s.component;
+        m.metric = s.metric;
+        m.unit = s.unit;
+        m.kind = s.kind;
+        m.labels = s.labels;
+        m.timestamp = previousTimestamp;
+        m.value = bitsDouble(previousBits[static_cast<std::size_t>(id)]);
+        m.histogram = std::move(histogram);
+        out.push_back(std::move(m));
+    }
+    if (in.remaining() != 0) {
+        out.resize(before);
+        return false;
+    }
+    return true;
+}
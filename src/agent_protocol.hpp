@@ -0,0 +1,159 @@
+/**
+ * @file agent_protocol.hpp
+ * @brief Protocolo TCP binario entre un agente SysPulse y el agregador central.
+ * @details
+ * La conexión es un flujo de tramas:
+ *
+ *     [longitud: u32 little-endian][tipo: u8][contenido: longitud - 1 bytes]
+ *
+ * La longitud cubre el tipo y el contenido, así que el receptor sabe cuánto
+ * esperar antes de decodificar y una trama nunca se procesa a medias.
+ *
+ * Tipos:
+ *  - Hello (agente -> agregador): primera trama de cada conexión. Versión,
+ *    nombre del agente y sesión (un número distinto en cada arranque del agente).
+ *  - Batch (agente -> agregador): un lote, con número de secuencia.
+ *  - Ack (agregador -> agente): la secuencia del último lote recibido. Es
+ *    acumulativo: confirma ese lote y todos los anteriores.
+ *
+ * Un Batch no repite textos: cada serie (component, metric, unit, tipo y
+ * etiquetas) se define una sola vez por conexión, en el primer lote que la usa,
+ * y recibe el id siguiente del diccionario (0, 1, 2...). Después cada muestra es:
+ *
+ *     [id: varint][timestamp: zigzag varint, delta con la muestra anterior]
+ *     [control: u8][bytes del XOR con el valor anterior de la serie][histograma]
+ *
+ * El byte de control indica cuántos bytes altos del XOR son cero (bits 4-6) y
+ * cuántos bytes significativos siguen (bits 0-3; 0 = mismo valor que antes);
+ * los bytes bajos restantes son cero. El bit 7 indica que sigue un histograma
+ * serializado. Una serie que no cambia ocupa 3 bytes por muestra; un lote de
+ * CPU y RAM por segundo, unas decenas de bytes con la cabecera.
+ *
+ * El diccionario y los valores anteriores son estado de la conexión: ambos
+ * lados lo reinician al reconectar, y el agente vuelve a codificar (y a
+ * enviar) los lotes que el agregador no confirmó.
+ * @author Sergio Gonzalez
+ * @date 2026-05-16
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "metric.hpp"
+
+/// Versión que envía el agente en Hello.
+constexpr std::uint64_t kAgentProtocolVersion = 2;
+
+/// Trama máxima aceptada: protege al agregador de una longitud corrupta.
+constexpr std::size_t kMaxFrameSize = 16u << 20;
+
+/**
+ * @enum FrameType
+ * @brief Tipo de una trama.
+ */
+enum class FrameType : unsigned char {
+    Hello = 1,
+    Batch = 2,
+    Ack = 3
+};
+
+/**
+ * @struct Frame
+ * @brief Trama ya delimitada; el contenido apunta al buffer de recepción (no se copia).
+ */
+struct Frame {
+    FrameType type = FrameType::Hello;
+    const char* payload = nullptr;
+    std::size_t payloadSize = 0;
+    std::size_t totalSize = 0;  ///< Bytes que ocupa la trama completa en el buffer.
+};
+
+/**
+ * @enum FrameStatus
+ * @brief Resultado de buscar una trama al principio de un buffer.
+ */
+enum class FrameStatus {
+    Complete,    ///< Hay una trama completa en @p frame.
+    Incomplete,  ///< Faltan bytes: hay que seguir leyendo del socket.
+    Invalid      ///< Longitud imposible: hay que cerrar la conexión.
+};
+
+/** @brief Agrega al final de @p out la trama Hello. */
+void encodeHello(std::string& out, const std::string& agent, std::uint64_t session);
+
+/** @brief Agrega al final de @p out una trama Ack. */
+void encodeAck(std::string& out, std::uint64_t sequence);
+
+/**
+ * @brief Delimita la primera trama de @p data.
+ */
+FrameStatus nextFrame(const char* data, std::size_t size, Frame& frame);
+
+/**
+ * @brief Lee una trama Hello.
+ * @return false si el contenido está truncado o mal formado.
+ */
+bool decodeHello(const Frame& frame, std::uint64_t& version, std::string& agent, std::uint64_t& session);
+
+/** @brief Lee una trama Ack. */
+bool decodeAck(const Frame& frame, std::uint64_t& sequence);
+
+/**
+ * @class BatchEncoder
+ * @brief Lado del agente: codifica lotes contra el diccionario de la conexión.
+ */
+class BatchEncoder {
+private:
+    std::unordered_map<std::string, std::uint32_t> ids;  ///< seriesKey() -> id
+    std::vector<std::uint64_t> previousBits;             ///< Último valor enviado por id.
+    long long previousTimestamp;
+
+    std::string keyBuffer;
+    std::vector<std::uint32_t> sampleIds;                ///< Id de cada muestra del lote actual.
+
+public:
+    BatchEncoder();
+
+    /** @brief Olvida el diccionario: se llama al abrir cada conexión. */
+    void reset();
+
+    /** @brief Agrega al final de @p out una trama Batch con el lote completo. */
+    void encode(std::string& out, std::uint64_t sequence, const std::vector<Metric>& batch);
+
+    std::size_t seriesCount() const { return previousBits.size(); }
+};
+
+/**
+ * @class BatchDecoder
+ * @brief Lado del agregador: decodifica los lotes de una conexión.
+ * @details Si decode() devuelve false el estado queda inconsistente con el del
+ * agente: hay que cerrar la conexión.
+ */
+class BatchDecoder {
+private:
+    /// Definición de una serie, copiada en cada muestra decodificada.
+    struct Series {
+        std::string component;
+        std::string metric;
+        std::string unit;
+        MetricKind kind = MetricKind::Gauge;
+        Labels labels;
+    };
+
+    std::vector<Series> series;
+    std::vector<std::uint64_t> previousBits;
+    long long previousTimestamp;
+
+public:
+    BatchDecoder();
+
+    /**
+     * @brief Lee una trama Batch y agrega sus muestras al final de @p out.
+     * @return false si el contenido está truncado o mal formado (@p out queda como estaba).
+     */
+    bool decode(const Frame& frame, std::uint64_t& sequence, std::vector<Metric>& out);
+
+    std::size_t seriesCount() const { return series.size(); }
+};
@@ -0,0 +1,156 @@
+/**
+ * @file agent_sink.cpp
+ * @brief Implementación de AgentPushSink.
+ * @author Sergio Gonzalez
+ * @date 2026-05-09
+ */
+
+#include "agent_sink.hpp"
+#include <algorithm>
+#include "logger.hpp"
+#include "net.hpp"
+
+namespace {
+
+constexpr std::chrono::milliseconds kInitialBackoff(1000);
+constexpr std::chrono::milliseconds kMaxBackoff(30000);
+
+} // namespace
+
+AgentPushSink::AgentPushSink(const AgentConfig& c)
+    : config(c), portText(std::to_string(c.port)), socketHandle(net::kInvalidSocket),
+      session(static_cast<std::uint64_t>(std::chrono::system_clock::now().time_since_epoch().count())),
+      nextSequence(1), sentOnConnection(0), unackedSamples(0), droppedBatches(0), sentBytes(0),
+      nextAttempt(std::chrono::steady_clock::now()), backoff(kInitialBackoff) {
+    if (config.name.empty()) config.name = net::hostName();
+    if (config.name.empty()) config.name = "syspulse";
+}
+
+AgentPushSink::~AgentPushSink() {
+    net::closeSocket(socketHandle);
+}
+
+/**
+ * @param retryLater true si la conexión falló: activa la espera exponencial.
+ */
+void AgentPushSink::disconnect(bool retryLater) {
+    net::closeSocket(socketHandle);
+    socketHandle = net::kInvalidSocket;
+    sentOnConnection = 0;
+    if (retryLater) {
+        nextAttempt = std::chrono::steady_clock::now() + backoff;
+        backoff = std::min(backoff * 2, kMaxBackoff);
+    }
+}
+
+/**
+ * @brief Conecta y se presenta con Hello. El diccionario de series empieza vacío.
+ */
+bool AgentPushSink::ensureConnected() {
+    if (socketHandle != net::kInvalidSocket) return true;
+    if (std::chrono::steady_clock::now() < nextAttempt) return false;
+
+    socketHandle = net::connectTcp(config.host, portText, config.timeoutMs);
+    frames.clear();
+    encodeHello(frames, config.name, session);
+    if (socketHandle == net::kInvalidSocket || !net::sendAll(socketHandle, frames.data(), frames.size())) {
+        disconnect(true);
+        return false;
+    }
+    encoder.reset();
+    received.clear();
+    sentOnConnection = 0;
+    backoff = kInitialBackoff;
+    Logger::info("Conectado al agregador.", {{"host", config.host}, {"port", config.port}, {"agent", config.name},
+                                             {"pending", unacked.size()}});
+    return true;
+}
+
+/**
+ * @brief Lee las confirmaciones disponibles y libera los lotes confirmados.
+ * @return false si la conexión se cerró o el agregador envió algo inválido.
+ */
+bool AgentPushSink::readAcks(int timeoutMs) {
+    int n = net::receive(socketHandle, received, timeoutMs);
+    if (n < 0) return false;
+
+    std::size_t offset = 0;
+    Frame frame;
+    while (true) {
+        FrameStatus status = nextFrame(received.data() + offset, received.size() - offset, frame);
+        if (status == FrameStatus::Incomplete) break;
+        std::uint64_t sequence;
+        if (status == FrameStatus::Invalid || !decodeAck(frame, sequence)) return false;
+        while (!unacked.empty() && unacked.front().sequence <= sequence && sentOnConnection > 0) {
+            unackedSamples -= unacked.front().batch.size();
+            unacked.pop_front();
+            --sentOnConnection;
+        }
+        offset += frame.totalSize;
+    }
+    received.erase(0, offset);
+    return true;
+}
+
+/**
+ * @brief Codifica los lotes que todavía no viajaron por esta conexión y los envía juntos.
+ */
+bool AgentPushSink::sendUnsent() {
+    if (sentOnConnection == unacked.size()) return true;
+    frames.clear();
+    for (std::size_t i = sentOnConnection; i < unacked.size(); ++i) {
+        encoder.encode(frames, unacked[i].sequence, unacked[i].batch);
+    }
+    if (!net::sendAll(socketHandle, frames.data(), frames.size())) return false;
+    sentBytes += frames.size();
+    sentOnConnection = unacked.size();
+    return true;
+}
+
+bool AgentPushSink::flush() {
+    nextAttempt = std::chrono::steady_clock::now();
+    write(std::vector<Metric>());
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(config.timeoutMs);
+    while (!unacked.empty() && socketHandle != net::kInvalidSocket) {
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        if (left.count() <= 0) break;
+        if (!readAcks(static_cast<int>(left.count()))) {
+            disconnect(true);
+        }
+    }
+    if (!unacked.empty()) {
+        Logger::warn("Lotes sin confirmar por el agregador.", {{"batches", unacked.size()}, {"samples", unackedSamples}});
+    }
+    return unacked.empty();
+}
+
+bool AgentPushSink::write(const std::vector<Metric>& batch) {
+    bool kept = true;
+    if (!batch.empty()) {
+        unacked.push_back(Unacked{nextSequence++, batch});
+        unackedSamples += batch.size();
+        // Sin confirmaciones, se descartan los lotes más antiguos (nunca el recién agregado).
+        while (unackedSamples > config.maxPendingSamples && unacked.size() > 1) {
+            unackedSamples -= unacked.front().batch.size();
+            unacked.pop_front();
+            if (sentOnConnection > 0) --sentOnConnection;
+            ++droppedBatches;
+        }
+        if (unackedSamples > config.maxPendingSamples) {
+            unackedSamples = 0;
+            unacked.clear();
+            sentOnConnection = 0;
+            ++droppedBatches;
+            kept = false;
+        }
+    }
+
+    if (!ensureConnected()) return kept;
+    if (!readAcks(0) || !sendUnsent()) {
+        Logger::warn("Se perdió la conexión con el agregador; se retienen los lotes sin confirmar.",
+                     {{"host", config.host}, {"port", config.port}, {"pending", unacked.size()}});
+        disconnect(true);
+    }
+    return kept;
+}
@@ -0,0 +1,100 @@
+/**
+ * @file agent_sink.hpp
+ * @brief Sink que envía cada lote al agregador central por TCP (ver aggregator.hpp).
+ * @details
+ * La conexión es persistente: se abre en el primer lote, empieza con la trama
+ * Hello (nombre del agente) y luego lleva una trama Batch por lote, codificada
+ * contra el diccionario de series de la conexión (ver agent_protocol.hpp).
+ *
+ * Entrega al menos una vez: cada lote queda en memoria hasta que el agregador
+ * confirma su secuencia (Ack). Si la conexión se corta, al reconectar se
+ * vuelven a codificar y enviar, en orden, todos los lotes sin confirmar. Si el
+ * agregador no responde, se acumulan hasta maxPendingSamples (descartando los
+ * más antiguos) y se reintenta con espera exponencial, como HttpPushSink.
+ * @author Sergio Gonzalez
+ * @date 2026-05-09
+ */
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+#include "agent_protocol.hpp"
+#include "sink.hpp"
+
+/**
+ * @struct AgentConfig
+ * @brief Agregador de destino e identidad del agente.
+ */
+struct AgentConfig {
+    std::string host = "127.0.0.1";
+    unsigned short port = 7070;
+    std::string name;                          ///< Vacío = nombre del equipo.
+    int timeoutMs = 2000;                      ///< Tiempo máximo por envío, y espera de confirmaciones al apagar.
+    std::size_t maxPendingSamples = 262144;    ///< Muestras sin confirmar retenidas en memoria.
+};
+
+/**
+ * @class AgentPushSink
+ * @brief Envía lotes al agregador con el protocolo de agent_protocol.hpp.
+ */
+class AgentPushSink : public MetricSink {
+private:
+    /// Lote enviado (o por enviar) que el agregador todavía no confirmó.
+    struct Unacked {
+        std::uint64_t sequence;
+        std::vector<Metric> batch;
+    };
+
+    AgentConfig config;
+    std::string portText;
+    std::uintptr_t socketHandle;
+    std::uint64_t session;               ///< Distinto en cada arranque: el agregador descarta reenvíos de la misma sesión.
+    std::uint64_t nextSequence;
+
+    BatchEncoder encoder;
+    std::string frames;                  ///< Tramas a enviar (reutilizado).
+    std::string received;                ///< Bytes recibidos sin formar una trama completa.
+    std::deque<Unacked> unacked;         ///< En orden de secuencia.
+    std::size_t sentOnConnection;        ///< Cuántos de `unacked` ya se enviaron por la conexión actual.
+    std::size_t unackedSamples;
+    std::uint64_t droppedBatches;
+    std::uint64_t sentBytes;
+
+    std::chrono::steady_clock::time_point nextAttempt;
+    std::chrono::milliseconds backoff;
+
+    bool ensureConnected();
+    void disconnect(bool retryLater);
+    bool readAcks(int timeoutMs);
+    bool sendUnsent();
+
+public:
+    explicit AgentPushSink(const AgentConfig& config);
+    ~AgentPushSink() override;
+
+    AgentPushSink(const AgentPushSink&) = delete;
+    AgentPushSink& operator=(const AgentPushSink&) = delete;
+
+    const char* name() const override { return "agent"; }
+
+    /**
+     * @brief Procesa las confirmaciones recibidas y envía el lote y los que no llegaron.
+     * @return false solo si el lote no se pudo enviar ni retener.
+     */
+    bool write(const std::vector<Metric>& batch) override;
+
+    /**
+     * @brief Envía lo pendiente ignorando la espera exponencial y espera las
+     * confirmaciones hasta timeoutMs.
+     * @return false si quedan lotes sin confirmar.
+     */
+    bool flush() override;
+
+    const std::string& agentName() const { return config.name; }
+    std::size_t pendingCount() const { return unacked.size(); }
+    std::uint64_t dropped() const { return droppedBatches; }
+    std::uint64_t bytesSent() const { return sentBytes; }
+};
@@ -0,0 +1,359 @@
+/**
+ * @file aggregation.cpp
+ * @brief Kernels de agregación (escalar, SSE2, AVX2) y despacho en tiempo de ejecución.
+ *
+ * @details
+ * Cada estadística se reduce a tres recorridos simples sobre el arreglo de valores:
+ *  1. suma            -> sum y mean
+ *  2. mínimo y máximo -> min y max
+ *  3. suma de (x - mean)^2 -> stddev
+ *
+ * Se usan dos pasadas para la desviación (primero la media, luego las diferencias)
+ * en lugar de la fórmula E[x²] - E[x]², que pierde precisión cuando los valores son
+ * grandes y parecidos entre sí (por ejemplo contadores acumulados).
+ *
+ * Los kernels SIMD usan varios acumuladores independientes para que el procesador
+ * pueda ejecutar sumas en paralelo en vez de esperar a que termine la anterior.
+ * Por eso el orden de las sumas difiere del escalar y el resultado puede variar en
+ * los últimos bits: es esperado en aritmética de punto flotante.
+ *
+ * El código SIMD solo se compila en x86/x64. En otras arquitecturas se usa el kernel escalar.
+ *
+ * @author Sergio Gonzalez
+ * @date 2026-01-31
+ */
+
+#include "aggregation.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define SYSPULSE_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+// GCC/Clang solo permiten usar intrínsecos AVX2 dentro de funciones marcadas con
+// ese "target"; el resto del programa sigue compilado para la CPU base.
+// MSVC no necesita la marca.
+#if defined(SYSPULSE_X86) && (defined(__GNUC__) || defined(__clang__))
+#define SYSPULSE_TARGET_AVX2 __attribute__((target("avx2")))
+#define SYSPULSE_TARGET_SSE2 __attribute__((target("sse2")))
+#else
+#define SYSPULSE_TARGET_AVX2
+#define SYSPULSE_TARGET_SSE2
+#endif
+
+namespace {
+
+/**
+ * @struct Kernels
+ * @brief Tabla de funciones de un nivel SIMD.
+ */
+struct Kernels {
+    SimdLevel level;
+    double (*sum)(const double*, std::size_t);
+    void (*minMax)(const double*, std::size_t, double*, double*);
+    double (*sumSquaredDeviation)(const double*, std::size_t, double);
+};
+
+// -----------------------------------------------------------------------------
+// Escalar
+// -----------------------------------------------------------------------------
+
+double sumScalar(const double* v, std::size_t n) {
+    double s = 0.0;
+    for (std::size_t i = 0; i < n; ++i) s += v[i];
+    return s;
+}
+
+void minMaxScalar(const double* v, std::size_t n, double* outMin, double* outMax) {
+    double lo = v[0], hi = v[0];
+    for (std::size_t i = 1; i < n; ++i) {
+        lo = std::min(lo, v[i]);
+        hi = std::max(hi, v[i]);
+    }
+    *outMin = lo;
+    *outMax = hi;
+}
+
+double sumSquaredDeviationScalar(const double* v, std::size_t n, double mean) {
+    double s = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        double d = v[i] - mean;
+        s += d * d;
+    }
+    return s;
+}
+
+const Kernels kScalarKernels = {SimdLevel::Scalar, sumScalar, minMaxScalar, sumSquaredDeviationScalar};
+
+#if defined(SYSPULSE_X86)
+
+// -----------------------------------------------------------------------------
+// SSE2: registros de 128 bits = 2 doubles
+// -----------------------------------------------------------------------------
+
+SYSPULSE_TARGET_SSE2 double horizontalSum(__m128d v) {
+    return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v)));
+}
+
+SYSPULSE_TARGET_SSE2 double sumSse2(const double* v, std::size_t n) {
+    __m128d a0 = _mm_setzero_pd(), a1 = _mm_setzero_pd();
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        a0 = _mm_add_pd(a0, _mm_loadu_pd(v + i));
+        a1 = _mm_add_pd(a1, _mm_loadu_pd(v + i + 2));
+    }
+    double s = horizontalSum(_mm_add_pd(a0, a1));
+    for (; i < n; ++i) s += v[i];
+    return s;
+}
+
+SYSPULSE_TARGET_SSE2 void minMaxSse2(const double* v, std::size_t n, double* outMin, double* outMax) {
+    std::size_t i = 0;
+    double lo = v[0], hi = v[0];
+    if (n >= 2) {
+        __m128d vlo = _mm_loadu_pd(v), vhi = vlo;
+        for (i = 2; i + 2 <= n; i += 2) {
+            __m128d x = _mm_loadu_pd(v + i);
+            vlo = _mm_min_pd(vlo, x);
+            vhi = _mm_max_pd(vhi, x);
+        }
+        lo = std::min(_mm_cvtsd_f64(vlo), _mm_cvtsd_f64(_mm_unpackhi_pd(vlo, vlo)));
+        hi = std::max(_mm_cvtsd_f64(vhi), _mm_cvtsd_f64(_mm_unpackhi_pd(vhi, vhi)));
+    }
+    for (; i < n; ++i) {
+        lo = std::min(lo, v[i]);
+        hi = std::max(hi, v[i]);
+    }
+    *outMin = lo;
+    *outMax = hi;
+}
+
+SYSPULSE_TARGET_SSE2 double sumSquaredDeviationSse2(const double* v, std::size_t n, double mean) {
+    __m128d m = _mm_set1_pd(mean);
+    __m128d a0 = _mm_setzero_pd(), a1 = _mm_setzero_pd();
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128d d0 = _mm_sub_pd(_mm_loadu_pd(v + i), m);
+        __m128d d1 = _mm_sub_pd(_mm_loadu_pd(v + i + 2), m);
+        a0 = _mm_add_pd(a0, _mm_mul_pd(d0, d0));
+        a1 = _mm_add_pd(a1, _mm_mul_pd(d1, d1));
+    }
+    double s = horizontalSum(_mm_add_pd(a0, a1));
+    for (; i < n; ++i) {
+        double d = v[i] - mean;
+        s += d * d;
+    }
+    return s;
+}
+
+const Kernels kSse2Kernels = {SimdLevel::SSE2, sumSse2, minMaxSse2, sumSquaredDeviationSse2};
+
+// -----------------------------------------------------------------------------
+// AVX2: registros de 256 bits = 4 doubles
+// -----------------------------------------------------------------------------
+
+SYSPULSE_TARGET_AVX2 double horizontalSum(__m256d v) {
+    __m128d lo = _mm256_castpd256_pd128(v);
+    __m128d hi = _mm256_extractf128_pd(v, 1);
+    lo = _mm_add_pd(lo, hi);
+    return _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+}
+
+SYSPULSE_TARGET_AVX2 double sumAvx2(const double* v, std::size_t n) {
+    __m256d a0 = _mm256_setzero_pd(), a1 = _mm256_setzero_pd();
+    __m256d a2 = _mm256_setzero_pd(), a3 = _mm256_setzero_pd();
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        a0 = _mm256_add_pd(a0, _mm256_loadu_pd(v + i));
+        a1 = _mm256_add_pd(a1, _mm256_loadu_pd(v + i + 4));
+        a2 = _mm256_add_pd(a2, _mm256_loadu_pd(v + i + 8));
+        a3 = _mm256_add_pd(a3, _mm256_loadu_pd(v + i + 12));
+    }
+    for (; i + 4 <= n; i += 4) {
+        a0 = _mm256_add_pd(a0, _mm256_loadu_pd(v + i));
+    }
+    double s = horizontalSum(_mm256_add_pd(_mm256_add_pd(a0, a1), _mm256_add_pd(a2, a3)));
+    for (; i < n; ++i) s += v[i];
+    return s;
+}
+
+SYSPULSE_TARGET_AVX2 void minMaxAvx2(const double* v, std::size_t n, double* outMin, double* outMax) {
+    std::size_t i = 0;
+    double lo = v[0], hi = v[0];
+    if (n >= 4) {
+        __m256d vlo = _mm256_loadu_pd(v), vhi = vlo;
+        for (i = 4; i + 4 <= n; i += 4) {
+            __m256d x = _mm256_loadu_pd(v + i);
+            vlo = _mm256_min_pd(vlo, x);
+            vhi = _mm256_max_pd(vhi, x);
+        }
+        alignas(32) double l[4], h[4];
+        _mm256_store_pd(l, vlo);
+        _mm256_store_pd(h, vhi);
+        lo = std::min(std::min(l[0], l[1]), std::min(l[2], l[3]));
+        hi = std::max(std::max(h[0], h[1]), std::max(h[2], h[3]));
+    }
+    for (; i < n; ++i) {
+        lo = std::min(lo, v[i]);
+        hi = std::max(hi, v[i]);
+    }
+    *outMin = lo;
+    *outMax = hi;
+}
+
+SYSPULSE_TARGET_AVX2 double sumSquaredDeviationAvx2(const double* v, std::size_t n, double mean) {
+    __m256d m = _mm256_set1_pd(mean);
+    __m256d a0 = _mm256_setzero_pd(), a1 = _mm256_setzero_pd();
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256d d0 = _mm256_sub_pd(_mm256_loadu_pd(v + i), m);
+        __m256d d1 = _mm256_sub_pd(_mm256_loadu_pd(v + i + 4), m);
+        a0 = _mm256_add_pd(a0, _mm256_mul_pd(d0, d0));
+        a1 = _mm256_add_pd(a1, _mm256_mul_pd(d1, d1));
+    }
+    double s = horizontalSum(_mm256_add_pd(a0, a1));
+    for (; i < n; ++i) {
+        double d = v[i] - mean;
+        s += d * d;
+    }
+    return s;
+}
+
+const Kernels kAvx2Kernels = {SimdLevel::AVX2, sumAvx2, minMaxAvx2, sumSquaredDeviationAvx2};
+
+/**
+ * @brief Ejecuta CPUID (hoja @p leaf, subhoja @p subleaf).
+ */
+void cpuid(unsigned leaf, unsigned subleaf, unsigned regs[4]) {
+#if defined(_MSC_VER)
+    int r[4];
+    __cpuidex(r, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int i = 0; i < 4; ++i) regs[i] = static_cast<unsigned>(r[i]);
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+/**
+ * @brief Lee el registro XCR0, que indica qué registros extendidos guarda el SO.
+ */
+unsigned long long readXcr0() {
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    unsigned eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<unsigned long long>(edx) << 32) | eax;
+#endif
+}
+
+#endif // SYSPULSE_X86
+
+const Kernels& kernelsFor(SimdLevel level) {
+#if defined(SYSPULSE_X86)
+    switch (level) {
+    case SimdLevel::AVX2: return kAvx2Kernels;
+    case SimdLevel::SSE2: return kSse2Kernels;
+    default: break;
+    }
+#else
+    (void)level;
+#endif
+    return kScalarKernels;
+}
+
+// Tabla activa. Se publica con atomic para que varios hilos puedan agregar a la vez.
+std::atomic<const Kernels*> gActiveKernels{nullptr};
+
+const Kernels& activeKernels() {
+    const Kernels* k = gActiveKernels.load(std::memory_order_acquire);
+    if (!k) {
+        k = &kernelsFor(detectSimdLevel());
+        gActiveKernels.store(k, std::memory_order_release);
+    }
+    return *k;
+}
+
+} // namespace
+
+SimdLevel detectSimdLevel() {
+#if defined(SYSPULSE_X86)
+    unsigned regs[4];
+    cpuid(0, 0, regs);
+    unsigned maxLeaf = regs[0];
+
+    cpuid(1, 0, regs);
+    bool sse2 = (regs[3] & (1u << 26)) != 0;       // EDX bit 26
+    bool osxsave = (regs[2] & (1u << 27)) != 0;    // ECX bit 27
+    bool avx = (regs[2] & (1u << 28)) != 0;        // ECX bit 28
+
+    bool avx2 = false;
+    if (maxLeaf >= 7 && osxsave && avx) {
+        // XCR0 bits 1 y 2: el SO guarda los registros XMM e YMM.
+        bool osSavesYmm = (readXcr0() & 0x6) == 0x6;
+        cpuid(7, 0, regs);
+        avx2 = osSavesYmm && (regs[1] & (1u << 5)) != 0; // EBX bit 5
+    }
+
+    if (avx2) return SimdLevel::AVX2;
+    if (sse2) return SimdLevel::SSE2;
+#endif
+    return SimdLevel::Scalar;
+}
+
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+    case SimdLevel::AVX2: return "avx2";
+    case SimdLevel::SSE2: return "sse2";
+    default: return "scalar";
+    }
+}
+
+SimdLevel activeSimdLevel() {
+    return activeKernels().level;
+}
+
+void setSimdLevel(SimdLevel level) {
+    SimdLevel best = detectSimdLevel();
+    if (static_cast<int>(level) > static_cast<int>(best)) level = best;
+    gActiveKernels.store(&kernelsFor(level), std::memory_order_release);
+}
+
+WindowStats aggregate(const long long* timestamps, const double* values, std::size_t n) {
+    WindowStats stats;
+    if (n == 0) return stats;
+
+    const Kernels& k = activeKernels();
+
+    stats.count = n;
+    stats.sum = k.sum(values, n);
+    k.minMax(values, n, &stats.min, &stats.max);
+    stats.mean = stats.sum / static_cast<double>(n);
+    stats.stddev = std::sqrt(k.sumSquaredDeviation(values, n, stats.mean) / static_cast<double>(n));
+
+    long long elapsed = timestamps[n - 1] - timestamps[0];
+    if (elapsed > 0) {
+        stats.rate = (values[n - 1] - values[0]) / static_cast<double>(elapsed);
+    }
+    return stats;
+}
+
+WindowStats aggregate(const SeriesColumns& series) {
+    return aggregate(series.timestamps.data(), series.values.data(), series.size());
+}
+
+WindowStats aggregateWindow(const SeriesColumns& series, long long from, long long to) {
+    auto first = std::lower_bound(series.timestamps.begin(), series.timestamps.end(), from);
+    auto last = std::upper_bound(first, series.timestamps.end(), to);
+    std::size_t offset = static_cast<std::size_t>(first - series.timestamps.begin());
+    std::size_t n = static_cast<std::size_t>(last - first);
+    return aggregate(series.timestamps.data() + offset, series.values.data() + offset, n);
+}
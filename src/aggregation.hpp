@@ -0,0 +1,99 @@
+/**
+ * @file aggregation.hpp
+ * @brief Motor de agregación en memoria para estadísticas por ventana de tiempo.
+ * @details
+ * Una serie (component + metric) se carga desde SQLite UNA vez a dos arreglos
+ * contiguos: timestamps (int64) y valores (double). A partir de ahí las
+ * estadísticas de cualquier ventana se calculan recorriendo memoria contigua
+ * con kernels vectorizados (AVX2 o SSE2), elegidos en tiempo de ejecución según
+ * lo que soporte el procesador.
+ * @author Sergio Gonzalez
+ * @date 2026-01-31
+ */
+#pragma once
+#include <cstddef>
+#include <vector>
+
+/**
+ * @struct SeriesColumns
+ * @brief Serie en formato columnar: timestamps[i] corresponde a values[i].
+ * @details Los timestamps están ordenados de forma ascendente.
+ */
+struct SeriesColumns {
+    std::vector<long long> timestamps; ///< Timestamps Unix ordenados.
+    std::vector<double> values;        ///< Valores de la serie.
+
+    std::size_t size() const { return values.size(); }
+
+    void clear() {
+        timestamps.clear();
+        values.clear();
+    }
+};
+
+/**
+ * @struct WindowStats
+ * @brief Resultado de agregar una ventana de la serie.
+ */
+struct WindowStats {
+    std::size_t count = 0; ///< Cantidad de muestras en la ventana.
+    double sum = 0.0;      ///< Suma de los valores.
+    double min = 0.0;      ///< Valor mínimo.
+    double max = 0.0;      ///< Valor máximo.
+    double mean = 0.0;     ///< Promedio.
+    double stddev = 0.0;   ///< Desviación estándar poblacional.
+    double rate = 0.0;     ///< Cambio por segundo entre la primera y la última muestra.
+};
+
+/**
+ * @enum SimdLevel
+ * @brief Conjunto de instrucciones usado por los kernels de agregación.
+ */
+enum class SimdLevel {
+    Scalar, ///< C++ puro; funciona en cualquier CPU.
+    SSE2,   ///< 2 doubles por instrucción.
+    AVX2    ///< 4 doubles por instrucción.
+};
+
+/**
+ * @brief Detecta (vía CPUID) el mejor nivel SIMD disponible en este procesador.
+ * @details Para AVX2 también se verifica con XGETBV que el sistema operativo
+ * guarde los registros YMM en los cambios de contexto.
+ */
+SimdLevel detectSimdLevel();
+
+/**
+ * @brief Nombre legible del nivel SIMD ("scalar", "sse2", "avx2").
+ */
+const char* simdLevelName(SimdLevel level);
+
+/**
+ * @brief Nivel SIMD activo (detectado una sola vez en la primera llamada).
+ */
+SimdLevel activeSimdLevel();
+
+/**
+ * @brief Fuerza un nivel SIMD concreto (útil para comparar kernels).
+ * @details Si el procesador no soporta el nivel pedido se usa el mejor disponible por debajo.
+ */
+void setSimdLevel(SimdLevel level);
+
+/**
+ * @brief Agrega n muestras contiguas.
+ * @param timestamps Timestamps de las muestras (solo se usan el primero y el último, para rate).
+ * @param values Valores de las muestras.
+ * @param n Cantidad de muestras.
+ */
+WindowStats aggregate(const long long* timestamps, const double* values, std::size_t n);
+
+/**
+ * @brief Agrega la serie completa.
+ */
+WindowStats aggregate(const SeriesColumns& series);
+
+/**
+ * @brief Agrega solo las muestras con timestamp en [from, to].
+ * @details La ventana se localiza con búsqueda binaria sobre los timestamps,
+ * por lo que consultar muchas ventanas de la misma serie no vuelve a tocar SQLite.
+ */
+WindowStats aggregateWindow(const SeriesColumns& series, long long from, long long to);
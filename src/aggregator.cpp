@@ -0,0 +1,409 @@
+/**
+ * @file aggregator.cpp
+ * @brief Implementación de AggregatorServer.
+ * @author Sergio Gonzalez
+ * @date 2026-05-09
+ */
+
+#include <winsock2.h> // Debe ir antes que cualquier inclusión de windows.h
+#include "aggregator.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <mutex>
+#include "db_sink.hpp"
+#include "logger.hpp"
+#include "net.hpp"
+
+namespace {
+
+/// Espera máxima de WSAPoll: cada cuánto un hilo revisa su bandeja de conexiones nuevas y la parada.
+constexpr int kPollTimeoutMs = 50;
+
+/// Bytes leídos por recv().
+constexpr std::size_t kReadChunk = 64 * 1024;
+
+/// FNV-1a de 32 bits: estable entre compilaciones, a diferencia de std::hash.
+std::uint32_t fnv1a(const std::string& text) {
+    std::uint32_t hash = 2166136261u;
+    for (unsigned char c : text) {
+        hash ^= c;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Agrega `host=<agente>` a las etiquetas si la muestra no trae host.
+ */
+void tagHost(Metric& m, const std::string& agent) {
+    for (const auto& label : m.labels) {
+        if (label.first == "host") return;
+    }
+    m.labels.emplace_back("host", agent);
+    normalizeLabels(m.labels);
+}
+
+} // namespace
+
+struct AggregatorServer::Connection {
+    std::uintptr_t socket;
+    std::string buffer;     ///< Bytes recibidos todavía sin formar una trama completa.
+    std::string agent;      ///< Vacío hasta recibir Hello.
+    std::uint64_t session = 0;
+    std::size_t shard = 0;
+    BatchDecoder decoder;   ///< Diccionario de series de la conexión.
+    std::uint64_t ackSequence = 0;
+    bool ackPending = false;
+    std::string outbox;     ///< Bytes de Ack que send() no llegó a aceptar.
+};
+
+struct AggregatorServer::IoThread {
+    std::thread thread;
+    std::mutex inboxMutex;
+    std::vector<std::uintptr_t> inbox;       ///< Sockets aceptados, pendientes de agregar al poll.
+    std::atomic<std::size_t> connections{0};
+    bool acceptor = false;                   ///< El hilo 0 también vigila el socket de escucha.
+};
+
+struct AggregatorServer::Shard {
+    DatabaseManager db;
+    FanOut writer;
+};
+
+AggregatorServer::AggregatorServer(const AggregatorConfig& c)
+    : config(c), listenSocket(net::kInvalidSocket), stopping(false), running(false),
+      acceptedCount(0), frameCount(0), sampleCount(0), errorCount(0), duplicateCount(0), nonFiniteCount(0) {
+    if (config.ioThreads == 0) config.ioThreads = 1;
+    if (config.shards == 0) config.shards = 1;
+}
+
+AggregatorServer::~AggregatorServer() {
+    stop();
+}
+
+bool AggregatorServer::start(std::string& error) {
+    if (running) return true;
+
+    std::error_code ec;
+    std::filesystem::create_directories(config.dataDir, ec);
+    for (std::size_t i = 0; i < config.shards; ++i) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "/shard-%02zu", i);
+        std::string base = config.dataDir + name;
+
+        auto shard = std::make_unique<Shard>();
+        if (!shard->db.connect(base + ".db")) {
+            error = "no se pudo abrir " + base + ".db";
+            return false;
+        }
+        for (const std::string& pragma : config.pragmas) {
+            if (!shard->db.applyPragma(pragma)) {
+                Logger::error("PRAGMA rechazado.", {{"pragma", pragma}, {"shard", i}});
+            }
+        }
+        // La cola de la partición no descarta: lo que se publicó ya está confirmado al agente.
+        shard->writer.addSink(std::make_unique<DatabaseSink>(shard->db, base + ".spool", config.spoolCapacity),
+                              config.queueBatches, OverflowPolicy::Block);
+        shards.push_back(std::move(shard));
+    }
+
+    listenSocket = net::listenTcp(config.listenAddress, config.port, error);
+    if (listenSocket == net::kInvalidSocket) {
+        shards.clear();
+        return false;
+    }
+
+    for (auto& shard : shards) {
+        shard->writer.start();
+    }
+    stopping = false;
+    for (std::size_t i = 0; i < config.ioThreads; ++i) {
+        auto io = std::make_unique<IoThread>();
+        io->acceptor = i == 0;
+        ioThreads.push_back(std::move(io));
+    }
+    for (auto& io : ioThreads) {
+        IoThread* self = io.get();
+        self->thread = std::thread([this, self] { ioLoop(*self); });
+    }
+    running = true;
+    return true;
+}
+
+void AggregatorServer::stop() {
+    if (!running) return;
+    running = false;
+
+    // Primero la red: así nadie publica en los escritores mientras se detienen.
+    stopping = true;
+    for (auto& io : ioThreads) {
+        if (io->thread.joinable()) io->thread.join();
+        for (std::uintptr_t s : io->inbox) net::closeSocket(s);
+    }
+    ioThreads.clear();
+    net::closeSocket(listenSocket);
+    listenSocket = net::kInvalidSocket;
+
+    for (auto& shard : shards) {
+        shard->writer.stop();
+        shard->db.checkpoint();
+        shard->db.close();
+    }
+    shards.clear();
+}
+
+std::size_t AggregatorServer::shardFor(const std::string& agent) const {
+    return fnv1a(agent) % shards.size();
+}
+
+/**
+ * @brief Registra la secuencia de un lote del agente.
+ * @return false si ya se había recibido (misma sesión y secuencia no mayor que la última).
+ * @details Se guarda por agente y no por conexión: tras una reconexión el
+ * agente reenvía lo que no vio confirmado, quizá por otro hilo de E/S.
+ */
+bool AggregatorServer::acceptSequence(const Connection& connection, std::uint64_t sequence) {
+    std::lock_guard<std::mutex> lock(sessionsMutex);
+    AgentSession& known = sessions[connection.agent];
+    if (known.session == connection.session && sequence <= known.lastSequence) return false;
+    known.session = connection.session;
+    known.lastSequence = sequence;
+    return true;
+}
+
+/**
+ * @brief Acepta todas las conexiones en espera y reparte cada una al hilo con menos conexiones.
+ */
+void AggregatorServer::acceptPending() {
+    while (true) {
+        SOCKET s = accept(static_cast<SOCKET>(listenSocket), nullptr, nullptr);
+        if (s == INVALID_SOCKET) return;  // WSAEWOULDBLOCK: no hay más en espera.
+
+        std::uintptr_t handle = static_cast<std::uintptr_t>(s);
+        if (!net::setNonBlocking(handle)) {
+            net::closeSocket(handle);
+            continue;
+        }
+        ++acceptedCount;
+
+        IoThread* target = ioThreads.front().get();
+        for (auto& io : ioThreads) {
+            if (io->connections < target->connections) target = io.get();
+        }
+        ++target->connections;
+        std::lock_guard<std::mutex> lock(target->inboxMutex);
+        target->inbox.push_back(handle);
+    }
+}
+
+/**
+ * @brief Lee lo disponible en el socket y procesa las tramas completas.
+ * @return false si la conexión se cerró o envió algo inválido.
+ */
+bool AggregatorServer::readConnection(Connection& connection, std::vector<std::vector<Metric>>& pendingByShard) {
+    bool open = true;
+    char chunk[kReadChunk];
+    while (true) {
+        int n = recv(static_cast<SOCKET>(connection.socket), chunk, static_cast<int>(sizeof(chunk)), 0);
+        if (n > 0) {
+            connection.buffer.append(chunk, static_cast<std::size_t>(n));
+            if (static_cast<std::size_t>(n) < sizeof(chunk)) break;
+            continue;
+        }
+        if (n < 0 && WSAGetLastError() == WSAEWOULDBLOCK) break;
+        open = false;  // 0 = el agente cerró; < 0 = error. Se procesa lo que ya llegó.
+        break;
+    }
+
+    std::size_t offset = 0;
+    Frame frame;
+    while (true) {
+        FrameStatus status = nextFrame(connection.buffer.data() + offset, connection.buffer.size() - offset, frame);
+        if (status == FrameStatus::Incomplete) break;
+        bool ok = status == FrameStatus::Complete;
+        if (ok && connection.agent.empty()) {
+            // La primera trama debe ser Hello: sin nombre no hay partición ni etiqueta host.
+            std::uint64_t version = 0;
+            ok = decodeHello(frame, version, connection.agent, connection.session) &&
+                 version == kAgentProtocolVersion && !connection.agent.empty();
+            if (ok) {
+                connection.shard = shardFor(connection.agent);
+                Logger::info("Agente conectado.", {{"agent", connection.agent}, {"shard", connection.shard}});
+            }
+        } else if (ok) {
+            std::vector<Metric>& pending = pendingByShard[connection.shard];
+            std::size_t before = pending.size();
+            std::uint64_t sequence = 0;
+            ok = connection.decoder.decode(frame, sequence, pending);
+            if (ok && !acceptSequence(connection, sequence)) {
+                // Reenvío de un lote que ya llegó por una conexión anterior: solo se confirma.
+                duplicateCount += pending.size() - before;
+                pending.resize(before);
+            }
+            if (ok) {
+                // El decodificador ya avanzó su estado con estos valores; aquí solo se descartan.
+                auto firstBad = std::remove_if(pending.begin() + static_cast<std::ptrdiff_t>(before), pending.end(),
+                                               [](const Metric& m) { return !std::isfinite(m.value); });
+                nonFiniteCount += static_cast<std::uint64_t>(pending.end() - firstBad);
+                pending.erase(firstBad, pending.end());
+            }
+            for (std::size_t i = before; ok && i < pending.size(); ++i) {
+                tagHost(pending[i], connection.agent);
+            }
+            sampleCount += pending.size() - before;
+            if (ok) {
+                connection.ackSequence = sequence;
+                connection.ackPending = true;
+            }
+        }
+        if (!ok) {
+            ++errorCount;
+            Logger::warn("Trama inválida; se cierra la conexión.", {{"agent", connection.agent}});
+            return false;
+        }
+        ++frameCount;
+        offset += frame.totalSize;
+    }
+    connection.buffer.erase(0, offset);
+    return open;
+}
+
+/**
+ * @brief Bucle de un hilo de E/S.
+ *
+ * @details
+ * `fds[i]` corresponde a `connections[i - first]`; en el hilo aceptador la
+ * posición 0 es el socket de escucha. Las conexiones cerradas se quitan
+ * intercambiándolas con la última, así que quitar es O(1).
+ *
+ * WSAPoll con cero sockets devuelve error en lugar de esperar: un hilo sin
+ * conexiones duerme el mismo intervalo.
+ */
+void AggregatorServer::ioLoop(IoThread& self) {
+    std::vector<WSAPOLLFD> fds;
+    std::vector<Connection> connections;
+    std::vector<std::vector<Metric>> pendingByShard(shards.size());
+    const std::size_t first = self.acceptor ? 1 : 0;
+    if (self.acceptor) {
+        WSAPOLLFD listener{};
+        listener.fd = static_cast<SOCKET>(listenSocket);
+        listener.events = POLLRDNORM;
+        fds.push_back(listener);
+    }
+
+    auto closeAt = [&](std::size_t i) {
+        net::closeSocket(connections[i].socket);
+        if (!connections[i].agent.empty()) {
+            Logger::info("Agente desconectado.", {{"agent", connections[i].agent}});
+        }
+        connections[i] = std::move(connections.back());
+        connections.pop_back();
+        fds[first + i] = fds.back();
+        fds.pop_back();
+        --self.connections;
+    };
+
+    // Envía lo que quede del Ack en curso. false si la conexión falló.
+    auto flushOutbox = [](Connection& connection) {
+        while (!connection.outbox.empty()) {
+            int n = send(static_cast<SOCKET>(connection.socket), connection.outbox.data(),
+                         static_cast<int>(connection.outbox.size()), 0);
+            if (n > 0) {
+                connection.outbox.erase(0, static_cast<std::size_t>(n));
+                continue;
+            }
+            return n < 0 && WSAGetLastError() == WSAEWOULDBLOCK;
+        }
+        return true;
+    };
+
+    while (!stopping) {
+        {
+            std::lock_guard<std::mutex> lock(self.inboxMutex);
+            for (std::uintptr_t s : self.inbox) {
+                Connection connection;
+                connection.socket = s;
+                connections.push_back(std::move(connection));
+                WSAPOLLFD fd{};
+                fd.fd = static_cast<SOCKET>(s);
+                fd.events = POLLRDNORM;
+                fds.push_back(fd);
+            }
+            self.inbox.clear();
+        }
+
+        if (fds.empty()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(kPollTimeoutMs));
+            continue;
+        }
+        int ready = WSAPoll(fds.data(), static_cast<ULONG>(fds.size()), kPollTimeoutMs);
+        if (ready <= 0) continue;
+
+        if (self.acceptor && fds[0].revents != 0) {
+            acceptPending();
+        }
+        // De atrás hacia adelante: closeAt() mueve la última conexión a la posición actual.
+        for (std::size_t i = connections.size(); i-- > 0;) {
+            short revents = fds[first + i].revents;
+            if (revents == 0) continue;
+            fds[first + i].revents = 0;
+            // Solo POLLWRNORM: hay lugar para el Ack pendiente, se envía abajo.
+            if ((revents & ~POLLWRNORM) == 0) continue;
+            if (!readConnection(connections[i], pendingByShard)) {
+                closeAt(i);
+            }
+        }
+
+        for (std::size_t s = 0; s < pendingByShard.size(); ++s) {
+            if (!pendingByShard[s].empty()) {
+                shards[s]->writer.publish(std::move(pendingByShard[s]));
+            }
+        }
+
+        // Las confirmaciones salen después de publicar: un Ack significa que el
+        // lote está en la cola de su partición, que no descarta. Son acumulativas:
+        // mientras un Ack no termina de salir, los nuevos se juntan en el siguiente.
+        // Lo que send() no acepta queda en outbox y sale cuando el socket admite
+        // escritura (POLLWRNORM).
+        for (std::size_t i = connections.size(); i-- > 0;) {
+            Connection& connection = connections[i];
+            if (connection.ackPending && connection.outbox.empty()) {
+                connection.ackPending = false;
+                encodeAck(connection.outbox, connection.ackSequence);
+            }
+            if (connection.outbox.empty()) continue;
+            if (!flushOutbox(connection)) {
+                closeAt(i);
+                continue;
+            }
+            fds[first + i].events = connection.outbox.empty() ? POLLRDNORM : POLLRDNORM | POLLWRNORM;
+        }
+    }
+
+    while (!connections.empty()) {
+        closeAt(connections.size() - 1);
+    }
+}
+
+AggregatorStats AggregatorServer::stats() const {
+    AggregatorStats s;
+    for (const auto& io : ioThreads) {
+        s.connections += io->connections;
+    }
+    s.accepted = acceptedCount;
+    s.frames = frameCount;
+    s.samples = sampleCount;
+    s.protocolErrors = errorCount;
+    s.duplicateSamples = duplicateCount;
+    s.nonFiniteSamples = nonFiniteCount;
+    for (const auto& shard : shards) {
+        for (const SinkStats& sink : shard->writer.stats()) {
+            s.queuedBatches += sink.queuedBatches;
+            s.failedBatches += sink.failedBatches;
+        }
+    }
+    return s;
+}
@@ -0,0 +1,136 @@
+/**
+ * @file aggregator.hpp
+ * @brief Modo agregador: recibe por TCP los lotes de muchos agentes SysPulse.
+ * @details
+ * Cada equipo corre SysPulse como agente (con AgentPushSink) y un equipo
+ * central corre `syspulse --aggregator <puerto>`. El agregador guarda todo en
+ * bases particionadas, consultables desde un solo lugar.
+ *
+ * Red: unos pocos hilos de E/S, cada uno con su propio conjunto de conexiones
+ * no bloqueantes esperando en WSAPoll (el equivalente de epoll/poll en
+ * Winsock). El hilo 0 además acepta conexiones nuevas y se las asigna al hilo
+ * con menos conexiones. Miles de agentes que envían un lote por segundo son
+ * unas pocas tramas por vuelta de poll.
+ *
+ * Almacenamiento: SQLite admite un solo escritor por archivo, así que los
+ * datos se reparten en N bases (`<data_dir>/shard-NN.db`), cada una con su
+ * propio hilo escritor (un FanOut con un DatabaseSink: cola acotada, cola local
+ * ante fallos y rollups). Todas las muestras de un agente van siempre a la
+ * misma partición (hash FNV-1a de su nombre), y cada una recibe la etiqueta
+ * `host=<agente>` si no la traía.
+ *
+ * Los hilos de E/S no escriben en SQLite: juntan lo recibido en cada vuelta de
+ * poll por partición, lo publican como un único lote y recién entonces
+ * confirman (Ack) a cada agente la secuencia de su último lote. La cola de
+ * cada partición no descarta: si se llena, el hilo de E/S espera y deja de
+ * leer, y los agentes retienen sus lotes sin confirmar hasta que se libere. Los lotes que
+ * un agente reenvía tras reconectar y que ya habían llegado se reconocen por
+ * su sesión y secuencia, se confirman y se descartan. Las muestras con un
+ * valor NaN o infinito se descartan al decodificar y se cuentan aparte: ni
+ * SQLite ni los rollups las admiten.
+ * @author Sergio Gonzalez
+ * @date 2026-05-09
+ */
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "agent_protocol.hpp"
+#include "db_manager.hpp"
+#include "fanout.hpp"
+
+/**
+ * @struct AggregatorConfig
+ * @brief Dirección de escucha, hilos y particiones del agregador.
+ */
+struct AggregatorConfig {
+    std::string listenAddress = "0.0.0.0";
+    unsigned short port = 7070;
+    std::size_t ioThreads = 2;
+    std::size_t shards = 4;
+    std::string dataDir = "data/shards";
+    std::vector<std::string> pragmas;     ///< Se aplican a cada partición.
+    std::size_t queueBatches = 64;        ///< Cola de cada escritor.
+    std::size_t spoolCapacity = 262144;   ///< Cola local de cada partición.
+};
+
+/**
+ * @struct AggregatorStats
+ * @brief Contadores del agregador (acumulados desde start(), salvo connections).
+ */
+struct AggregatorStats {
+    std::size_t connections = 0;        ///< Agentes conectados ahora.
+    std::uint64_t accepted = 0;
+    std::uint64_t frames = 0;
+    std::uint64_t samples = 0;
+    std::uint64_t protocolErrors = 0;   ///< Conexiones cerradas por tramas inválidas.
+    std::uint64_t duplicateSamples = 0; ///< Reenviadas por un agente tras reconectar y ya recibidas.
+    std::uint64_t nonFiniteSamples = 0; ///< Descartadas por traer un valor NaN o infinito.
+    std::size_t queuedBatches = 0;      ///< Lotes en las colas de escritura ahora (llenas = E/S en espera).
+    std::uint64_t failedBatches = 0;    ///< Lotes que una partición no pudo guardar ni pasar a su cola local.
+};
+
+/**
+ * @class AggregatorServer
+ * @brief Servidor TCP de agentes con escritura particionada.
+ */
+class AggregatorServer {
+private:
+    struct Connection;
+    struct IoThread;
+    struct Shard;
+
+    AggregatorConfig config;
+    std::uintptr_t listenSocket;
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::vector<std::unique_ptr<IoThread>> ioThreads;
+    std::atomic<bool> stopping;
+    bool running;
+
+    std::atomic<std::uint64_t> acceptedCount;
+    std::atomic<std::uint64_t> frameCount;
+    std::atomic<std::uint64_t> sampleCount;
+    std::atomic<std::uint64_t> errorCount;
+    std::atomic<std::uint64_t> duplicateCount;
+    std::atomic<std::uint64_t> nonFiniteCount;
+
+    /// Última secuencia recibida de cada agente, dentro de su sesión actual.
+    struct AgentSession {
+        std::uint64_t session = 0;
+        std::uint64_t lastSequence = 0;
+    };
+    std::mutex sessionsMutex;
+    std::unordered_map<std::string, AgentSession> sessions;
+
+    void ioLoop(IoThread& self);
+    void acceptPending();
+    bool readConnection(Connection& connection, std::vector<std::vector<Metric>>& pendingByShard);
+    std::size_t shardFor(const std::string& agent) const;
+    bool acceptSequence(const Connection& connection, std::uint64_t sequence);
+
+public:
+    explicit AggregatorServer(const AggregatorConfig& config);
+    ~AggregatorServer();
+
+    AggregatorServer(const AggregatorServer&) = delete;
+    AggregatorServer& operator=(const AggregatorServer&) = delete;
+
+    /**
+     * @brief Abre las particiones, empieza a escuchar y arranca los hilos.
+     * @param error Descripción del fallo.
+     */
+    bool start(std::string& error);
+
+    /**
+     * @brief Cierra las conexiones, vacía las colas de escritura y cierra las bases.
+     */
+    void stop();
+
+    AggregatorStats stats() const;
+};
@@ -0,0 +1,76 @@
+/**
+ * @file alert_dispatcher.cpp
+ * @brief Implementación de AlertDispatcher.
+ * @author Sergio Gonzalez
+ * @date 2026-02-14
+ */
+
+#include "alert_dispatcher.hpp"
+#include "logger.hpp"
+
+AlertDispatcher::AlertDispatcher(DatabaseManager& d, std::unique_ptr<AlertSink> w, std::size_t c)
+    : db(d), webhook(std::move(w)), capacity(c == 0 ? 1 : c), stopping(false) {}
+
+AlertDispatcher::~AlertDispatcher() {
+    stop();
+}
+
+void AlertDispatcher::start() {
+    if (worker.joinable()) return;
+    stopping = false;
+    worker = std::thread([this] { run(); });
+}
+
+void AlertDispatcher::publish(const std::vector<AlertEvent>& events) {
+    if (events.empty()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const AlertEvent& e : events) {
+            if (queue.size() >= capacity) {
+                queue.pop_front();
+                ++droppedEvents;
+            }
+            queue.push_back(e);
+        }
+    }
+    ready.notify_one();
+}
+
+/**
+ * @brief Bucle del hilo: toma todo lo encolado, lo guarda en una transacción y lo envía.
+ * @details Al pedir la parada se entrega lo que quedó en la cola antes de salir.
+ */
+void AlertDispatcher::run() {
+    std::vector<AlertEvent> pending;
+    while (true) {
+        pending.clear();
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            ready.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) break;  // stopping y sin trabajo
+            pending.assign(std::make_move_iterator(queue.begin()), std::make_move_iterator(queue.end()));
+            queue.clear();
+        }
+
+        if (!db.insertAlertEvents(pending)) {
+            Logger::error("Fallo al guardar eventos de alerta en DB.", {{"events", pending.size()}});
+        }
+        if (webhook) {
+            for (const AlertEvent& e : pending) {
+                if (!webhook->send(e)) {
+                    Logger::error("No se pudo entregar la alerta al webhook.", {{"rule", e.rule}});
+                }
+            }
+        }
+    }
+}
+
+void AlertDispatcher::stop() {
+    if (!worker.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    ready.notify_one();
+    worker.join();
+}
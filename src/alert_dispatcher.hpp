@@ -0,0 +1,67 @@
+/**
+ * @file alert_dispatcher.hpp
+ * @brief Entrega de los eventos de alerta (base y webhook) desde su propio hilo.
+ * @details
+ * El motor de alertas corre en el bucle de muestreo, pero guardar sus eventos
+ * (toma el mutex de la base, que puede estar en medio de una transacción larga
+ * del sink de SQLite) y enviarlos al webhook (hasta 500 ms si el receptor no
+ * responde) no: publish() solo encola, como FanOut::publish. Si la cola se
+ * llena se descartan los eventos más antiguos y se cuentan.
+ * @author Sergio Gonzalez
+ * @date 2026-02-14
+ */
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "alert_engine.hpp"
+#include "db_manager.hpp"
+
+/**
+ * @class AlertDispatcher
+ * @brief Cola acotada de eventos de alerta con un hilo que los guarda y los envía.
+ */
+class AlertDispatcher {
+private:
+    DatabaseManager& db;
+    std::unique_ptr<AlertSink> webhook;   ///< Puede ser nulo.
+    std::size_t capacity;
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::deque<AlertEvent> queue;
+    bool stopping;
+    std::thread worker;
+    std::atomic<std::uint64_t> droppedEvents{0};
+
+    void run();
+
+public:
+    /**
+     * @param db Base ya conectada (compartida con el sink de SQLite).
+     * @param webhook Destino adicional opcional.
+     * @param capacity Eventos que puede acumular antes de descartar los más antiguos.
+     */
+    AlertDispatcher(DatabaseManager& db, std::unique_ptr<AlertSink> webhook, std::size_t capacity = 1024);
+    ~AlertDispatcher();
+
+    AlertDispatcher(const AlertDispatcher&) = delete;
+    AlertDispatcher& operator=(const AlertDispatcher&) = delete;
+
+    /** @brief Arranca el hilo de entrega. */
+    void start();
+
+    /** @brief Encola los eventos. No hace E/S. */
+    void publish(const std::vector<AlertEvent>& events);
+
+    /** @brief Entrega lo que quede en la cola y detiene el hilo. */
+    void stop();
+
+    /** @brief Eventos descartados por cola llena (acumulado). */
+    std::uint64_t dropped() const { return droppedEvents.load(); }
+};
@@ -0,0 +1,449 @@
+/**
+ * @file alert_engine.cpp
+ * @brief Implementación del motor de alertas, del lector de reglas y del webhook.
+ *
+ * @details
+ * Máquina de estados de cada regla:
+ *
+ *     inactiva --(condición)--> pendiente --(forSeconds cumplidos)--> disparada
+ *        ^                         |                                    |
+ *        +----(condición falsa)----+-------(condición falsa: resuelta)--+
+ *
+ * Con forSeconds = 0 se pasa directamente de inactiva a disparada en la misma
+ * muestra: la latencia de detección es la del propio ciclo de muestreo.
+ *
+ * @author Sergio Gonzalez
+ * @date 2026-02-14
+ */
+
+#include "alert_engine.hpp"
+#include "http_client.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+bool compare(AlertComparison op, double value, double threshold) {
+    switch (op) {
+    case AlertComparison::Greater: return value > threshold;
+    case AlertComparison::GreaterEqual: return value >= threshold;
+    case AlertComparison::Less: return value < threshold;
+    case AlertComparison::LessEqual: return value <= threshold;
+    }
+    return false;
+}
+
+bool parseComparison(const std::string& token, AlertComparison& out) {
+    if (token == ">") out = AlertComparison::Greater;
+    else if (token == ">=") out = AlertComparison::GreaterEqual;
+    else if (token == "<") out = AlertComparison::Less;
+    else if (token == "<=") out = AlertComparison::LessEqual;
+    else return false;
+    return true;
+}
+
+bool parseNumber(const std::string& token, double& out) {
+    char* end = nullptr;
+    out = std::strtod(token.c_str(), &end);
+    return end != token.c_str() && *end == '\0';
+}
+
+void buildMetricKey(std::string& key, const std::string& component, const std::string& metric) {
+    key.assign(component);
+    key.push_back('\x1f');
+    key.append(metric);
+}
+
+/// Clave de la serie: la de component/metric seguida de las etiquetas.
+void appendSeriesLabels(std::string& key, const Labels& labels) {
+    key.push_back('\x1f');
+    appendLabels(key, labels);
+}
+
+/**
+ * @brief Escapa un texto para incluirlo entre comillas en JSON.
+ */
+void appendJsonString(std::string& out, const std::string& text) {
+    out.push_back('"');
+    for (char c : text) {
+        switch (c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char buffer[8];
+                std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                out += buffer;
+            } else {
+                out.push_back(c);
+            }
+        }
+    }
+    out.push_back('"');
+}
+
+} // namespace
+
+/**
+ * @brief Lee el archivo de reglas línea por línea.
+ *
+ * @details Gramática de una regla (separada por espacios):
+ *  - `<nombre> <serie> <op> <valor> [for <segundos>]`
+ *  - `<nombre> <serie> rate <op> <valor> [for <segundos>]`
+ *  - `<nombre> <serie> absent <segundos>`
+ *
+ * `<serie>` es `<component>/<metric>` con condiciones opcionales sobre las
+ * etiquetas, sin espacios: `Disk/FreePercent{device=C:}`, `CPU/Usage{cpu=*}`.
+ *
+ * Y una directiva opcional: `webhook <host>:<puerto>[/ruta]`.
+ */
+bool loadAlertRules(const std::string& path, AlertRuleFile& out, std::string& error) {
+    std::ifstream file(path);
+    if (!file) {
+        error = "no se pudo abrir " + path;
+        return false;
+    }
+
+    out = AlertRuleFile();
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        std::vector<std::string> tokens;
+        std::istringstream ss(line);
+        std::string token;
+        while (ss >> token) tokens.push_back(token);
+        if (tokens.empty() || tokens[0][0] == '#') continue;
+
+        auto fail = [&](const std::string& what) {
+            error = path + ":" + std::to_string(lineNumber) + ": " + what;
+            return false;
+        };
+
+        if (tokens[0] == "webhook") {
+            if (tokens.size() != 2) return fail("uso: webhook <host>:<puerto>[/ruta]");
+            std::string target = tokens[1];
+            std::size_t slash = target.find('/');
+            if (slash != std::string::npos) {
+                out.webhookPath = target.substr(slash);
+                target = target.substr(0, slash);
+            }
+            std::size_t colon = target.rfind(':');
+            if (colon == std::string::npos) return fail("falta el puerto del webhook");
+            out.webhookHost = target.substr(0, colon);
+            out.webhookPort = static_cast<unsigned short>(std::atoi(target.c_str() + colon + 1));
+            if (out.webhookPort == 0) return fail("puerto de webhook inválido");
+            continue;
+        }
+
+        if (tokens.size() < 3) return fail("regla incompleta");
+
+        AlertRule rule;
+        rule.name = tokens[0];
+        SeriesSelector selector;
+        std::string selectorError;
+        if (!parseSeriesSelector(tokens[1], selector, selectorError)) return fail(selectorError);
+        if (selector.component.empty() || selector.metric.empty()) {
+            return fail("la serie debe tener la forma <component>/<metric>{...}");
+        }
+        rule.component = std::move(selector.component);
+        rule.metric = std::move(selector.metric);
+        rule.matchers = std::move(selector.matchers);
+
+        std::size_t next = 2;
+        double number;
+        if (tokens[next] == "absent") {
+            if (tokens.size() != 4 || !parseNumber(tokens[3], number) || number <= 0) {
+                return fail("uso: <nombre> <serie> absent <segundos>");
+            }
+            rule.type = AlertRuleType::Absence;
+            rule.absentSeconds = static_cast<int>(number);
+            out.rules.push_back(rule);
+            continue;
+        }
+
+        if (tokens[next] == "rate") {
+            rule.type = AlertRuleType::RateOfChange;
+            ++next;
+        }
+        if (tokens.size() < next + 2 || !parseComparison(tokens[next], rule.comparison) ||
+            !parseNumber(tokens[next + 1], rule.threshold)) {
+            return fail("se esperaba <op> <valor> con op en > >= < <=");
+        }
+        next += 2;
+
+        if (next < tokens.size()) {
+            if (tokens[next] != "for" || next + 2 != tokens.size() ||
+                !parseNumber(tokens[next + 1], number) || number < 0) {
+                return fail("se esperaba 'for <segundos>' al final");
+            }
+            rule.forSeconds = static_cast<int>(number);
+        }
+        out.rules.push_back(rule);
+    }
+    return true;
+}
+
+/**
+ * @brief Compila las reglas.
+ *
+ * @details
+ * Las reglas se ordenan por component/metric para que todas las de una misma
+ * métrica queden contiguas en `table`; el índice guarda solo el rango [inicio, fin).
+ * Así evaluar una muestra es: 1 búsqueda en hash + recorrer un tramo contiguo.
+ *
+ * Las reglas cuyas condiciones son todas de igualdad nombran una sola serie:
+ * se empieza a seguir desde ahora, para que su ausencia se detecte aunque
+ * nunca llegue una muestra.
+ */
+void AlertEngine::compile(const std::vector<AlertRule>& newRules, long long now) {
+    rules = newRules;
+    table.clear();
+    metricIndex.clear();
+    seriesStates.clear();
+    absenceStates.clear();
+
+    std::vector<std::uint32_t> order(rules.size());
+    for (std::uint32_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [this](std::uint32_t a, std::uint32_t b) {
+        if (rules[a].component != rules[b].component) return rules[a].component < rules[b].component;
+        return rules[a].metric < rules[b].metric;
+    });
+
+    table.reserve(rules.size());
+    for (std::uint32_t index : order) {
+        const AlertRule& r = rules[index];
+        CompiledRule c{};
+        c.type = r.type;
+        c.comparison = r.comparison;
+        c.threshold = r.threshold;
+        c.forSeconds = r.forSeconds;
+        c.absentSeconds = r.absentSeconds;
+        c.ruleIndex = index;
+
+        std::uint32_t position = static_cast<std::uint32_t>(table.size());
+        table.push_back(c);
+
+        buildMetricKey(keyBuffer, r.component, r.metric);
+        auto it = metricIndex.find(keyBuffer);
+        if (it == metricIndex.end()) {
+            metricIndex.emplace(keyBuffer, std::make_pair(position, position + 1));
+        } else {
+            it->second.second = position + 1;
+        }
+    }
+
+    for (const AlertRule& r : rules) {
+        if (r.type != AlertRuleType::Absence) continue;
+        Labels labels;
+        bool exact = true;
+        for (const LabelMatcher& matcher : r.matchers) {
+            exact = exact && !matcher.anyValue;
+            labels.emplace_back(matcher.name, matcher.value);
+        }
+        if (!exact) continue;
+        normalizeLabels(labels);
+
+        buildMetricKey(keyBuffer, r.component, r.metric);
+        std::pair<std::uint32_t, std::uint32_t> range = metricIndex.find(keyBuffer)->second;
+        appendSeriesLabels(keyBuffer, labels);
+        if (seriesStates.find(keyBuffer) == seriesStates.end()) {
+            trackSeries(keyBuffer, range, labels, now);
+        }
+    }
+}
+
+/**
+ * @brief Empieza a seguir una serie: un estado por cada regla de su métrica cuyas condiciones cumple.
+ * @param now Momento desde el que cuentan las reglas de ausencia.
+ */
+AlertEngine::SeriesState& AlertEngine::trackSeries(const std::string& key,
+                                                   const std::pair<std::uint32_t, std::uint32_t>& range,
+                                                   const Labels& labels, long long now) {
+    SeriesState& series = seriesStates[key];
+    series.labels = labels;
+    for (std::uint32_t i = range.first; i < range.second; ++i) {
+        if (!matchesLabels(labels, rules[table[i].ruleIndex].matchers)) continue;
+        RuleState state{};
+        state.position = i;
+        state.lastSeen = now;
+        series.rules.push_back(state);
+    }
+    for (std::uint32_t i = 0; i < series.rules.size(); ++i) {
+        if (table[series.rules[i].position].type == AlertRuleType::Absence) {
+            absenceStates.emplace_back(&series, i);
+        }
+    }
+    return series;
+}
+
+void AlertEngine::emit(const SeriesState& series, const RuleState& state, bool firing, double value, long long timestamp) {
+    const AlertRule& r = rules[table[state.position].ruleIndex];
+    AlertEvent e;
+    e.rule = r.name;
+    e.component = r.component;
+    e.metric = r.metric;
+    e.labels = series.labels;
+    e.firing = firing;
+    e.value = value;
+    e.timestamp = timestamp;
+    events.push_back(std::move(e));
+}
+
+/**
+ * @brief Aplica la máquina de estados de una regla en una serie.
+ */
+void AlertEngine::transition(const SeriesState& series, RuleState& state, bool conditionMet, double value,
+                             long long timestamp) {
+    // NaN no cumple ninguna comparación: sin este corte resolvería la alerta, y
+    // `alert_events.value` es NOT NULL (SQLite guarda NaN como NULL).
+    if (!std::isfinite(value)) return;
+    if (!conditionMet) {
+        state.pending = false;
+        if (state.firing) {
+            state.firing = false;
+            emit(series, state, false, value, timestamp);
+        }
+        return;
+    }
+    if (state.firing) return;
+
+    if (!state.pending) {
+        state.pending = true;
+        state.pendingSince = timestamp;
+    }
+    if (timestamp - state.pendingSince >= table[state.position].forSeconds) {
+        state.pending = false;
+        state.firing = true;
+        emit(series, state, true, value, timestamp);
+    }
+}
+
+void AlertEngine::observe(const Metric& m) {
+    if (metricIndex.empty()) return;
+
+    buildMetricKey(keyBuffer, m.component, m.metric);
+    auto range = metricIndex.find(keyBuffer);
+    if (range == metricIndex.end()) return;
+
+    appendSeriesLabels(keyBuffer, m.labels);
+    auto it = seriesStates.find(keyBuffer);
+    SeriesState& series = it != seriesStates.end() ? it->second : trackSeries(keyBuffer, range->second, m.labels, m.timestamp);
+    series.lastSample = m.timestamp;
+    if (m.timestamp > newestSample) newestSample = m.timestamp;
+
+    for (RuleState& state : series.rules) {
+        const CompiledRule& rule = table[state.position];
+        switch (rule.type) {
+        case AlertRuleType::Threshold:
+            transition(series, state, compare(rule.comparison, m.value, rule.threshold), m.value, m.timestamp);
+            break;
+
+        case AlertRuleType::RateOfChange:
+            if (!std::isfinite(m.value)) break;  // No se usa como lectura anterior.
+            if (state.hasPrevious && m.timestamp > state.previousTimestamp) {
+                double rate = (m.value - state.previousValue) / static_cast<double>(m.timestamp - state.previousTimestamp);
+                transition(series, state, compare(rule.comparison, rate, rule.threshold), rate, m.timestamp);
+            }
+            state.hasPrevious = true;
+            state.previousValue = m.value;
+            state.previousTimestamp = m.timestamp;
+            break;
+
+        case AlertRuleType::Absence:
+            state.lastSeen = m.timestamp;
+            if (state.firing) {
+                state.firing = false;
+                emit(series, state, false, 0.0, m.timestamp);
+            }
+            break;
+        }
+    }
+}
+
+void AlertEngine::tick(long long now) {
+    for (const auto& entry : absenceStates) {
+        RuleState& state = entry.first->rules[entry.second];
+        long long silent = now - state.lastSeen;
+        if (!state.firing && silent >= table[state.position].absentSeconds) {
+            state.firing = true;
+            emit(*entry.first, state, true, static_cast<double>(silent), now);
+        }
+    }
+    if (++tickPass % kSweepEvery == 0) prune();
+}
+
+/**
+ * @details Las series con reglas de ausencia no se tocan: absenceStates guarda
+ * punteros a ellas, y borrar otros nodos del mapa no mueve a los que quedan.
+ */
+void AlertEngine::prune() {
+    for (auto it = seriesStates.begin(); it != seriesStates.end();) {
+        const SeriesState& series = it->second;
+        bool keep = series.lastSample >= newestSample - kStaleSeconds;
+        for (const RuleState& state : series.rules) {
+            keep = keep || state.firing || table[state.position].type == AlertRuleType::Absence;
+        }
+        if (keep) {
+            ++it;
+        } else {
+            it = seriesStates.erase(it);
+        }
+    }
+}
+
+void AlertEngine::takeEvents(std::vector<AlertEvent>& out) {
+    for (AlertEvent& e : events) {
+        out.push_back(std::move(e));
+    }
+    events.clear();
+}
+
+WebhookAlertSink::WebhookAlertSink(const std::string& host, unsigned short port, const std::string& p)
+    : client(std::make_unique<HttpClient>(host, port, 500)), path(p) {}
+
+WebhookAlertSink::~WebhookAlertSink() = default;
+
+/**
+ * @brief Envía el evento como un objeto JSON.
+ * @details Cualquier código 2xx se considera aceptado. Un valor NaN o
+ * infinito va como `null`.
+ */
+bool WebhookAlertSink::send(const AlertEvent& e) {
+    char number[64];
+    body.clear();
+    body += "{\"rule\":";
+    appendJsonString(body, e.rule);
+    body += ",\"component\":";
+    appendJsonString(body, e.component);
+    body += ",\"metric\":";
+    appendJsonString(body, e.metric);
+    body += ",\"labels\":{";
+    for (std::size_t i = 0; i < e.labels.size(); ++i) {
+        if (i > 0) body.push_back(',');
+        appendJsonString(body, e.labels[i].first);
+        body.push_back(':');
+        appendJsonString(body, e.labels[i].second);
+    }
+    body.push_back('}');
+    body += e.firing ? ",\"state\":\"firing\"" : ",\"state\":\"resolved\"";
+    // JSON no tiene NaN ni infinito: un valor así se envía como null.
+    if (std::isfinite(e.value)) {
+        std::snprintf(number, sizeof(number), ",\"value\":%.17g", e.value);
+        body += number;
+    } else {
+        body += ",\"value\":null";
+    }
+    std::snprintf(number, sizeof(number), ",\"timestamp\":%lld}", e.timestamp);
+    body += number;
+
+    int status = client->post(path, "application/json", body.data(), body.size());
+    return status >= 200 && status < 300;
+}
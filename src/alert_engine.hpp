@@ -0,0 +1,250 @@
+/**
+ * @file alert_engine.hpp
+ * @brief Motor de alertas evaluado en línea sobre el flujo de muestras.
+ * @details
+ * Las reglas se leen y se COMPILAN una sola vez al iniciar: se ordenan por serie
+ * en una tabla plana y se construye un índice serie -> rango de reglas. Después,
+ * cada muestra que sale de los colectores solo cuesta una búsqueda en el índice
+ * y la evaluación de sus reglas, sin consultar SQLite.
+ *
+ * Una regla nombra component/metric y, opcionalmente, condiciones sobre las
+ * etiquetas (`CPU/Usage{cpu=*}`). Se evalúa por separado en cada serie que la
+ * cumple: cada núcleo o disco tiene su propio estado y sus propios eventos.
+ *
+ * Tipos de regla:
+ *  - Umbral: el valor cruza un límite (opcionalmente durante N segundos seguidos).
+ *  - Tasa de cambio: la variación por segundo entre dos muestras cruza un límite.
+ *  - Ausencia: la serie no reporta durante N segundos. Cuenta desde la última
+ *    muestra de cada serie ya vista; si las condiciones son todas de igualdad,
+ *    la serie que nombran se vigila desde el inicio aunque nunca haya reportado.
+ * @author Sergio Gonzalez
+ * @date 2026-02-14
+ */
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "labels.hpp"
+#include "metric.hpp"
+
+class HttpClient;
+
+/**
+ * @enum AlertRuleType
+ * @brief Qué evalúa una regla.
+ */
+enum class AlertRuleType {
+    Threshold,    ///< Compara el valor de la muestra.
+    RateOfChange, ///< Compara (v - v_anterior) / (t - t_anterior).
+    Absence       ///< Dispara si la serie no reporta durante absentSeconds.
+};
+
+/**
+ * @enum AlertComparison
+ * @brief Operador de comparación de las reglas de umbral y de tasa.
+ */
+enum class AlertComparison { Greater, GreaterEqual, Less, LessEqual };
+
+/**
+ * @struct AlertRule
+ * @brief Regla tal como se escribe en el archivo de reglas.
+ */
+struct AlertRule {
+    std::string name;         ///< Nombre de la alerta (aparece en los eventos).
+    std::string component;    ///< Componente de la serie observada.
+    std::string metric;       ///< Métrica de la serie observada.
+    std::vector<LabelMatcher> matchers; ///< Condiciones sobre las etiquetas; vacío = todas las series.
+    AlertRuleType type = AlertRuleType::Threshold;
+    AlertComparison comparison = AlertComparison::Greater;
+    double threshold = 0.0;   ///< Límite para umbral o tasa.
+    int forSeconds = 0;       ///< Segundos que la condición debe mantenerse antes de disparar.
+    int absentSeconds = 0;    ///< Segundos sin muestras para las reglas de ausencia.
+};
+
+/**
+ * @struct AlertEvent
+ * @brief Cambio de estado de una alerta (disparada o resuelta).
+ */
+struct AlertEvent {
+    std::string rule;        ///< Nombre de la regla.
+    std::string component;   ///< Serie observada.
+    std::string metric;
+    Labels labels;           ///< Etiquetas de la serie.
+    bool firing = false;     ///< true = disparada, false = resuelta.
+    double value = 0.0;      ///< Valor que provocó el cambio (muestra, tasa o segundos de ausencia).
+    long long timestamp = 0; ///< Momento del cambio.
+};
+
+/**
+ * @class AlertSink
+ * @brief Destino de los eventos de alerta (además de la base de datos).
+ */
+class AlertSink {
+public:
+    virtual ~AlertSink() = default;
+
+    /**
+     * @brief Entrega un evento.
+     * @return true si el destino lo aceptó.
+     */
+    virtual bool send(const AlertEvent& event) = 0;
+};
+
+/**
+ * @class WebhookAlertSink
+ * @brief Envía cada evento como JSON por HTTP POST a un servicio local.
+ * @details Usa una conexión persistente con tiempo máximo corto. Se llama desde
+ * el hilo de AlertDispatcher, nunca desde el ciclo de muestreo.
+ */
+class WebhookAlertSink : public AlertSink {
+private:
+    std::unique_ptr<HttpClient> client;
+    std::string path;
+    std::string body; ///< Reutilizado entre eventos.
+
+public:
+    WebhookAlertSink(const std::string& host, unsigned short port, const std::string& path);
+    ~WebhookAlertSink() override;
+
+    bool send(const AlertEvent& event) override;
+};
+
+/**
+ * @struct AlertRuleFile
+ * @brief Contenido de un archivo de reglas: las reglas y el webhook opcional.
+ */
+struct AlertRuleFile {
+    std::vector<AlertRule> rules;
+    std::string webhookHost;          ///< Vacío si no se configuró webhook.
+    unsigned short webhookPort = 0;
+    std::string webhookPath = "/";
+};
+
+/**
+ * @brief Lee un archivo de reglas.
+ *
+ * @details Una regla por línea; las líneas vacías y las que empiezan con '#' se ignoran:
+ * @code
+ * cpu_alta     CPU/Usage > 90 for 30
+ * ram_se_llena RAM/Usage rate > 2
+ * cpu_muda     CPU/Usage absent 10
+ * webhook 127.0.0.1:9000/alerts
+ * @endcode
+ *
+ * @param path Ruta del archivo.
+ * @param out Resultado.
+ * @param error Descripción del primer error (con número de línea) si la lectura falla.
+ * @return true si todas las líneas son válidas.
+ */
+bool loadAlertRules(const std::string& path, AlertRuleFile& out, std::string& error);
+
+/**
+ * @class AlertEngine
+ * @brief Evalúa las reglas compiladas contra cada muestra.
+ *
+ * @details
+ * Con etiquetas comodín (`{pid=*}`) cada combinación de etiquetas que aparece
+ * tiene su estado. Para que un servicio que corre meses no guarde el de cada
+ * proceso que existió alguna vez, cada kSweepEvery llamadas a tick() se olvidan
+ * las series sin muestras en kStaleSeconds (medidos contra la muestra más
+ * nueva, como RateEngine). Se conservan las que tienen una alerta disparada,
+ * para que su resolución se siga informando, y las que tienen reglas de
+ * ausencia, que justamente vigilan que la serie deje de llegar.
+ */
+class AlertEngine {
+private:
+    /**
+     * @struct CompiledRule
+     * @brief Fila de la tabla plana: parámetros de la regla.
+     */
+    struct CompiledRule {
+        AlertRuleType type;
+        AlertComparison comparison;
+        double threshold;
+        long long forSeconds;
+        long long absentSeconds;
+        std::uint32_t ruleIndex;   ///< Posición en `rules` (para nombre y serie).
+    };
+
+    /**
+     * @struct RuleState
+     * @brief Estado de una regla en una serie concreta.
+     */
+    struct RuleState {
+        std::uint32_t position;    ///< Posición de la regla en table.
+        bool firing;               ///< La alerta está disparada.
+        bool pending;              ///< La condición se cumple pero aún no pasó forSeconds.
+        long long pendingSince;    ///< Desde cuándo se cumple la condición.
+        bool hasPrevious;          ///< Hay una muestra previa (para la tasa).
+        double previousValue;
+        long long previousTimestamp;
+        long long lastSeen;        ///< Último timestamp con muestra (para ausencia).
+    };
+
+    /**
+     * @struct SeriesState
+     * @brief Reglas que aplican a una serie (component/metric/etiquetas) y su estado.
+     * @details Se crea con la primera muestra de la serie; los estados de sus
+     * reglas quedan contiguos.
+     */
+    struct SeriesState {
+        Labels labels;
+        std::vector<RuleState> rules;
+        long long lastSample = 0;  ///< Timestamp de la última muestra (para olvidar la serie).
+    };
+
+    std::vector<AlertRule> rules;                  ///< Reglas originales.
+    std::vector<CompiledRule> table;               ///< Tabla plana ordenada por component/metric.
+    std::unordered_map<std::string, std::pair<std::uint32_t, std::uint32_t>> metricIndex; ///< component/metric -> [inicio, fin) en table.
+    std::unordered_map<std::string, SeriesState> seriesStates; ///< Serie con etiquetas -> estado de sus reglas.
+    std::vector<std::pair<SeriesState*, std::uint32_t>> absenceStates; ///< Estados de las reglas de ausencia (los nodos del mapa no se mueven).
+    std::vector<AlertEvent> events;                ///< Eventos pendientes de entregar.
+    std::string keyBuffer;                         ///< Reutilizado para no reservar memoria por muestra.
+    std::uint64_t tickPass = 0;                    ///< Llamadas a tick(), para espaciar las barridas.
+    long long newestSample = 0;                    ///< Timestamp más nuevo observado, referencia de kStaleSeconds.
+
+    SeriesState& trackSeries(const std::string& key, const std::pair<std::uint32_t, std::uint32_t>& range,
+                             const Labels& labels, long long now);
+    void transition(const SeriesState& series, RuleState& state, bool conditionMet, double value, long long timestamp);
+    void emit(const SeriesState& series, const RuleState& state, bool firing, double value, long long timestamp);
+    void prune();
+
+public:
+    /// Cada cuántas llamadas a tick() se buscan series desaparecidas.
+    static constexpr std::uint64_t kSweepEvery = 256;
+    /// Una serie sin muestras en este tiempo se olvida; debe superar el mayor interval_ms y el mayor `for`.
+    static constexpr long long kStaleSeconds = 3600;
+
+    /**
+     * @brief Compila las reglas en la tabla de evaluación.
+     * @param rules Reglas a compilar (reemplazan a las anteriores).
+     * @param now Timestamp actual; las reglas de ausencia cuentan desde aquí.
+     */
+    void compile(const std::vector<AlertRule>& rules, long long now);
+
+    /**
+     * @brief Evalúa una muestra contra las reglas de su serie.
+     * @details Un valor NaN o infinito no dispara ni resuelve nada; para las
+     * reglas de ausencia cuenta igual como muestra recibida.
+     */
+    void observe(const Metric& metric);
+
+    /**
+     * @brief Evalúa las reglas de ausencia y, cada kSweepEvery llamadas, olvida
+     * las series desaparecidas. Se llama una vez por ciclo.
+     * @param now Timestamp actual.
+     */
+    void tick(long long now);
+
+    /**
+     * @brief Mueve los eventos generados a @p out.
+     */
+    void takeEvents(std::vector<AlertEvent>& out);
+
+    std::size_t ruleCount() const { return table.size(); }
+
+    /** @brief Series con estado (una por combinación de etiquetas vista). */
+    std::size_t trackedSeries() const { return seriesStates.size(); }
+};
@@ -0,0 +1,95 @@
+/**
+ * @file arrow_export.cpp
+ * @brief Implementación de la exportación a Arrow IPC.
+ * @author Sergio Gonzalez
+ * @date 2026-03-14
+ */
+
+#include "arrow_export.hpp"
+#include "arrow_ipc.hpp"
+
+bool exportMetricsArrow(DatabaseManager& db, const std::string& path, const ExportOptions& options, ExportStats& stats) {
+    stats = ExportStats();
+    ArrowIpcWriter writer;
+    if (!writer.open(path, {{"timestamp", ArrowColumnType::Timestamp},
+                            {"component", ArrowColumnType::DictionaryUtf8},
+                            {"metric", ArrowColumnType::DictionaryUtf8},
+                            {"unit", ArrowColumnType::DictionaryUtf8},
+                            {"labels", ArrowColumnType::DictionaryUtf8},
+                            {"value", ArrowColumnType::Float64}})) {
+        return false;
+    }
+
+    bool writeOk = true;
+    std::string labels;  // Reutilizado entre filas.
+    bool scanOk = db.scanMetrics(options.from, options.to, [&](const Metric& m) {
+        labels.clear();
+        appendLabels(labels, m.labels);
+        writer.appendInt64(0, m.timestamp);
+        writer.appendString(1, m.component);
+        writer.appendString(2, m.metric);
+        writer.appendString(3, m.unit);
+        writer.appendString(4, labels);
+        writer.appendDouble(5, m.value);
+        ++stats.rows;
+        if (writer.rows() >= options.batchRows) {
+            writeOk = writer.writeBatch();
+        }
+        return writeOk;
+    }, options.series);
+
+    bool closeOk = writer.close();
+    stats.batches = writer.batches();
+    stats.bytes = writer.bytes();
+    return scanOk && writeOk && closeOk;
+}
+
+bool exportRollupsArrow(DatabaseManager& db, const std::string& path, const ExportOptions& options, ExportStats& stats) {
+    stats = ExportStats();
+    ArrowIpcWriter writer;
+    if (!writer.open(path, {{"bucket_start", ArrowColumnType::Timestamp},
+                            {"bucket_seconds", ArrowColumnType::Int64},
+                            {"component", ArrowColumnType::DictionaryUtf8},
+                            {"metric", ArrowColumnType::DictionaryUtf8},
+                            {"unit", ArrowColumnType::DictionaryUtf8},
+                            {"labels", ArrowColumnType::DictionaryUtf8},
+                            {"count", ArrowColumnType::Int64},
+                            {"sum", ArrowColumnType::Float64},
+                            {"min", ArrowColumnType::Float64},
+                            {"max", ArrowColumnType::Float64},
+                            {"p50", ArrowColumnType::Float64},
+                            {"p95", ArrowColumnType::Float64},
+                            {"p99", ArrowColumnType::Float64}})) {
+        return false;
+    }
+
+    bool writeOk = true;
+    std::string labels;
+    bool scanOk = db.scanRollups(options.from, options.to, [&](const RollupRow& row) {
+        labels.clear();
+        appendLabels(labels, row.labels);
+        writer.appendInt64(0, row.bucketStart);
+        writer.appendInt64(1, row.bucketSeconds);
+        writer.appendString(2, row.component);
+        writer.appendString(3, row.metric);
+        writer.appendString(4, row.unit);
+        writer.appendString(5, labels);
+        writer.appendInt64(6, static_cast<std::int64_t>(row.count));
+        writer.appendDouble(7, row.sum);
+        writer.appendDouble(8, row.min);
+        writer.appendDouble(9, row.max);
+        writer.appendDouble(10, row.sketch.quantile(0.50));
+        writer.appendDouble(11, row.sketch.quantile(0.95));
+        writer.appendDouble(12, row.sketch.quantile(0.99));
+        ++stats.rows;
+        if (writer.rows() >= options.batchRows) {
+            writeOk = writer.writeBatch();
+        }
+        return writeOk;
+    }, options.series);
+
+    bool closeOk = writer.close();
+    stats.batches = writer.batches();
+    stats.bytes = writer.bytes();
+    return scanOk && writeOk && closeOk;
+}
@@ -0,0 +1,63 @@
+/**
+ * @file arrow_export.hpp
+ * @brief Exportación de un rango de la base a archivos Arrow IPC.
+ * @details
+ * Reemplaza el `SELECT *` desde pandas: las filas se leen de SQLite en orden de
+ * tiempo y se escriben en lotes columnares de tamaño fijo, así que la memoria
+ * usada no depende del rango exportado.
+ *
+ * Esquema de `metrics`:
+ *     timestamp (timestamp[s, UTC]), component, metric, unit, labels (diccionario), value (double)
+ *
+ * Esquema de `metric_rollups`:
+ *     bucket_start (timestamp[s, UTC]), bucket_seconds (int64), component, metric, unit, labels (diccionario),
+ *     count (int64), sum, min, max, p50, p95, p99 (double)
+ *
+ * `labels` es el texto canónico de las etiquetas (`cpu=3,host=web01`, ver
+ * formatLabels); vacío en las series sin etiquetas.
+ *
+ * Los percentiles de los rollups se calculan desde el DDSketch de cada cubeta.
+ * @author Sergio Gonzalez
+ * @date 2026-03-14
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+#include "db_manager.hpp"
+
+/**
+ * @struct ExportOptions
+ * @brief Rango y tamaño de lote de una exportación.
+ */
+struct ExportOptions {
+    long long from = std::numeric_limits<long long>::min(); ///< Timestamp inicial (inclusive).
+    long long to = std::numeric_limits<long long>::max();   ///< Timestamp final (inclusive).
+    std::size_t batchRows = 65536;                          ///< Filas por lote Arrow.
+    std::vector<long long> series;                          ///< Ids de serie a exportar (ver DatabaseManager::selectSeries); vacío = todas.
+};
+
+/**
+ * @struct ExportStats
+ * @brief Resultado de una exportación.
+ */
+struct ExportStats {
+    std::uint64_t rows = 0;
+    std::uint64_t batches = 0;
+    std::uint64_t bytes = 0;
+};
+
+/**
+ * @brief Exporta la tabla `metrics` en [from, to] a un flujo Arrow IPC.
+ * @param db Base conectada.
+ * @param path Archivo de salida (se sobrescribe).
+ * @return false si falló la consulta o la escritura.
+ */
+bool exportMetricsArrow(DatabaseManager& db, const std::string& path, const ExportOptions& options, ExportStats& stats);
+
+/**
+ * @brief Exporta la tabla `metric_rollups` (cubetas con inicio en [from, to]) a un flujo Arrow IPC.
+ */
+bool exportRollupsArrow(DatabaseManager& db, const std::string& path, const ExportOptions& options, ExportStats& stats);
@@ -0,0 +1,428 @@
+/**
+ * @file arrow_ipc.cpp
+ * @brief Implementación de ArrowIpcWriter y de los metadatos FlatBuffers de Arrow.
+ *
+ * @details
+ * Estructura del flujo (formato "streaming" de Arrow IPC):
+ *
+ *     Schema | Diccionarios iniciales | RecordBatch | [Delta de diccionario] RecordBatch ... | Fin
+ *
+ * Cada mensaje es: 0xFFFFFFFF, largo de los metadatos (int32), metadatos
+ * FlatBuffers (tabla Message de Message.fbs) rellenados a 8 bytes y el cuerpo
+ * con los buffers de las columnas, cada uno alineado a 8 bytes. El fin de flujo
+ * es 0xFFFFFFFF seguido de un largo 0.
+ *
+ * FlatBuffers se construye "de atrás hacia adelante": los objetos hijos se
+ * escriben antes que sus padres y los desplazamientos apuntan siempre hacia el
+ * final del buffer. FlatBuilder implementa solo lo necesario para Schema.fbs y
+ * Message.fbs; los números de campo y de tipo corresponden a esos archivos.
+ *
+ * Se asume una CPU little-endian (x86/x64 y ARM en Windows).
+ *
+ * @author Sergio Gonzalez
+ * @date 2026-03-14
+ */
+
+#include "arrow_ipc.hpp"
+#include <cstring>
+#include <utility>
+
+namespace {
+
+// --- Constantes de Schema.fbs / Message.fbs ---
+constexpr std::int16_t kMetadataV5 = 4;
+constexpr std::uint8_t kHeaderSchema = 1;
+constexpr std::uint8_t kHeaderDictionaryBatch = 2;
+constexpr std::uint8_t kHeaderRecordBatch = 3;
+constexpr std::uint8_t kTypeInt = 2;
+constexpr std::uint8_t kTypeFloatingPoint = 3;
+constexpr std::uint8_t kTypeUtf8 = 5;
+constexpr std::uint8_t kTypeTimestamp = 10;
+constexpr std::int16_t kPrecisionDouble = 2;
+constexpr std::int16_t kTimeUnitSecond = 0;
+
+/**
+ * @class FlatBuilder
+ * @brief Constructor mínimo de buffers FlatBuffers.
+ *
+ * @details Las posiciones se miden desde el FINAL del buffer (size() en el
+ * momento de escribir el objeto), igual que en la biblioteca oficial.
+ */
+class FlatBuilder {
+private:
+    std::string buf;
+    std::uint32_t tableStart = 0;
+    std::vector<std::pair<std::uint16_t, std::uint32_t>> fields;  ///< (campo, posición) de la tabla abierta.
+
+    void pad(std::size_t n) { buf.insert(0, n, '\0'); }
+
+    /// Rellena para que, tras escribir @p additional bytes, el tamaño quede alineado a @p align.
+    void prep(std::size_t align, std::size_t additional) {
+        pad((~(buf.size() + additional) + 1) & (align - 1));
+    }
+
+    template <typename T>
+    void push(T value) {
+        char bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        buf.insert(0, bytes, sizeof(T));
+    }
+
+    void pushOffset(std::uint32_t target) {
+        prep(4, 0);
+        push<std::uint32_t>(size() + 4 - target);
+    }
+
+public:
+    std::uint32_t size() const { return static_cast<std::uint32_t>(buf.size()); }
+
+    std::uint32_t string(const std::string& text) {
+        prep(4, text.size() + 1);
+        push<std::uint8_t>(0);
+        buf.insert(0, text);
+        push<std::uint32_t>(static_cast<std::uint32_t>(text.size()));
+        return size();
+    }
+
+    std::uint32_t offsetVector(const std::vector<std::uint32_t>& items) {
+        prep(4, 4 * items.size());
+        for (std::size_t i = items.size(); i-- > 0;) pushOffset(items[i]);
+        push<std::uint32_t>(static_cast<std::uint32_t>(items.size()));
+        return size();
+    }
+
+    /// Vector de structs de dos int64 (FieldNode y Buffer en Message.fbs).
+    std::uint32_t pairVector(const std::vector<std::pair<std::int64_t, std::int64_t>>& items) {
+        prep(4, 16 * items.size());
+        prep(8, 16 * items.size());
+        for (std::size_t i = items.size(); i-- > 0;) {
+            push(items[i].second);
+            push(items[i].first);
+        }
+        push<std::uint32_t>(static_cast<std::uint32_t>(items.size()));
+        return size();
+    }
+
+    void startTable() {
+        fields.clear();
+        tableStart = size();
+    }
+
+    template <typename T>
+    void addScalar(std::uint16_t field, T value) {
+        prep(sizeof(T), 0);
+        push(value);
+        fields.emplace_back(field, size());
+    }
+
+    void addOffset(std::uint16_t field, std::uint32_t target) {
+        pushOffset(target);
+        fields.emplace_back(field, size());
+    }
+
+    /**
+     * @brief Cierra la tabla: escribe el desplazamiento a su vtable y la vtable.
+     */
+    std::uint32_t endTable() {
+        prep(4, 0);
+        push<std::int32_t>(0);
+        std::uint32_t tableEnd = size();
+
+        std::uint16_t slots = 0;
+        for (const auto& f : fields) {
+            if (f.first + 1 > slots) slots = static_cast<std::uint16_t>(f.first + 1);
+        }
+        std::vector<std::uint16_t> vtable(slots, 0);
+        for (const auto& f : fields) {
+            vtable[f.first] = static_cast<std::uint16_t>(tableEnd - f.second);
+        }
+        for (std::size_t i = vtable.size(); i-- > 0;) push(vtable[i]);
+        push<std::uint16_t>(static_cast<std::uint16_t>(tableEnd - tableStart));
+        push<std::uint16_t>(static_cast<std::uint16_t>((2 + slots) * 2));
+
+        // La tabla guarda (posición de la tabla - posición de la vtable).
+        std::int32_t toVtable = static_cast<std::int32_t>(size() - tableEnd);
+        std::memcpy(&buf[buf.size() - tableEnd], &toVtable, sizeof(toVtable));
+        return tableEnd;
+    }
+
+    std::string finish(std::uint32_t root) {
+        prep(8, 4);
+        pushOffset(root);
+        return std::move(buf);
+    }
+};
+
+std::uint32_t intType(FlatBuilder& fb, std::int32_t bitWidth) {
+    fb.startTable();
+    fb.addScalar<std::int32_t>(0, bitWidth);  // bitWidth
+    fb.addScalar<std::uint8_t>(1, 1);         // is_signed
+    return fb.endTable();
+}
+
+std::uint32_t messageTable(FlatBuilder& fb, std::uint8_t headerType, std::uint32_t header, std::int64_t bodyLength) {
+    fb.startTable();
+    fb.addScalar<std::int64_t>(3, bodyLength);
+    fb.addOffset(2, header);
+    fb.addScalar<std::int16_t>(0, kMetadataV5);
+    fb.addScalar<std::uint8_t>(1, headerType);
+    return fb.endTable();
+}
+
+/**
+ * @brief Tabla RecordBatch: largo, nodos (uno por columna) y buffers (desplazamiento y largo en el cuerpo).
+ */
+std::uint32_t recordBatchTable(FlatBuilder& fb, std::int64_t length,
+                               const std::vector<std::pair<std::int64_t, std::int64_t>>& nodes,
+                               const std::vector<std::pair<std::int64_t, std::int64_t>>& buffers) {
+    std::uint32_t nodesVector = fb.pairVector(nodes);
+    std::uint32_t buffersVector = fb.pairVector(buffers);
+    fb.startTable();
+    fb.addScalar<std::int64_t>(0, length);
+    fb.addOffset(1, nodesVector);
+    fb.addOffset(2, buffersVector);
+    return fb.endTable();
+}
+
+/**
+ * @brief Agrega un buffer al cuerpo, alineado a 8 bytes, y registra su ubicación.
+ */
+void appendBuffer(std::string& body, std::vector<std::pair<std::int64_t, std::int64_t>>& buffers,
+                  const void* data, std::size_t size) {
+    buffers.emplace_back(static_cast<std::int64_t>(body.size()), static_cast<std::int64_t>(size));
+    body.append(static_cast<const char*>(data), size);
+    body.append((8 - body.size() % 8) % 8, '\0');
+}
+
+} // namespace
+
+ArrowIpcWriter::ArrowIpcWriter() : file(nullptr), dictionariesStarted(false), bytesWritten(0), batchesWritten(0) {}
+
+ArrowIpcWriter::~ArrowIpcWriter() {
+    close();
+}
+
+bool ArrowIpcWriter::writeMessage(const std::string& metadata, const std::string& bodyBytes) {
+    // metadata ya tiene un largo múltiplo de 8 (FlatBuilder::finish), así que
+    // el cuerpo queda alineado a 8 bytes en el archivo.
+    std::uint32_t continuation = 0xFFFFFFFFu;
+    std::int32_t length = static_cast<std::int32_t>(metadata.size());
+    bool ok = std::fwrite(&continuation, 4, 1, file) == 1 && std::fwrite(&length, 4, 1, file) == 1 &&
+              std::fwrite(metadata.data(), 1, metadata.size(), file) == metadata.size() &&
+              std::fwrite(bodyBytes.data(), 1, bodyBytes.size(), file) == bodyBytes.size();
+    if (ok) bytesWritten += 8 + metadata.size() + bodyBytes.size();
+    return ok;
+}
+
+bool ArrowIpcWriter::open(const std::string& path, const std::vector<ArrowField>& fields) {
+    close();
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+
+    columns.clear();
+    dictionariesStarted = false;
+    bytesWritten = 0;
+    batchesWritten = 0;
+
+    std::int64_t nextDictionaryId = 0;
+    for (const ArrowField& f : fields) {
+        Column c;
+        c.field = f;
+        if (f.type == ArrowColumnType::DictionaryUtf8) c.dictionaryId = nextDictionaryId++;
+        columns.push_back(std::move(c));
+    }
+
+    // Esquema: una tabla Field por columna.
+    FlatBuilder fb;
+    std::vector<std::uint32_t> fieldTables;
+    for (const Column& c : columns) {
+        std::uint32_t name = fb.string(c.field.name);
+        std::uint32_t children = fb.offsetVector({});
+
+        std::uint8_t typeType = kTypeInt;
+        std::uint32_t type = 0;
+        std::uint32_t dictionary = 0;
+        switch (c.field.type) {
+        case ArrowColumnType::Int64:
+            type = intType(fb, 64);
+            break;
+        case ArrowColumnType::Timestamp: {
+            std::uint32_t timezone = fb.string("UTC");
+            fb.startTable();
+            fb.addOffset(1, timezone);
+            fb.addScalar<std::int16_t>(0, kTimeUnitSecond);
+            type = fb.endTable();
+            typeType = kTypeTimestamp;
+            break;
+        }
+        case ArrowColumnType::Float64:
+            fb.startTable();
+            fb.addScalar<std::int16_t>(0, kPrecisionDouble);
+            type = fb.endTable();
+            typeType = kTypeFloatingPoint;
+            break;
+        case ArrowColumnType::DictionaryUtf8: {
+            fb.startTable();
+            type = fb.endTable();
+            typeType = kTypeUtf8;
+            std::uint32_t indexType = intType(fb, 32);
+            fb.startTable();
+            fb.addScalar<std::int64_t>(0, c.dictionaryId);
+            fb.addOffset(1, indexType);
+            dictionary = fb.endTable();
+            break;
+        }
+        }
+
+        fb.startTable();
+        fb.addOffset(0, name);
+        fb.addOffset(3, type);
+        if (dictionary) fb.addOffset(4, dictionary);
+        fb.addOffset(5, children);
+        fb.addScalar<std::uint8_t>(1, 0);  // nullable = false
+        fb.addScalar<std::uint8_t>(2, typeType);
+        fieldTables.push_back(fb.endTable());
+    }
+    std::uint32_t fieldsVector = fb.offsetVector(fieldTables);
+    fb.startTable();
+    fb.addOffset(1, fieldsVector);
+    fb.addScalar<std::int16_t>(0, 0);  // endianness = Little
+    std::uint32_t schema = fb.endTable();
+
+    if (!writeMessage(fb.finish(messageTable(fb, kHeaderSchema, schema, 0)), std::string())) {
+        std::fclose(file);
+        file = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void ArrowIpcWriter::appendString(std::size_t column, const std::string& value) {
+    Column& c = columns[column];
+    auto it = c.dictionary.find(value);
+    if (it == c.dictionary.end()) {
+        std::int32_t index = static_cast<std::int32_t>(c.dictionaryValues.size());
+        it = c.dictionary.emplace(value, index).first;
+        c.dictionaryValues.push_back(value);
+    }
+    c.indices.push_back(it->second);
+}
+
+std::size_t ArrowIpcWriter::rows() const {
+    if (columns.empty()) return 0;
+    const Column& c = columns[0];
+    switch (c.field.type) {
+    case ArrowColumnType::Int64:
+    case ArrowColumnType::Timestamp: return c.ints.size();
+    case ArrowColumnType::Float64: return c.doubles.size();
+    case ArrowColumnType::DictionaryUtf8: return c.indices.size();
+    }
+    return 0;
+}
+
+/**
+ * @brief Envía los textos de diccionario que el lector todavía no conoce.
+ *
+ * @details La primera vez se envía un diccionario completo por columna (Arrow lo
+ * exige antes del primer lote); después, solo deltas con los textos nuevos.
+ */
+bool ArrowIpcWriter::writeDictionaries() {
+    std::vector<std::int32_t> offsets;
+    for (Column& c : columns) {
+        if (c.dictionaryId < 0) continue;
+        if (dictionariesStarted && c.dictionaryWritten == c.dictionaryValues.size()) continue;
+
+        body.clear();
+        offsets.assign(1, 0);
+        std::string data;
+        for (std::size_t i = c.dictionaryWritten; i < c.dictionaryValues.size(); ++i) {
+            data += c.dictionaryValues[i];
+            offsets.push_back(static_cast<std::int32_t>(data.size()));
+        }
+        std::int64_t length = static_cast<std::int64_t>(offsets.size() - 1);
+
+        std::vector<std::pair<std::int64_t, std::int64_t>> buffers;
+        appendBuffer(body, buffers, nullptr, 0);  // validez: sin nulos
+        appendBuffer(body, buffers, offsets.data(), offsets.size() * sizeof(std::int32_t));
+        appendBuffer(body, buffers, data.data(), data.size());
+
+        FlatBuilder fb;
+        std::uint32_t batch = recordBatchTable(fb, length, {{length, 0}}, buffers);
+        fb.startTable();
+        fb.addScalar<std::int64_t>(0, c.dictionaryId);
+        fb.addOffset(1, batch);
+        fb.addScalar<std::uint8_t>(2, dictionariesStarted ? 1 : 0);  // isDelta
+        std::uint32_t dictionaryBatch = fb.endTable();
+
+        if (!writeMessage(fb.finish(messageTable(fb, kHeaderDictionaryBatch, dictionaryBatch,
+                                                 static_cast<std::int64_t>(body.size()))), body)) {
+            return false;
+        }
+        c.dictionaryWritten = c.dictionaryValues.size();
+    }
+    dictionariesStarted = true;
+    return true;
+}
+
+bool ArrowIpcWriter::writeBatch() {
+    if (!file) return false;
+    std::size_t length = rows();
+    if (length == 0) return true;
+
+    if (!writeDictionaries()) return false;
+
+    body.clear();
+    std::vector<std::pair<std::int64_t, std::int64_t>> nodes;
+    std::vector<std::pair<std::int64_t, std::int64_t>> buffers;
+    for (const Column& c : columns) {
+        std::size_t count = 0;
+        const void* data = nullptr;
+        std::size_t width = 0;
+        switch (c.field.type) {
+        case ArrowColumnType::Int64:
+        case ArrowColumnType::Timestamp:
+            count = c.ints.size(); data = c.ints.data(); width = sizeof(std::int64_t);
+            break;
+        case ArrowColumnType::Float64:
+            count = c.doubles.size(); data = c.doubles.data(); width = sizeof(double);
+            break;
+        case ArrowColumnType::DictionaryUtf8:
+            count = c.indices.size(); data = c.indices.data(); width = sizeof(std::int32_t);
+            break;
+        }
+        if (count != length) return false;
+
+        nodes.emplace_back(static_cast<std::int64_t>(length), 0);
+        appendBuffer(body, buffers, nullptr, 0);  // validez: sin nulos
+        appendBuffer(body, buffers, data, count * width);
+    }
+
+    FlatBuilder fb;
+    std::uint32_t batch = recordBatchTable(fb, static_cast<std::int64_t>(length), nodes, buffers);
+    if (!writeMessage(fb.finish(messageTable(fb, kHeaderRecordBatch, batch, static_cast<std::int64_t>(body.size()))), body)) {
+        return false;
+    }
+
+    for (Column& c : columns) {
+        c.ints.clear();
+        c.doubles.clear();
+        c.indices.clear();
+    }
+    ++batchesWritten;
+    return true;
+}
+
+bool ArrowIpcWriter::close() {
+    if (!file) return false;
+
+    bool ok = writeBatch();
+    // Un flujo sin lotes igual debe declarar sus diccionarios.
+    if (ok && !dictionariesStarted) ok = writeDictionaries();
+
+    std::uint32_t endOfStream[2] = {0xFFFFFFFFu, 0};
+    ok = ok && std::fwrite(endOfStream, sizeof(endOfStream), 1, file) == 1;
+    if (ok) bytesWritten += sizeof(endOfStream);
+    ok = std::fclose(file) == 0 && ok;
+    file = nullptr;
+    return ok;
+}
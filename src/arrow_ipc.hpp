@@ -0,0 +1,132 @@
+/**
+ * @file arrow_ipc.hpp
+ * @brief Escritor mínimo del formato Apache Arrow IPC (streaming) sin dependencias.
+ * @details
+ * Produce un archivo `.arrows` que pyarrow, pandas, polars o DuckDB leen
+ * directamente (por ejemplo `pyarrow.ipc.open_stream(ruta).read_pandas()`), y que
+ * se puede convertir a Parquet con cualquiera de ellos.
+ *
+ * Solo implementa lo que necesita la exportación de SysPulse:
+ *  - Columnas Int64, Timestamp (segundos, UTC), Float64 y texto con diccionario.
+ *  - Sin valores nulos.
+ *  - Lotes (record batches) de tamaño acotado: la memoria usada depende del
+ *    tamaño del lote, no del total exportado.
+ *
+ * Las columnas de texto se codifican con diccionario: cada lote solo lleva un
+ * índice int32 por fila y los textos nuevos se envían una sola vez como
+ * "delta" de diccionario antes del lote que los usa.
+ *
+ * Los metadatos de Arrow son FlatBuffers; se construyen a mano (ver arrow_ipc.cpp)
+ * para no agregar la biblioteca de Arrow al proyecto.
+ * @author Sergio Gonzalez
+ * @date 2026-03-14
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @enum ArrowColumnType
+ * @brief Tipos de columna soportados.
+ */
+enum class ArrowColumnType {
+    Int64,
+    Timestamp,      ///< Segundos Unix, zona horaria UTC.
+    Float64,
+    DictionaryUtf8  ///< Texto con diccionario (índices int32).
+};
+
+/**
+ * @struct ArrowField
+ * @brief Definición de una columna del esquema.
+ */
+struct ArrowField {
+    std::string name;
+    ArrowColumnType type;
+};
+
+/**
+ * @class ArrowIpcWriter
+ * @brief Escribe un flujo Arrow IPC lote por lote.
+ *
+ * @details Uso:
+ * @code
+ * ArrowIpcWriter w;
+ * w.open("salida.arrows", {{"timestamp", ArrowColumnType::Timestamp}, {"value", ArrowColumnType::Float64}});
+ * w.appendInt64(0, ts); w.appendDouble(1, v);   // una fila
+ * if (w.rows() == 65536) w.writeBatch();
+ * ...
+ * w.close();
+ * @endcode
+ */
+class ArrowIpcWriter {
+private:
+    /**
+     * @struct Column
+     * @brief Datos pendientes de una columna y, si corresponde, su diccionario.
+     */
+    struct Column {
+        ArrowField field;
+        std::int64_t dictionaryId = -1;
+        std::vector<std::int64_t> ints;
+        std::vector<double> doubles;
+        std::vector<std::int32_t> indices;
+        std::unordered_map<std::string, std::int32_t> dictionary;
+        std::vector<std::string> dictionaryValues;  ///< En orden de índice.
+        std::size_t dictionaryWritten = 0;          ///< Valores ya enviados en el flujo.
+    };
+
+    std::FILE* file;
+    std::vector<Column> columns;
+    bool dictionariesStarted;  ///< Ya se escribieron los diccionarios iniciales.
+    std::uint64_t bytesWritten;
+    std::uint64_t batchesWritten;
+
+    std::string body;          ///< Cuerpo del mensaje en construcción (reutilizado).
+
+    bool writeMessage(const std::string& metadata, const std::string& bodyBytes);
+    bool writeDictionaries();
+
+public:
+    ArrowIpcWriter();
+    ~ArrowIpcWriter();
+
+    ArrowIpcWriter(const ArrowIpcWriter&) = delete;
+    ArrowIpcWriter& operator=(const ArrowIpcWriter&) = delete;
+
+    /**
+     * @brief Crea el archivo y escribe el esquema.
+     * @return false si no se pudo crear el archivo.
+     */
+    bool open(const std::string& path, const std::vector<ArrowField>& fields);
+
+    /** @brief Agrega un valor a una columna Int64 o Timestamp. */
+    void appendInt64(std::size_t column, std::int64_t value) { columns[column].ints.push_back(value); }
+
+    /** @brief Agrega un valor a una columna Float64. */
+    void appendDouble(std::size_t column, double value) { columns[column].doubles.push_back(value); }
+
+    /** @brief Agrega un texto a una columna con diccionario. */
+    void appendString(std::size_t column, const std::string& value);
+
+    /** @brief Filas pendientes del lote en construcción (según la primera columna). */
+    std::size_t rows() const;
+
+    /**
+     * @brief Escribe el lote pendiente (precedido por los textos nuevos de los diccionarios).
+     * @return false si las columnas tienen largos distintos o falló la escritura.
+     */
+    bool writeBatch();
+
+    /**
+     * @brief Escribe el lote pendiente y la marca de fin de flujo, y cierra el archivo.
+     */
+    bool close();
+
+    std::uint64_t bytes() const { return bytesWritten; }
+    std::uint64_t batches() const { return batchesWritten; }
+};
@@ -0,0 +1,41 @@
+/**
+ * @file collector.hpp
+ * @brief Interfaz común de todos los productores de métricas.
+ * @details El bucle principal no conoce monitores concretos: recorre una lista de
+ * Collector y guarda lo que cada uno agregue al lote del ciclo.
+ * @author Sergio Gonzalez
+ * @date 2026-01-24
+ */
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "metric.hpp"
+
+/**
+ * @class Collector
+ * @brief Clase base abstracta para cualquier fuente de métricas.
+ *
+ * @details
+ * Un colector puede producir cero, una o muchas métricas por ciclo:
+ *  - RamMonitor produce una; CpuMonitor, sus dos contadores crudos.
+ *  - Los colectores sintéticos de carga producen miles.
+ *
+ * Las métricas se AGREGAN al vector recibido en lugar de devolver uno nuevo,
+ * así el bucle principal reutiliza el mismo buffer en cada ciclo.
+ */
+class Collector {
+public:
+    virtual ~Collector() = default;
+
+    /**
+     * @brief Nombre corto del colector (para mensajes de log).
+     */
+    virtual const char* name() const = 0;
+
+    /**
+     * @brief Toma una muestra y agrega las métricas válidas al lote.
+     * @param out Lote del ciclo actual; solo se le agregan elementos.
+     * @return Cantidad de métricas agregadas (0 si todavía no hay datos válidos).
+     */
+    virtual std::size_t collect(std::vector<Metric>& out) = 0;
+};
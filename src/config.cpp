@@ -0,0 +1,385 @@
+/**
+ * @file config.cpp
+ * @brief Implementación de la lectura del archivo de configuración y de ConfigWatcher.
+ * @author Sergio Gonzalez
+ * @date 2026-04-11
+ */
+
+#include "config.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include "synthetic_collector.hpp"
+
+namespace {
+
+std::string trim(const std::string& text) {
+    std::size_t begin = 0;
+    std::size_t end = text.size();
+    while (begin < end && std::isspace(static_cast<unsigned char>(text[begin]))) ++begin;
+    while (end > begin && std::isspace(static_cast<unsigned char>(text[end - 1]))) --end;
+    return text.substr(begin, end - begin);
+}
+
+/// Quita el comentario (';' o '#' al inicio o precedido de un espacio).
+std::string stripComment(const std::string& line) {
+    for (std::size_t i = 0; i < line.size(); ++i) {
+        if ((line[i] == ';' || line[i] == '#') &&
+            (i == 0 || std::isspace(static_cast<unsigned char>(line[i - 1])))) {
+            return line.substr(0, i);
+        }
+    }
+    return line;
+}
+
+bool parseInteger(const std::string& text, long long& out) {
+    char* end = nullptr;
+    out = std::strtoll(text.c_str(), &end, 10);
+    return end != text.c_str() && *end == '\0';
+}
+
+bool parseBool(const std::string& text, bool& out) {
+    if (text == "true" || text == "yes" || text == "on" || text == "1") out = true;
+    else if (text == "false" || text == "no" || text == "off" || text == "0") out = false;
+    else return false;
+    return true;
+}
+
+/// Coincidencia con '*' (cualquier secuencia, incluida la vacía), con vuelta atrás al último '*'.
+bool matchWildcard(const char* pattern, const char* text) {
+    const char* star = nullptr;
+    const char* resume = nullptr;
+    while (*text) {
+        if (*pattern == '*') {
+            star = pattern++;
+            resume = text;
+        } else if (*pattern == *text) {
+            ++pattern;
+            ++text;
+        } else if (star) {
+            pattern = star + 1;
+            text = ++resume;
+        } else {
+            return false;
+        }
+    }
+    while (*pattern == '*') ++pattern;
+    return *pattern == '\0';
+}
+
+/// Qué valores acepta una clave propia de un colector.
+enum class OptionValue { Text, Positive, Unsigned, Number, Distribution };
+
+/**
+ * @brief Indica si @p name es el name() en minúsculas de un colector que main() puede construir.
+ */
+bool knownCollector(const std::string& name) {
+    static const char* const kCollectors[] = {
+        "cpu", "ram", "perf", "sched", "vm", "fs", "sensors", "irq", "net", "synthetic", "replay", "pipeline",
+    };
+    for (const char* known : kCollectors) {
+        if (name == known) return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Claves propias de cada colector, fuera de las comunes (enabled, interval_ms, include, exclude).
+ * @return false si el colector no admite esa clave.
+ */
+bool collectorOption(const std::string& collector, const std::string& key, OptionValue& type) {
+    static const struct {
+        const char* collector;
+        const char* key;
+        OptionValue type;
+    } kOptions[] = {
+        {"sched", "pid", OptionValue::Positive},
+        {"vm", "counter", OptionValue::Text},
+        {"fs", "trend_half_life", OptionValue::Positive},
+        {"sensors", "temperature_counter", OptionValue::Text},
+        {"sensors", "frequency_counter", OptionValue::Text},
+        {"sensors", "power_counter", OptionValue::Text},
+        {"net", "stat", OptionValue::Text},
+        {"synthetic", "components", OptionValue::Positive},
+        {"synthetic", "distribution", OptionValue::Distribution},
+        {"synthetic", "min", OptionValue::Number},
+        {"synthetic", "max", OptionValue::Number},
+        {"synthetic", "seed", OptionValue::Unsigned},
+    };
+    for (const auto& option : kOptions) {
+        if (collector == option.collector && key == option.key) {
+            type = option.type;
+            return true;
+        }
+    }
+    return false;
+}
+
+/// El valor cumple el tipo de su clave (ver kOptions).
+bool validOption(OptionValue type, const std::string& value) {
+    long long number = 0;
+    char* end = nullptr;
+    ValueDistribution distribution;
+    switch (type) {
+    case OptionValue::Text:
+        return !value.empty();
+    case OptionValue::Positive:
+        return parseInteger(value, number) && number > 0;
+    case OptionValue::Unsigned:
+        return parseInteger(value, number) && number >= 0;
+    case OptionValue::Number:
+        std::strtod(value.c_str(), &end);
+        return !value.empty() && *end == '\0';
+    case OptionValue::Distribution:
+        return parseValueDistribution(value, distribution);
+    }
+    return false;
+}
+
+/// Colectores con una serie por CPU: solo se construyen si la configuración tiene su sección (ver main()).
+const char* const kOptInCollectors[] = {"perf", "sched", "sensors", "irq"};
+
+const std::vector<std::pair<std::string, std::string>>& optionsOf(const ServiceConfig& config, const std::string& name) {
+    static const std::vector<std::pair<std::string, std::string>> kNone;
+    const CollectorSettings* settings = config.collector(name);
+    return settings ? settings->options : kNone;
+}
+
+} // namespace
+
+std::vector<std::string> CollectorSettings::values(const std::string& key) const {
+    std::vector<std::string> result;
+    for (const auto& option : options) {
+        if (option.first == key) result.push_back(option.second);
+    }
+    return result;
+}
+
+const CollectorSettings* ServiceConfig::collector(const std::string& name) const {
+    for (const CollectorSettings& c : collectors) {
+        if (c.name == name) return &c;
+    }
+    return nullptr;
+}
+
+int ServiceConfig::intervalFor(const std::string& name) const {
+    const CollectorSettings* c = collector(name);
+    return c && c->intervalMs > 0 ? c->intervalMs : defaultIntervalMs;
+}
+
+/**
+ * @details
+ * Formato INI: secciones `[nombre]`, pares `clave = valor`, comentarios con ';'
+ * o '#'. Una clave o sección desconocida es un error (con número de línea), no
+ * se ignora: un error de tipeo en una recarga no debe pasar desapercibido.
+ */
+bool loadServiceConfig(const std::string& path, ServiceConfig& out, std::string& error) {
+    std::ifstream file(path);
+    if (!file) {
+        error = "no se pudo abrir " + path;
+        return false;
+    }
+
+    ServiceConfig config;
+    std::string section;
+    CollectorSettings* current = nullptr;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        line = trim(stripComment(line));
+        if (line.empty()) continue;
+
+        auto fail = [&](const std::string& what) {
+            error = path + ":" + std::to_string(lineNumber) + ": " + what;
+            return false;
+        };
+
+        if (line.front() == '[') {
+            if (line.back() != ']') return fail("sección sin cerrar");
+            section = trim(line.substr(1, line.size() - 2));
+            current = nullptr;
+            if (section.compare(0, 10, "collector.") == 0 && section.size() > 10) {
+                std::string name = section.substr(10);
+                std::transform(name.begin(), name.end(), name.begin(),
+                               [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+                if (!knownCollector(name)) return fail("colector desconocido: " + section.substr(10));
+                if (config.collector(name)) return fail("sección repetida: " + section);
+                config.collectors.push_back(CollectorSettings());
+                current = &config.collectors.back();
+                current->name = name;
+            } else if (section != "storage" && section != "collectors" && section != "sinks" &&
+                       section != "aggregator" && section != "log") {
+                return fail("sección desconocida: " + section);
+            }
+            continue;
+        }
+
+        std::size_t equals = line.find('=');
+        if (equals == std::string::npos) return fail("se esperaba <clave> = <valor>");
+        std::string key = trim(line.substr(0, equals));
+        std::string value = trim(line.substr(equals + 1));
+        long long number = 0;
+
+        if (section == "storage") {
+            if (key == "path") {
+                if (value.empty()) return fail("path vacío");
+                config.dbPath = value;
+            } else if (key == "pragma") {
+                config.pragmas.push_back(value);
+            } else if (key == "spool") {
+                config.spoolPath = value;
+            } else if (key == "spool_capacity") {
+                if (!parseInteger(value, number) || number <= 0) return fail("spool_capacity inválido");
+                config.spoolCapacity = static_cast<std::size_t>(number);
+            } else {
+                return fail("clave desconocida en [storage]: " + key);
+            }
+        } else if (section == "collectors") {
+            if (key != "interval_ms") return fail("clave desconocida en [collectors]: " + key);
+            if (!parseInteger(value, number) || number <= 0) return fail("interval_ms inválido");
+            config.defaultIntervalMs = static_cast<int>(number);
+        } else if (current) {
+            OptionValue type = OptionValue::Text;
+            if (key == "enabled") {
+                if (!parseBool(value, current->enabled)) return fail("enabled debe ser true o false");
+            } else if (key == "interval_ms") {
+                if (!parseInteger(value, number) || number <= 0) return fail("interval_ms inválido");
+                current->intervalMs = static_cast<int>(number);
+            } else if (key == "include" || key == "exclude") {
+                if (value.find('/') == std::string::npos) return fail("el patrón debe tener la forma <component>/<metric>");
+                (key == "include" ? current->include : current->exclude).push_back(value);
+            } else if (collectorOption(current->name, key, type)) {
+                if (!validOption(type, value)) return fail(key + " inválido");
+                current->options.emplace_back(key, value);
+            } else {
+                return fail("clave desconocida en [" + section + "]: " + key);
+            }
+        } else if (section == "sinks") {
+            if (key == "queue_batches") {
+                if (!parseInteger(value, number) || number <= 0) return fail("queue_batches inválido");
+                config.queueBatches = static_cast<std::size_t>(number);
+            } else if (key == "console") {
+                if (!parseBool(value, config.console)) return fail("console debe ser true o false");
+            } else if (key == "sample_log") {
+                config.sampleLogDir = value;
+            } else if (key == "push") {
+                config.pushTarget = value;
+            } else if (key == "push_format") {
+                if (value != "influx" && value != "otlp") return fail("push_format debe ser influx u otlp");
+                config.pushFormat = value;
+            } else if (key == "agent") {
+                config.agentTarget = value;
+            } else if (key == "agent_name") {
+                config.agentName = value;
+            } else {
+                return fail("clave desconocida en [sinks]: " + key);
+            }
+        } else if (section == "aggregator") {
+            if (key == "listen") {
+                if (value.empty()) return fail("listen vacío");
+                config.aggregatorListen = value;
+            } else if (key == "port") {
+                if (!parseInteger(value, number) || number <= 0 || number > 65535) return fail("port inválido");
+                config.aggregatorPort = static_cast<int>(number);
+            } else if (key == "shards") {
+                if (!parseInteger(value, number) || number <= 0 || number > 256) return fail("shards debe estar entre 1 y 256");
+                config.aggregatorShards = static_cast<std::size_t>(number);
+            } else if (key == "io_threads") {
+                if (!parseInteger(value, number) || number <= 0 || number > 64) return fail("io_threads debe estar entre 1 y 64");
+                config.aggregatorIoThreads = static_cast<std::size_t>(number);
+            } else if (key == "data_dir") {
+                if (value.empty()) return fail("data_dir vacío");
+                config.aggregatorDataDir = value;
+            } else {
+                return fail("clave desconocida en [aggregator]: " + key);
+            }
+        } else if (section == "log") {
+            if (key == "level") {
+                if (!parseLogLevel(value, config.logLevel)) return fail("level debe ser debug, info, warn o error");
+            } else if (key == "format") {
+                if (!parseLogFormat(value, config.logFormat)) return fail("format debe ser text, logfmt o json");
+            } else {
+                return fail("clave desconocida en [log]: " + key);
+            }
+        } else {
+            return fail("clave fuera de sección: " + key);
+        }
+    }
+
+    // min y max se validan por separado línea a línea; juntos, el rango no puede
+    // ser vacío ni estar invertido (las distribuciones de SyntheticCollector lo exigen).
+    if (const CollectorSettings* synthetic = config.collector("synthetic")) {
+        SyntheticConfig defaults;
+        double minValue = defaults.minValue;
+        double maxValue = defaults.maxValue;
+        for (const auto& option : synthetic->options) {
+            if (option.first == "min") minValue = std::strtod(option.second.c_str(), nullptr);
+            if (option.first == "max") maxValue = std::strtod(option.second.c_str(), nullptr);
+        }
+        if (!(maxValue > minValue)) {
+            error = path + ": [collector.synthetic] max debe ser mayor que min";
+            return false;
+        }
+    }
+
+    out = std::move(config);
+    return true;
+}
+
+bool requiresRestart(const ServiceConfig& before, const ServiceConfig& after) {
+    // Los colectores a pedido se construyen al arrancar solo si tienen sección:
+    // agregarla o quitarla no cambia nada hasta reiniciar.
+    for (const char* name : kOptInCollectors) {
+        if ((before.collector(name) != nullptr) != (after.collector(name) != nullptr)) return true;
+    }
+    for (const CollectorSettings& c : before.collectors) {
+        if (c.options != optionsOf(after, c.name)) return true;
+    }
+    for (const CollectorSettings& c : after.collectors) {
+        if (c.options != optionsOf(before, c.name)) return true;
+    }
+    return before.dbPath != after.dbPath || before.spoolPath != after.spoolPath ||
+           before.spoolCapacity != after.spoolCapacity || before.queueBatches != after.queueBatches ||
+           before.console != after.console || before.sampleLogDir != after.sampleLogDir ||
+           before.pushTarget != after.pushTarget || before.pushFormat != after.pushFormat ||
+           before.agentTarget != after.agentTarget || before.agentName != after.agentName ||
+           before.aggregatorListen != after.aggregatorListen || before.aggregatorPort != after.aggregatorPort ||
+           before.aggregatorShards != after.aggregatorShards ||
+           before.aggregatorIoThreads != after.aggregatorIoThreads ||
+           before.aggregatorDataDir != after.aggregatorDataDir || before.logFormat != after.logFormat;
+}
+
+bool matchSeriesPattern(const std::string& pattern, const std::string& component, const std::string& metric) {
+    std::size_t slash = pattern.find('/');
+    if (slash == std::string::npos) return false;
+    std::string componentPattern = pattern.substr(0, slash);
+    return matchWildcard(componentPattern.c_str(), component.c_str()) &&
+           matchWildcard(pattern.c_str() + slash + 1, metric.c_str());
+}
+
+ConfigWatcher::ConfigWatcher(const std::string& configPath) : path(configPath) {
+    std::error_code ec;
+    lastWrite = std::filesystem::last_write_time(path, ec);
+    existed = !ec;
+    lastCheck = std::chrono::steady_clock::now();
+}
+
+bool ConfigWatcher::changed() {
+    auto now = std::chrono::steady_clock::now();
+    if (now - lastCheck < std::chrono::seconds(1)) return false;
+    lastCheck = now;
+
+    std::error_code ec;
+    auto current = std::filesystem::last_write_time(path, ec);
+    if (ec) {
+        // Borrado o renombrado a medio guardar: se sigue con la configuración actual.
+        existed = false;
+        return false;
+    }
+    if (existed && current == lastWrite) return false;
+    existed = true;
+    lastWrite = current;
+    return true;
+}
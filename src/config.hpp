@@ -0,0 +1,196 @@
+/**
+ * @file config.hpp
+ * @brief Archivo de configuración del servicio (formato INI) y su recarga en caliente.
+ * @details
+ * Ejemplo (`config/syspulse.ini`):
+ * @code
+ * [storage]
+ * path = data/syspulse.db
+ * pragma = journal_mode=WAL        ; se puede repetir
+ * pragma = synchronous=NORMAL
+ * spool = data/spool.bin
+ * spool_capacity = 262144
+ *
+ * [collectors]
+ * interval_ms = 1000               ; intervalo por defecto
+ *
+ * [collector.ram]
+ * interval_ms = 5000
+ *
+ * [collector.synthetic]            ; solo con --synthetic
+ * exclude = synth01/s00*           ; patrones <component>/<metric> con '*'
+ * components = 10                  ; cardinalidad de component
+ * distribution = random_walk       ; constant, uniform, normal o random_walk
+ * min = 0
+ * max = 100
+ * seed = 42
+ *
+ * [collector.sched]                ; perf, sched, sensors e irq solo corren si tienen sección
+ * pid = 4242                       ; clave propia del colector (se puede repetir)
+ *
+ * [collector.irq]
+ * interval_ms = 10000
+ *
+ * [collector.vm]
+ * counter = pages_in               ; contadores de memoria a publicar (ver vm_monitor.cpp)
+ *
+ * [collector.fs]
+ * trend_half_life = 3600           ; segundos, para estimar TimeToFull
+ *
+ * [collector.sensors]
+ * power_counter = \Energy Meter(*)\Power   ; ruta PDH de cada sensor (ver sensor_monitor.hpp)
+ *
+ * [collector.net]
+ * stat = TcpRetransSegs            ; estadísticas de TCP/UDP a publicar (ver net_monitor.hpp)
+ *
+ * [sinks]
+ * queue_batches = 64
+ * console = true
+ * sample_log = data/samples
+ * push = collector.example:8086/api/v2/write
+ * push_format = influx
+ * agent = aggregator.example:7070  ; envío al agregador central
+ * agent_name = web01               ; por defecto, el nombre del equipo
+ *
+ * [aggregator]                     ; solo con --aggregator
+ * listen = 0.0.0.0
+ * port = 7070
+ * shards = 4
+ * io_threads = 2
+ * data_dir = data/shards
+ *
+ * [log]
+ * level = info
+ * format = text
+ * @endcode
+ *
+ * Todo es opcional: sin archivo (o sin una clave) se usan los mismos valores
+ * que antes estaban fijos en main(). Los colectores con una serie por CPU
+ * (perf, sched, sensors, irq) son la excepción: se agregan solo si el archivo
+ * tiene su sección `[collector.<nombre>]` al arrancar, que basta vacía.
+ * Agregar o quitar esa sección se aplica al reiniciar; con la sección presente,
+ * `enabled` los activa y desactiva en caliente.
+ *
+ * En Windows no existe SIGHUP: ConfigWatcher detecta que el archivo cambió por
+ * su fecha de modificación y el bucle principal lo vuelve a leer. Los
+ * intervalos, filtros, colectores activos, PRAGMA y el nivel de log se aplican
+ * en caliente; la ruta de la base, la cola local, los sinks, las claves propias
+ * de cada colector y el formato de log solo al reiniciar.
+ * @author Sergio Gonzalez
+ * @date 2026-04-11
+ */
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+#include "logger.hpp"
+
+/**
+ * @struct CollectorSettings
+ * @brief Sección `[collector.<nombre>]`.
+ */
+struct CollectorSettings {
+    std::string name;                  ///< Nombre en minúsculas (cpu, ram, perf, sched, vm, fs, sensors, irq, net, synthetic, replay, pipeline); otro es un error.
+    bool enabled = true;
+    int intervalMs = 0;                ///< 0 = el de `[collectors]`.
+    std::vector<std::string> include;  ///< Si no está vacío, solo pasan las series que coinciden.
+    std::vector<std::string> exclude;  ///< Series descartadas (se evalúa después de include).
+    std::vector<std::pair<std::string, std::string>> options;  ///< Claves propias del colector, en orden; se aplican al reiniciar.
+
+    /** @brief Valores de una clave propia, en el orden del archivo. */
+    std::vector<std::string> values(const std::string& key) const;
+};
+
+/**
+ * @struct ServiceConfig
+ * @brief Configuración completa del servicio.
+ */
+struct ServiceConfig {
+    // [storage]
+    std::string dbPath = "data/syspulse.db";
+    std::vector<std::string> pragmas;
+    std::string spoolPath = "data/spool.bin";
+    std::size_t spoolCapacity = 262144;
+
+    // [collectors] y [collector.*]
+    int defaultIntervalMs = 1000;
+    std::vector<CollectorSettings> collectors;
+
+    // [sinks]
+    std::size_t queueBatches = 64;     ///< Lotes máximos en la cola de cada sink.
+    bool console = true;
+    std::string sampleLogDir;          ///< Vacío = sin registro binario.
+    std::string pushTarget;            ///< `<host>:<puerto>[/ruta]`; vacío = sin envío.
+    std::string pushFormat = "influx";
+    std::string agentTarget;           ///< `<host>:<puerto>` del agregador; vacío = sin envío.
+    std::string agentName;             ///< Vacío = nombre del equipo.
+
+    // [aggregator]
+    std::string aggregatorListen = "0.0.0.0";
+    int aggregatorPort = 7070;
+    std::size_t aggregatorShards = 4;
+    std::size_t aggregatorIoThreads = 2;
+    std::string aggregatorDataDir = "data/shards";
+
+    // [log]
+    LogLevel logLevel = LogLevel::Info;
+    LogFormat logFormat = LogFormat::Text;
+
+    /**
+     * @brief Configuración de un colector, o nullptr si no tiene sección propia.
+     */
+    const CollectorSettings* collector(const std::string& name) const;
+
+    /**
+     * @brief Intervalo efectivo de un colector.
+     */
+    int intervalFor(const std::string& name) const;
+};
+
+/**
+ * @brief Lee un archivo de configuración.
+ * @param path Ruta del archivo.
+ * @param out Configuración resultante (solo se modifica si la lectura es válida).
+ * @param error Descripción del primer error, con número de línea.
+ * @return false si el archivo no se puede abrir o tiene errores.
+ */
+bool loadServiceConfig(const std::string& path, ServiceConfig& out, std::string& error);
+
+/**
+ * @brief Indica si entre dos configuraciones cambió algo que solo se aplica al
+ * reiniciar (base, cola local, sinks, agregador, claves propias de los colectores, secciones
+ * de los colectores a pedido, formato de log).
+ */
+bool requiresRestart(const ServiceConfig& before, const ServiceConfig& after);
+
+/**
+ * @brief Indica si una serie `<component>/<metric>` coincide con un patrón con comodines '*'.
+ */
+bool matchSeriesPattern(const std::string& pattern, const std::string& component, const std::string& metric);
+
+/**
+ * @class ConfigWatcher
+ * @brief Detecta cambios en el archivo de configuración por su fecha de modificación.
+ *
+ * @details
+ * changed() hace como mucho una consulta al sistema de archivos por segundo,
+ * así que se puede llamar en cada ciclo.
+ */
+class ConfigWatcher {
+private:
+    std::string path;
+    std::filesystem::file_time_type lastWrite{};
+    bool existed = false;
+    std::chrono::steady_clock::time_point lastCheck{};
+
+public:
+    explicit ConfigWatcher(const std::string& path);
+
+    /**
+     * @return true si el archivo cambió (o apareció) desde la llamada anterior.
+     */
+    bool changed();
+};
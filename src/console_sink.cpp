@@ -0,0 +1,29 @@
+/**
+ * @file console_sink.cpp
+ * @brief Implementación de ConsoleSink.
+ * @author Sergio Gonzalez
+ * @date 2026-03-28
+ */
+
+#include "console_sink.hpp"
+#include "logger.hpp"
+
+bool ConsoleSink::write(const std::vector<Metric>& batch) {
+    // Una línea por lote es ruido en producción: solo con --log-level debug.
+    if (batch.empty() || !Logger::enabled(LogLevel::Debug)) return true;
+
+    // En modo carga, solo el resumen del lote.
+    if (batch.size() <= 4) {
+        for (const Metric& m : batch) {
+            if (m.labels.empty()) {
+                Logger::debug("Métrica", {{"component", m.component}, {"metric", m.metric}, {"value", m.value}, {"unit", m.unit}});
+            } else {
+                Logger::debug("Métrica", {{"component", m.component}, {"metric", m.metric}, {"labels", formatLabels(m.labels)},
+                                          {"value", m.value}, {"unit", m.unit}});
+            }
+        }
+    } else {
+        Logger::debug("Lote", {{"metrics", batch.size()}});
+    }
+    return true;
+}
@@ -0,0 +1,20 @@
+/**
+ * @file console_sink.hpp
+ * @brief Sink que muestra cada lote en la consola.
+ * @details Registra en nivel Debug: por defecto no escribe nada.
+ * @author Sergio Gonzalez
+ * @date 2026-03-28
+ */
+#pragma once
+#include <vector>
+#include "sink.hpp"
+
+/**
+ * @class ConsoleSink
+ * @brief Imprime los lotes chicos completos y, de los grandes, solo el tamaño.
+ */
+class ConsoleSink : public MetricSink {
+public:
+    const char* name() const override { return "console"; }
+    bool write(const std::vector<Metric>& batch) override;
+};
@@ -18,7 +18,10 @@
  */
 
 #include "db_manager.hpp"
+#include "rate_engine.hpp"
+#include <algorithm>
 #include <iostream>
+#include <unordered_map>
 
 /**
  * @brief Constructor por defecto.
@@ -47,6 +50,7 @@ DatabaseManager::DatabaseManager() : db(nullptr) {}
  * Este método NO asume que la base de datos ya existe ni que esté bien formada.
  */
 bool DatabaseManager::connect(const std::string& dbPath) {
+    std::lock_guard<std::mutex> lock(mutex);
     // Intentamos abrir el archivo. Si no existe, SQLite lo crea.
     int rc = sqlite3_open(dbPath.c_str(), &db);
     
@@ -76,10 +80,37 @@ bool DatabaseManager::connect(const std::string& dbPath) {
  *  - Estados inconsistentes del sistema.
  */
 DatabaseManager::~DatabaseManager() {
-    if (db) {
-        sqlite3_close(db);
-        db = nullptr;
-    }
+    close();
+}
+
+/**
+ * @brief Cierre explícito de la conexión.
+ *
+ * @details
+ * Permite cerrar en un punto conocido del apagado (y saber si funcionó) en lugar
+ * de depender del orden de destrucción de objetos al salir de main().
+ */
+bool DatabaseManager::close() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!db) return true;
+    int rc = sqlite3_close(db);
+    db = nullptr;
+    seriesIndex.clear();
+    return rc == SQLITE_OK;
+}
+
+/**
+ * @brief Checkpoint del WAL en modo TRUNCATE.
+ *
+ * @details
+ * En modo WAL las escrituras confirmadas viven primero en el archivo `-wal`.
+ * El checkpoint las copia a la base principal; TRUNCATE además deja el WAL en
+ * cero bytes, de modo que el archivo .db queda completo por sí solo al apagar.
+ */
+bool DatabaseManager::checkpoint() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!db) return false;
+    return sqlite3_wal_checkpoint_v2(db, nullptr, SQLITE_CHECKPOINT_TRUNCATE, nullptr, nullptr) == SQLITE_OK;
 }
 
 /**
@@ -98,6 +129,25 @@ DatabaseManager::~DatabaseManager() {
  *  - `value`: valor numérico
  *  - `unit`: unidad asociada al valor
  *  - `timestamp`: tiempo en formato UNIX (segundos o milisegundos)
+ *
+ *  - `histogram`: histograma serializado (ver histogram.hpp), solo en métricas de distribución
+ *  - `kind`: 0 = gauge, 1 = contador monótono crudo (ver MetricKind)
+ *  - `series_id`: fila de `series` (component, metric y etiquetas)
+ *
+ * `metric_rollups` y `alert_events` también llevan el `series_id` de la serie
+ * que resumen o que cambió de estado (NULL en los eventos anteriores a las etiquetas).
+ *
+ * `series` tiene una fila por serie, con sus etiquetas en texto canónico para
+ * la restricción UNIQUE; `series_labels` guarda cada etiqueta una vez (por
+ * serie), para poder filtrar también desde SQL.
+ *
+ * La tabla `metric_rollups` guarda resúmenes por cubeta de tiempo (ver rollup.hpp)
+ * y `alert_events` el historial de alertas (ver alert_engine.hpp).
+ *
+ * Las columnas agregadas después de la primera versión del esquema se agregan
+ * con ensureColumn() a las bases que ya existían.
+ *
+ * sqlite3_exec ejecuta todas las sentencias del texto, una tras otra.
  */
 bool DatabaseManager::initTables() {
     // 2. Definición de la nueva tabla genérica
@@ -108,7 +158,55 @@ bool DatabaseManager::initTables() {
         "metric TEXT NOT NULL,"
         "value REAL NOT NULL,"
         "unit TEXT NOT NULL,"
-        "timestamp INTEGER NOT NULL"
+        "timestamp INTEGER NOT NULL,"
+        "histogram BLOB,"
+        "kind INTEGER NOT NULL DEFAULT 0,"
+        "series_id INTEGER"
+        ");"
+        // Índice por tiempo: la exportación recorre todas las series de un rango.
+        "CREATE INDEX IF NOT EXISTS idx_metrics_time ON metrics (timestamp);"
+        // Rollups: una fila por serie y cubeta de tiempo, con el DDSketch en un BLOB.
+        "CREATE TABLE IF NOT EXISTS metric_rollups ("
+        "id INTEGER PRIMARY KEY AUTOINCREMENT,"
+        "component TEXT NOT NULL,"
+        "metric TEXT NOT NULL,"
+        "unit TEXT NOT NULL,"
+        "bucket_start INTEGER NOT NULL,"
+        "bucket_seconds INTEGER NOT NULL,"
+        "count INTEGER NOT NULL,"
+        "sum REAL NOT NULL,"
+        "min REAL NOT NULL,"
+        "max REAL NOT NULL,"
+        "sketch BLOB NOT NULL,"
+        "histogram BLOB,"
+        "series_id INTEGER"
+        ");"
+        "CREATE INDEX IF NOT EXISTS idx_rollups_time ON metric_rollups (bucket_start);"
+        // Series y sus etiquetas: se guardan una vez, no en cada muestra.
+        "CREATE TABLE IF NOT EXISTS series ("
+        "id INTEGER PRIMARY KEY AUTOINCREMENT,"
+        "component TEXT NOT NULL,"
+        "metric TEXT NOT NULL,"
+        "labels TEXT NOT NULL DEFAULT '',"
+        "UNIQUE (component, metric, labels)"
+        ");"
+        "CREATE TABLE IF NOT EXISTS series_labels ("
+        "series_id INTEGER NOT NULL,"
+        "name TEXT NOT NULL,"
+        "value TEXT NOT NULL,"
+        "PRIMARY KEY (series_id, name)"
+        ");"
+        "CREATE INDEX IF NOT EXISTS idx_series_labels_name ON series_labels (name, value);"
+        // Historial de alertas: cada cambio de estado es una fila.
+        "CREATE TABLE IF NOT EXISTS alert_events ("
+        "id INTEGER PRIMARY KEY AUTOINCREMENT,"
+        "rule TEXT NOT NULL,"
+        "component TEXT NOT NULL,"
+        "metric TEXT NOT NULL,"
+        "state TEXT NOT NULL,"
+        "value REAL NOT NULL,"
+        "timestamp INTEGER NOT NULL,"
+        "series_id INTEGER"
         ");";
 
     char* errMsg = nullptr;
@@ -119,10 +217,300 @@ bool DatabaseManager::initTables() {
         sqlite3_free(errMsg);
         return false;
     }
-    
+
+    if (!ensureColumn("metrics", "histogram", "BLOB") ||
+        !ensureColumn("metric_rollups", "histogram", "BLOB") ||
+        !ensureColumn("metrics", "kind", "INTEGER NOT NULL DEFAULT 0") ||
+        !ensureColumn("metrics", "series_id", "INTEGER") ||
+        !ensureColumn("metric_rollups", "series_id", "INTEGER") ||
+        !ensureColumn("alert_events", "series_id", "INTEGER")) {
+        return false;
+    }
+    // Después de ensureColumn: en una base anterior la columna recién existe ahora.
+    // Índices por serie y tiempo: las consultas por ventana (loadSeries, loadSketch)
+    // los recorren en orden en lugar de escanear toda la tabla. Las consultas ya van
+    // por series_id: los índices por component/metric de bases anteriores sobran
+    // y solo encarecían cada INSERT.
+    const char* seriesIndexes =
+        "CREATE INDEX IF NOT EXISTS idx_metrics_series_id_time ON metrics (series_id, timestamp);"
+        "CREATE INDEX IF NOT EXISTS idx_rollups_series_id_time ON metric_rollups (series_id, bucket_start);"
+        "DROP INDEX IF EXISTS idx_metrics_series_time;"
+        "DROP INDEX IF EXISTS idx_rollups_series_time;";
+    if (sqlite3_exec(db, seriesIndexes, nullptr, nullptr, nullptr) != SQLITE_OK) {
+        return false;
+    }
+    return loadSeriesIndex();
+}
+
+/**
+ * @brief Agrega una columna a una tabla existente si todavía no la tiene.
+ *
+ * @details
+ * `CREATE TABLE IF NOT EXISTS` no modifica una tabla que ya existe, así que una
+ * base creada por una versión anterior no recibe las columnas nuevas. Se
+ * consulta `PRAGMA table_info` y, si falta, se agrega con `ALTER TABLE`
+ * (instantáneo en SQLite: no reescribe las filas, que quedan con NULL).
+ */
+bool DatabaseManager::ensureColumn(const char* table, const char* column, const char* type) {
+    std::string sql = std::string("PRAGMA table_info(") + table + ");";
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        return false;
+    }
+    bool found = false;
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        // Columna 1 de table_info: nombre de la columna.
+        const unsigned char* name = sqlite3_column_text(stmt, 1);
+        if (name && std::string(reinterpret_cast<const char*>(name)) == column) {
+            found = true;
+            break;
+        }
+    }
+    sqlite3_finalize(stmt);
+    if (found) return true;
+
+    sql = std::string("ALTER TABLE ") + table + " ADD COLUMN " + column + " " + type + ";";
+    return sqlite3_exec(db, sql.c_str(), nullptr, nullptr, nullptr) == SQLITE_OK;
+}
+
+namespace {
+
+/**
+ * @brief Enlaza el histograma de una métrica (o NULL si es escalar).
+ * @param blob Buffer del llamador: se reutiliza entre filas.
+ */
+void bindHistogram(sqlite3_stmt* stmt, int index, const Histogram* histogram, std::string& blob) {
+    if (!histogram || histogram->count() == 0) {
+        sqlite3_bind_null(stmt, index);
+        return;
+    }
+    blob = histogram->serialize();
+    sqlite3_bind_blob(stmt, index, blob.data(), static_cast<int>(blob.size()), SQLITE_TRANSIENT);
+}
+
+std::string columnText(sqlite3_stmt* stmt, int column) {
+    const unsigned char* text = sqlite3_column_text(stmt, column);
+    return text ? std::string(reinterpret_cast<const char*>(text), static_cast<size_t>(sqlite3_column_bytes(stmt, column)))
+                : std::string();
+}
+
+/**
+ * @brief Etiquetas normalizadas de una métrica.
+ * @details Los colectores ya las entregan ordenadas; solo si no lo están se
+ * normaliza una copia en @p scratch, para no copiar en cada fila.
+ */
+const Labels& normalized(const Labels& labels, Labels& scratch) {
+    bool ok = labels.empty() || !labels.front().first.empty();
+    for (std::size_t i = 1; ok && i < labels.size(); ++i) {
+        ok = labels[i - 1].first < labels[i].first;
+    }
+    if (ok) return labels;
+    scratch = labels;
+    normalizeLabels(scratch);
+    return scratch;
+}
+
+/**
+ * @brief Carga @p seriesIds en la tabla temporal `scan_series` que usa appendSeriesFilter.
+ * @details Los ids se enlazan uno a uno en una sentencia ya preparada, así la consulta
+ * del recorrido tiene siempre el mismo texto sin importar cuántas series se pidan.
+ * La tabla vive en la base temporal de la conexión: no toca el archivo ni su lock.
+ */
+bool loadSeriesFilter(sqlite3* db, const std::vector<long long>& seriesIds) {
+    if (seriesIds.empty()) return true;
+    if (sqlite3_exec(db, "CREATE TEMP TABLE IF NOT EXISTS scan_series (id INTEGER PRIMARY KEY);"
+                         "BEGIN; DELETE FROM temp.scan_series;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+        return false;
+    }
+    sqlite3_stmt* stmt;
+    bool ok = sqlite3_prepare_v2(db, "INSERT OR IGNORE INTO temp.scan_series (id) VALUES (?);", -1, &stmt, nullptr) == SQLITE_OK;
+    for (std::size_t i = 0; ok && i < seriesIds.size(); ++i) {
+        sqlite3_bind_int64(stmt, 1, seriesIds[i]);
+        ok = sqlite3_step(stmt) == SQLITE_DONE;
+        sqlite3_reset(stmt);
+    }
+    sqlite3_finalize(stmt);
+    if (!ok || sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+        return false;
+    }
+    return true;
+}
+
+/// Agrega el filtro por las series cargadas con loadSeriesFilter (nada si @p seriesIds está vacío).
+void appendSeriesFilter(std::string& sql, const std::vector<long long>& seriesIds) {
+    if (seriesIds.empty()) return;
+    sql += " AND series_id IN (SELECT id FROM temp.scan_series)";
+}
+
+/**
+ * @brief Identidad (component, metric, etiquetas) de cubetas o eventos, para resolveSeries.
+ * @details Se llama una vez por lote de cubetas o de eventos, no por muestra.
+ */
+template <typename Row>
+std::vector<Metric> seriesOf(const std::vector<Row>& rows) {
+    std::vector<Metric> keys(rows.size());
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        keys[i].component = rows[i].component;
+        keys[i].metric = rows[i].metric;
+        keys[i].labels = rows[i].labels;
+    }
+    return keys;
+}
+
+} // namespace
+
+/**
+ * @brief Completa `series_id` en las filas anteriores a las etiquetas y carga el índice en memoria.
+ *
+ * @details
+ * Las muestras y cubetas de rollup guardadas antes de que existiera `series`
+ * quedan con `series_id` NULL: se les crea su serie sin etiquetas y se completa
+ * la columna. En una base ya migrada las dos sentencias no encuentran filas (usan
+ * idx_metrics_series_id_time e idx_rollups_series_id_time), así que conectar
+ * no se vuelve más lento.
+ *
+ * Luego se leen `series` y `series_labels` en orden de id y se arma el
+ * SeriesIndex; una base con decenas de miles de series tarda milisegundos.
+ */
+bool DatabaseManager::loadSeriesIndex() {
+    const char* backfill =
+        "INSERT OR IGNORE INTO series (component, metric, labels) "
+        "SELECT DISTINCT component, metric, '' FROM metrics WHERE series_id IS NULL;"
+        "UPDATE metrics SET series_id = (SELECT s.id FROM series s WHERE s.component = metrics.component "
+        "AND s.metric = metrics.metric AND s.labels = '') WHERE series_id IS NULL;"
+        "INSERT OR IGNORE INTO series (component, metric, labels) "
+        "SELECT DISTINCT component, metric, '' FROM metric_rollups WHERE series_id IS NULL;"
+        "UPDATE metric_rollups SET series_id = (SELECT s.id FROM series s WHERE s.component = metric_rollups.component "
+        "AND s.metric = metric_rollups.metric AND s.labels = '') WHERE series_id IS NULL;";
+    if (sqlite3_exec(db, backfill, nullptr, nullptr, nullptr) != SQLITE_OK) {
+        return false;
+    }
+
+    std::vector<LabeledSeries> loaded;
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, "SELECT id, component, metric FROM series ORDER BY id;", -1, &stmt, nullptr) != SQLITE_OK) {
+        return false;
+    }
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        LabeledSeries info;
+        info.id = sqlite3_column_int64(stmt, 0);
+        info.component = columnText(stmt, 1);
+        info.metric = columnText(stmt, 2);
+        loaded.push_back(std::move(info));
+    }
+    sqlite3_finalize(stmt);
+    if (rc != SQLITE_DONE) return false;
+
+    // Las etiquetas llegan ordenadas por serie y nombre: se recorren a la par de `loaded`.
+    if (sqlite3_prepare_v2(db, "SELECT series_id, name, value FROM series_labels ORDER BY series_id, name;",
+                           -1, &stmt, nullptr) != SQLITE_OK) {
+        return false;
+    }
+    std::size_t cursor = 0;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        long long id = sqlite3_column_int64(stmt, 0);
+        while (cursor < loaded.size() && loaded[cursor].id < id) ++cursor;
+        if (cursor == loaded.size()) break;
+        if (loaded[cursor].id == id) {
+            loaded[cursor].labels.emplace_back(columnText(stmt, 1), columnText(stmt, 2));
+        }
+    }
+    sqlite3_finalize(stmt);
+    if (rc != SQLITE_DONE && rc != SQLITE_ROW) return false;
+
+    seriesIndex.clear();
+    for (const LabeledSeries& info : loaded) {
+        seriesIndex.add(info);
+    }
+    return true;
+}
+
+/**
+ * @brief Resuelve el id de serie de cada métrica.
+ *
+ * @details
+ * Lo normal es que todas las series ya existan y esto sea una búsqueda en un
+ * hash por fila. Las nuevas (primer ciclo, un disco que se conectó) se insertan
+ * juntas en una transacción propia y se agregan al índice recién después del COMMIT.
+ */
+bool DatabaseManager::resolveSeries(const Metric* metrics, std::size_t count, std::vector<long long>& ids) {
+    ids.assign(count, 0);
+    Labels scratch;
+    std::vector<std::size_t> missing;
+    for (std::size_t i = 0; i < count; ++i) {
+        SeriesIndex::seriesKey(keyBuffer, metrics[i].component, metrics[i].metric, normalized(metrics[i].labels, scratch));
+        ids[i] = seriesIndex.find(keyBuffer);
+        if (ids[i] == 0) missing.push_back(i);
+    }
+    if (missing.empty()) return true;
+
+    if (sqlite3_exec(db, "BEGIN TRANSACTION;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        return false;
+    }
+    sqlite3_stmt* seriesStmt = nullptr;
+    sqlite3_stmt* labelStmt = nullptr;
+    bool ok = sqlite3_prepare_v2(db, "INSERT INTO series (component, metric, labels) VALUES (?, ?, ?);",
+                                 -1, &seriesStmt, nullptr) == SQLITE_OK &&
+              sqlite3_prepare_v2(db, "INSERT INTO series_labels (series_id, name, value) VALUES (?, ?, ?);",
+                                 -1, &labelStmt, nullptr) == SQLITE_OK;
+
+    // Una serie nueva puede aparecer varias veces en el mismo lote.
+    std::unordered_map<std::string, long long> created;
+    std::vector<LabeledSeries> added;
+    for (std::size_t i : missing) {
+        if (!ok) break;
+        const Metric& m = metrics[i];
+        const Labels& labels = normalized(m.labels, scratch);
+        SeriesIndex::seriesKey(keyBuffer, m.component, m.metric, labels);
+        auto it = created.find(keyBuffer);
+        if (it != created.end()) {
+            ids[i] = it->second;
+            continue;
+        }
+
+        std::string text = formatLabels(labels);
+        sqlite3_bind_text(seriesStmt, 1, m.component.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(seriesStmt, 2, m.metric.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(seriesStmt, 3, text.c_str(), -1, SQLITE_TRANSIENT);
+        ok = sqlite3_step(seriesStmt) == SQLITE_DONE;
+        sqlite3_reset(seriesStmt);
+        if (!ok) break;
+
+        long long id = sqlite3_last_insert_rowid(db);
+        for (const auto& label : labels) {
+            sqlite3_bind_int64(labelStmt, 1, id);
+            sqlite3_bind_text(labelStmt, 2, label.first.c_str(), -1, SQLITE_TRANSIENT);
+            sqlite3_bind_text(labelStmt, 3, label.second.c_str(), -1, SQLITE_TRANSIENT);
+            ok = sqlite3_step(labelStmt) == SQLITE_DONE;
+            sqlite3_reset(labelStmt);
+            if (!ok) break;
+        }
+
+        ids[i] = id;
+        created.emplace(keyBuffer, id);
+        added.push_back(LabeledSeries{id, m.component, m.metric, labels});
+    }
+    sqlite3_finalize(seriesStmt);
+    sqlite3_finalize(labelStmt);
+
+    if (!ok || sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+        return false;
+    }
+    for (const LabeledSeries& info : added) {
+        seriesIndex.add(info);
+    }
     return true;
 }
 
+long long DatabaseManager::unlabeledSeries(const std::string& component, const std::string& metric) {
+    SeriesIndex::seriesKey(keyBuffer, component, metric, Labels());
+    return seriesIndex.find(keyBuffer);
+}
+
 /**
  * @brief Inserta una métrica en la base de datos.
  *
@@ -140,9 +528,16 @@ bool DatabaseManager::initTables() {
  * los strings, ya que su ciclo de vida depende de C++.
  */
 bool DatabaseManager::insertMetric(const Metric& metric) {
+    std::lock_guard<std::mutex> lock(mutex);
     if (!db) return false;
 
-    const char* sql = "INSERT INTO metrics (component, metric, value, unit, timestamp) VALUES (?, ?, ?, ?, ?);";
+    std::vector<long long> seriesIds;
+    if (!resolveSeries(&metric, 1, seriesIds)) {
+        return false;
+    }
+
+    const char* sql = "INSERT INTO metrics (component, metric, value, unit, timestamp, histogram, kind, series_id) "
+                      "VALUES (?, ?, ?, ?, ?, ?, ?, ?);";
     sqlite3_stmt* stmt;
 
     if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
@@ -157,6 +552,10 @@ bool DatabaseManager::insertMetric(const Metric& metric) {
     sqlite3_bind_double(stmt, 3, metric.value);
     sqlite3_bind_text(stmt, 4, metric.unit.c_str(), -1, SQLITE_TRANSIENT);
     sqlite3_bind_int64(stmt, 5, metric.timestamp);
+    std::string blob;
+    bindHistogram(stmt, 6, metric.histogram.get(), blob);
+    sqlite3_bind_int(stmt, 7, static_cast<int>(metric.kind));
+    sqlite3_bind_int64(stmt, 8, seriesIds[0]);
 
     if (sqlite3_step(stmt) != SQLITE_DONE) {
         sqlite3_finalize(stmt);
@@ -165,4 +564,613 @@ bool DatabaseManager::insertMetric(const Metric& metric) {
     // Liberamos explícitamente la sentencia preparada
     sqlite3_finalize(stmt);
     return true;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Inserta un lote de métricas usando una sola transacción.
+ *
+ * @param metrics Métricas a guardar.
+ * @return true si el lote completo se confirmó.
+ * @return false si ocurre cualquier error (el lote se revierte).
+ *
+ * @details
+ * Por defecto SQLite abre y confirma una transacción implícita por cada INSERT,
+ * lo que en disco significa una sincronización (fsync) por fila.
+ * Agrupando el lote entre BEGIN y COMMIT se paga ese costo una sola vez.
+ *
+ * Además, la sentencia preparada se compila UNA vez y se reutiliza con
+ * sqlite3_reset para cada fila, en lugar de compilarla en cada inserción.
+ */
+bool DatabaseManager::insertMetrics(const std::vector<Metric>& metrics) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!db) return false;
+    if (metrics.empty()) return true;
+
+    std::vector<long long> seriesIds;
+    if (!resolveSeries(metrics.data(), metrics.size(), seriesIds)) {
+        return false;
+    }
+
+    if (sqlite3_exec(db, "BEGIN TRANSACTION;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        return false;
+    }
+
+    const char* sql = "INSERT INTO metrics (component, metric, value, unit, timestamp, histogram, kind, series_id) "
+                      "VALUES (?, ?, ?, ?, ?, ?, ?, ?);";
+    sqlite3_stmt* stmt;
+
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+        return false;
+    }
+
+    bool ok = true;
+    std::string blob;
+    for (std::size_t i = 0; i < metrics.size(); ++i) {
+        const Metric& metric = metrics[i];
+        sqlite3_bind_text(stmt, 1, metric.component.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 2, metric.metric.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_double(stmt, 3, metric.value);
+        sqlite3_bind_text(stmt, 4, metric.unit.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int64(stmt, 5, metric.timestamp);
+        bindHistogram(stmt, 6, metric.histogram.get(), blob);
+        sqlite3_bind_int(stmt, 7, static_cast<int>(metric.kind));
+        sqlite3_bind_int64(stmt, 8, seriesIds[i]);
+
+        if (sqlite3_step(stmt) != SQLITE_DONE) {
+            ok = false;
+            break;
+        }
+        // reset deja la sentencia lista para la siguiente fila sin recompilarla
+        sqlite3_reset(stmt);
+    }
+    sqlite3_finalize(stmt);
+
+    // Si el COMMIT falla (SQLITE_BUSY, base bloqueada) la transacción sigue
+    // abierta: sin ROLLBACK, todo BEGIN posterior fallaría y cada lote iría a
+    // la cola local sin que esta se pueda reinsertar nunca.
+    if (!ok || sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Ejecuta una directiva PRAGMA.
+ *
+ * @param pragma Directiva sin el prefijo "PRAGMA".
+ * @return true si SQLite la aceptó.
+ *
+ * @details
+ * Los PRAGMA controlan el comportamiento del motor (modo de journal, nivel de
+ * sincronización, tamaño de caché...). Algunos devuelven una fila con el valor
+ * resultante; sqlite3_exec la descarta porque no registramos callback.
+ */
+bool DatabaseManager::applyPragma(const std::string& pragma) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!db) return false;
+
+    std::string sql = "PRAGMA " + pragma + ";";
+    char* errMsg = nullptr;
+    int rc = sqlite3_exec(db, sql.c_str(), nullptr, nullptr, &errMsg);
+
+    if (rc != SQLITE_OK) {
+        sqlite3_free(errMsg);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Carga la serie sin etiquetas component/metric.
+ *
+ * @details
+ * Antes de las etiquetas, component/metric identificaba una serie; ahora puede
+ * haber varias (una por núcleo, por disco...). Esta versión conserva el
+ * significado anterior: la serie sin etiquetas, que es donde quedaron también
+ * las muestras guardadas antes de la migración.
+ */
+bool DatabaseManager::loadSeries(const std::string& component, const std::string& metric,
+                                 long long from, long long to, SeriesColumns& out) {
+    long long seriesId;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!db) {
+            out.clear();
+            return false;
+        }
+        seriesId = unlabeledSeries(component, metric);
+    }
+    if (seriesId == 0) {
+        out.clear();
+        return true;
+    }
+    return loadSeries(seriesId, from, to, out);
+}
+
+/**
+ * @brief Carga una serie en columnas contiguas (timestamps y valores).
+ *
+ * @details
+ * SQLite entrega los resultados fila por fila; aquí se paga ese costo una sola
+ * vez. Las estadísticas posteriores (aggregate / aggregateWindow) recorren los
+ * arreglos en memoria sin volver a consultar la base.
+ *
+ * Se reserva memoria por adelantado con COUNT(*) para que los vectores no se
+ * realojen mientras crecen. Ambas consultas recorren idx_metrics_series_id_time.
+ */
+bool DatabaseManager::loadSeries(long long seriesId, long long from, long long to, SeriesColumns& out) {
+    std::lock_guard<std::mutex> lock(mutex);
+    out.clear();
+    if (!db) return false;
+
+    const char* countSql = "SELECT COUNT(*) FROM metrics WHERE series_id = ? AND timestamp BETWEEN ? AND ?;";
+    const char* sql = "SELECT timestamp, value FROM metrics WHERE series_id = ? AND timestamp BETWEEN ? AND ? "
+                      "ORDER BY timestamp;";
+
+    for (int pass = 0; pass < 2; ++pass) {
+        sqlite3_stmt* stmt;
+        if (sqlite3_prepare_v2(db, pass == 0 ? countSql : sql, -1, &stmt, nullptr) != SQLITE_OK) {
+            return false;
+        }
+        sqlite3_bind_int64(stmt, 1, seriesId);
+        sqlite3_bind_int64(stmt, 2, from);
+        sqlite3_bind_int64(stmt, 3, to);
+
+        int rc;
+        while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+            if (pass == 0) {
+                sqlite3_int64 count = sqlite3_column_int64(stmt, 0);
+                out.timestamps.reserve(static_cast<size_t>(count));
+                out.values.reserve(static_cast<size_t>(count));
+            } else {
+                out.timestamps.push_back(sqlite3_column_int64(stmt, 0));
+                out.values.push_back(sqlite3_column_double(stmt, 1));
+            }
+        }
+        sqlite3_finalize(stmt);
+
+        if (rc != SQLITE_DONE) {
+            out.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Resuelve un selector con el índice en memoria.
+ *
+ * @details No hay consulta SQL: todo es intersección de listas en SeriesIndex.
+ * Luego cada serie se carga con loadSeries(seriesId, ...) o loadRates(seriesId, ...).
+ */
+bool DatabaseManager::selectSeries(const SeriesSelector& selector, std::vector<LabeledSeries>& out) {
+    std::lock_guard<std::mutex> lock(mutex);
+    out.clear();
+    if (!db) return false;
+
+    std::vector<long long> ids;
+    seriesIndex.select(selector, ids);
+    out.reserve(ids.size());
+    for (long long id : ids) {
+        out.push_back(*seriesIndex.get(id));
+    }
+    return true;
+}
+
+/**
+ * @brief Tasas de la serie sin etiquetas component/metric (ver loadSeries).
+ */
+bool DatabaseManager::loadRates(const std::string& component, const std::string& metric,
+                                long long from, long long to, SeriesColumns& out, std::size_t* resets) {
+    long long seriesId;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!db) {
+            out.clear();
+            return false;
+        }
+        seriesId = unlabeledSeries(component, metric);
+    }
+    if (seriesId == 0) {
+        out.clear();
+        if (resets) *resets = 0;
+        return true;
+    }
+    return loadRates(seriesId, from, to, out, resets);
+}
+
+/**
+ * @brief Tasas por segundo de un contador, calculadas sobre los valores crudos guardados.
+ *
+ * @details
+ * Se carga la serie cruda con loadSeries (que toma el mutex) y la conversión se
+ * hace fuera del candado con computeRates, la misma regla que usa RateEngine en
+ * la ingesta. Para que la primera tasa del rango exista se pide también la
+ * lectura anterior a @p from.
+ */
+bool DatabaseManager::loadRates(long long seriesId, long long from, long long to, SeriesColumns& out,
+                                std::size_t* resets) {
+    SeriesColumns raw;
+    if (!loadSeries(seriesId, from, to, raw)) {
+        out.clear();
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        const char* sql = "SELECT timestamp, value FROM metrics WHERE series_id = ? AND timestamp < ? "
+                          "ORDER BY timestamp DESC LIMIT 1;";
+        sqlite3_stmt* stmt;
+        if (db && sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK) {
+            sqlite3_bind_int64(stmt, 1, seriesId);
+            sqlite3_bind_int64(stmt, 2, from);
+            if (sqlite3_step(stmt) == SQLITE_ROW) {
+                raw.timestamps.insert(raw.timestamps.begin(), sqlite3_column_int64(stmt, 0));
+                raw.values.insert(raw.values.begin(), sqlite3_column_double(stmt, 1));
+            }
+            sqlite3_finalize(stmt);
+        }
+    }
+
+    std::size_t found = computeRates(raw, out);
+    if (resets) *resets = found;
+    return true;
+}
+
+/**
+ * @brief Guarda cubetas de rollup.
+ *
+ * @details
+ * El sketch se serializa a un BLOB de unos cientos de bytes. Se enlaza con
+ * SQLITE_TRANSIENT porque el std::string temporal se destruye antes del step.
+ */
+bool DatabaseManager::insertRollups(const std::vector<RollupRow>& rows) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!db) return false;
+    if (rows.empty()) return true;
+
+    std::vector<long long> seriesIds;
+    std::vector<Metric> keys = seriesOf(rows);
+    if (!resolveSeries(keys.data(), keys.size(), seriesIds)) {
+        return false;
+    }
+
+    if (sqlite3_exec(db, "BEGIN TRANSACTION;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        return false;
+    }
+
+    const char* sql = "INSERT INTO metric_rollups (component, metric, unit, bucket_start, bucket_seconds, "
+                      "count, sum, min, max, sketch, histogram, series_id) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?);";
+    sqlite3_stmt* stmt;
+
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+        return false;
+    }
+
+    bool ok = true;
+    std::string histogramBlob;
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        const RollupRow& row = rows[i];
+        std::string blob = row.sketch.serialize();
+
+        sqlite3_bind_text(stmt, 1, row.component.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 2, row.metric.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 3, row.unit.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int64(stmt, 4, row.bucketStart);
+        sqlite3_bind_int(stmt, 5, row.bucketSeconds);
+        sqlite3_bind_int64(stmt, 6, static_cast<sqlite3_int64>(row.count));
+        sqlite3_bind_double(stmt, 7, row.sum);
+        sqlite3_bind_double(stmt, 8, row.min);
+        sqlite3_bind_double(stmt, 9, row.max);
+        sqlite3_bind_blob(stmt, 10, blob.data(), static_cast<int>(blob.size()), SQLITE_TRANSIENT);
+        bindHistogram(stmt, 11, &row.histogram, histogramBlob);
+        sqlite3_bind_int64(stmt, 12, seriesIds[i]);
+
+        if (sqlite3_step(stmt) != SQLITE_DONE) {
+            ok = false;
+            break;
+        }
+        sqlite3_reset(stmt);
+    }
+    sqlite3_finalize(stmt);
+
+    if (!ok || sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Sketch de la serie sin etiquetas component/metric (ver loadSeries).
+ */
+bool DatabaseManager::loadSketch(const std::string& component, const std::string& metric,
+                                 long long from, long long to, DDSketch& out) {
+    long long seriesId;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!db) {
+            out.clear();
+            return false;
+        }
+        seriesId = unlabeledSeries(component, metric);
+    }
+    if (seriesId == 0) {
+        out.clear();
+        return true;
+    }
+    return loadSketch(seriesId, from, to, out);
+}
+
+/**
+ * @brief Combina los sketches de un rango de cubetas.
+ *
+ * @details
+ * Solo se leen las filas de `metric_rollups` (una por cubeta), nunca las filas
+ * crudas de `metrics`. Un mes de cubetas de 60 s son ~43 000 merges, cada uno
+ * de unos pocos cientos de contadores. La consulta recorre idx_rollups_series_id_time.
+ *
+ * Los BLOB que no se pueden deserializar se ignoran en lugar de abortar la consulta.
+ */
+bool DatabaseManager::loadSketch(long long seriesId, long long from, long long to, DDSketch& out) {
+    std::lock_guard<std::mutex> lock(mutex);
+    out.clear();
+    if (!db) return false;
+
+    const char* sql = "SELECT sketch FROM metric_rollups "
+                      "WHERE series_id = ? AND bucket_start BETWEEN ? AND ?;";
+    sqlite3_stmt* stmt;
+
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        return false;
+    }
+    sqlite3_bind_int64(stmt, 1, seriesId);
+    sqlite3_bind_int64(stmt, 2, from);
+    sqlite3_bind_int64(stmt, 3, to);
+
+    DDSketch bucket(out.relativeAccuracy());
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        const void* data = sqlite3_column_blob(stmt, 0);
+        int size = sqlite3_column_bytes(stmt, 0);
+        if (bucket.deserialize(data, static_cast<size_t>(size))) {
+            out.merge(bucket);
+        }
+    }
+    sqlite3_finalize(stmt);
+    return rc == SQLITE_DONE;
+}
+
+/**
+ * @brief Histograma de la serie sin etiquetas component/metric (ver loadSeries).
+ */
+bool DatabaseManager::loadHistogram(const std::string& component, const std::string& metric,
+                                    long long from, long long to, Histogram& out, std::size_t* skipped) {
+    long long seriesId;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!db) {
+            out = Histogram();
+            if (skipped) *skipped = 0;
+            return false;
+        }
+        seriesId = unlabeledSeries(component, metric);
+    }
+    if (seriesId == 0) {
+        out = Histogram();
+        if (skipped) *skipped = 0;
+        return true;
+    }
+    return loadHistogram(seriesId, from, to, out, skipped);
+}
+
+/**
+ * @brief Combina los histogramas de un rango de cubetas.
+ *
+ * @details Igual que loadSketch, pero para las series de distribución. Las
+ * cubetas con cubetas de histograma distintas a las de la primera (el colector
+ * cambió su configuración) no se pueden combinar y se cuentan en @p skipped.
+ */
+bool DatabaseManager::loadHistogram(long long seriesId, long long from, long long to, Histogram& out,
+                                    std::size_t* skipped) {
+    std::lock_guard<std::mutex> lock(mutex);
+    out = Histogram();
+    if (skipped) *skipped = 0;
+    if (!db) return false;
+
+    const char* sql = "SELECT histogram FROM metric_rollups "
+                      "WHERE series_id = ? AND bucket_start BETWEEN ? AND ? AND histogram IS NOT NULL "
+                      "ORDER BY bucket_start;";
+    sqlite3_stmt* stmt;
+
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        return false;
+    }
+    sqlite3_bind_int64(stmt, 1, seriesId);
+    sqlite3_bind_int64(stmt, 2, from);
+    sqlite3_bind_int64(stmt, 3, to);
+
+    Histogram bucket;
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        const void* data = sqlite3_column_blob(stmt, 0);
+        int size = sqlite3_column_bytes(stmt, 0);
+        if (!bucket.deserialize(data, static_cast<size_t>(size)) || !out.merge(bucket)) {
+            if (skipped) ++*skipped;
+        }
+    }
+    sqlite3_finalize(stmt);
+    return rc == SQLITE_DONE;
+}
+
+/**
+ * @brief Recorre las métricas de un rango sin cargarlas en memoria.
+ *
+ * @details
+ * Las filas se entregan una a una en el mismo objeto Metric: sus strings
+ * reutilizan la capacidad ya reservada, así que recorrer millones de filas no
+ * reserva memoria por fila. El recorrido usa idx_metrics_time; las etiquetas
+ * salen de seriesIndex por el `series_id` de la fila.
+ */
+bool DatabaseManager::scanMetrics(long long from, long long to, const std::function<bool(const Metric&)>& visitor,
+                                  const std::vector<long long>& seriesIds) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!db || !loadSeriesFilter(db, seriesIds)) return false;
+
+    std::string sql = "SELECT component, metric, value, unit, timestamp, histogram, kind, series_id FROM metrics "
+                      "WHERE timestamp BETWEEN ? AND ?";
+    appendSeriesFilter(sql, seriesIds);
+    sql += " ORDER BY timestamp;";
+    sqlite3_stmt* stmt;
+
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        return false;
+    }
+    sqlite3_bind_int64(stmt, 1, from);
+    sqlite3_bind_int64(stmt, 2, to);
+
+    Metric m;
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        m.component.assign(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)),
+                           static_cast<size_t>(sqlite3_column_bytes(stmt, 0)));
+        m.metric.assign(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1)),
+                        static_cast<size_t>(sqlite3_column_bytes(stmt, 1)));
+        m.value = sqlite3_column_double(stmt, 2);
+        m.unit.assign(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3)),
+                      static_cast<size_t>(sqlite3_column_bytes(stmt, 3)));
+        m.timestamp = sqlite3_column_int64(stmt, 4);
+        m.kind = sqlite3_column_int(stmt, 6) == 1 ? MetricKind::Counter : MetricKind::Gauge;
+        const LabeledSeries* series = seriesIndex.get(sqlite3_column_int64(stmt, 7));
+        if (series) m.labels = series->labels;
+        else m.labels.clear();
+        m.histogram.reset();
+        if (sqlite3_column_type(stmt, 5) == SQLITE_BLOB) {
+            auto histogram = std::make_shared<Histogram>();
+            if (histogram->deserialize(sqlite3_column_blob(stmt, 5), static_cast<size_t>(sqlite3_column_bytes(stmt, 5)))) {
+                m.histogram = std::move(histogram);
+            }
+        }
+        if (!visitor(m)) {
+            rc = SQLITE_DONE;
+            break;
+        }
+    }
+    sqlite3_finalize(stmt);
+    return rc == SQLITE_DONE;
+}
+
+/**
+ * @brief Recorre las cubetas de rollup de un rango, con su sketch ya deserializado.
+ * @details Como en scanMetrics, las etiquetas salen de seriesIndex por el `series_id` de la fila.
+ */
+bool DatabaseManager::scanRollups(long long from, long long to, const std::function<bool(const RollupRow&)>& visitor,
+                                  const std::vector<long long>& seriesIds) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!db || !loadSeriesFilter(db, seriesIds)) return false;
+
+    std::string sql = "SELECT component, metric, unit, bucket_start, bucket_seconds, count, sum, min, max, sketch, histogram, "
+                      "series_id FROM metric_rollups WHERE bucket_start BETWEEN ? AND ?";
+    appendSeriesFilter(sql, seriesIds);
+    sql += " ORDER BY bucket_start;";
+    sqlite3_stmt* stmt;
+
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        return false;
+    }
+    sqlite3_bind_int64(stmt, 1, from);
+    sqlite3_bind_int64(stmt, 2, to);
+
+    RollupRow row;
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        row.component.assign(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)),
+                             static_cast<size_t>(sqlite3_column_bytes(stmt, 0)));
+        row.metric.assign(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1)),
+                          static_cast<size_t>(sqlite3_column_bytes(stmt, 1)));
+        row.unit.assign(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2)),
+                        static_cast<size_t>(sqlite3_column_bytes(stmt, 2)));
+        row.bucketStart = sqlite3_column_int64(stmt, 3);
+        row.bucketSeconds = sqlite3_column_int(stmt, 4);
+        row.count = static_cast<std::uint64_t>(sqlite3_column_int64(stmt, 5));
+        row.sum = sqlite3_column_double(stmt, 6);
+        row.min = sqlite3_column_double(stmt, 7);
+        row.max = sqlite3_column_double(stmt, 8);
+        if (!row.sketch.deserialize(sqlite3_column_blob(stmt, 9), static_cast<size_t>(sqlite3_column_bytes(stmt, 9)))) {
+            row.sketch.clear();
+        }
+        if (sqlite3_column_type(stmt, 10) != SQLITE_BLOB ||
+            !row.histogram.deserialize(sqlite3_column_blob(stmt, 10), static_cast<size_t>(sqlite3_column_bytes(stmt, 10)))) {
+            row.histogram = Histogram();
+        }
+        row.seriesId = sqlite3_column_int64(stmt, 11);
+        const LabeledSeries* series = seriesIndex.get(row.seriesId);
+        if (series) row.labels = series->labels;
+        else row.labels.clear();
+        if (!visitor(row)) {
+            rc = SQLITE_DONE;
+            break;
+        }
+    }
+    sqlite3_finalize(stmt);
+    return rc == SQLITE_DONE;
+}
+
+/**
+ * @brief Guarda eventos de alerta.
+ *
+ * @details El estado se guarda como texto ("firing" / "resolved") para que el
+ * historial se pueda leer directamente con cualquier cliente SQL.
+ */
+bool DatabaseManager::insertAlertEvents(const std::vector<AlertEvent>& events) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!db) return false;
+    if (events.empty()) return true;
+
+    std::vector<long long> seriesIds;
+    std::vector<Metric> keys = seriesOf(events);
+    if (!resolveSeries(keys.data(), keys.size(), seriesIds)) {
+        return false;
+    }
+
+    if (sqlite3_exec(db, "BEGIN TRANSACTION;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        return false;
+    }
+
+    const char* sql = "INSERT INTO alert_events (rule, component, metric, state, value, timestamp, series_id) "
+                      "VALUES (?, ?, ?, ?, ?, ?, ?);";
+    sqlite3_stmt* stmt;
+
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+        return false;
+    }
+
+    bool ok = true;
+    for (std::size_t i = 0; i < events.size(); ++i) {
+        const AlertEvent& e = events[i];
+        sqlite3_bind_text(stmt, 1, e.rule.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 2, e.component.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 3, e.metric.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 4, e.firing ? "firing" : "resolved", -1, SQLITE_STATIC);
+        sqlite3_bind_double(stmt, 5, e.value);
+        sqlite3_bind_int64(stmt, 6, e.timestamp);
+        sqlite3_bind_int64(stmt, 7, seriesIds[i]);
+
+        if (sqlite3_step(stmt) != SQLITE_DONE) {
+            ok = false;
+            break;
+        }
+        sqlite3_reset(stmt);
+    }
+    sqlite3_finalize(stmt);
+
+    if (!ok || sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+        return false;
+    }
+    return true;
+}
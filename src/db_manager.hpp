@@ -8,9 +8,16 @@
  */
 
 #pragma once
+#include <functional>
+#include <mutex>
 #include <string>
+#include <vector>
 #include <sqlite3.h> // Le diremos al compilador dónde buscarlo
-#include "monitor.hpp" // Para struct Metric
+#include "metric.hpp" // Para struct Metric
+#include "aggregation.hpp" // Para SeriesColumns
+#include "rollup.hpp" // Para RollupRow y DDSketch
+#include "alert_engine.hpp" // Para AlertEvent
+#include "series_index.hpp" // Para SeriesIndex y SeriesSelector
 
 /**
  * @class DatabaseManager
@@ -19,16 +26,49 @@
  * - Abre la conexión en el constructor.
  * - Cierra la conexión en el destructor.
  * También se encarga de verificar y crear el esquema de tablas necesario.
+ *
+ * Se puede usar desde varios hilos: cada operación pública toma un mutex interno
+ * durante toda su transacción.
+ *
+ * Cada combinación component/metric/etiquetas es una fila de la tabla `series`
+ * (sus etiquetas, una fila por par en `series_labels`) y cada muestra guarda su
+ * `series_id`. La tabla se carga al conectar en un SeriesIndex, así que
+ * selectSeries() se resuelve en memoria sin tocar las muestras.
  */
 class DatabaseManager {
 private:
     sqlite3* db;    ///< Puntero nativo (Handle) a la conexión de SQLite.
+    std::mutex mutex; ///< Serializa las operaciones: la conexión se comparte entre hilos y cada transacción debe quedar completa.
+    SeriesIndex seriesIndex; ///< Copia en memoria de `series` y `series_labels`.
+    std::string keyBuffer;   ///< Clave de serie reutilizada entre filas.
 
     /**
      * @brief Método interno para inicializar el esquema de la base de datos.
      * Ejecuta sentencias DDL (CREATE TABLE) si las tablas no existen.
      */
     bool initTables();
+
+    /**
+     * @brief Agrega una columna a una tabla ya existente (migración de bases anteriores).
+     * @return true si la columna ya existía o se pudo agregar.
+     */
+    bool ensureColumn(const char* table, const char* column, const char* type);
+
+    /**
+     * @brief Asigna series a las muestras anteriores a las etiquetas y carga `series` en seriesIndex.
+     */
+    bool loadSeriesIndex();
+
+    /**
+     * @brief Obtiene el id de serie de cada métrica, creando las series nuevas.
+     * @details Las series nuevas se guardan en su propia transacción, antes de la
+     * de las muestras: si el lote se revierte, el índice no queda con ids inexistentes.
+     * @param ids Id de serie de cada métrica, en el mismo orden.
+     */
+    bool resolveSeries(const Metric* metrics, std::size_t count, std::vector<long long>& ids);
+
+    /** @brief Id de la serie sin etiquetas component/metric (0 si no existe). Requiere el mutex tomado. */
+    long long unlabeledSeries(const std::string& component, const std::string& metric);
     
 public:
     /**
@@ -49,6 +89,19 @@ public:
      */
     ~DatabaseManager();
 
+    /**
+     * @brief Cierra la conexión explícitamente (el destructor ya no tendrá nada que hacer).
+     * @return true si SQLite cerró la conexión sin sentencias pendientes.
+     */
+    bool close();
+
+    /**
+     * @brief Vuelca el WAL al archivo principal y lo trunca.
+     * @details Sin efecto si la base no está en modo WAL.
+     * @return true si el checkpoint se completó.
+     */
+    bool checkpoint();
+
     /**
      * @brief Inserta una nueva métrica genérica en la base de datos.
      * @param metric Objeto Metric con los datos a guardar.
@@ -56,4 +109,112 @@ public:
      * @return false Si hubo un error de SQL o la base de datos no está conectada.
      */
     bool insertMetric(const Metric& metric);
+
+    /**
+     * @brief Inserta un lote de métricas dentro de una única transacción.
+     * @param metrics Métricas a guardar, en el orden en que se recibieron.
+     * @return true Si todo el lote quedó confirmado (COMMIT).
+     * @return false Si alguna inserción falló; en ese caso el lote completo se descarta (ROLLBACK).
+     */
+    bool insertMetrics(const std::vector<Metric>& metrics);
+
+    /**
+     * @brief Aplica una directiva PRAGMA sobre la conexión activa.
+     * @param pragma Directiva sin el prefijo "PRAGMA" (por ejemplo "journal_mode=WAL").
+     * @return true si SQLite aceptó la directiva.
+     */
+    bool applyPragma(const std::string& pragma);
+
+    /**
+     * @brief Carga un rango de una serie en formato columnar.
+     * @param component Componente de la serie (ej. "CPU").
+     * @param metric Nombre de la métrica (ej. "Usage").
+     * @param from Timestamp inicial (inclusive).
+     * @param to Timestamp final (inclusive).
+     * @param out Columnas destino; se vacían antes de cargar.
+     * @return true si la consulta se ejecutó (aunque no haya filas).
+     */
+    bool loadSeries(const std::string& component, const std::string& metric,
+                    long long from, long long to, SeriesColumns& out);
+
+    /**
+     * @brief Carga un rango de la serie @p seriesId (ver selectSeries) en formato columnar.
+     * @details La versión por component/metric carga la serie sin etiquetas.
+     */
+    bool loadSeries(long long seriesId, long long from, long long to, SeriesColumns& out);
+
+    /**
+     * @brief Series que cumplen el selector, resuelto con el índice invertido en memoria.
+     * @param out Series encontradas, en orden de id; se vacía antes de cargar.
+     * @return true si la base está conectada (aunque no haya series).
+     */
+    bool selectSeries(const SeriesSelector& selector, std::vector<LabeledSeries>& out);
+
+    /**
+     * @brief Tasas por segundo de un contador guardado crudo (kind = Counter), con detección de reinicios.
+     * @param out Tasas en formato columnar; cada una lleva el timestamp del final de su intervalo.
+     * @param resets Si no es nulo, recibe la cantidad de reinicios del contador en el rango.
+     * @return true si la consulta se ejecutó (aunque no haya tasas).
+     */
+    bool loadRates(const std::string& component, const std::string& metric,
+                   long long from, long long to, SeriesColumns& out, std::size_t* resets = nullptr);
+
+    /** @brief Igual que loadRates, para la serie @p seriesId. */
+    bool loadRates(long long seriesId, long long from, long long to, SeriesColumns& out,
+                   std::size_t* resets = nullptr);
+
+    /**
+     * @brief Guarda cubetas de rollup (con su sketch serializado) en una única transacción.
+     * @details La serie de cada cubeta se resuelve por sus etiquetas, como en insertMetrics.
+     * @param rows Cubetas cerradas por RollupManager.
+     * @return true si todas se guardaron.
+     */
+    bool insertRollups(const std::vector<RollupRow>& rows);
+
+    /**
+     * @brief Combina los sketches de todas las cubetas de la serie @p seriesId cuyo inicio está en [from, to].
+     * @param out Sketch resultado; se vacía antes de combinar. Luego se consulta con out.quantile(q).
+     * @return true si la consulta se ejecutó (aunque no haya cubetas).
+     */
+    bool loadSketch(long long seriesId, long long from, long long to, DDSketch& out);
+
+    /** @brief Igual que loadSketch, para la serie sin etiquetas component/metric. */
+    bool loadSketch(const std::string& component, const std::string& metric,
+                    long long from, long long to, DDSketch& out);
+
+    /**
+     * @brief Combina los histogramas de todas las cubetas de una serie de distribución con inicio en [from, to].
+     * @param out Histograma resultado; luego se consulta con out.quantile(q).
+     * @param skipped Si no es nulo, recibe cuántas cubetas no se pudieron combinar (cubetas de histograma distintas).
+     * @return true si la consulta se ejecutó (aunque no haya cubetas).
+     */
+    bool loadHistogram(long long seriesId, long long from, long long to, Histogram& out,
+                       std::size_t* skipped = nullptr);
+
+    /** @brief Igual que loadHistogram, para la serie sin etiquetas component/metric. */
+    bool loadHistogram(const std::string& component, const std::string& metric,
+                       long long from, long long to, Histogram& out, std::size_t* skipped = nullptr);
+
+    /**
+     * @brief Recorre las métricas con timestamp en [from, to], en orden de tiempo, sin cargarlas en memoria.
+     * @param visitor Se llama con cada fila (el objeto se reutiliza entre filas; trae el histograma y las etiquetas si los tiene); devolver false detiene el recorrido.
+     * @param seriesIds Solo estas series (ver selectSeries); vacío = todas.
+     * @return true si la consulta terminó sin errores (también si el visitante la detuvo).
+     */
+    bool scanMetrics(long long from, long long to, const std::function<bool(const Metric&)>& visitor,
+                     const std::vector<long long>& seriesIds = {});
+
+    /**
+     * @brief Recorre las cubetas de rollup con inicio en [from, to], en orden de tiempo.
+     * @param visitor Igual que en scanMetrics; el sketch llega deserializado y la fila trae su serie y etiquetas.
+     */
+    bool scanRollups(long long from, long long to, const std::function<bool(const RollupRow&)>& visitor,
+                     const std::vector<long long>& seriesIds = {});
+
+    /**
+     * @brief Registra eventos de alerta (disparadas y resueltas) en una única transacción.
+     * @details Cada evento guarda el `series_id` de la serie (con sus etiquetas) que cambió de estado.
+     * @return true si todos se guardaron.
+     */
+    bool insertAlertEvents(const std::vector<AlertEvent>& events);
 };
\ No newline at end of file
@@ -0,0 +1,129 @@
+/**
+ * @file db_sink.cpp
+ * @brief Implementación de DatabaseSink.
+ * @author Sergio Gonzalez
+ * @date 2026-03-28
+ */
+
+#include "db_sink.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iterator>
+#include "logger.hpp"
+
+namespace {
+
+/// Muestras de la cola local que se reinsertan como máximo por lote, para no alargar cada escritura.
+constexpr std::size_t kSpoolReplayChunk = 5000;
+
+bool isNonFinite(const Metric& m) {
+    return !std::isfinite(m.value);
+}
+
+} // namespace
+
+DatabaseSink::DatabaseSink(DatabaseManager& database, const std::string& spoolPath, std::size_t spoolCapacity)
+    : db(database), rollups(60) {
+    if (spoolPath.empty()) return;
+    if (!spool.open(spoolPath, spoolCapacity)) {
+        Logger::error("No se pudo abrir la cola local; los lotes fallidos se perderán.", {{"path", spoolPath}});
+    } else if (spool.pending() > 0) {
+        Logger::info("Registros pendientes en la cola local.", {{"pending", spool.pending()}});
+    }
+}
+
+void DatabaseSink::saveRollups() {
+    rollupRows.clear();
+    rollups.takeCompleted(rollupRows);
+    if (!rollupRows.empty() && !db.insertRollups(rollupRows) && failureLog.allow()) {
+        Logger::error("Fallo al guardar rollups en DB.",
+                      {{"rollups", rollupRows.size()}, {"suppressed", failureLog.suppressed()}});
+    }
+}
+
+bool DatabaseSink::write(const std::vector<Metric>& input) {
+    // Lo normal es que no haya ninguna: solo entonces se paga la copia.
+    const std::vector<Metric>* filtered = &input;
+    if (std::any_of(input.begin(), input.end(), isNonFinite)) {
+        finiteBatch.clear();
+        std::remove_copy_if(input.begin(), input.end(), std::back_inserter(finiteBatch), isNonFinite);
+        if (nonFiniteLog.allow()) {
+            Logger::warn("Muestras NaN o infinitas descartadas.",
+                         {{"samples", input.size() - finiteBatch.size()}, {"suppressed", nonFiniteLog.suppressed()}});
+        }
+        filtered = &finiteBatch;
+    }
+    const std::vector<Metric>& batch = *filtered;
+
+    bool ok = true;
+    if (!batch.empty()) {
+        // Todo el lote en una sola transacción. Si la base falla, el lote va a la
+        // cola local y se reintenta en los lotes siguientes.
+        // Mientras la base no responda esto pasa en cada lote: el aviso se limita.
+        if (!db.insertMetrics(batch)) {
+            if (spool.isOpen()) {
+                spool.append(batch);
+            } else {
+                ok = false;
+            }
+            if (failureLog.allow()) {
+                Logger::error("Fallo al guardar métricas en DB.",
+                              {{"metrics", batch.size()}, {"spooled", spool.isOpen() ? spool.pending() : 0},
+                               {"suppressed", failureLog.suppressed()}});
+            }
+        } else if (spool.isOpen() && spool.pending() > 0) {
+            // La base responde: reinsertamos un tramo acotado de la cola.
+            // La cola pudo guardar muestras no finitas antes de que se filtraran aquí.
+            replayBatch.clear();
+            std::size_t n = spool.peek(replayBatch, kSpoolReplayChunk);
+            replayBatch.erase(std::remove_if(replayBatch.begin(), replayBatch.end(), isNonFinite), replayBatch.end());
+            if (db.insertMetrics(replayBatch)) {
+                spool.consume(n);
+                replayFailures = 0;
+                if (spool.pending() == 0) {
+                    Logger::info("Cola local vaciada en la base de datos.");
+                }
+            } else if (++replayFailures >= kReplayAttempts) {
+                // El lote nuevo entró y este tramo no: el problema es el tramo.
+                Logger::error("Tramo de la cola local rechazado por la base; se descarta.",
+                              {{"records", n}, {"samples", replayBatch.size()}, {"attempts", replayFailures}});
+                spool.consume(n);
+                replayFailures = 0;
+            }
+        }
+
+        for (const Metric& m : batch) {
+            rollups.add(m);
+        }
+        if (rollups.dropped() != reportedDropped && droppedLog.allow()) {
+            Logger::warn("Muestras atrasadas fuera de los rollups (se guardan crudas).",
+                         {{"samples", rollups.dropped() - reportedDropped}});
+            reportedDropped = rollups.dropped();
+        }
+    }
+
+    // Las cubetas se cierran por reloj, aunque el lote venga vacío.
+    auto now = std::chrono::system_clock::now();
+    rollups.closeExpired(std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count());
+    saveRollups();
+
+    // La cola local se lleva al disco una vez por lote, no por muestra.
+    if (spool.isOpen() && spool.pending() > 0) {
+        spool.flush();
+    }
+    return ok;
+}
+
+bool DatabaseSink::flush() {
+    rollups.flushAll();
+    saveRollups();
+
+    if (spool.isOpen()) {
+        spool.flush();
+        if (spool.pending() > 0) {
+            Logger::info("Registros en la cola local para el próximo inicio.", {{"pending", spool.pending()}});
+        }
+    }
+    return true;
+}
@@ -0,0 +1,66 @@
+/**
+ * @file db_sink.hpp
+ * @brief Sink de SQLite: métricas crudas, cola local ante fallos y rollups por minuto.
+ * @author Sergio Gonzalez
+ * @date 2026-03-28
+ */
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "db_manager.hpp"
+#include "logger.hpp"
+#include "rollup.hpp"
+#include "sink.hpp"
+#include "spool.hpp"
+
+/**
+ * @class DatabaseSink
+ * @brief Guarda cada lote en DatabaseManager.
+ *
+ * @details
+ * - Cada lote va en una sola transacción (insertMetrics).
+ * - Si la base rechaza el lote, se escribe en la cola local (MetricSpool) y se
+ *   reinserta por tramos cuando la base vuelve a responder.
+ * - Los resúmenes por minuto (RollupManager) se alimentan aquí y se guardan
+ *   cuando se cierra cada cubeta; flush() guarda las cubetas abiertas.
+ * - Las muestras NaN o infinitas se descartan antes de todo eso: la columna
+ *   `value` es NOT NULL y SQLite guarda NaN como NULL, así que una sola haría
+ *   fallar el lote entero.
+ * - Un tramo de la cola local que falla kReplayAttempts veces seguidas con la
+ *   base respondiendo se descarta, para que no trabe a todo lo que viene detrás.
+ */
+class DatabaseSink : public MetricSink {
+private:
+    DatabaseManager& db;
+    MetricSpool spool;
+    std::vector<Metric> replayBatch;   ///< Tramo de la cola en reinserción (reutilizado).
+    std::size_t replayFailures = 0;    ///< Intentos fallidos seguidos del tramo actual.
+    std::vector<Metric> finiteBatch;   ///< Copia del lote sin valores no finitos, solo si hace falta.
+    RollupManager rollups;
+    std::vector<RollupRow> rollupRows; ///< Cubetas cerradas (reutilizado).
+    LogRateLimiter failureLog;         ///< Avisos de fallo de la base (uno por lote si no se limitan).
+    LogRateLimiter droppedLog;         ///< Avisos de muestras atrasadas (un reenvío del agente trae muchas).
+    LogRateLimiter nonFiniteLog;       ///< Avisos de muestras NaN o infinitas descartadas.
+    std::uint64_t reportedDropped = 0; ///< RollupManager::dropped() ya avisado.
+
+    void saveRollups();
+
+public:
+    /// Intentos de un mismo tramo de la cola local antes de descartarlo.
+    static constexpr std::size_t kReplayAttempts = 3;
+
+    /**
+     * @param db Base ya conectada.
+     * @param spoolPath Archivo de la cola local (vacío = sin cola).
+     * @param spoolCapacity Registros de la cola (128 bytes cada uno; una muestra ocupa uno o más).
+     */
+    DatabaseSink(DatabaseManager& db, const std::string& spoolPath, std::size_t spoolCapacity = 262144);
+
+    const char* name() const override { return "sqlite"; }
+
+    bool write(const std::vector<Metric>& batch) override;
+
+    /** @brief Guarda los rollups abiertos y lleva la cola local al disco. */
+    bool flush() override;
+};
@@ -0,0 +1,234 @@
+/**
+ * @file ddsketch.cpp
+ * @brief Implementación de DDSketch.
+ *
+ * @details
+ * Para un valor x > 0 su cubeta es i = ceil(log(x) / log(gamma)). Al estimar un
+ * percentil se devuelve el punto de la cubeta que minimiza el error relativo:
+ * 2 * gamma^i / (gamma + 1). Cualquier valor de la cubeta está a menos de alpha
+ * (en términos relativos) de ese punto.
+ *
+ * @author Sergio Gonzalez
+ * @date 2026-02-07
+ */
+
+#include "ddsketch.hpp"
+#include "varint.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+/// Valores con magnitud menor a esta se cuentan como cero (evita índices enormes).
+constexpr double kMinIndexableValue = 1e-9;
+
+/// Tope del índice de cubeta: con alpha = 0.001 el mayor double cae en ~355000; con un alpha
+/// mucho más chico, log(x) / log(gamma) no cabría en un int ni en memoria.
+constexpr double kMaxIndex = 1 << 20;
+
+/// Versión del formato binario de serialize().
+constexpr unsigned char kFormatVersion = 1;
+
+} // namespace
+
+void DDSketch::Store::add(int index, std::uint64_t count) {
+    if (counts.empty()) {
+        offset = index;
+        counts.assign(1, count);
+        return;
+    }
+    if (index < offset) {
+        // Agrandamos hacia abajo: se insertan ceros al inicio.
+        counts.insert(counts.begin(), static_cast<std::size_t>(offset - index), 0);
+        offset = index;
+    } else if (index >= offset + static_cast<int>(counts.size())) {
+        counts.resize(static_cast<std::size_t>(index - offset) + 1, 0);
+    }
+    counts[static_cast<std::size_t>(index - offset)] += count;
+}
+
+void DDSketch::Store::collapseTo(std::size_t maxBins) {
+    if (counts.size() <= maxBins) return;
+
+    // Las cubetas más bajas se suman en la primera que sobrevive.
+    std::size_t excess = counts.size() - maxBins;
+    std::uint64_t collapsed = 0;
+    for (std::size_t i = 0; i < excess; ++i) collapsed += counts[i];
+    counts.erase(counts.begin(), counts.begin() + static_cast<std::ptrdiff_t>(excess));
+    counts[0] += collapsed;
+    offset += static_cast<int>(excess);
+}
+
+DDSketch::DDSketch(double relativeAccuracy, std::size_t bins)
+    : alpha(relativeAccuracy), maxBins(bins == 0 ? 1 : bins) {
+    if (!(alpha > 0.0 && alpha < 1.0)) alpha = 0.01;
+    gamma = (1.0 + alpha) / (1.0 - alpha);
+    logGamma = std::log(gamma);
+    clear();
+}
+
+void DDSketch::clear() {
+    positive = Store();
+    negative = Store();
+    zeroCount = 0;
+    total = 0;
+    minValue = std::numeric_limits<double>::infinity();
+    maxValue = -std::numeric_limits<double>::infinity();
+    sumValue = 0.0;
+}
+
+int DDSketch::indexOf(double magnitude) const {
+    double index = std::ceil(std::log(magnitude) / logGamma);
+    return static_cast<int>(std::clamp(index, -kMaxIndex, kMaxIndex));
+}
+
+double DDSketch::valueOf(int index) const {
+    return 2.0 * std::exp(index * logGamma) / (gamma + 1.0);
+}
+
+void DDSketch::add(double value) {
+    // NaN e infinito no tienen cubeta (y arruinarían min, max y la suma).
+    if (!std::isfinite(value)) return;
+
+    if (value > kMinIndexableValue) {
+        positive.add(indexOf(value), 1);
+        positive.collapseTo(maxBins);
+    } else if (value < -kMinIndexableValue) {
+        negative.add(indexOf(-value), 1);
+        negative.collapseTo(maxBins);
+    } else {
+        ++zeroCount;
+    }
+
+    ++total;
+    minValue = std::min(minValue, value);
+    maxValue = std::max(maxValue, value);
+    sumValue += value;
+}
+
+bool DDSketch::merge(const DDSketch& other) {
+    if (std::fabs(alpha - other.alpha) > 1e-12) return false;
+    if (other.total == 0) return true;
+
+    auto mergeStore = [this](Store& into, const Store& from) {
+        if (from.counts.empty()) return;
+        // Dos add() en los extremos dejan el vector ya dimensionado para todo el rango.
+        into.add(from.offset, 0);
+        into.add(from.offset + static_cast<int>(from.counts.size()) - 1, 0);
+        std::size_t base = static_cast<std::size_t>(from.offset - into.offset);
+        for (std::size_t i = 0; i < from.counts.size(); ++i) {
+            into.counts[base + i] += from.counts[i];
+        }
+        into.collapseTo(maxBins);
+    };
+
+    mergeStore(positive, other.positive);
+    mergeStore(negative, other.negative);
+    zeroCount += other.zeroCount;
+    total += other.total;
+    minValue = std::min(minValue, other.minValue);
+    maxValue = std::max(maxValue, other.maxValue);
+    sumValue += other.sumValue;
+    return true;
+}
+
+/**
+ * @brief Estima un percentil recorriendo las cubetas en orden de valor.
+ *
+ * @details
+ * Orden de recorrido: negativos (de mayor a menor magnitud), ceros, positivos
+ * (de menor a mayor). Se busca la cubeta donde el conteo acumulado supera el
+ * rango q * (n - 1). El resultado se acota a [min, max] exactos, por lo que
+ * p0 y p100 son siempre precisos.
+ */
+double DDSketch::quantile(double q) const {
+    if (total == 0) return 0.0;
+    q = std::clamp(q, 0.0, 1.0);
+
+    double rank = q * static_cast<double>(total - 1);
+    double accumulated = 0.0;
+    double estimate = maxValue;
+    bool found = false;
+
+    for (std::size_t i = negative.counts.size(); i-- > 0 && !found;) {
+        accumulated += static_cast<double>(negative.counts[i]);
+        if (accumulated > rank) {
+            estimate = -valueOf(negative.offset + static_cast<int>(i));
+            found = true;
+        }
+    }
+    if (!found) {
+        accumulated += static_cast<double>(zeroCount);
+        if (accumulated > rank) {
+            estimate = 0.0;
+            found = true;
+        }
+    }
+    for (std::size_t i = 0; i < positive.counts.size() && !found; ++i) {
+        accumulated += static_cast<double>(positive.counts[i]);
+        if (accumulated > rank) {
+            estimate = valueOf(positive.offset + static_cast<int>(i));
+            found = true;
+        }
+    }
+
+    return std::clamp(estimate, minValue, maxValue);
+}
+
+std::string DDSketch::serialize() const {
+    std::string out;
+    out.reserve(48 + positive.counts.size() + negative.counts.size());
+
+    out.push_back(static_cast<char>(kFormatVersion));
+    varint::putDouble(out, alpha);
+    varint::put(out, total);
+    varint::put(out, zeroCount);
+    varint::putDouble(out, minValue);
+    varint::putDouble(out, maxValue);
+    varint::putDouble(out, sumValue);
+
+    for (const Store* store : {&positive, &negative}) {
+        varint::putSigned(out, store->offset);
+        varint::put(out, store->counts.size());
+        for (std::uint64_t c : store->counts) {
+            varint::put(out, c);
+        }
+    }
+    return out;
+}
+
+bool DDSketch::deserialize(const void* data, std::size_t size) {
+    varint::Reader in(data, size);
+
+    unsigned char version;
+    double storedAlpha;
+    if (!in.getByte(version) || version != kFormatVersion) return false;
+    if (!in.getDouble(storedAlpha) || !(storedAlpha > 0.0 && storedAlpha < 1.0)) return false;
+
+    DDSketch result(storedAlpha, maxBins);
+    if (!in.get(result.total) || !in.get(result.zeroCount)) return false;
+    if (!in.getDouble(result.minValue) || !in.getDouble(result.maxValue) || !in.getDouble(result.sumValue)) {
+        return false;
+    }
+
+    std::uint64_t binsTotal = result.zeroCount;
+    for (Store* store : {&result.positive, &result.negative}) {
+        std::int64_t offset;
+        std::uint64_t bins;
+        if (!in.getSigned(offset) || !in.get(bins)) return false;
+        // Cada contador ocupa al menos un byte: un tamaño mayor es un BLOB corrupto.
+        if (bins > in.remaining()) return false;
+
+        store->offset = static_cast<int>(offset);
+        store->counts.resize(static_cast<std::size_t>(bins));
+        for (std::uint64_t& c : store->counts) {
+            if (!in.get(c)) return false;
+            binsTotal += c;
+        }
+    }
+    if (binsTotal != result.total) return false;
+
+    *this = std::move(result);
+    return true;
+}
@@ -0,0 +1,104 @@
+/**
+ * @file ddsketch.hpp
+ * @brief Sketch de cuantiles DDSketch: percentiles aproximados sin guardar las muestras.
+ * @details
+ * DDSketch divide la recta numérica en cubetas de tamaño geométrico: la cubeta i
+ * cubre (gamma^(i-1), gamma^i], con gamma = (1 + alpha) / (1 - alpha).
+ * Cada muestra solo incrementa el contador de su cubeta, así que:
+ *  - El error RELATIVO de cualquier percentil es como máximo alpha (1% por defecto).
+ *  - Dos sketches se combinan sumando contadores cubeta a cubeta (merge exacto).
+ *  - El tamaño depende del rango de valores, no de la cantidad de muestras.
+ *
+ * Referencia: Masson, Rim, Lee. "DDSketch: A Fast and Fully-Mergeable Quantile
+ * Sketch with Relative-Error Guarantees" (VLDB 2019).
+ * @author Sergio Gonzalez
+ * @date 2026-02-07
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @class DDSketch
+ * @brief Sketch de cuantiles con error relativo acotado y merge exacto.
+ */
+class DDSketch {
+private:
+    /**
+     * @struct Store
+     * @brief Contadores de cubetas contiguas a partir de un índice inicial.
+     * @details Se usa un vector denso (y no un mapa) porque las métricas reales
+     * ocupan un rango de cubetas compacto y así agregar es O(1) sin reservas.
+     */
+    struct Store {
+        int offset = 0;                       ///< Índice de la cubeta counts[0].
+        std::vector<std::uint64_t> counts;    ///< Contadores por cubeta.
+
+        void add(int index, std::uint64_t count);
+        void collapseTo(std::size_t maxBins); ///< Funde las cubetas más bajas si se supera el límite.
+    };
+
+    double alpha;            ///< Precisión relativa garantizada.
+    double gamma;            ///< Razón entre límites de cubetas consecutivas.
+    double logGamma;         ///< log(gamma), precalculado.
+    std::size_t maxBins;     ///< Límite de cubetas por lado (acota la memoria).
+
+    Store positive;          ///< Cubetas de valores > 0.
+    Store negative;          ///< Cubetas de |valor| para valores < 0.
+    std::uint64_t zeroCount; ///< Muestras iguales a 0 (o más pequeñas que la precisión mínima).
+    std::uint64_t total;     ///< Cantidad total de muestras.
+    double minValue;         ///< Mínimo exacto observado.
+    double maxValue;         ///< Máximo exacto observado.
+    double sumValue;         ///< Suma exacta de las muestras.
+
+    int indexOf(double magnitude) const;
+    double valueOf(int index) const;
+
+public:
+    /**
+     * @brief Constructor.
+     * @param alpha Error relativo máximo de los percentiles (0.01 = 1%).
+     * @param maxBins Máximo de cubetas por signo; al superarlo se sacrifica precisión en los valores más pequeños.
+     */
+    explicit DDSketch(double alpha = 0.01, std::size_t maxBins = 2048);
+
+    /** @brief Agrega una muestra. NaN e infinito se ignoran. */
+    void add(double value);
+
+    /**
+     * @brief Combina otro sketch en este.
+     * @return false si los sketches usan precisiones distintas (no son combinables).
+     */
+    bool merge(const DDSketch& other);
+
+    /**
+     * @brief Estima el percentil @p q.
+     * @param q Cuantil entre 0 y 1 (0.5 = mediana, 0.99 = p99).
+     * @return Valor estimado; 0 si el sketch está vacío.
+     */
+    double quantile(double q) const;
+
+    std::uint64_t count() const { return total; }
+    double min() const { return minValue; }
+    double max() const { return maxValue; }
+    double sum() const { return sumValue; }
+    double relativeAccuracy() const { return alpha; }
+
+    /** @brief Vacía el sketch manteniendo su precisión. */
+    void clear();
+
+    /**
+     * @brief Serializa el sketch en formato binario compacto (apto para una columna BLOB).
+     * @details Formato: versión, alpha, total, ceros, min, max, suma y luego, por cada
+     * signo, el índice inicial y los contadores como varints.
+     */
+    std::string serialize() const;
+
+    /**
+     * @brief Reconstruye un sketch a partir de serialize().
+     * @return false si el buffer está truncado o no es un sketch válido.
+     */
+    bool deserialize(const void* data, std::size_t size);
+};
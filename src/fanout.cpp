@@ -0,0 +1,180 @@
+/**
+ * @file fanout.cpp
+ * @brief Implementación de FanOut y PipelineStatsCollector.
+ * @author Sergio Gonzalez
+ * @date 2026-03-28
+ */
+
+#include "fanout.hpp"
+
+namespace {
+
+/// Cubetas de la duración de write(): 0,1 ms a ~52 s, duplicando. Fijas, para que los rollups las combinen.
+Histogram writeLatencyLayout() {
+    return Histogram::exponential(0.1, 2.0, 20);
+}
+
+} // namespace
+
+FanOut::FanOut() : running(false) {}
+
+FanOut::~FanOut() {
+    stop();
+}
+
+void FanOut::addSink(std::unique_ptr<MetricSink> sink, std::size_t queueCapacity, OverflowPolicy overflow) {
+    auto lane = std::make_unique<Lane>();
+    lane->sink = std::move(sink);
+    lane->capacity = queueCapacity == 0 ? 1 : queueCapacity;
+    lane->overflow = overflow;
+    lane->writeLatency = writeLatencyLayout();
+    lanes.push_back(std::move(lane));
+}
+
+void FanOut::start() {
+    if (running) return;
+    running = true;
+    for (auto& lane : lanes) {
+        Lane* l = lane.get();
+        l->worker = std::thread([l] { run(*l); });
+    }
+}
+
+/**
+ * @brief Bucle del hilo de un sink.
+ * @details Al pedir la parada no se descarta nada: se terminan de escribir los
+ * lotes encolados y luego se llama a flush().
+ */
+void FanOut::run(Lane& lane) {
+    while (true) {
+        Batch batch;
+        {
+            std::unique_lock<std::mutex> lock(lane.mutex);
+            lane.ready.wait(lock, [&lane] { return lane.stopping || !lane.queue.empty(); });
+            if (lane.queue.empty()) break;  // stopping y sin trabajo
+            batch = std::move(lane.queue.front().first);
+            lane.queue.pop_front();
+        }
+        if (lane.overflow == OverflowPolicy::Block) lane.space.notify_all();
+
+        auto started = Clock::now();
+        bool written = lane.sink->write(*batch);
+        double elapsedMs = std::chrono::duration<double, std::milli>(Clock::now() - started).count();
+        if (written) {
+            lane.writtenSamples += batch->size();
+        } else {
+            ++lane.failedBatches;
+        }
+        {
+            std::lock_guard<std::mutex> lock(lane.mutex);
+            lane.writeLatency.add(elapsedMs);
+        }
+    }
+    lane.sink->flush();
+}
+
+void FanOut::publish(std::vector<Metric>&& batch) {
+    Batch shared = std::make_shared<const std::vector<Metric>>(std::move(batch));
+    batch.clear();
+    auto now = Clock::now();
+
+    for (auto& lane : lanes) {
+        {
+            std::unique_lock<std::mutex> lock(lane->mutex);
+            if (lane->overflow == OverflowPolicy::Block) {
+                // Al detenerse el hilo igual vacía la cola: no hace falta esperar.
+                lane->space.wait(lock, [&] { return lane->stopping || lane->queue.size() < lane->capacity; });
+            } else if (lane->queue.size() >= lane->capacity) {
+                // Cola llena: este sink no da abasto. Se pierde su lote más antiguo.
+                lane->droppedSamples += lane->queue.front().first->size();
+                lane->queue.pop_front();
+            }
+            lane->queue.emplace_back(shared, now);
+        }
+        lane->ready.notify_one();
+    }
+}
+
+void FanOut::stop() {
+    if (!running) return;
+    for (auto& lane : lanes) {
+        {
+            std::lock_guard<std::mutex> lock(lane->mutex);
+            lane->stopping = true;
+        }
+        lane->ready.notify_one();
+        lane->space.notify_all();
+    }
+    for (auto& lane : lanes) {
+        if (lane->worker.joinable()) lane->worker.join();
+    }
+    running = false;
+}
+
+std::vector<SinkStats> FanOut::stats() {
+    std::vector<SinkStats> out;
+    auto now = Clock::now();
+    for (auto& lane : lanes) {
+        SinkStats s;
+        s.name = lane->sink->name();
+        {
+            std::lock_guard<std::mutex> lock(lane->mutex);
+            s.queuedBatches = lane->queue.size();
+            if (!lane->queue.empty()) {
+                s.lagMs = std::chrono::duration<double, std::milli>(now - lane->queue.front().second).count();
+            }
+        }
+        s.writtenSamples = lane->writtenSamples.load();
+        s.droppedSamples = lane->droppedSamples.load();
+        s.failedBatches = lane->failedBatches.load();
+        out.push_back(std::move(s));
+    }
+    return out;
+}
+
+std::vector<Histogram> FanOut::takeWriteLatencies() {
+    std::vector<Histogram> out;
+    out.reserve(lanes.size());
+    for (auto& lane : lanes) {
+        std::lock_guard<std::mutex> lock(lane->mutex);
+        out.push_back(lane->writeLatency);
+        lane->writeLatency.clear();
+    }
+    return out;
+}
+
+PipelineStatsCollector::PipelineStatsCollector(FanOut& f, std::chrono::seconds i)
+    : fanOut(f), interval(i), lastReport(std::chrono::steady_clock::now()) {}
+
+std::size_t PipelineStatsCollector::collect(std::vector<Metric>& out) {
+    auto now = std::chrono::steady_clock::now();
+    if (now - lastReport < interval) return 0;
+
+    double seconds = std::chrono::duration<double>(now - lastReport).count();
+    lastReport = now;
+    long long timestamp = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    std::vector<SinkStats> current = fanOut.stats();
+    std::vector<Histogram> latencies = fanOut.takeWriteLatencies();
+    std::size_t before = out.size();
+    for (std::size_t i = 0; i < current.size(); ++i) {
+        const SinkStats& s = current[i];
+        std::uint64_t written = s.writtenSamples;
+        std::uint64_t dropped = s.droppedSamples;
+        if (i < previous.size()) {
+            written -= previous[i].writtenSamples;
+            dropped -= previous[i].droppedSamples;
+        }
+        out.push_back({"Pipeline", s.name + ".lag", s.lagMs, "ms", timestamp, nullptr});
+        out.push_back({"Pipeline", s.name + ".queue", static_cast<double>(s.queuedBatches), "lotes", timestamp, nullptr});
+        out.push_back({"Pipeline", s.name + ".throughput", static_cast<double>(written) / seconds, "muestras/s", timestamp, nullptr});
+        out.push_back({"Pipeline", s.name + ".dropped", static_cast<double>(dropped), "muestras", timestamp, nullptr});
+        if (i < latencies.size() && latencies[i].count() > 0) {
+            auto latency = std::make_shared<const Histogram>(std::move(latencies[i]));
+            out.push_back({"Pipeline", s.name + ".write_latency", latency->mean(), "ms", timestamp, latency});
+        }
+    }
+    previous = std::move(current);
+    return out.size() - before;
+}
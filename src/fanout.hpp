@@ -0,0 +1,161 @@
+/**
+ * @file fanout.hpp
+ * @brief Etapa de reparto: cada lote de los colectores va a N sinks en paralelo.
+ * @details
+ * Cada sink tiene su propia cola acotada y su propio hilo. publish() solo
+ * encola (no hace E/S), así que un sink lento (una red caída, un disco
+ * saturado) nunca frena a los demás ni al ciclo de muestreo: si su cola se
+ * llena, se descartan SUS lotes más antiguos y se cuentan como pérdidas.
+ *
+ * Un sink agregado con OverflowPolicy::Block no pierde lotes: publish() espera
+ * a que su cola tenga lugar. Lo usa el agregador, que confirma a cada agente
+ * lo publicado y no puede descartarlo después.
+ *
+ * El lote se comparte entre todas las colas (shared_ptr a un vector inmutable),
+ * así que repartirlo a N sinks no copia las muestras.
+ * @author Sergio Gonzalez
+ * @date 2026-03-28
+ */
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "collector.hpp"
+#include "histogram.hpp"
+#include "sink.hpp"
+
+/**
+ * @struct SinkStats
+ * @brief Estado de un sink dentro del reparto.
+ */
+struct SinkStats {
+    std::string name;
+    std::size_t queuedBatches = 0;     ///< Lotes esperando en la cola.
+    double lagMs = 0.0;                ///< Antigüedad del lote más viejo en la cola.
+    std::uint64_t writtenSamples = 0;  ///< Muestras entregadas (acumulado).
+    std::uint64_t droppedSamples = 0;  ///< Muestras descartadas por cola llena (acumulado).
+    std::uint64_t failedBatches = 0;   ///< Lotes en los que write() devolvió false (acumulado).
+};
+
+/**
+ * @enum OverflowPolicy
+ * @brief Qué hace publish() cuando la cola de un sink está llena.
+ */
+enum class OverflowPolicy {
+    DropOldest,   ///< Descarta el lote más antiguo de esa cola (no bloquea).
+    Block         ///< Espera a que el hilo del sink saque un lote.
+};
+
+/**
+ * @class FanOut
+ * @brief Reparte lotes a varios sinks, cada uno con cola e hilo propios.
+ */
+class FanOut {
+private:
+    using Batch = std::shared_ptr<const std::vector<Metric>>;
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @struct Lane
+     * @brief Un sink con su cola y su hilo.
+     */
+    struct Lane {
+        std::unique_ptr<MetricSink> sink;
+        std::size_t capacity;                                ///< Lotes máximos en cola.
+        OverflowPolicy overflow;
+        std::mutex mutex;
+        std::condition_variable ready;
+        std::condition_variable space;                       ///< Solo con OverflowPolicy::Block.
+        std::deque<std::pair<Batch, Clock::time_point>> queue;
+        Histogram writeLatency;                              ///< Duración de cada write() (ms) desde el último takeWriteLatencies().
+        bool stopping = false;
+        std::thread worker;
+
+        std::atomic<std::uint64_t> writtenSamples{0};
+        std::atomic<std::uint64_t> droppedSamples{0};
+        std::atomic<std::uint64_t> failedBatches{0};
+    };
+
+    std::vector<std::unique_ptr<Lane>> lanes;
+    bool running;
+
+    static void run(Lane& lane);
+
+public:
+    FanOut();
+    ~FanOut();
+
+    FanOut(const FanOut&) = delete;
+    FanOut& operator=(const FanOut&) = delete;
+
+    /**
+     * @brief Agrega un sink. Debe llamarse antes de start().
+     * @param queueCapacity Lotes que puede acumular antes de descartar los más antiguos
+     * (o de hacer esperar a publish(), según overflow).
+     */
+    void addSink(std::unique_ptr<MetricSink> sink, std::size_t queueCapacity = 64,
+                 OverflowPolicy overflow = OverflowPolicy::DropOldest);
+
+    /** @brief Arranca un hilo por sink. */
+    void start();
+
+    /**
+     * @brief Encola el lote en todos los sinks. No bloquea por E/S, salvo que
+     * un sink con OverflowPolicy::Block tenga la cola llena.
+     * @param batch Se mueve; el llamador recibe un vector vacío.
+     */
+    void publish(std::vector<Metric>&& batch);
+
+    /**
+     * @brief Detiene el reparto: cada hilo vacía su cola, llama a flush() y termina.
+     * @details Puede tardar lo que tarde el sink más lento; el apagado lo acota
+     * con ShutdownSignal::armWatchdog.
+     */
+    void stop();
+
+    /** @brief Estado actual de cada sink. */
+    std::vector<SinkStats> stats();
+
+    /**
+     * @brief Distribución de la duración de write() de cada sink (ms, mismo orden que stats()).
+     * @details Entrega lo acumulado desde la llamada anterior y lo pone en cero.
+     */
+    std::vector<Histogram> takeWriteLatencies();
+
+    std::size_t sinkCount() const { return lanes.size(); }
+};
+
+/**
+ * @class PipelineStatsCollector
+ * @brief Publica el estado del reparto como métricas, cada cierta cantidad de segundos.
+ *
+ * @details Por cada sink (componente "Pipeline"):
+ *  - `<sink>.lag` (ms): antigüedad del lote más viejo en cola.
+ *  - `<sink>.queue` (lotes): tamaño de la cola.
+ *  - `<sink>.throughput` (muestras/s): entregadas desde la publicación anterior.
+ *  - `<sink>.dropped` (muestras): descartadas desde la publicación anterior.
+ *  - `<sink>.write_latency` (ms): distribución de la duración de cada write()
+ *    desde la publicación anterior, como histograma (value es la media). Solo
+ *    si hubo escrituras.
+ */
+class PipelineStatsCollector : public Collector {
+private:
+    FanOut& fanOut;
+    std::chrono::seconds interval;
+    std::chrono::steady_clock::time_point lastReport;
+    std::vector<SinkStats> previous;
+
+public:
+    PipelineStatsCollector(FanOut& fanOut, std::chrono::seconds interval = std::chrono::seconds(10));
+
+    const char* name() const override { return "pipeline"; }
+    std::size_t collect(std::vector<Metric>& out) override;
+};
@@ -0,0 +1,124 @@
+/**
+ * @file fs_monitor.cpp
+ * @brief Implementación de FsMonitor.
+ * @author Sergio Gonzalez
+ * @date 2026-06-13
+ */
+
+#include "fs_monitor.hpp"
+#include <windows.h>
+#include <chrono>
+#include "db_manager.hpp"
+
+FsMonitor::FsMonitor(double trendHalfLifeSeconds) : driveMask(0), trendHalfLife(trendHalfLifeSeconds) {
+    refresh();
+}
+
+void FsMonitor::refresh() {
+    DWORD mask = GetLogicalDrives();
+    if (mask == driveMask) return;
+    driveMask = mask;
+
+    for (int letter = 0; letter < 26; ++letter) {
+        Volume& volume = volumes[letter];
+        wchar_t root[] = {static_cast<wchar_t>(L'A' + letter), L':', L'\\', L'\0'};
+        bool fixed = (mask & (1UL << letter)) && GetDriveTypeW(root) == DRIVE_FIXED;
+        if (!fixed) {
+            volume.present = false;
+            continue;
+        }
+        if (volume.present) continue;  // Ya estaba: se conserva su tendencia.
+
+        wchar_t fsName[MAX_PATH + 1] = {};
+        volume.fsType.clear();
+        if (GetVolumeInformationW(root, nullptr, 0, nullptr, nullptr, nullptr, fsName, MAX_PATH + 1)) {
+            for (const wchar_t* c = fsName; *c; ++c) volume.fsType.push_back(static_cast<char>(*c));  // Siempre ASCII.
+        }
+        volume.device = std::string(1, static_cast<char>('A' + letter)) + ":";
+        volume.trend = LinearTrend(trendHalfLife);
+        volume.present = true;
+    }
+}
+
+std::size_t FsMonitor::collect(std::vector<Metric>& out) {
+    refresh();
+
+    auto now = std::chrono::system_clock::now();
+    long long timestamp = std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count();
+    std::size_t added = 0;
+
+    for (int letter = 0; letter < 26; ++letter) {
+        Volume& volume = volumes[letter];
+        if (!volume.present) continue;
+
+        wchar_t root[] = {static_cast<wchar_t>(L'A' + letter), L':', L'\\', L'\0'};
+        ULARGE_INTEGER available, total, totalFree;
+        if (!GetDiskFreeSpaceExW(root, &available, &total, &totalFree) || total.QuadPart == 0) continue;
+
+        auto push = [&](const char* metric, const char* unit, double value) {
+            Metric m;
+            m.component = "Fs";
+            m.metric = metric;
+            m.unit = unit;
+            m.value = value;
+            m.timestamp = timestamp;
+            m.labels.emplace_back("device", volume.device);
+            if (!volume.fsType.empty()) m.labels.emplace_back("fstype", volume.fsType);
+            out.push_back(std::move(m));
+            ++added;
+        };
+
+        double used = static_cast<double>(total.QuadPart - totalFree.QuadPart);
+        double free = static_cast<double>(available.QuadPart);
+        push("UsedBytes", "bytes", used);
+        push("FreeBytes", "bytes", free);
+        push("UsedPercent", "%", used * 100.0 / static_cast<double>(total.QuadPart));
+
+        volume.trend.add(static_cast<double>(timestamp), free);
+        double slope, current;
+        if (volume.trend.fit(slope, current)) {
+            push("FillRate", "bytes/s", -slope);
+            if (slope < 0.0 && current > 0.0) push("TimeToFull", "s", current / -slope);
+        }
+    }
+    return added;
+}
+
+/**
+ * @brief Siembra las tendencias con la historia guardada.
+ *
+ * @details
+ * La serie de cada volumen se busca por `device` y `fstype`, las mismas
+ * etiquetas con las que collect() la publica. Si hay más de una (el volumen se
+ * formateó con otro sistema de archivos sin fstype conocido, por ejemplo) se
+ * usa la más nueva. Sin vida media (trend_half_life = 0) toda la historia
+ * pesa igual y no hay ventana que acotar, así que no se siembra nada.
+ */
+std::size_t FsMonitor::seed(DatabaseManager& db, long long now) {
+    if (trendHalfLife <= 0.0) return 0;
+    long long from = now - static_cast<long long>(trendHalfLife * kSeedHalfLives);
+    std::size_t seeded = 0;
+
+    for (Volume& volume : volumes) {
+        if (!volume.present) continue;
+
+        SeriesSelector selector;
+        selector.component = "Fs";
+        selector.metric = "FreeBytes";
+        selector.matchers.push_back({"device", volume.device, false});
+        if (!volume.fsType.empty()) selector.matchers.push_back({"fstype", volume.fsType, false});
+
+        std::vector<LabeledSeries> found;
+        if (!db.selectSeries(selector, found) || found.empty()) continue;
+
+        SeriesColumns history;
+        if (!db.loadSeries(found.back().id, from, now, history) || history.size() == 0) continue;
+
+        volume.trend.reset();
+        for (std::size_t i = 0; i < history.size(); ++i) {
+            volume.trend.add(static_cast<double>(history.timestamps[i]), history.values[i]);
+        }
+        ++seeded;
+    }
+    return seeded;
+}
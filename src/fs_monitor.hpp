@@ -0,0 +1,77 @@
+/**
+ * @file fs_monitor.hpp
+ * @brief Ocupación de los volúmenes locales y estimación del tiempo hasta llenarse.
+ * @details
+ * "Disco lleno" avisa cuando ya es tarde. FsMonitor publica (componente "Fs",
+ * etiquetas `device` = `C:` y `fstype` = `NTFS`) por cada volumen fijo:
+ *
+ *  - `UsedBytes`, `FreeBytes` (gauges): ocupado y disponible para el servicio
+ *    (descontando cuotas), de GetDiskFreeSpaceEx.
+ *  - `UsedPercent` (gauge): ocupado sobre el total.
+ *  - `FillRate` (gauge, bytes/s): pendiente reciente del espacio ocupado.
+ *  - `TimeToFull` (gauge, s): cuánto falta para que FreeBytes llegue a cero
+ *    al ritmo actual. Solo se publica mientras el volumen se está llenando.
+ *
+ * La pendiente sale de una recta de mínimos cuadrados sobre FreeBytes que se
+ * actualiza en O(1) por muestra (LinearTrend), con una vida media configurable
+ * (`[collector.fs] trend_half_life = <segundos>`, por defecto 3600). Al
+ * arrancar, seed() la carga con los FreeBytes ya guardados en la base, así un
+ * reinicio del servicio no deja a TimeToFull sin datos durante horas.
+ *
+ * La lista de volúmenes se arma al construir el colector y se vuelve a armar
+ * solo cuando cambia la máscara de GetLogicalDrives (se conecta o se quita una
+ * unidad); cada ciclo es una llamada por volumen. Solo se miran las unidades
+ * fijas: consultar una unidad de red o un lector vacío puede bloquear.
+ *
+ * NTFS y ReFS no tienen una tabla de inodos de tamaño fijo que se pueda
+ * agotar, así que no hay métricas de inodos.
+ * @author Sergio Gonzalez
+ * @date 2026-06-13
+ */
+#pragma once
+#include <string>
+#include "collector.hpp"
+#include "linear_trend.hpp"
+
+class DatabaseManager;
+
+/**
+ * @class FsMonitor
+ * @brief Colector de ocupación de volúmenes.
+ */
+class FsMonitor : public Collector {
+private:
+    /// Volumen por letra de unidad.
+    struct Volume {
+        bool present = false;
+        std::string device;   ///< "C:"
+        std::string fsType;   ///< "NTFS", "ReFS"...
+        LinearTrend trend;
+    };
+
+    Volume volumes[26];
+    unsigned long driveMask;
+    double trendHalfLife;
+
+    /** @brief Vuelve a armar la lista si cambió la máscara de unidades. */
+    void refresh();
+
+public:
+    /** @param trendHalfLifeSeconds Vida media de las muestras en la estimación de TimeToFull. */
+    explicit FsMonitor(double trendHalfLifeSeconds = 3600.0);
+
+    const char* name() const override { return "Fs"; }
+
+    std::size_t collect(std::vector<Metric>& out) override;
+
+    /**
+     * @brief Carga en la tendencia de cada volumen los FreeBytes guardados de
+     * las últimas kSeedHalfLives vidas medias (lo anterior ya casi no pesa).
+     * @details Se llama una vez, antes del primer collect().
+     * @param now Timestamp actual; las muestras posteriores se ignoran.
+     * @return Volúmenes que recibieron al menos una muestra.
+     */
+    std::size_t seed(DatabaseManager& db, long long now);
+
+    static constexpr double kSeedHalfLives = 8.0;
+};
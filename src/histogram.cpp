@@ -0,0 +1,227 @@
+/**
+ * @file histogram.cpp
+ * @brief Implementación de Histogram.
+ * @author Sergio Gonzalez
+ * @date 2026-04-18
+ */
+
+#include "histogram.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "varint.hpp"
+
+namespace {
+
+/// Versión del formato binario de serialize().
+constexpr unsigned char kFormatVersion = 1;
+
+/// Cubetas máximas aceptadas al deserializar (protege de un BLOB corrupto).
+constexpr std::uint64_t kMaxBuckets = 1 << 16;
+
+} // namespace
+
+Histogram::Histogram() : counts(1, 0) {}
+
+Histogram Histogram::fixed(std::vector<double> upperBounds) {
+    upperBounds.erase(std::remove_if(upperBounds.begin(), upperBounds.end(),
+                                     [](double b) { return !std::isfinite(b); }),
+                      upperBounds.end());
+    std::sort(upperBounds.begin(), upperBounds.end());
+    upperBounds.erase(std::unique(upperBounds.begin(), upperBounds.end()), upperBounds.end());
+
+    Histogram h;
+    h.scale = HistogramScale::Fixed;
+    h.bounds = std::move(upperBounds);
+    h.counts.assign(h.bounds.size() + 1, 0);
+    return h;
+}
+
+Histogram Histogram::exponential(double start, double factor, std::size_t buckets) {
+    Histogram h;
+    if (!(start > 0.0) || !(factor > 1.0) || buckets == 0) return h;
+
+    h.scale = HistogramScale::Exponential;
+    h.start = start;
+    h.factor = factor;
+    h.bounds.reserve(buckets);
+    double bound = start;
+    for (std::size_t i = 0; i < buckets && std::isfinite(bound); ++i) {
+        h.bounds.push_back(bound);
+        bound *= factor;
+    }
+    h.counts.assign(h.bounds.size() + 1, 0);
+    return h;
+}
+
+std::size_t Histogram::bucketOf(double value) const {
+    if (bounds.empty() || value <= bounds.front()) return 0;
+    if (value > bounds.back()) return bounds.size();
+
+    if (scale == HistogramScale::Exponential) {
+        // Índice directo por logaritmo; el redondeo de punto flotante puede
+        // desplazarlo una cubeta, así que se corrige contra los límites reales.
+        std::size_t i = static_cast<std::size_t>(std::ceil(std::log(value / start) / std::log(factor)));
+        i = std::min(i, bounds.size() - 1);
+        while (i > 0 && value <= bounds[i - 1]) --i;
+        while (value > bounds[i]) ++i;
+        return i;
+    }
+    return static_cast<std::size_t>(std::lower_bound(bounds.begin(), bounds.end(), value) - bounds.begin());
+}
+
+void Histogram::add(double value, std::uint64_t n) {
+    if (n == 0 || std::isnan(value)) return;
+    counts[bucketOf(value)] += n;
+    if (total == 0) {
+        minValue = value;
+        maxValue = value;
+    } else {
+        minValue = std::min(minValue, value);
+        maxValue = std::max(maxValue, value);
+    }
+    total += n;
+    sumValue += value * static_cast<double>(n);
+}
+
+bool Histogram::sameLayout(const Histogram& other) const {
+    return scale == other.scale && bounds == other.bounds;
+}
+
+bool Histogram::merge(const Histogram& other) {
+    if (other.total == 0) return true;
+    if (total == 0) {
+        *this = other;
+        return true;
+    }
+    if (!sameLayout(other)) return false;
+
+    for (std::size_t i = 0; i < counts.size(); ++i) {
+        counts[i] += other.counts[i];
+    }
+    minValue = std::min(minValue, other.minValue);
+    maxValue = std::max(maxValue, other.maxValue);
+    total += other.total;
+    sumValue += other.sumValue;
+    return true;
+}
+
+double Histogram::upperBound(std::size_t i) const {
+    return i < bounds.size() ? bounds[i] : std::numeric_limits<double>::infinity();
+}
+
+double Histogram::quantile(double q) const {
+    if (total == 0) return 0.0;
+    if (q <= 0.0) return minValue;
+    if (q >= 1.0) return maxValue;
+
+    double rank = q * static_cast<double>(total);
+    double seen = 0.0;
+    for (std::size_t i = 0; i < counts.size(); ++i) {
+        if (counts[i] == 0) continue;
+        double next = seen + static_cast<double>(counts[i]);
+        if (rank <= next) {
+            // Se interpola dentro de la cubeta, recortada a [min, max]: la primera
+            // y la de desborde no tienen un límite propio del otro lado.
+            double lower = i == 0 ? minValue : std::max(bounds[i - 1], minValue);
+            double upper = i < bounds.size() ? std::min(bounds[i], maxValue) : maxValue;
+            double fraction = (rank - seen) / static_cast<double>(counts[i]);
+            return lower + (upper - lower) * fraction;
+        }
+        seen = next;
+    }
+    return maxValue;
+}
+
+void Histogram::clear() {
+    std::fill(counts.begin(), counts.end(), 0);
+    total = 0;
+    sumValue = 0.0;
+    minValue = 0.0;
+    maxValue = 0.0;
+}
+
+std::string Histogram::serialize() const {
+    std::string out;
+    out.reserve(48 + counts.size() * 2);
+
+    out.push_back(static_cast<char>(kFormatVersion));
+    out.push_back(static_cast<char>(scale));
+    if (scale == HistogramScale::Exponential) {
+        varint::putDouble(out, start);
+        varint::putDouble(out, factor);
+        varint::put(out, bounds.size());
+    } else {
+        varint::put(out, bounds.size());
+        for (double b : bounds) {
+            varint::putDouble(out, b);
+        }
+    }
+    varint::put(out, total);
+    varint::putDouble(out, sumValue);
+    varint::putDouble(out, minValue);
+    varint::putDouble(out, maxValue);
+
+    // Las latencias suelen concentrarse en pocas cubetas: solo se guardan las no vacías.
+    std::uint64_t nonEmpty = 0;
+    for (std::uint64_t c : counts) nonEmpty += c > 0 ? 1 : 0;
+    varint::put(out, nonEmpty);
+    std::size_t previous = 0;
+    for (std::size_t i = 0; i < counts.size(); ++i) {
+        if (counts[i] == 0) continue;
+        varint::put(out, i - previous);
+        varint::put(out, counts[i]);
+        previous = i;
+    }
+    return out;
+}
+
+bool Histogram::deserialize(const void* data, std::size_t size) {
+    varint::Reader in(data, size);
+
+    unsigned char version;
+    unsigned char storedScale;
+    if (!in.getByte(version) || version != kFormatVersion) return false;
+    if (!in.getByte(storedScale)) return false;
+
+    Histogram result;
+    std::uint64_t n;
+    if (storedScale == static_cast<unsigned char>(HistogramScale::Exponential)) {
+        double s, f;
+        if (!in.getDouble(s) || !in.getDouble(f) || !in.get(n) || n == 0 || n > kMaxBuckets) return false;
+        result = exponential(s, f, static_cast<std::size_t>(n));
+        if (result.bounds.size() != n) return false;
+    } else if (storedScale == static_cast<unsigned char>(HistogramScale::Fixed)) {
+        if (!in.get(n) || n > kMaxBuckets || n * sizeof(double) > in.remaining()) return false;
+        std::vector<double> b(static_cast<std::size_t>(n));
+        for (double& bound : b) {
+            if (!in.getDouble(bound)) return false;
+        }
+        result = fixed(b);
+        if (result.bounds != b) return false;  // Desordenados o repetidos: no los escribió serialize().
+    } else {
+        return false;
+    }
+
+    if (!in.get(result.total)) return false;
+    if (!in.getDouble(result.sumValue) || !in.getDouble(result.minValue) || !in.getDouble(result.maxValue)) {
+        return false;
+    }
+
+    std::uint64_t nonEmpty;
+    if (!in.get(nonEmpty) || nonEmpty > result.counts.size()) return false;
+    std::uint64_t index = 0;
+    std::uint64_t binsTotal = 0;
+    for (std::uint64_t k = 0; k < nonEmpty; ++k) {
+        std::uint64_t skip, c;
+        if (!in.get(skip) || !in.get(c)) return false;
+        index += skip;
+        if (index >= result.counts.size() || (k > 0 && skip == 0)) return false;
+        result.counts[static_cast<std::size_t>(index)] = c;
+        binsTotal += c;
+    }
+    if (binsTotal != result.total) return false;
+
+    *this = std::move(result);
+    return true;
+}
@@ -0,0 +1,124 @@
+/**
+ * @file histogram.hpp
+ * @brief Histograma de cubetas fijas o exponenciales, combinable y serializable.
+ * @details
+ * Para mediciones tipo latencia (espera en la cola del planificador, tiempos de
+ * disco) un promedio por ciclo oculta justamente lo que interesa: la cola de la
+ * distribución. Un colector puede entonces publicar, por ciclo, un histograma
+ * con cuántas observaciones cayeron en cada cubeta.
+ *
+ * Cubetas:
+ *  - Fijas: límites superiores explícitos, por ejemplo {1, 5, 10, 50, 100} ms.
+ *  - Exponenciales: start, start*factor, start*factor^2... (n límites).
+ * Cada cubeta i cuenta los valores en (límite[i-1], límite[i]]; la primera
+ * incluye todo lo que está por debajo de límite[0] y hay una cubeta final para
+ * lo que supera el último límite.
+ *
+ * A diferencia de DDSketch (que se arma en el servidor a partir de muestras
+ * sueltas), el histograma ya llega agregado desde el colector: solo se suman
+ * contadores. Dos histogramas con las mismas cubetas se combinan exactamente,
+ * así que se acumulan por cubeta de tiempo en los rollups y se combinan otra vez
+ * para consultar cuantiles de cualquier rango.
+ * @author Sergio Gonzalez
+ * @date 2026-04-18
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @enum HistogramScale
+ * @brief Cómo se definen los límites de las cubetas.
+ */
+enum class HistogramScale : unsigned char {
+    Fixed = 0,       ///< Límites explícitos.
+    Exponential = 1  ///< start * factor^i.
+};
+
+/**
+ * @class Histogram
+ * @brief Contadores por cubeta más count/sum/min/max exactos.
+ */
+class Histogram {
+private:
+    HistogramScale scale = HistogramScale::Fixed;
+    double start = 0.0;                 ///< Primer límite (solo exponencial).
+    double factor = 0.0;                ///< Razón entre límites (solo exponencial).
+    std::vector<double> bounds;         ///< Límites superiores, crecientes.
+    std::vector<std::uint64_t> counts;  ///< bounds.size() + 1 contadores (el último es el desborde).
+    std::uint64_t total = 0;
+    double sumValue = 0.0;
+    double minValue = 0.0;
+    double maxValue = 0.0;
+
+    std::size_t bucketOf(double value) const;
+
+public:
+    /** @brief Histograma sin cubetas (todo cae en el desborde). Adopta las cubetas del primero que se le combine. */
+    Histogram();
+
+    /**
+     * @brief Cubetas con límites superiores explícitos.
+     * @param upperBounds Límites; se ordenan y se quitan los repetidos.
+     */
+    static Histogram fixed(std::vector<double> upperBounds);
+
+    /**
+     * @brief Cubetas exponenciales: start, start*factor, ..., start*factor^(buckets-1).
+     * @param start Primer límite (> 0).
+     * @param factor Razón entre límites (> 1).
+     * @param buckets Cantidad de límites.
+     */
+    static Histogram exponential(double start, double factor, std::size_t buckets);
+
+    /** @brief Agrega @p n observaciones de @p value. */
+    void add(double value, std::uint64_t n = 1);
+
+    /** @brief Indica si ambos histogramas tienen las mismas cubetas. */
+    bool sameLayout(const Histogram& other) const;
+
+    /**
+     * @brief Suma los contadores de @p other.
+     * @details Si este histograma está vacío adopta las cubetas de @p other.
+     * @return false si las cubetas son distintas (no son combinables).
+     */
+    bool merge(const Histogram& other);
+
+    /**
+     * @brief Estima el cuantil @p q interpolando linealmente dentro de su cubeta.
+     * @details El resultado queda acotado por el mínimo y el máximo exactos.
+     * @return 0 si el histograma está vacío.
+     */
+    double quantile(double q) const;
+
+    std::uint64_t count() const { return total; }
+    double sum() const { return sumValue; }
+    double min() const { return minValue; }
+    double max() const { return maxValue; }
+    double mean() const { return total > 0 ? sumValue / static_cast<double>(total) : 0.0; }
+
+    /** @brief Cantidad de cubetas (límites + desborde). */
+    std::size_t bucketCount() const { return counts.size(); }
+    /** @brief Límite superior de la cubeta @p i (infinito para la de desborde). */
+    double upperBound(std::size_t i) const;
+    std::uint64_t bucket(std::size_t i) const { return counts[i]; }
+
+    /** @brief Pone los contadores en cero manteniendo las cubetas. */
+    void clear();
+
+    /**
+     * @brief Serializa en formato binario compacto (apto para una columna BLOB).
+     * @details Formato: versión, escala, definición de las cubetas (start/factor/n
+     * o los n límites), count, sum, min, max y luego solo las cubetas no vacías
+     * como pares varint (salto desde la anterior, contador).
+     */
+    std::string serialize() const;
+
+    /**
+     * @brief Reconstruye un histograma a partir de serialize().
+     * @return false si el buffer está truncado o no es un histograma válido.
+     */
+    bool deserialize(const void* data, std::size_t size);
+};
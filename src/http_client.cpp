@@ -0,0 +1,186 @@
+/**
+ * @file http_client.cpp
+ * @brief Implementación del cliente HTTP sobre Winsock.
+ *
+ * @details
+ * La conexión (y la inicialización de Winsock) la abre net::connectTcp; aquí
+ * solo queda HTTP.
+ *
+ * @author Sergio Gonzalez
+ * @date 2026-02-14
+ */
+
+#include <winsock2.h> // Debe ir antes que cualquier inclusión de windows.h
+#include <ws2tcpip.h>
+#include "http_client.hpp"
+#include "net.hpp"
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+SOCKET toSocket(std::uintptr_t handle) {
+    return static_cast<SOCKET>(handle);
+}
+
+char toLower(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+/**
+ * @brief Búsqueda de una cabecera sin distinguir mayúsculas (los nombres HTTP no las distinguen).
+ * @details Solo cuenta al comienzo de una línea, así "X-Content-Length:" o un
+ * valor que contenga el nombre no se confunden con la cabecera.
+ * @return Posición del valor (justo después de @p name), o npos.
+ */
+std::size_t findHeader(const std::string& headers, const char* name) {
+    std::size_t len = std::strlen(name);
+    for (std::size_t i = 0; i + len <= headers.size(); ++i) {
+        if (i > 0 && headers[i - 1] != '\n') continue;
+        bool match = true;
+        for (std::size_t j = 0; j < len && match; ++j) {
+            match = toLower(headers[i + j]) == toLower(name[j]);
+        }
+        if (match) return i + len;
+    }
+    return std::string::npos;
+}
+
+/**
+ * @brief Indica si el valor que empieza en @p pos (hasta el CRLF) tiene el
+ * elemento @p token en su lista separada por comas, sin distinguir mayúsculas.
+ * @details "Connection: keep-alive, Upgrade" no contiene "close" aunque otra
+ * cabecera o el cuerpo lo digan.
+ */
+bool headerHasToken(const std::string& headers, std::size_t pos, const char* token) {
+    std::size_t end = headers.find("\r\n", pos);
+    if (end == std::string::npos) end = headers.size();
+    std::size_t len = std::strlen(token);
+
+    while (pos < end) {
+        std::size_t comma = headers.find(',', pos);
+        if (comma == std::string::npos || comma > end) comma = end;
+        std::size_t first = pos, last = comma;
+        while (first < last && (headers[first] == ' ' || headers[first] == '\t')) ++first;
+        while (last > first && (headers[last - 1] == ' ' || headers[last - 1] == '\t')) --last;
+        if (last - first == len) {
+            bool match = true;
+            for (std::size_t j = 0; j < len && match; ++j) {
+                match = toLower(headers[first + j]) == toLower(token[j]);
+            }
+            if (match) return true;
+        }
+        pos = comma + 1;
+    }
+    return false;
+}
+
+} // namespace
+
+HttpClient::HttpClient(const std::string& h, unsigned short p, int timeout)
+    : host(h), port(std::to_string(p)), timeoutMs(timeout), socketHandle(net::kInvalidSocket) {}
+
+HttpClient::~HttpClient() {
+    close();
+}
+
+void HttpClient::close() {
+    if (socketHandle != net::kInvalidSocket) {
+        net::closeSocket(socketHandle);
+        socketHandle = net::kInvalidSocket;
+    }
+}
+
+/**
+ * @brief Abre la conexión TCP si no hay una abierta.
+ */
+bool HttpClient::ensureConnected() {
+    if (socketHandle != net::kInvalidSocket) return true;
+    socketHandle = net::connectTcp(host, port, timeoutMs);
+    return socketHandle != net::kInvalidSocket;
+}
+
+bool HttpClient::sendAll(const char* data, std::size_t size) {
+    return net::sendAll(socketHandle, data, size);
+}
+
+/**
+ * @brief Lee una respuesta completa y devuelve su código de estado.
+ *
+ * @details
+ * El cuerpo de la respuesta se descarta: solo interesa el código. Se lee hasta
+ * completar Content-Length para dejar la conexión lista para la siguiente
+ * petición. Si no hay Content-Length o el servidor pide "Connection: close",
+ * la conexión no se reutiliza.
+ */
+int HttpClient::readResponse(bool& keepAlive) {
+    responseBuffer.clear();
+    char chunk[4096];
+    std::size_t headerEnd = std::string::npos;
+
+    while (headerEnd == std::string::npos) {
+        int n = recv(toSocket(socketHandle), chunk, sizeof(chunk), 0);
+        if (n <= 0) return -1;
+        responseBuffer.append(chunk, static_cast<std::size_t>(n));
+        headerEnd = responseBuffer.find("\r\n\r\n");
+    }
+
+    // "HTTP/1.1 204 No Content"
+    if (responseBuffer.compare(0, 5, "HTTP/") != 0) return -1;
+    std::size_t space = responseBuffer.find(' ');
+    if (space == std::string::npos) return -1;
+    int status = std::atoi(responseBuffer.c_str() + space + 1);
+
+    std::string headers = responseBuffer.substr(0, headerEnd);
+    std::size_t bodyRead = responseBuffer.size() - (headerEnd + 4);
+
+    std::size_t lengthPos = findHeader(headers, "content-length:");
+    std::size_t connectionPos = findHeader(headers, "connection:");
+    keepAlive = lengthPos != std::string::npos &&
+                (connectionPos == std::string::npos || !headerHasToken(headers, connectionPos, "close"));
+
+    if (lengthPos != std::string::npos) {
+        std::size_t contentLength = std::strtoull(headers.c_str() + lengthPos, nullptr, 10);
+        while (bodyRead < contentLength) {
+            int n = recv(toSocket(socketHandle), chunk, sizeof(chunk), 0);
+            if (n <= 0) {
+                keepAlive = false;
+                break;
+            }
+            bodyRead += static_cast<std::size_t>(n);
+        }
+    }
+    return status;
+}
+
+int HttpClient::post(const std::string& path, const std::string& contentType,
+                     const char* body, std::size_t size, const std::string& extraHeaders) {
+    std::string head;
+    head.reserve(256 + extraHeaders.size());
+    head += "POST " + path + " HTTP/1.1\r\n";
+    head += "Host: " + host + ":" + port + "\r\n";
+    head += "Content-Type: " + contentType + "\r\n";
+    head += "Content-Length: " + std::to_string(size) + "\r\n";
+    head += "Connection: keep-alive\r\n";
+    head += extraHeaders;
+    head += "\r\n";
+
+    // Un reintento: la conexión persistente pudo haber sido cerrada por el servidor
+    // mientras estaba inactiva, y eso solo se descubre al intentar usarla.
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        if (!ensureConnected()) return -1;
+
+        bool keepAlive = false;
+        int status = -1;
+        if (sendAll(head.data(), head.size()) && sendAll(body, size)) {
+            status = readResponse(keepAlive);
+        }
+        if (status < 0) {
+            close();
+            continue;
+        }
+        if (!keepAlive) close();
+        return status;
+    }
+    return -1;
+}
@@ -0,0 +1,70 @@
+/**
+ * @file http_client.hpp
+ * @brief Cliente HTTP/1.1 mínimo sobre Winsock con conexión persistente.
+ * @details
+ * Solo implementa lo que SysPulse necesita para empujar datos a un servicio
+ * local o remoto: peticiones POST con cuerpo, reutilizando la misma conexión TCP
+ * (keep-alive) mientras el servidor lo permita.
+ * @author Sergio Gonzalez
+ * @date 2026-02-14
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @class HttpClient
+ * @brief Conexión HTTP persistente hacia un único host:puerto.
+ *
+ * @details
+ * La conexión se abre en la primera petición y se mantiene abierta. Si el
+ * servidor la cierra o una escritura falla, se reconecta UNA vez y se reintenta.
+ * Todas las operaciones de red tienen un tiempo máximo para que un servidor
+ * lento no bloquee indefinidamente al llamador.
+ *
+ * El socket se guarda como entero para no exponer winsock2.h en la cabecera:
+ * winsock2.h debe incluirse antes que windows.h y este archivo no puede garantizarlo.
+ */
+class HttpClient {
+private:
+    std::string host;
+    std::string port;
+    int timeoutMs;
+    std::uintptr_t socketHandle; ///< SOCKET de Winsock (INVALID_SOCKET si no hay conexión).
+    std::string responseBuffer;  ///< Reutilizado para leer respuestas.
+
+    bool ensureConnected();
+    bool sendAll(const char* data, std::size_t size);
+    int readResponse(bool& keepAlive);
+
+public:
+    /**
+     * @brief Constructor. No abre la conexión todavía.
+     * @param host Nombre o IP del servidor.
+     * @param port Puerto TCP.
+     * @param timeoutMs Tiempo máximo por operación de envío o recepción.
+     */
+    HttpClient(const std::string& host, unsigned short port, int timeoutMs = 1000);
+
+    /** @brief Destructor. Cierra la conexión si está abierta. */
+    ~HttpClient();
+
+    HttpClient(const HttpClient&) = delete;
+    HttpClient& operator=(const HttpClient&) = delete;
+
+    /**
+     * @brief Envía una petición POST.
+     * @param path Ruta del recurso (ej. "/alerts").
+     * @param contentType Valor de la cabecera Content-Type.
+     * @param body Cuerpo de la petición.
+     * @param size Tamaño del cuerpo en bytes.
+     * @param extraHeaders Cabeceras adicionales, cada una terminada en "\r\n".
+     * @return Código de estado HTTP, o -1 si hubo un error de red.
+     */
+    int post(const std::string& path, const std::string& contentType,
+             const char* body, std::size_t size, const std::string& extraHeaders = "");
+
+    /** @brief Cierra la conexión (la siguiente petición la vuelve a abrir). */
+    void close();
+};
@@ -0,0 +1,111 @@
+/**
+ * @file irq_monitor.cpp
+ * @brief Implementación de IrqMonitor.
+ * @author Sergio Gonzalez
+ * @date 2026-06-27
+ */
+
+#include "irq_monitor.hpp"
+#include <chrono>
+
+namespace {
+
+const struct {
+    const char* path;
+    const char* metric;
+    const char* unit;
+    double scale;
+} kSources[] = {
+    {"\\Processor Information(*)\\Interrupts/sec", "Interrupts", "interrupts", 1.0},
+    {"\\Processor Information(*)\\DPCs Queued/sec", "Dpcs", "dpcs", 1.0},
+    // Los "% ... Time" acumulan unidades de 100 ns.
+    {"\\Processor Information(*)\\% Interrupt Time", "InterruptTime", "ms", 1e-4},
+    {"\\Processor Information(*)\\% DPC Time", "DpcTime", "ms", 1e-4},
+};
+
+constexpr std::size_t kSourceCount = sizeof(kSources) / sizeof(kSources[0]);
+
+} // namespace
+
+IrqMonitor::IrqMonitor() {
+    for (const auto& source : kSources) {
+        sourceCounters.push_back(pdh.add(source.path));
+    }
+}
+
+bool IrqMonitor::sameInstances() const {
+    if (instances.size() != mappedInstances.size()) return false;
+    for (std::size_t i = 0; i < instances.size(); ++i) {
+        if (instances[i].instance != mappedInstances[i]) return false;
+    }
+    return true;
+}
+
+void IrqMonitor::mapColumns() {
+    columnOf.assign(instances.size(), -1);
+    cpuLabels.clear();
+    std::string cpu;
+    for (std::size_t i = 0; i < instances.size(); ++i) {
+        if (!processorInstance(instances[i].instance, cpu)) continue;
+        columnOf[i] = static_cast<int>(cpuLabels.size());
+        cpuLabels.push_back(cpu);
+    }
+    matrix.assign(kSourceCount * cpuLabels.size(), 0);
+    mappedInstances.clear();
+    for (const PdhInstanceValue& instance : instances) mappedInstances.push_back(instance.instance);
+}
+
+std::vector<RateShare> IrqMonitor::shares() {
+    RateShare interrupts;
+    interrupts.component = "Irq";
+    interrupts.counter = "Interrupts";
+    interrupts.label = "cpu";
+    interrupts.metric = "InterruptShareMax";
+    interrupts.unit = "%";
+    interrupts.scale = 100.0;
+    return {interrupts};
+}
+
+std::size_t IrqMonitor::collect(std::vector<Metric>& out) {
+    if (!pdh.collect()) return 0;
+
+    auto now = std::chrono::system_clock::now();
+    long long timestamp = std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count();
+    std::size_t added = 0;
+
+    // 1. Volcamos todas las fuentes a la matriz.
+    bool present[kSourceCount] = {};
+    for (std::size_t s = 0; s < kSourceCount; ++s) {
+        if (sourceCounters[s] < 0 || !pdh.rawArray(sourceCounters[s], instances)) continue;
+        if (!sameInstances()) {
+            mapColumns();
+            for (bool& p : present) p = false;  // Las filas ya leídas quedaron en cero.
+        }
+        long long* row = matrix.data() + s * cpuLabels.size();
+        for (std::size_t i = 0; i < instances.size(); ++i) {
+            if (columnOf[i] >= 0) row[columnOf[i]] = instances[i].value;
+        }
+        present[s] = true;
+    }
+    if (cpuLabels.empty()) return 0;
+
+    // 2. Publicamos la matriz: una serie por fuente y CPU.
+    for (std::size_t s = 0; s < kSourceCount; ++s) {
+        if (!present[s]) continue;
+        const long long* row = matrix.data() + s * cpuLabels.size();
+        for (std::size_t cpu = 0; cpu < cpuLabels.size(); ++cpu) {
+            Metric m;
+            m.component = "Irq";
+            m.metric = kSources[s].metric;
+            m.unit = kSources[s].unit;
+            m.value = static_cast<double>(row[cpu]) * kSources[s].scale;
+            m.timestamp = timestamp;
+            m.kind = MetricKind::Counter;
+            m.labels.emplace_back("cpu", cpuLabels[cpu]);
+            out.push_back(std::move(m));
+            ++added;
+        }
+    }
+
+    return added;
+}
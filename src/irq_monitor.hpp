@@ -0,0 +1,67 @@
+/**
+ * @file irq_monitor.hpp
+ * @brief Interrupciones y DPC por CPU.
+ * @details
+ * En un equipo con mucho tráfico de red es común que una sola CPU atienda
+ * todas las interrupciones de la placa mientras el resto está libre: el
+ * "Usage" agregado de CpuMonitor no lo muestra. IrqMonitor publica
+ * (componente "Irq", etiqueta `cpu`) los contadores acumulados de cada CPU:
+ *
+ *  - `Interrupts`: interrupciones de hardware atendidas.
+ *  - `Dpcs`: DPC encolados (el trabajo diferido de los drivers, el equivalente
+ *    de las softirq de Linux).
+ *  - `InterruptTime`, `DpcTime` (ms): tiempo de CPU gastado en cada uno.
+ *
+ * RateEngine deriva sus tasas y, con el reparto de shares(), sin etiqueta,
+ * `InterruptShareMax` (%): qué parte de las interrupciones del último
+ * intervalo atendió la CPU más cargada. Con N CPU balanceadas ronda 100/N;
+ * cerca de 100 es desbalance.
+ *
+ * Todas las fuentes se leen con una sola consulta PDH por ciclo a una matriz
+ * fuentes × CPU reservada de antemano. La correspondencia entre instancia de
+ * PDH y columna se calcula una vez y solo se rehace si cambian los nombres de
+ * las instancias (PDH puede reordenarlas, o una CPU puede salir y otra entrar
+ * sin que cambie la cantidad).
+ *
+ * Windows no expone conteos por vector de interrupción (por dispositivo) sin
+ * una sesión ETW del kernel: las fuentes son por tipo, no por dispositivo.
+ * @author Sergio Gonzalez
+ * @date 2026-06-27
+ */
+#pragma once
+#include <string>
+#include <vector>
+#include "collector.hpp"
+#include "pdh_counters.hpp"
+#include "rate_engine.hpp"
+
+/**
+ * @class IrqMonitor
+ * @brief Colector de interrupciones y DPC por CPU.
+ */
+class IrqMonitor : public Collector {
+private:
+    PdhCounterSet pdh;
+    std::vector<int> sourceCounters;           ///< Índice PDH por fuente (-1 si no está).
+    std::vector<PdhInstanceValue> instances;   ///< Reutilizado entre ciclos.
+    std::vector<std::string> mappedInstances;  ///< Nombres de instancia, en orden, para los que vale columnOf.
+    std::vector<int> columnOf;                 ///< Posición en la lectura de PDH -> columna (-1 = total).
+    std::vector<std::string> cpuLabels;        ///< Etiqueta por columna.
+    std::vector<long long> matrix;             ///< fuentes × CPU, fila por fuente.
+
+    /** @brief Indica si la lectura actual tiene las mismas instancias, en el mismo orden, que columnOf. */
+    bool sameInstances() const;
+
+    /** @brief Rehace columnOf, cpuLabels y matrix para la lectura actual. */
+    void mapColumns();
+
+public:
+    IrqMonitor();
+
+    const char* name() const override { return "Irq"; }
+
+    std::size_t collect(std::vector<Metric>& out) override;
+
+    /** @brief Repartos derivados que publica este colector, para registrarlos en RateEngine. */
+    static std::vector<RateShare> shares();
+};
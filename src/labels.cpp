@@ -0,0 +1,148 @@
+/**
+ * @file labels.cpp
+ * @brief Implementación de las funciones de etiquetas y selectores.
+ * @author Sergio Gonzalez
+ * @date 2026-05-02
+ */
+
+#include "labels.hpp"
+#include <algorithm>
+#include <cctype>
+
+namespace {
+
+void appendEscaped(std::string& out, const std::string& text) {
+    for (char c : text) {
+        if (c == ',' || c == '=' || c == '\\') out.push_back('\\');
+        out.push_back(c);
+    }
+}
+
+std::string trim(const std::string& text) {
+    std::size_t begin = 0;
+    std::size_t end = text.size();
+    while (begin < end && std::isspace(static_cast<unsigned char>(text[begin]))) ++begin;
+    while (end > begin && std::isspace(static_cast<unsigned char>(text[end - 1]))) --end;
+    return text.substr(begin, end - begin);
+}
+
+} // namespace
+
+void normalizeLabels(Labels& labels) {
+    // stable_sort: entre nombres repetidos se conserva el primero que agregó el colector.
+    std::stable_sort(labels.begin(), labels.end(),
+                     [](const Labels::value_type& a, const Labels::value_type& b) { return a.first < b.first; });
+    labels.erase(std::unique(labels.begin(), labels.end(),
+                             [](const Labels::value_type& a, const Labels::value_type& b) { return a.first == b.first; }),
+                 labels.end());
+    if (!labels.empty() && labels.front().first.empty()) labels.erase(labels.begin());
+}
+
+std::string formatLabels(const Labels& labels) {
+    std::string out;
+    appendLabels(out, labels);
+    return out;
+}
+
+void appendLabels(std::string& out, const Labels& labels) {
+    bool first = true;
+    for (const auto& label : labels) {
+        if (!first) out.push_back(',');
+        first = false;
+        appendEscaped(out, label.first);
+        out.push_back('=');
+        appendEscaped(out, label.second);
+    }
+}
+
+bool parseLabels(const std::string& text, Labels& out) {
+    out.clear();
+    if (text.empty()) return true;
+
+    std::string name, value;
+    std::string* field = &name;
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        char c = text[i];
+        if (c == '\\') {
+            if (++i == text.size()) return false;
+            field->push_back(text[i]);
+        } else if (c == '=' && field == &name) {
+            field = &value;
+        } else if (c == ',') {
+            if (field != &value) return false;
+            out.emplace_back(std::move(name), std::move(value));
+            name.clear();
+            value.clear();
+            field = &name;
+        } else {
+            field->push_back(c);
+        }
+    }
+    if (field != &value) return false;
+    out.emplace_back(std::move(name), std::move(value));
+    return true;
+}
+
+bool parseSeriesSelector(const std::string& text, SeriesSelector& out, std::string& error) {
+    SeriesSelector selector;
+    std::string series = text;
+    std::size_t brace = text.find('{');
+    if (brace != std::string::npos) {
+        if (text.back() != '}') {
+            error = "falta '}' al final del selector";
+            return false;
+        }
+        series = text.substr(0, brace);
+
+        std::string body = text.substr(brace + 1, text.size() - brace - 2);
+        std::size_t begin = 0;
+        while (begin <= body.size()) {
+            std::size_t comma = body.find(',', begin);
+            if (comma == std::string::npos) comma = body.size();
+            std::string term = trim(body.substr(begin, comma - begin));
+            begin = comma + 1;
+            if (term.empty()) {
+                if (comma == body.size()) break;
+                error = "condición vacía en el selector";
+                return false;
+            }
+
+            std::size_t equals = term.find('=');
+            if (equals == std::string::npos) {
+                error = "se esperaba <etiqueta>=<valor>: " + term;
+                return false;
+            }
+            LabelMatcher matcher;
+            matcher.name = trim(term.substr(0, equals));
+            matcher.value = trim(term.substr(equals + 1));
+            matcher.anyValue = matcher.value == "*";
+            if (matcher.name.empty()) {
+                error = "etiqueta sin nombre: " + term;
+                return false;
+            }
+            selector.matchers.push_back(std::move(matcher));
+        }
+    }
+
+    std::size_t slash = series.find('/');
+    if (slash == std::string::npos) {
+        error = "el selector debe tener la forma <component>/<metric>{...}";
+        return false;
+    }
+    selector.component = trim(series.substr(0, slash));
+    selector.metric = trim(series.substr(slash + 1));
+    if (selector.component == "*") selector.component.clear();
+    if (selector.metric == "*") selector.metric.clear();
+
+    out = std::move(selector);
+    return true;
+}
+
+bool matchesLabels(const Labels& labels, const std::vector<LabelMatcher>& matchers) {
+    for (const LabelMatcher& matcher : matchers) {
+        auto it = std::find_if(labels.begin(), labels.end(),
+                               [&](const std::pair<std::string, std::string>& l) { return l.first == matcher.name; });
+        if (it == labels.end() || (!matcher.anyValue && it->second != matcher.value)) return false;
+    }
+    return true;
+}
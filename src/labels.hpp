@@ -0,0 +1,99 @@
+/**
+ * @file labels.hpp
+ * @brief Etiquetas (dimensiones clave/valor) de una serie y selectores de series.
+ * @details
+ * `component` y `metric` identifican qué se mide; las etiquetas dicen de dónde:
+ * `cpu=3`, `device=C:`, `interface=Ethernet`, `host=web01`. Así, "uso de cada
+ * núcleo" son varias series CPU/Usage que solo difieren en la etiqueta `cpu`, en
+ * lugar de nombres como "Usage_core3" que luego hay que buscar con LIKE.
+ *
+ * Las etiquetas se guardan ordenadas por nombre y sin nombres repetidos
+ * (normalizeLabels). Con eso, formatLabels() da un texto canónico: dos métricas
+ * con las mismas etiquetas pertenecen a la misma serie aunque el colector las
+ * haya agregado en otro orden.
+ *
+ * Selectores (parseSeriesSelector), por ejemplo:
+ *
+ *     CPU/Usage{cpu=*}                  todos los núcleos
+ *     Disk/ReadBytes{device=C:,host=*}  el disco C: de cada equipo
+ *     CPU/Usage                         todas las series CPU/Usage, con o sin etiquetas
+ *
+ * Un componente o métrica `*` acepta cualquiera; `nombre=*` exige que la
+ * etiqueta exista, con cualquier valor. Los selectores se resuelven con SeriesIndex.
+ * @author Sergio Gonzalez
+ * @date 2026-05-02
+ */
+#pragma once
+#include <string>
+#include <utility>
+#include <vector>
+
+/// Etiquetas de una serie: pares (nombre, valor) ordenados por nombre.
+using Labels = std::vector<std::pair<std::string, std::string>>;
+
+/**
+ * @brief Ordena por nombre y descarta los nombres vacíos o repetidos (gana el primero).
+ */
+void normalizeLabels(Labels& labels);
+
+/**
+ * @brief Texto canónico de las etiquetas: `cpu=3,host=web01` ("" si no hay).
+ * @details Las etiquetas deben estar normalizadas. ',', '=' y '\' dentro de
+ * nombres o valores llevan '\' delante, así que el texto identifica la serie sin ambigüedad.
+ */
+std::string formatLabels(const Labels& labels);
+
+/**
+ * @brief Agrega el texto canónico de las etiquetas al final de @p out, sin reservar otro string.
+ */
+void appendLabels(std::string& out, const Labels& labels);
+
+/**
+ * @brief Inverso de formatLabels: interpreta el texto canónico (con sus escapes).
+ * @return false si el texto está mal formado (un par sin '=' o un '\' al final).
+ */
+bool parseLabels(const std::string& text, Labels& out);
+
+/**
+ * @struct LabelMatcher
+ * @brief Condición sobre una etiqueta: igualdad o existencia.
+ */
+struct LabelMatcher {
+    std::string name;
+    std::string value;      ///< Valor exigido (se ignora si anyValue).
+    bool anyValue = false;  ///< `nombre=*`: basta con que la etiqueta exista.
+};
+
+/**
+ * @struct SeriesSelector
+ * @brief Series que se quieren consultar: componente, métrica y condiciones sobre etiquetas.
+ */
+struct SeriesSelector {
+    std::string component;               ///< Vacío = cualquiera.
+    std::string metric;                  ///< Vacío = cualquiera.
+    std::vector<LabelMatcher> matchers;  ///< Todas deben cumplirse.
+};
+
+/**
+ * @brief Interpreta un selector `<component>/<metric>{nombre=valor,...}`.
+ * @param error Descripción del problema si el texto no es válido.
+ * @return false si el texto no es un selector válido.
+ */
+bool parseSeriesSelector(const std::string& text, SeriesSelector& out, std::string& error);
+
+/**
+ * @brief Indica si unas etiquetas cumplen todas las condiciones.
+ * @param labels Etiquetas normalizadas de la serie.
+ */
+bool matchesLabels(const Labels& labels, const std::vector<LabelMatcher>& matchers);
+
+/**
+ * @struct LabeledSeries
+ * @brief Identidad de una serie guardada: su id en la tabla `series` y sus dimensiones.
+ */
+struct LabeledSeries {
+    long long id = 0;
+    std::string component;
+    std::string metric;
+    Labels labels;
+};
@@ -0,0 +1,45 @@
+/**
+ * @file linear_trend.cpp
+ * @brief Implementación de LinearTrend.
+ * @author Sergio Gonzalez
+ * @date 2026-06-13
+ */
+
+#include "linear_trend.hpp"
+#include <cmath>
+
+void LinearTrend::add(double t, double y) {
+    if (samples == 0) origin = t;
+    double x = t - origin;
+    if (samples > 0 && halfLife > 0.0) {
+        // Envejecer todo lo acumulado de una vez: w *= 2^(-Δt / vida media).
+        double decay = std::exp2(-(x - last) / halfLife);
+        sw *= decay;
+        st *= decay;
+        sy *= decay;
+        stt *= decay;
+        sty *= decay;
+    }
+    sw += 1.0;
+    st += x;
+    sy += y;
+    stt += x * x;
+    sty += x * y;
+    last = x;
+    ++samples;
+}
+
+void LinearTrend::reset() {
+    *this = LinearTrend(halfLife);
+}
+
+bool LinearTrend::fit(double& slope, double& current) const {
+    if (samples < 2) return false;
+    double denominator = sw * stt - st * st;
+    // Relativo a la escala de los tiempos: evita pendientes absurdas por cancelación.
+    if (!(denominator > 1e-12 * sw * stt)) return false;
+    slope = (sw * sty - st * sy) / denominator;
+    double intercept = (sy - slope * st) / sw;
+    current = intercept + slope * last;
+    return true;
+}
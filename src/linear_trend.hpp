@@ -0,0 +1,49 @@
+/**
+ * @file linear_trend.hpp
+ * @brief Recta de mínimos cuadrados incremental con olvido exponencial.
+ * @details
+ * Para estimar cuándo se llena un disco hace falta la pendiente reciente de
+ * su ocupación. Recalcular una regresión sobre la serie guardada en cada
+ * muestra cuesta O(n); LinearTrend guarda solo cinco sumas ponderadas
+ * (Σw, Σw·t, Σw·y, Σw·t², Σw·t·y) y las actualiza en O(1) por muestra.
+ *
+ * Cada muestra vieja pierde peso exponencialmente con la vida media elegida:
+ * la recta sigue los cambios de ritmo (una carga que empieza o termina) sin
+ * arrastrar toda la historia. El tiempo se guarda relativo a la primera
+ * muestra para no perder precisión al elevar al cuadrado timestamps Unix.
+ * @author Sergio Gonzalez
+ * @date 2026-06-13
+ */
+#pragma once
+#include <cstddef>
+
+/**
+ * @class LinearTrend
+ * @brief y ≈ a + b·t ajustada sobre las muestras recibidas, con olvido exponencial.
+ */
+class LinearTrend {
+private:
+    double halfLife;
+    double origin = 0.0;   ///< Tiempo de la primera muestra.
+    double last = 0.0;     ///< Tiempo de la última muestra (relativo a origin).
+    std::size_t samples = 0;
+    double sw = 0.0, st = 0.0, sy = 0.0, stt = 0.0, sty = 0.0;
+
+public:
+    /** @param halfLifeSeconds Antigüedad a la que una muestra pesa la mitad. */
+    explicit LinearTrend(double halfLifeSeconds = 3600.0) : halfLife(halfLifeSeconds) {}
+
+    /** @brief Agrega una muestra (t en segundos, creciente). */
+    void add(double t, double y);
+
+    /** @brief Olvida todas las muestras. */
+    void reset();
+
+    std::size_t count() const { return samples; }
+
+    /**
+     * @brief Pendiente (unidades de y por segundo) y valor ajustado en la última muestra.
+     * @return false con menos de dos muestras o si todas tienen el mismo tiempo.
+     */
+    bool fit(double& slope, double& current) const;
+};
@@ -0,0 +1,367 @@
+/**
+ * @file logger.cpp
+ * @brief Implementación de Logger y LogRateLimiter.
+ * @author Sergio Gonzalez
+ * @date 2026-04-04
+ */
+
+#include "logger.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+/// Registros que caben en la cola. Potencia de dos.
+constexpr std::size_t kQueueSlots = 1024;
+/// Bytes máximos de una línea (se trunca si es más larga).
+constexpr std::size_t kSlotBytes = 512;
+/// Pausa del hilo escritor cuando la cola está vacía.
+constexpr std::chrono::milliseconds kIdleWait(10);
+
+/**
+ * @struct Slot
+ * @brief Celda de la cola. El número de secuencia indica de quién es el turno
+ * (cola acotada de Vyukov): un productor la reserva con un CAS sobre la
+ * posición de escritura y la publica al avanzar la secuencia.
+ */
+struct alignas(64) Slot {
+    std::atomic<std::size_t> sequence;
+    std::uint32_t length;
+    char data[kSlotBytes];
+};
+
+Slot slots[kQueueSlots];
+alignas(64) std::atomic<std::size_t> enqueuePos{0};
+alignas(64) std::size_t dequeuePos = 0;  // Solo la toca el hilo escritor.
+
+std::atomic<int> minLevel{static_cast<int>(LogLevel::Info)};
+std::atomic<int> outputFormat{static_cast<int>(LogFormat::Text)};
+std::atomic<bool> running{false};
+std::atomic<bool> stopping{false};
+std::atomic<std::uint64_t> droppedRecords{0};
+std::FILE* output = stdout;
+std::thread writer;
+std::mutex lifecycle;  // start()/stop(); nunca en la ruta de log().
+
+const char* levelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::Debug: return "debug";
+        case LogLevel::Info:  return "info";
+        case LogLevel::Warn:  return "warn";
+        case LogLevel::Error: return "error";
+    }
+    return "info";
+}
+
+const char* levelTag(LogLevel level) {
+    switch (level) {
+        case LogLevel::Debug: return "[DEBUG]";
+        case LogLevel::Info:  return "[INFO]";
+        case LogLevel::Warn:  return "[WARN]";
+        case LogLevel::Error: return "[ERROR]";
+    }
+    return "[INFO]";
+}
+
+/**
+ * @brief Escribe `AAAA-MM-DDTHH:MM:SS.mmmZ` sin gmtime (que no es reentrante
+ * y en MinGW toma un candado): conversión de días a fecha civil.
+ */
+void appendTimestamp(std::string& out) {
+    long long ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    long long days = ms / 86400000;
+    long long rem = ms % 86400000;
+
+    long long z = days + 719468;
+    long long era = (z >= 0 ? z : z - 146096) / 146097;
+    long long doe = z - era * 146097;
+    long long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    long long y = yoe + era * 400;
+    long long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    long long mp = (5 * doy + 2) / 153;
+    long long d = doy - (153 * mp + 2) / 5 + 1;
+    long long m = mp < 10 ? mp + 3 : mp - 9;
+    if (m <= 2) ++y;
+
+    char buffer[32];
+    int n = std::snprintf(buffer, sizeof(buffer), "%04lld-%02lld-%02lldT%02lld:%02lld:%02lld.%03lldZ",
+                          y, m, d, rem / 3600000, (rem / 60000) % 60, (rem / 1000) % 60, rem % 1000);
+    out.append(buffer, static_cast<std::size_t>(n));
+}
+
+void appendJsonString(std::string& out, const char* text, std::size_t length) {
+    out += '"';
+    for (std::size_t i = 0; i < length; ++i) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += static_cast<char>(c);
+        } else if (c < 0x20) {
+            char buffer[8];
+            std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+            out += buffer;
+        } else {
+            out += static_cast<char>(c);
+        }
+    }
+    out += '"';
+}
+
+/// En logfmt (y en texto) un valor va entre comillas si tiene espacios, '=' o comillas.
+void appendLogfmtValue(std::string& out, const char* text, std::size_t length) {
+    bool quote = length == 0;
+    for (std::size_t i = 0; i < length && !quote; ++i) {
+        char c = text[i];
+        quote = c == ' ' || c == '=' || c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20;
+    }
+    if (!quote) {
+        out.append(text, length);
+        return;
+    }
+    appendJsonString(out, text, length);
+}
+
+void appendNumber(std::string& out, const LogField& field) {
+    char buffer[32];
+    int n;
+    if (field.kind == LogField::Kind::Integer) {
+        n = std::snprintf(buffer, sizeof(buffer), "%lld", field.integer);
+    } else {
+        n = std::snprintf(buffer, sizeof(buffer), "%.6g", field.real);
+    }
+    out.append(buffer, static_cast<std::size_t>(n));
+}
+
+void formatRecord(std::string& out, LogFormat fmt, LogLevel level, const char* message,
+                  std::initializer_list<LogField> fields) {
+    if (fmt == LogFormat::Json) {
+        out += "{\"ts\":\"";
+        appendTimestamp(out);
+        out += "\",\"level\":\"";
+        out += levelName(level);
+        out += "\",\"msg\":";
+        appendJsonString(out, message, std::strlen(message));
+        for (const LogField& f : fields) {
+            out += ',';
+            appendJsonString(out, f.key, std::strlen(f.key));
+            out += ':';
+            if (f.kind == LogField::Kind::Text) {
+                appendJsonString(out, f.text, f.textLength);
+            } else if (f.kind == LogField::Kind::Real && !(f.real == f.real && f.real - f.real == 0.0)) {
+                out += "null";  // NaN e infinito no existen en JSON.
+            } else {
+                appendNumber(out, f);
+            }
+        }
+        out += "}\n";
+        return;
+    }
+
+    if (fmt == LogFormat::Logfmt) {
+        out += "ts=";
+        appendTimestamp(out);
+        out += " level=";
+        out += levelName(level);
+        out += " msg=";
+        appendLogfmtValue(out, message, std::strlen(message));
+    } else {
+        appendTimestamp(out);
+        out += ' ';
+        out += levelTag(level);
+        out += ' ';
+        out += message;
+    }
+    for (const LogField& f : fields) {
+        out += ' ';
+        out += f.key;
+        out += '=';
+        if (f.kind == LogField::Kind::Text) {
+            appendLogfmtValue(out, f.text, f.textLength);
+        } else {
+            appendNumber(out, f);
+        }
+    }
+    out += '\n';
+}
+
+bool enqueue(const std::string& line) {
+    std::size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    Slot* slot;
+    for (;;) {
+        slot = &slots[pos & (kQueueSlots - 1)];
+        std::size_t seq = slot->sequence.load(std::memory_order_acquire);
+        std::intptr_t diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            return false;  // Llena: el escritor no alcanzó a vaciarla.
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    std::size_t length = std::min(line.size(), kSlotBytes);
+    std::memcpy(slot->data, line.data(), length);
+    if (length == kSlotBytes) slot->data[kSlotBytes - 1] = '\n';  // Truncada, pero sigue siendo una línea.
+    slot->length = static_cast<std::uint32_t>(length);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Pasa a @p out todo lo que haya en la cola.
+ * @return Registros extraídos.
+ */
+std::size_t drain(std::string& out) {
+    std::size_t count = 0;
+    for (;;) {
+        Slot& slot = slots[dequeuePos & (kQueueSlots - 1)];
+        std::size_t seq = slot.sequence.load(std::memory_order_acquire);
+        if (seq != dequeuePos + 1) break;
+        out.append(slot.data, slot.length);
+        slot.sequence.store(dequeuePos + kQueueSlots, std::memory_order_release);
+        ++dequeuePos;
+        ++count;
+    }
+    return count;
+}
+
+void writerLoop() {
+    std::string pending;
+    pending.reserve(kQueueSlots * 128);
+    for (;;) {
+        // Se lee la bandera antes de vaciar: lo encolado antes de stop() sale en esta vuelta.
+        bool last = stopping.load(std::memory_order_acquire);
+        pending.clear();
+        if (drain(pending) > 0) {
+            std::fwrite(pending.data(), 1, pending.size(), output);
+            std::fflush(output);
+        } else if (last) {
+            return;
+        } else {
+            std::this_thread::sleep_for(kIdleWait);
+        }
+    }
+}
+
+thread_local std::string lineBuffer;
+
+} // namespace
+
+bool parseLogLevel(const std::string& name, LogLevel& level) {
+    if (name == "debug") level = LogLevel::Debug;
+    else if (name == "info") level = LogLevel::Info;
+    else if (name == "warn") level = LogLevel::Warn;
+    else if (name == "error") level = LogLevel::Error;
+    else return false;
+    return true;
+}
+
+bool parseLogFormat(const std::string& name, LogFormat& format) {
+    if (name == "text") format = LogFormat::Text;
+    else if (name == "logfmt") format = LogFormat::Logfmt;
+    else if (name == "json") format = LogFormat::Json;
+    else return false;
+    return true;
+}
+
+bool Logger::start(LogLevel level, LogFormat format, std::FILE* out) {
+    std::lock_guard<std::mutex> lock(lifecycle);
+    if (running.load()) return false;
+
+    for (std::size_t i = 0; i < kQueueSlots; ++i) {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    enqueuePos.store(0, std::memory_order_relaxed);
+    dequeuePos = 0;
+    droppedRecords.store(0, std::memory_order_relaxed);
+    output = out;
+    minLevel.store(static_cast<int>(level));
+    outputFormat.store(static_cast<int>(format));
+    stopping.store(false);
+    writer = std::thread(writerLoop);
+    running.store(true, std::memory_order_release);
+    return true;
+}
+
+void Logger::stop() {
+    std::lock_guard<std::mutex> lock(lifecycle);
+    if (!running.load()) return;
+
+    stopping.store(true, std::memory_order_release);
+    writer.join();
+    running.store(false, std::memory_order_release);
+
+    // Un productor que reservó celda justo antes del cierre puede no haber
+    // alcanzado a publicarla; lo que quede se escribe aquí, ya sin hilo escritor.
+    std::string rest;
+    drain(rest);
+    std::uint64_t lost = droppedRecords.load();
+    if (lost > 0) {
+        formatRecord(rest, static_cast<LogFormat>(outputFormat.load()), LogLevel::Warn,
+                     "Registros de log descartados por cola llena.", {{"dropped", lost}});
+    }
+    if (!rest.empty()) {
+        std::fwrite(rest.data(), 1, rest.size(), output);
+    }
+    std::fflush(output);
+}
+
+void Logger::setLevel(LogLevel level) {
+    minLevel.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+LogLevel Logger::level() {
+    return static_cast<LogLevel>(minLevel.load(std::memory_order_relaxed));
+}
+
+LogFormat Logger::format() {
+    return static_cast<LogFormat>(outputFormat.load(std::memory_order_relaxed));
+}
+
+bool Logger::enabled(LogLevel level) {
+    return static_cast<int>(level) >= minLevel.load(std::memory_order_relaxed);
+}
+
+void Logger::log(LogLevel level, const char* message, std::initializer_list<LogField> fields) {
+    if (!enabled(level)) return;
+
+    std::string& line = lineBuffer;
+    line.clear();
+    formatRecord(line, static_cast<LogFormat>(outputFormat.load(std::memory_order_relaxed)), level, message, fields);
+
+    if (!running.load(std::memory_order_acquire)) {
+        // Sin hilo escritor (arranque o después del apagado): directo a stderr.
+        std::fwrite(line.data(), 1, line.size(), stderr);
+        return;
+    }
+    if (!enqueue(line)) {
+        droppedRecords.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+std::uint64_t Logger::dropped() {
+    return droppedRecords.load(std::memory_order_relaxed);
+}
+
+LogRateLimiter::LogRateLimiter(double perSecond, double burst)
+    : perSecond(perSecond), burst(burst), tokens(burst), last(std::chrono::steady_clock::now()) {}
+
+bool LogRateLimiter::allow() {
+    auto now = std::chrono::steady_clock::now();
+    double elapsed = std::chrono::duration<double>(now - last).count();
+    last = now;
+    tokens = std::min(burst, tokens + elapsed * perSecond);
+    if (tokens < 1.0) {
+        ++suppressedCount;
+        return false;
+    }
+    tokens -= 1.0;
+    reportedSuppressed = suppressedCount;
+    suppressedCount = 0;
+    return true;
+}
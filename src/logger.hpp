@@ -0,0 +1,166 @@
+/**
+ * @file logger.hpp
+ * @brief Registro de eventos asíncrono y estructurado del servicio.
+ * @details
+ * Quien registra no hace E/S: el registro se formatea en un búfer propio del
+ * hilo y se copia a una cola circular sin bloqueos (varios productores, un
+ * consumidor). Un hilo de fondo vacía la cola y escribe todo lo acumulado con
+ * un solo fwrite + fflush, así que una salida lenta (una tubería llena,
+ * journald ocupado) nunca frena al ciclo de muestreo ni a los sinks.
+ *
+ * Si la cola está llena el registro se descarta y se cuenta: perder una línea
+ * de log es preferible a bloquear la captura.
+ *
+ * Formatos:
+ *  - Text:   `2026-04-04T10:00:00.123Z [INFO] mensaje clave=valor`
+ *  - Logfmt: `ts=2026-04-04T10:00:00.123Z level=info msg="mensaje" clave=valor`
+ *  - Json:   `{"ts":"2026-04-04T10:00:00.123Z","level":"info","msg":"mensaje","clave":valor}`
+ *
+ * Antes de start() (o después de stop()) los registros se escriben directamente
+ * en stderr, para no perder los errores del arranque.
+ * @author Sergio Gonzalez
+ * @date 2026-04-04
+ */
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <initializer_list>
+#include <string>
+
+/**
+ * @enum LogLevel
+ * @brief Severidad de un registro, de menor a mayor.
+ */
+enum class LogLevel { Debug, Info, Warn, Error };
+
+/**
+ * @enum LogFormat
+ * @brief Formato de salida de cada línea.
+ */
+enum class LogFormat { Text, Logfmt, Json };
+
+/**
+ * @brief Interpreta "debug", "info", "warn" o "error".
+ * @return false si el nombre no es un nivel válido.
+ */
+bool parseLogLevel(const std::string& name, LogLevel& level);
+
+/**
+ * @brief Interpreta "text", "logfmt" o "json".
+ * @return false si el nombre no es un formato válido.
+ */
+bool parseLogFormat(const std::string& name, LogFormat& format);
+
+/**
+ * @struct LogField
+ * @brief Un par clave/valor de un registro. No copia: solo vive durante la llamada a log().
+ */
+struct LogField {
+    enum class Kind { Text, Integer, Real };
+
+    const char* key;
+    Kind kind;
+    const char* text = nullptr;
+    std::size_t textLength = 0;
+    long long integer = 0;
+    double real = 0.0;
+
+    LogField(const char* k, const char* v) : key(k), kind(Kind::Text), text(v), textLength(std::char_traits<char>::length(v)) {}
+    LogField(const char* k, const std::string& v) : key(k), kind(Kind::Text), text(v.data()), textLength(v.size()) {}
+    LogField(const char* k, int v) : key(k), kind(Kind::Integer), integer(v) {}
+    LogField(const char* k, unsigned v) : key(k), kind(Kind::Integer), integer(v) {}
+    LogField(const char* k, long v) : key(k), kind(Kind::Integer), integer(v) {}
+    LogField(const char* k, long long v) : key(k), kind(Kind::Integer), integer(v) {}
+    LogField(const char* k, unsigned long v) : key(k), kind(Kind::Integer), integer(static_cast<long long>(v)) {}
+    LogField(const char* k, unsigned long long v) : key(k), kind(Kind::Integer), integer(static_cast<long long>(v)) {}
+    LogField(const char* k, double v) : key(k), kind(Kind::Real), real(v) {}
+};
+
+/**
+ * @class Logger
+ * @brief Registro global del proceso (métodos estáticos, como ShutdownSignal).
+ */
+class Logger {
+public:
+    /**
+     * @brief Arranca el hilo escritor.
+     * @param level Nivel mínimo que se registra.
+     * @param format Formato de cada línea.
+     * @param out Destino (stdout por defecto).
+     * @return false si ya estaba arrancado.
+     */
+    static bool start(LogLevel level, LogFormat format, std::FILE* out = stdout);
+
+    /**
+     * @brief Vacía la cola, detiene el hilo escritor e informa los registros descartados.
+     */
+    static void stop();
+
+    /**
+     * @brief Cambia el nivel mínimo en caliente.
+     */
+    static void setLevel(LogLevel level);
+
+    static LogLevel level();
+    static LogFormat format();
+
+    /**
+     * @brief Indica si un registro de nivel @p level se escribiría.
+     * @details Es una sola lectura atómica: conviene consultarlo antes de armar
+     * campos costosos en rutas calientes.
+     */
+    static bool enabled(LogLevel level);
+
+    /**
+     * @brief Formatea y encola un registro (no bloquea).
+     */
+    static void log(LogLevel level, const char* message, std::initializer_list<LogField> fields = {});
+
+    static void debug(const char* message, std::initializer_list<LogField> fields = {}) { log(LogLevel::Debug, message, fields); }
+    static void info(const char* message, std::initializer_list<LogField> fields = {}) { log(LogLevel::Info, message, fields); }
+    static void warn(const char* message, std::initializer_list<LogField> fields = {}) { log(LogLevel::Warn, message, fields); }
+    static void error(const char* message, std::initializer_list<LogField> fields = {}) { log(LogLevel::Error, message, fields); }
+
+    /**
+     * @brief Registros descartados por cola llena desde start().
+     */
+    static std::uint64_t dropped();
+};
+
+/**
+ * @class LogRateLimiter
+ * @brief Cubeta de fichas para un sitio de registro que se puede repetir en ráfaga.
+ *
+ * @details
+ * Pensado para mensajes que pueden salir en cada lote (la base rechaza
+ * escrituras, el servidor remoto no responde): deja pasar @p burst registros
+ * seguidos y luego como mucho @p perSecond por segundo. Los suprimidos se
+ * cuentan y se informan en el siguiente registro permitido (ver suppressed()).
+ *
+ * No es seguro entre hilos: se usa uno por sitio de llamada, desde un solo hilo.
+ */
+class LogRateLimiter {
+private:
+    double perSecond;
+    double burst;
+    double tokens;
+    std::chrono::steady_clock::time_point last;
+    std::uint64_t suppressedCount = 0;
+    std::uint64_t reportedSuppressed = 0;
+
+public:
+    explicit LogRateLimiter(double perSecond = 1.0, double burst = 5.0);
+
+    /**
+     * @brief Consume una ficha si hay.
+     * @return true si el registro debe escribirse.
+     */
+    bool allow();
+
+    /**
+     * @brief Registros suprimidos desde el último allow() que devolvió true.
+     */
+    std::uint64_t suppressed() const { return reportedSuppressed; }
+};
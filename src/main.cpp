@@ -2,68 +2,608 @@
  * @file main.cpp
  * @brief Punto de entrada del servicio SysPulse.
  * @details Orquesta la captura de datos y su almacenamiento.
+ *
+ * Modos de ejecución:
+ *  - Sin argumentos: monitores reales de CPU, RAM, paginación y carga (VmMonitor),
+ *    ocupación de los volúmenes (FsMonitor) y estadísticas de TCP/UDP (NetMonitor).
+ *    Los que publican una serie por CPU se agregan si su sección está en la
+ *    configuración: contadores del sistema (PerfMonitor), presión sobre el
+ *    planificador (SchedMonitor), sensores de hardware (SensorMonitor) e
+ *    interrupciones (IrqMonitor).
+ *  - `--synthetic <series> <muestras/s>`: carga sintética determinista (cardinalidad y distribución de
+ *    valores en `[collector.synthetic]`, ver config.hpp).
+ *  - `--replay <traza.csv> [muestras/s]`: reproduce una traza grabada.
+ *
+ * Los modos de carga alimentan exactamente el mismo bucle y la misma ruta de
+ * escritura que los monitores reales, para dimensionar DatabaseManager.
+ *
+ * Si existe `config/alerts.rules`, sus reglas se evalúan sobre cada muestra
+ * (ver alert_engine.hpp).
+ *
+ * `--shutdown-timeout <ms>` (por defecto 4000) acota el tiempo que puede tardar
+ * el apagado ordenado tras Ctrl+C o SIGTERM; debe ser positivo, y al cerrar la
+ * consola Windows lo corta de todos modos a los 4,5 s.
+ *
+ * `--sample-log <dir>` escribe además cada muestra en el registro binario de
+ * segmentos (ver sample_log.hpp) para análisis masivo fuera de línea.
+ *
+ * `--push <host>:<puerto>[/ruta]` envía además cada lote a un servidor central
+ * (InfluxDB line protocol por defecto, u OTLP/HTTP con `--push-format otlp`).
+ *
+ * `--agent <host>:<puerto>` envía además cada lote a un agregador SysPulse
+ * (ver agent_sink.hpp), identificándose con `--agent-name` (por defecto, el
+ * nombre del equipo).
+ *
+ * `--aggregator <puerto>` cambia de modo: en lugar de muestrear, recibe los
+ * lotes de muchos agentes y los guarda en bases particionadas (ver
+ * aggregator.hpp). `--shards N` y `--io-threads N` fijan las particiones y los
+ * hilos de red; el resto sale de la sección `[aggregator]` de la configuración.
+ *
+ * Si un lote no se puede guardar en SQLite se escribe en `data/spool.bin` y se
+ * reinserta por tramos cuando la base vuelve a aceptar escrituras (ver spool.hpp).
+ *
+ * Cada lote se reparte a todos los destinos (SQLite, consola, registro binario,
+ * envío remoto) a través de FanOut: cada uno escribe desde su propio hilo.
+ *
+ * La configuración (ruta de la base, PRAGMA, intervalos y filtros por colector,
+ * sinks, log) se lee de `config/syspulse.ini` o de `--config <ruta>` (ver
+ * config.hpp) y se vuelve a leer cuando el archivo cambia, sin reiniciar. Las
+ * opciones de la línea de comandos tienen prioridad sobre el archivo.
+ *
+ * Los mensajes del servicio pasan por Logger (ver logger.hpp), que escribe desde
+ * un hilo propio. `--log-level debug|info|warn|error` (info por defecto; las
+ * líneas por muestra solo salen en debug) y `--log-format text|logfmt|json`.
  */
 
 #include <iostream>
-#include <thread>         // Para std::this_thread::sleep_for
 #include <chrono>         // Para std::chrono::seconds
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
 #include "db_manager.hpp"
 #include "monitor.hpp"
+#include "perf_monitor.hpp"
+#include "sched_monitor.hpp"
+#include "vm_monitor.hpp"
+#include "fs_monitor.hpp"
+#include "sensor_monitor.hpp"
+#include "irq_monitor.hpp"
+#include "net_monitor.hpp"
+#include "synthetic_collector.hpp"
+#include "alert_engine.hpp"
+#include "alert_dispatcher.hpp"
+#include "shutdown.hpp"
+#include "sample_log.hpp"
+#include "push_sink.hpp"
+#include "db_sink.hpp"
+#include "console_sink.hpp"
+#include "fanout.hpp"
+#include "logger.hpp"
+#include "config.hpp"
+#include "scheduler.hpp"
+#include "rate_engine.hpp"
+#include "agent_sink.hpp"
+#include "aggregator.hpp"
 
-int main() {
-    std::cout << "========================================" << std::endl;
-    std::cout << "   SysPulse Core v0.3 (MVP) Iniciado    " << std::endl;
-    std::cout << "========================================" << std::endl;
+namespace {
 
-    // 1. Preparamos la Base de Datos
-    std::string dbPath = "data/syspulse.db";
+/**
+ * @brief Lee un entero en [@p min, @p max] sin aceptar texto sobrante (como --shutdown-timeout).
+ * @return false si @p text no es exactamente un entero en el rango.
+ */
+bool parseBounded(const char* text, long long min, long long max, long long& out) {
+    char* end = nullptr;
+    long long value = std::strtoll(text, &end, 10);
+    if (end == text || *end != '\0' || value < min || value > max) return false;
+    out = value;
+    return true;
+}
+
+/**
+ * @brief Modo agregador: recibe lotes de agentes hasta Ctrl+C / SIGTERM.
+ * @return Código de salida del proceso.
+ */
+int runAggregator(const ServiceConfig& config, std::chrono::milliseconds shutdownTimeout) {
+    AggregatorConfig aggregatorConfig;
+    aggregatorConfig.listenAddress = config.aggregatorListen;
+    aggregatorConfig.port = static_cast<unsigned short>(config.aggregatorPort);
+    aggregatorConfig.shards = config.aggregatorShards;
+    aggregatorConfig.ioThreads = config.aggregatorIoThreads;
+    aggregatorConfig.dataDir = config.aggregatorDataDir;
+    aggregatorConfig.pragmas = config.pragmas;
+    aggregatorConfig.queueBatches = config.queueBatches;
+    aggregatorConfig.spoolCapacity = config.spoolCapacity;
+
+    if (!ShutdownSignal::install()) {
+        Logger::error("No se pudo instalar el manejador de apagado.");
+    }
+
+    AggregatorServer server(aggregatorConfig);
+    std::string error;
+    if (!server.start(error)) {
+        Logger::error("No se pudo iniciar el agregador.", {{"error", error}});
+        Logger::stop();
+        return 1;
+    }
+    Logger::info("Agregador escuchando (Ctrl+C para salir)...",
+                 {{"address", aggregatorConfig.listenAddress}, {"port", aggregatorConfig.port},
+                  {"shards", aggregatorConfig.shards}, {"io_threads", aggregatorConfig.ioThreads},
+                  {"dir", aggregatorConfig.dataDir}});
+
+    while (!ShutdownSignal::waitFor(std::chrono::seconds(10))) {
+        AggregatorStats stats = server.stats();
+        Logger::info("Estado del agregador.",
+                     {{"connections", stats.connections}, {"accepted", stats.accepted}, {"frames", stats.frames},
+                      {"samples", stats.samples}, {"protocol_errors", stats.protocolErrors},
+                      {"duplicates", stats.duplicateSamples}, {"non_finite", stats.nonFiniteSamples},
+                      {"queued", stats.queuedBatches}, {"failed", stats.failedBatches}});
+    }
+
+    Logger::info("Apagando...", {{"timeout_ms", static_cast<long long>(shutdownTimeout.count())}});
+    ShutdownSignal::armWatchdog(shutdownTimeout);
+    server.stop();
+    AggregatorStats stats = server.stats();
+    Logger::info("SysPulse detenido.", {{"samples", stats.samples}});
+    Logger::stop();
+    ShutdownSignal::markComplete();
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    // 1. Preparamos los colectores según el modo elegido. Logger aún no arrancó:
+    // los errores de esta etapa se escriben directamente en stderr.
+    std::vector<std::unique_ptr<Collector>> collectors;
+    std::chrono::milliseconds shutdownTimeout(4000);
+    const char* usage = "Uso: syspulse [--config <ruta>] "
+                        "[--synthetic <series> <muestras/s> | --replay <traza.csv> [muestras/s]] "
+                        "[--shutdown-timeout <ms>] [--sample-log <dir>] "
+                        "[--push <host>:<puerto>[/ruta]] [--push-format influx|otlp] "
+                        "[--agent <host>:<puerto>] [--agent-name <nombre>] "
+                        "[--aggregator <puerto> [--shards N] [--io-threads N]] "
+                        "[--log-level debug|info|warn|error] [--log-format text|logfmt|json]";
+
+    // El archivo se lee antes que el resto de las opciones, que lo pisan.
+    std::string configPath = "config/syspulse.ini";
+    bool configRequired = false;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::string(argv[i]) == "--config") {
+            configPath = argv[i + 1];
+            configRequired = true;
+        }
+    }
+    ServiceConfig config;
+    if (configRequired || std::ifstream(configPath).good()) {
+        std::string error;
+        if (!loadServiceConfig(configPath, config, error)) {
+            Logger::error("Configuración inválida.", {{"error", error}});
+            return 1;
+        }
+    }
+    ServiceConfig fileConfig = config;  // Sin las opciones de la línea de comandos, para comparar al recargar.
+    bool logLevelFromCli = false;
+    bool aggregatorMode = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--config" && i + 1 < argc) {
+            ++i;
+        } else if (arg == "--synthetic" && i + 2 < argc) {
+            // Cardinalidad y valores salen de [collector.synthetic] (ya validados al leer el archivo).
+            SyntheticConfig synthetic;
+            char* seriesEnd = nullptr;
+            char* rateEnd = nullptr;
+            long long seriesCount = std::strtoll(argv[i + 1], &seriesEnd, 10);
+            synthetic.samplesPerSecond = std::strtod(argv[i + 2], &rateEnd);
+            if (seriesEnd == argv[i + 1] || *seriesEnd != '\0' || seriesCount <= 0 ||
+                rateEnd == argv[i + 2] || *rateEnd != '\0' || !(synthetic.samplesPerSecond > 0.0) ||
+                !std::isfinite(synthetic.samplesPerSecond)) {
+                Logger::error("--synthetic necesita una cantidad de series y una tasa positivas.",
+                              {{"series", argv[i + 1]}, {"rate", argv[i + 2]}});
+                std::cerr << usage << std::endl;
+                return 1;
+            }
+            synthetic.seriesCount = static_cast<std::size_t>(seriesCount);
+            synthetic.distribution = ValueDistribution::RandomWalk;
+            if (const CollectorSettings* settings = config.collector("synthetic")) {
+                for (const auto& option : settings->options) {
+                    const char* value = option.second.c_str();
+                    if (option.first == "components") synthetic.componentCount = std::strtoull(value, nullptr, 10);
+                    if (option.first == "distribution") parseValueDistribution(option.second, synthetic.distribution);
+                    if (option.first == "min") synthetic.minValue = std::strtod(value, nullptr);
+                    if (option.first == "max") synthetic.maxValue = std::strtod(value, nullptr);
+                    if (option.first == "seed") synthetic.seed = std::strtoull(value, nullptr, 10);
+                }
+            }
+            collectors.push_back(std::make_unique<SyntheticCollector>(synthetic));
+            i += 2;
+        } else if (arg == "--replay" && i + 1 < argc) {
+            ReplayConfig replayConfig;
+            replayConfig.tracePath = argv[++i];
+            // La tasa es opcional: solo se toma si el siguiente argumento no es otra opción.
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                char* end = nullptr;
+                replayConfig.samplesPerSecond = std::strtod(argv[++i], &end);
+                if (end == argv[i] || *end != '\0' || !(replayConfig.samplesPerSecond > 0.0) ||
+                    !std::isfinite(replayConfig.samplesPerSecond)) {
+                    Logger::error("La tasa de --replay debe ser un número positivo.", {{"rate", argv[i]}});
+                    std::cerr << usage << std::endl;
+                    return 1;
+                }
+            }
+            auto replay = std::make_unique<ReplayCollector>(replayConfig);
+            if (!replay->open()) {
+                Logger::error("No se pudo leer la traza", {{"path", replayConfig.tracePath}});
+                return 1;
+            }
+            collectors.push_back(std::move(replay));
+        } else if (arg == "--shutdown-timeout" && i + 1 < argc) {
+            // 0 o un texto armarían un watchdog que corta el apagado antes de vaciar las colas.
+            char* end = nullptr;
+            long long ms = std::strtoll(argv[++i], &end, 10);
+            if (end == argv[i] || *end != '\0' || ms <= 0) {
+                Logger::error("--shutdown-timeout debe ser un entero positivo (ms).", {{"value", argv[i]}});
+                return 1;
+            }
+            shutdownTimeout = std::chrono::milliseconds(ms);
+            if (shutdownTimeout > kShutdownCloseGrace) {
+                Logger::warn("Al cerrar la consola Windows corta el apagado antes de este límite.",
+                             {{"timeout_ms", ms}, {"close_grace_ms", static_cast<long long>(kShutdownCloseGrace.count())}});
+            }
+        } else if (arg == "--sample-log" && i + 1 < argc) {
+            config.sampleLogDir = argv[++i];
+        } else if (arg == "--push" && i + 1 < argc) {
+            config.pushTarget = argv[++i];
+        } else if (arg == "--push-format" && i + 1 < argc) {
+            config.pushFormat = argv[++i];
+            if (config.pushFormat != "otlp" && config.pushFormat != "influx") {
+                std::cerr << usage << std::endl;
+                return 1;
+            }
+        } else if (arg == "--agent" && i + 1 < argc) {
+            config.agentTarget = argv[++i];
+        } else if (arg == "--agent-name" && i + 1 < argc) {
+            config.agentName = argv[++i];
+        } else if (arg == "--aggregator" && i + 1 < argc) {
+            long long port = 0;
+            if (!parseBounded(argv[++i], 1, 65535, port)) {
+                Logger::error("--aggregator necesita un puerto entre 1 y 65535.", {{"value", argv[i]}});
+                std::cerr << usage << std::endl;
+                return 1;
+            }
+            config.aggregatorPort = static_cast<int>(port);
+            aggregatorMode = true;
+        } else if ((arg == "--shards" || arg == "--io-threads") && i + 1 < argc) {
+            long long count = 0;
+            if (!parseBounded(argv[++i], 1, arg == "--shards" ? 256 : 64, count)) {
+                Logger::error("Cantidad fuera de rango.", {{"option", arg}, {"value", argv[i]}});
+                std::cerr << usage << std::endl;
+                return 1;
+            }
+            (arg == "--shards" ? config.aggregatorShards : config.aggregatorIoThreads) = static_cast<std::size_t>(count);
+        } else if (arg == "--log-level" && i + 1 < argc) {
+            if (!parseLogLevel(argv[++i], config.logLevel)) {
+                std::cerr << usage << std::endl;
+                return 1;
+            }
+            logLevelFromCli = true;
+        } else if (arg == "--log-format" && i + 1 < argc) {
+            if (!parseLogFormat(argv[++i], config.logFormat)) {
+                std::cerr << usage << std::endl;
+                return 1;
+            }
+        } else {
+            std::cerr << usage << std::endl;
+            return 1;
+        }
+    }
+
+    // El encabezado solo en formato texto: en logfmt/JSON cada línea debe ser un registro.
+    if (config.logFormat == LogFormat::Text) {
+        std::cout << "========================================" << std::endl;
+        std::cout << "   SysPulse Core v0.3 (MVP) Iniciado    " << std::endl;
+        std::cout << "========================================" << std::endl;
+    }
+    Logger::start(config.logLevel, config.logFormat);
+
+    if (aggregatorMode) {
+        if (!collectors.empty()) {
+            Logger::warn("El agregador no muestrea; se ignoran --synthetic/--replay.");
+            collectors.clear();
+        }
+        return runAggregator(config, shutdownTimeout);
+    }
+
+    // Los colectores por defecto se construyen recién aquí: el agregador no
+    // muestrea, y cada uno abre consultas PDH o handles al construirse.
+    // Los que publican una serie por CPU (perf, sched, sensors, irq) multiplican
+    // las series por la cantidad de núcleos: solo se agregan si su sección
+    // `[collector.<nombre>]` está en la configuración al arrancar, aunque diga
+    // enabled = false (así una recarga puede activarlos). Una sección agregada
+    // después se avisa como cambio que requiere reiniciar (requiresRestart).
+    FsMonitor* volumeTrends = nullptr;  // Se siembra con la historia guardada al conectar la base.
+    if (collectors.empty()) {
+        collectors.push_back(std::make_unique<CpuMonitor>());
+        collectors.push_back(std::make_unique<RamMonitor>());
+        if (config.collector("perf")) {
+            collectors.push_back(std::make_unique<PerfMonitor>());
+        }
+        if (const CollectorSettings* sched = config.collector("sched")) {
+            std::vector<unsigned long> pids;
+            for (const std::string& pid : sched->values("pid")) pids.push_back(std::strtoul(pid.c_str(), nullptr, 10));
+            collectors.push_back(std::make_unique<SchedMonitor>(pids));
+        }
+        const CollectorSettings* vm = config.collector("vm");
+        collectors.push_back(std::make_unique<VmMonitor>(vm ? vm->values("counter") : std::vector<std::string>()));
+        const CollectorSettings* fs = config.collector("fs");
+        std::vector<std::string> halfLife = fs ? fs->values("trend_half_life") : std::vector<std::string>();
+        auto fsMonitor = std::make_unique<FsMonitor>(halfLife.empty() ? 3600.0 : std::strtod(halfLife.back().c_str(), nullptr));
+        volumeTrends = fsMonitor.get();
+        collectors.push_back(std::move(fsMonitor));
+        if (const CollectorSettings* sensors = config.collector("sensors")) {
+            SensorPaths sensorPaths;
+            for (const auto& option : sensors->options) {
+                if (option.first == "temperature_counter") sensorPaths.temperature = option.second;
+                if (option.first == "frequency_counter") sensorPaths.frequency = option.second;
+                if (option.first == "power_counter") sensorPaths.power = option.second;
+            }
+            collectors.push_back(std::make_unique<SensorMonitor>(sensorPaths));
+        }
+        if (config.collector("irq")) {
+            collectors.push_back(std::make_unique<IrqMonitor>());
+        }
+        const CollectorSettings* net = config.collector("net");
+        collectors.push_back(std::make_unique<NetMonitor>(net ? net->values("stat") : std::vector<std::string>()));
+    }
+
+    // 2. Preparamos la Base de Datos
     DatabaseManager db;
-    if (!db.connect(dbPath)) {
-        std::cerr << "[ERROR] No se pudo conectar a la base de datos." << std::endl;
+    if (!db.connect(config.dbPath)) {
+        Logger::error("No se pudo conectar a la base de datos.", {{"path", config.dbPath}});
+        Logger::stop();
         return 1;
     }
+    for (const std::string& pragma : config.pragmas) {
+        if (!db.applyPragma(pragma)) {
+            Logger::error("PRAGMA rechazado.", {{"pragma", pragma}});
+        }
+    }
+    if (volumeTrends) {
+        auto now = std::chrono::system_clock::now();
+        std::size_t seeded = volumeTrends->seed(db, std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count());
+        Logger::debug("Tendencias de volúmenes sembradas desde la base.", {{"volumes", seeded}});
+    }
+
+    // 3. Reglas de alerta (opcionales)
+    AlertEngine alerts;
+    std::unique_ptr<AlertSink> alertSink;
+    std::vector<AlertEvent> alertEvents;
+    const std::string rulesPath = "config/alerts.rules";
+    if (std::ifstream(rulesPath).good()) {
+        AlertRuleFile ruleFile;
+        std::string error;
+        if (!loadAlertRules(rulesPath, ruleFile, error)) {
+            Logger::error("Reglas de alerta inválidas.", {{"path", rulesPath}, {"error", error}});
+            Logger::stop();
+            return 1;
+        }
+        auto now = std::chrono::system_clock::now();
+        alerts.compile(ruleFile.rules, std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count());
+        if (!ruleFile.webhookHost.empty()) {
+            alertSink = std::make_unique<WebhookAlertSink>(ruleFile.webhookHost, ruleFile.webhookPort, ruleFile.webhookPath);
+        }
+        Logger::info("Reglas de alerta cargadas.", {{"rules", alerts.ruleCount()}});
+    }
+    // Los eventos se guardan y se envían desde su propio hilo: ni el webhook ni
+    // una transacción larga del sink de SQLite frenan al muestreo.
+    AlertDispatcher alertDispatcher(db, std::move(alertSink));
+
+    if (!ShutdownSignal::install()) {
+        Logger::error("No se pudo instalar el manejador de apagado.");
+    }
+
+    // 4. Destinos de las métricas. Cada sink tiene su propia cola y su propio hilo
+    // (ver fanout.hpp), así que ninguno frena al muestreo ni a los demás.
+    FanOut fanOut;
+
+    // SQLite, con cola local (por defecto data/spool.bin, 262144 registros de
+    // 128 bytes = 32 MB) para no perder muestras si la base deja de aceptar escrituras.
+    fanOut.addSink(std::make_unique<DatabaseSink>(db, config.spoolPath, config.spoolCapacity), config.queueBatches);
+    // Las líneas por lote solo salen con --log-level debug.
+    if (config.console) {
+        fanOut.addSink(std::make_unique<ConsoleSink>(), config.queueBatches);
+    }
+
+    // Registro binario opcional, independiente de SQLite.
+    if (!config.sampleLogDir.empty()) {
+        auto sampleLog = std::make_unique<SampleLogWriter>();
+        if (!sampleLog->open(config.sampleLogDir)) {
+            Logger::error("No se pudo abrir el registro binario.", {{"dir", config.sampleLogDir}});
+            Logger::stop();
+            return 1;
+        }
+        Logger::info("Registro binario de muestras.", {{"dir", config.sampleLogDir}});
+        fanOut.addSink(std::move(sampleLog), config.queueBatches);
+    }
+
+    // Envío opcional a un servidor central.
+    if (!config.pushTarget.empty()) {
+        PushConfig pushConfig;
+        if (config.pushFormat == "otlp") {
+            pushConfig.format = PushFormat::OtlpProtobuf;
+            pushConfig.path = "/v1/metrics";
+        }
+        std::string pushTarget = config.pushTarget;
+        std::size_t slash = pushTarget.find('/');
+        if (slash != std::string::npos) {
+            pushConfig.path = pushTarget.substr(slash);
+            pushTarget = pushTarget.substr(0, slash);
+        }
+        std::size_t colon = pushTarget.rfind(':');
+        long long port = 0;
+        if (colon == std::string::npos || !parseBounded(pushTarget.c_str() + colon + 1, 1, 65535, port)) {
+            Logger::error("El puerto de --push debe ser un entero entre 1 y 65535.", {{"target", config.pushTarget}});
+            Logger::stop();
+            std::cerr << usage << std::endl;
+            return 1;
+        }
+        pushConfig.host = pushTarget.substr(0, colon);
+        pushConfig.port = static_cast<unsigned short>(port);
+        auto pushSink = std::make_unique<HttpPushSink>(pushConfig);
+        Logger::info("Enviando métricas a un servidor central.",
+                     {{"host", pushConfig.host}, {"port", pushConfig.port}, {"path", pushConfig.path},
+                      {"pending", pushSink->pendingCount()}});
+        fanOut.addSink(std::move(pushSink), config.queueBatches);
+    }
 
-    // 2. Preparamos el Monitor
-    CpuMonitor monitor;
-    RamMonitor ramMonitor;
+    // Envío opcional a un agregador SysPulse.
+    if (!config.agentTarget.empty()) {
+        AgentConfig agentConfig;
+        std::size_t colon = config.agentTarget.rfind(':');
+        long long port = 0;
+        if (colon == std::string::npos || !parseBounded(config.agentTarget.c_str() + colon + 1, 1, 65535, port)) {
+            Logger::error("El puerto de --agent debe ser un entero entre 1 y 65535.", {{"target", config.agentTarget}});
+            Logger::stop();
+            std::cerr << usage << std::endl;
+            return 1;
+        }
+        agentConfig.host = config.agentTarget.substr(0, colon);
+        agentConfig.port = static_cast<unsigned short>(port);
+        agentConfig.name = config.agentName;
+        auto agentSink = std::make_unique<AgentPushSink>(agentConfig);
+        Logger::info("Enviando métricas a un agregador.",
+                     {{"host", agentConfig.host}, {"port", agentConfig.port}, {"agent", agentSink->agentName()}});
+        fanOut.addSink(std::move(agentSink), config.queueBatches);
+    }
+
+    // El estado del reparto (retraso, cola, rendimiento y pérdidas por sink) se
+    // publica como métricas cada 10 s.
+    collectors.push_back(std::make_unique<PipelineStatsCollector>(fanOut));
+
+    // Cada colector con su intervalo y sus filtros. Las recargas solo cambian
+    // la planificación: los colectores (y su estado) son siempre los mismos.
+    CollectorScheduler scheduler;
+    for (auto& collector : collectors) {
+        scheduler.add(std::move(collector));
+    }
+    collectors.clear();
+    scheduler.apply(config);
+    ConfigWatcher configWatcher(configPath);
+
+    fanOut.start();
+    alertDispatcher.start();
 
-    std::cout << "[INFO] Comenzando ciclo de captura (Ctrl+C para salir)..." << std::endl;
+    Logger::info("Comenzando ciclo de captura (Ctrl+C para salir)...");
 
-    // 3. El Bucle Infinito (El corazón del servicio)
+    // Lote del ciclo. Se entrega (move) al reparto, así que se reserva de nuevo
+    // con el tamaño del ciclo anterior para no crecer de a poco.
+    std::vector<Metric> batch;
+    std::size_t lastBatchSize = 0;
+
+    // Tasas por segundo de los contadores crudos (ver rate_engine.hpp).
+    RateEngine rates;
+    for (const RateRatio& ratio : CpuMonitor::ratios()) {
+        rates.addRatio(ratio);
+    }
+    for (const RateRatio& ratio : VmMonitor::ratios()) {
+        rates.addRatio(ratio);
+    }
+    for (const RateShare& share : IrqMonitor::shares()) {
+        rates.addShare(share);
+    }
+
+    // 5. El bucle del servicio: corre hasta que llega Ctrl+C / SIGTERM
     while (true) {
-        // A. Obtener el dato
-        auto cpuMetricOpt = monitor.getMetric();
-        auto ramMetricOpt = ramMonitor.getMetric();
-
-        // Validamos si tenemos datos
-        if (cpuMetricOpt.has_value() && ramMetricOpt.has_value()) {
-            Metric cpuMetric = *cpuMetricOpt;
-            Metric ramMetric = *ramMetricOpt;
-
-            // B. Mostrarlo en pantalla
-            std::cout << "[Métrica] " 
-                      << cpuMetric.component << ": " << cpuMetric.value << cpuMetric.unit 
-                      << " | " 
-                      << ramMetric.component << ": " << ramMetric.value << ramMetric.unit 
-                      << std::endl;
-
-            // C. Guardarlo
-            if (!db.insertMetric(cpuMetric)) {
-                std::cerr << "[ERROR] Fallo al guardar CPU en DB." << std::endl;
-            }
-            if (!db.insertMetric(ramMetric)) {
-                std::cerr << "[ERROR] Fallo al guardar RAM en DB." << std::endl;
+        // A. Obtener los datos de los colectores que vencieron
+        batch.clear();
+        batch.reserve(lastBatchSize);
+        scheduler.collectDue(std::chrono::steady_clock::now(), batch, &rates);
+
+        // B. Evaluar alertas en cuanto las muestras salen de los colectores,
+        // antes de guardarlas: la detección no espera a SQLite.
+        auto wallNow = std::chrono::system_clock::now();
+        long long nowSeconds = std::chrono::duration_cast<std::chrono::seconds>(wallNow.time_since_epoch()).count();
+        for (const Metric& m : batch) {
+            alerts.observe(m);
+        }
+        alerts.tick(nowSeconds);
+        alertEvents.clear();
+        alerts.takeEvents(alertEvents);
+        for (const AlertEvent& e : alertEvents) {
+            Logger::warn(e.firing ? "Alerta disparada." : "Alerta resuelta.",
+                         {{"rule", e.rule}, {"component", e.component}, {"metric", e.metric},
+                          {"labels", formatLabels(e.labels)}, {"value", e.value}});
+        }
+        alertDispatcher.publish(alertEvents);
+
+        // C. Repartir el lote a los sinks. Se publica aunque esté vacío (como
+        // en un ciclo sin colectores vencidos) para que los rollups cierren por reloj.
+        lastBatchSize = batch.size();
+        fanOut.publish(std::move(batch));
+
+        // D. Recargar la configuración si el archivo cambió. Si el archivo nuevo
+        // tiene errores se sigue con la configuración anterior.
+        if (configWatcher.changed()) {
+            ServiceConfig reloaded;
+            std::string error;
+            if (!loadServiceConfig(configPath, reloaded, error)) {
+                Logger::error("Configuración inválida; se mantiene la anterior.", {{"error", error}});
+            } else {
+                if (!logLevelFromCli) {
+                    Logger::setLevel(reloaded.logLevel);
+                }
+                if (reloaded.pragmas != fileConfig.pragmas) {
+                    for (const std::string& pragma : reloaded.pragmas) {
+                        if (!db.applyPragma(pragma)) {
+                            Logger::error("PRAGMA rechazado.", {{"pragma", pragma}});
+                        }
+                    }
+                }
+                if (requiresRestart(fileConfig, reloaded)) {
+                    Logger::warn("Los cambios de almacenamiento, sinks, colectores a pedido o formato de log se aplican al reiniciar.");
+                }
+                std::size_t changed = scheduler.apply(reloaded);
+                Logger::info("Configuración recargada.", {{"path", configPath}, {"collectors_changed", changed}});
+                // Se guarda entera: un cambio que requiere reiniciar se avisa una sola vez.
+                fileConfig = std::move(reloaded);
             }
+        }
 
-        } else {
-            // Si el monitor retorna nullopt (como en la inicialización),
-            // simplemente no hacemos nada y esperamos al siguiente ciclo.
-            // Esto evita imprimir errores falsos.
+        // E. Esperar hasta que venza el próximo colector (contra el reloj, así el
+        // tiempo que tarda cada ciclo no desplaza la frecuencia de muestreo).
+        // La espera se corta en cuanto se pide el apagado; el ciclo en curso
+        // siempre termina completo antes de salir.
+        auto now = std::chrono::steady_clock::now();
+        auto next = scheduler.nextDue();
+        auto remaining = next > now ? std::chrono::duration_cast<std::chrono::milliseconds>(next - now)
+                                    : std::chrono::milliseconds(0);
+        if (ShutdownSignal::waitFor(remaining)) {
+            break;
         }
+    }
+
+    // 6. Apagado ordenado, con tiempo máximo
+    Logger::info("Apagando...", {{"timeout_ms", static_cast<long long>(shutdownTimeout.count())}});
+    ShutdownSignal::armWatchdog(shutdownTimeout);
 
-        // D. Descansar 1 segundo
-        std::this_thread::sleep_for(std::chrono::seconds(1));
+    // Cada sink termina su cola y hace flush(): el de SQLite guarda los rollups
+    // abiertos, el registro binario y el envío remoto vacían lo pendiente.
+    fanOut.stop();
+    alertDispatcher.stop();
+
+    if (!db.checkpoint()) {
+        Logger::error("No se pudo hacer checkpoint del WAL.");
+    }
+    if (!db.close()) {
+        Logger::error("La base de datos no se cerró limpiamente.");
     }
 
+    Logger::info("SysPulse detenido.");
+    Logger::stop();
+    ShutdownSignal::markComplete();
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,135 @@
+/**
+ * @file mapped_file.cpp
+ * @brief Implementación de MappedFile con CreateFileMapping / MapViewOfFile.
+ *
+ * @details
+ * Pasos para proyectar un archivo en Windows:
+ *  1. CreateFileW abre el archivo y devuelve un HANDLE.
+ *  2. CreateFileMappingW crea el objeto de proyección (y agranda el archivo si
+ *     se le pide un tamaño mayor al actual).
+ *  3. MapViewOfFile devuelve un puntero a la memoria que representa el archivo.
+ *
+ * Al cerrar se deshacen en orden inverso.
+ *
+ * @author Sergio Gonzalez
+ * @date 2026-02-28
+ */
+
+#include "mapped_file.hpp"
+#include <windows.h>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Convierte una ruta UTF-8 a UTF-16, que es lo que esperan las funciones "W" de Windows.
+ */
+std::wstring toWide(const std::string& text) {
+    int n = MultiByteToWideChar(CP_UTF8, 0, text.c_str(), -1, nullptr, 0);
+    if (n <= 0) return std::wstring();
+    std::vector<wchar_t> buffer(static_cast<size_t>(n));
+    MultiByteToWideChar(CP_UTF8, 0, text.c_str(), -1, buffer.data(), n);
+    return std::wstring(buffer.data());
+}
+
+} // namespace
+
+MappedFile::MappedFile() : fileHandle(nullptr), mappingHandle(nullptr), view(nullptr), length(0) {}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::openReadWrite(const std::string& path, std::size_t size) {
+    close();
+
+    HANDLE file = CreateFileW(toWide(path).c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ,
+                              nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER current;
+    if (!GetFileSizeEx(file, &current)) {
+        CloseHandle(file);
+        return false;
+    }
+    ULONGLONG target = static_cast<ULONGLONG>(size);
+    if (static_cast<ULONGLONG>(current.QuadPart) > target) target = static_cast<ULONGLONG>(current.QuadPart);
+
+    // Con un tamaño mayor al del archivo, CreateFileMapping lo agranda rellenando con ceros.
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READWRITE,
+                                        static_cast<DWORD>(target >> 32), static_cast<DWORD>(target & 0xFFFFFFFF), nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+
+    void* address = MapViewOfFile(mapping, FILE_MAP_READ | FILE_MAP_WRITE, 0, 0, static_cast<SIZE_T>(target));
+    if (!address) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    fileHandle = file;
+    mappingHandle = mapping;
+    view = static_cast<unsigned char*>(address);
+    length = static_cast<std::size_t>(target);
+    return true;
+}
+
+bool MappedFile::openReadOnly(const std::string& path) {
+    close();
+
+    HANDLE file = CreateFileW(toWide(path).c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER current;
+    if (!GetFileSizeEx(file, &current) || current.QuadPart == 0) {
+        // No se puede proyectar un archivo vacío.
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+
+    void* address = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!address) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    fileHandle = file;
+    mappingHandle = mapping;
+    view = static_cast<unsigned char*>(address);
+    length = static_cast<std::size_t>(current.QuadPart);
+    return true;
+}
+
+bool MappedFile::flush() {
+    if (!view) return false;
+    // FlushViewOfFile solo inicia la escritura de las páginas; FlushFileBuffers
+    // espera a que ellas, los metadatos y la caché del disco lleguen al medio.
+    return FlushViewOfFile(view, 0) != 0 && FlushFileBuffers(static_cast<HANDLE>(fileHandle)) != 0;
+}
+
+void MappedFile::close() {
+    if (view) {
+        UnmapViewOfFile(view);
+        view = nullptr;
+    }
+    if (mappingHandle) {
+        CloseHandle(mappingHandle);
+        mappingHandle = nullptr;
+    }
+    if (fileHandle) {
+        CloseHandle(fileHandle);
+        fileHandle = nullptr;
+    }
+    length = 0;
+}
@@ -0,0 +1,65 @@
+/**
+ * @file mapped_file.hpp
+ * @brief Archivo proyectado en memoria (file mapping de Windows) con RAII.
+ * @details
+ * Proyectar un archivo permite leerlo y escribirlo como si fuera un arreglo en
+ * memoria: no hay llamadas a ReadFile/WriteFile por registro y el sistema
+ * operativo se encarga de llevar las páginas modificadas al disco.
+ * @author Sergio Gonzalez
+ * @date 2026-02-28
+ */
+#pragma once
+#include <cstddef>
+#include <string>
+
+/**
+ * @class MappedFile
+ * @brief Proyección completa de un archivo en el espacio de direcciones del proceso.
+ *
+ * @details
+ * Los handles de Windows se guardan como void* para no incluir windows.h en la cabecera.
+ */
+class MappedFile {
+private:
+    void* fileHandle;      ///< HANDLE del archivo.
+    void* mappingHandle;   ///< HANDLE del objeto de proyección.
+    unsigned char* view;   ///< Dirección donde quedó proyectado el archivo.
+    std::size_t length;    ///< Tamaño proyectado en bytes.
+
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Abre (o crea) un archivo para lectura y escritura y lo proyecta.
+     * @param path Ruta del archivo (UTF-8).
+     * @param size Tamaño mínimo: si el archivo es más chico se agranda (con ceros).
+     * @return true si la proyección quedó lista.
+     */
+    bool openReadWrite(const std::string& path, std::size_t size);
+
+    /**
+     * @brief Abre un archivo existente solo para lectura y lo proyecta completo.
+     * @return false si el archivo no existe o está vacío.
+     */
+    bool openReadOnly(const std::string& path);
+
+    /**
+     * @brief Escribe en disco las páginas modificadas y espera a que lleguen al medio.
+     * @details Son las únicas llamadas al sistema del camino de escritura
+     * (FlushViewOfFile y FlushFileBuffers); se usan una vez por ciclo, no por
+     * registro. Solo para archivos abiertos con openReadWrite().
+     */
+    bool flush();
+
+    /** @brief Deshace la proyección y cierra el archivo. */
+    void close();
+
+    unsigned char* data() { return view; }
+    const unsigned char* data() const { return view; }
+    std::size_t size() const { return length; }
+    bool isOpen() const { return view != nullptr; }
+};
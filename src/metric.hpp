@@ -0,0 +1,56 @@
+/**
+ * @file metric.hpp
+ * @brief Definición de la estructura Metric, el dato que circula por todo SysPulse.
+ * @details Se separa de monitor.hpp para que el almacenamiento y las herramientas
+ * puedan usarla sin depender de la API de Windows.
+ * @author Sergio Gonzalez
+ * @date 2026-01-24
+ */
+#pragma once
+#include <memory>
+#include <string>
+#include "histogram.hpp"
+#include "labels.hpp"
+
+/**
+ * @enum MetricKind
+ * @brief Semántica del valor de una serie.
+ */
+enum class MetricKind : unsigned char {
+    Gauge = 0,   ///< Valor instantáneo (uso de CPU, memoria, temperatura).
+    Counter = 1  ///< Contador monótono crudo (bytes leídos, cambios de contexto); su tasa la calcula RateEngine.
+};
+
+/**
+ * @struct Metric
+ * @brief Estructura genérica para representar una medición del sistema.
+ *
+ * @details
+ * Una métrica de distribución (latencias, por ejemplo) lleva además su
+ * histograma del ciclo; en ese caso `value` es la media, así los destinos que
+ * solo entienden escalares (consola, registro binario, envío remoto, cola local)
+ * siguen funcionando. SQLite guarda el histograma completo (ver DatabaseManager).
+ * El histograma es inmutable y compartido: copiar la métrica no lo copia.
+ *
+ * Los colectores de contadores publican el valor acumulado tal cual
+ * (kind = Counter) en lugar de calcular su propia diferencia: la tasa por
+ * segundo la deriva RateEngine, en la ingesta o al consultar.
+ *
+ * `timestamp` tiene resolución de segundos; para el intervalo de las tasas
+ * RateEngine usa `collectedMs`, así una lectura que cae justo después del cambio
+ * de segundo no cuenta como un intervalo de 2 s.
+ *
+ * Las etiquetas distinguen series con el mismo component/metric (un núcleo,
+ * un disco, una interfaz); deben estar normalizadas (ver normalizeLabels).
+ */
+struct Metric {
+    std::string component; ///< Componente medido (CPU, RAM, etc)
+    std::string metric;    ///< Nombre de la métrica (Usage, Temperature, etc)
+    double value;          ///< Valor numérico
+    std::string unit;      ///< Unidad de medida (%, MB, C)
+    long long timestamp;   ///< Timestamp Unix
+    std::shared_ptr<const Histogram> histogram; ///< Distribución del ciclo (nullptr = métrica escalar)
+    MetricKind kind = MetricKind::Gauge;        ///< Gauge o contador monótono
+    Labels labels{};                            ///< Dimensiones de la serie (cpu=3, device=C:); vacío = sin etiquetas
+    long long collectedMs = 0;                  ///< Momento de la lectura en ms de un reloj monótono (lo pone CollectorScheduler); 0 = desconocido
+};
@@ -11,6 +11,7 @@
  *  - sin hacer nada útil (idle)
  *
  * El porcentaje de uso se obtiene comparando DOS LECTURAS en el tiempo y calculando qué fracción del tiempo fue realmente trabajo.
+ * Esa comparación la hace RateEngine: CpuMonitor solo publica los acumulados.
  *
  * El porcentaje de uso de la RAM se obtiene consultando el estado actual del sistema.
  *
@@ -21,24 +22,6 @@
 #include <iostream>
 #include <chrono>
 
-/**
- * @brief Constructor del monitor de CPU.
- *
- * La clave aquí es entender que este monitor funciona por DIFERENCIAS entre lecturas sucesivas. No existe un "valor absoluto" de uso de CPU.
- *
- * Por eso:
- * 1. Inicializamos los tiempos previos en cero.
- * 2. Forzamos una primera lectura para establecer una línea base válida.
- *
- * Sin esta lectura inicial, el primer cálculo compararía contra cero y produciría porcentajes absurdos.
- */
-CpuMonitor::CpuMonitor() {
-    //Inicializamos los tiempos previos en cero.
-    lastIdleTime.QuadPart = 0;
-    lastKernelTime.QuadPart = 0;
-    lastUserTime.QuadPart = 0;
-}
-
 ULARGE_INTEGER CpuMonitor::fileTimeToInt(const FILETIME& ft) {
     //FILETIME almacena el tiempo como dos valores de 32 bits (ft.dwLowDateTime y ft.dwHighDateTime). 
     //Para poder operar matemáticamente con él, se reconstruye el valor completo en un ULARGE_INTEGER, usando sus campos LowPart y HighPart, y se utiliza QuadPart como entero de 64 bits
@@ -48,60 +31,6 @@ ULARGE_INTEGER CpuMonitor::fileTimeToInt(const FILETIME& ft) {
     return uli;
 }
 
-std::optional<Metric> CpuMonitor::getMetric() {
-    FILETIME idleTime, kernelTime, userTime;
-    Metric m;
-    m.component = "CPU";
-    m.metric = "Usage";
-    m.unit = "%";
-    
-    // Timestamp actual
-    auto now = std::chrono::system_clock::now();
-    m.timestamp = std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count(); //Convierte el tiempo actual en segundos desde el epoch (1970-01-01 00:00:00 UTC) y lo almacena en el campo timestamp de la estructura Metric.
-
-    //Se llama a GetSystemTimes para obtener los tiempos acumulados de CPU.
-    //Si la función falla, se retorna un valor nulo.
-    if (!GetSystemTimes(&idleTime, &kernelTime, &userTime)) {
-        return std::nullopt;
-    }
-
-    //Los valores de tiempo devueltos por GetSystemTimes en estructuras FILETIME se convierten a enteros de 64 bits (ULARGE_INTEGER) para permitir operaciones aritméticas entre lecturas.
-    ULARGE_INTEGER nowIdle = fileTimeToInt(idleTime);
-    ULARGE_INTEGER nowKernel = fileTimeToInt(kernelTime);
-    ULARGE_INTEGER nowUser = fileTimeToInt(userTime);
-
-    //Si no se ha realizado una lectura previa, se inicializan los valores anteriores con los valores actuales y se retorna un valor nulo.
-    if (lastIdleTime.QuadPart == 0) {
-        lastIdleTime = nowIdle;
-        lastKernelTime = nowKernel;
-        lastUserTime = nowUser;
-        return std::nullopt;
-    }
-
-    //Se calcula la diferencia entre el tiempo actual y el tiempo anterior para cada componente.
-    ULONGLONG deltaIdle = nowIdle.QuadPart - lastIdleTime.QuadPart;
-    ULONGLONG deltaKernel = nowKernel.QuadPart - lastKernelTime.QuadPart;
-    ULONGLONG deltaUser = nowUser.QuadPart - lastUserTime.QuadPart;
-
-    //Se actualizan los valores anteriores con los valores actuales.
-    lastIdleTime = nowIdle;
-    lastKernelTime = nowKernel;
-    lastUserTime = nowUser;
-
-    //Se calcula el total de tiempo del sistema sumando el tiempo del kernel y el tiempo del usuario.
-    ULONGLONG totalSystem = deltaKernel + deltaUser;
-
-    //Si no transcurrió tiempo entre lecturas, no es posible calcular una métrica significativa.
-    if (totalSystem == 0) {
-        m.value = 0.0;
-    } else {
-        //Se calcula el porcentaje de uso de la CPU restando el tiempo idle al total de tiempo del sistema y dividiendo el resultado por el total de tiempo del sistema.
-        m.value = (1.0 - ((double)deltaIdle / (double)totalSystem)) * 100.0;
-    }
-    
-    return m;
-}
-
 /**
  * @brief Obtiene el uso actual de memoria RAM del sistema.
  *
@@ -170,4 +99,58 @@ std::optional<Metric> RamMonitor::getMetric() {
     }
 
     return m;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Publica los tiempos acumulados de CPU sin restar contra una lectura anterior.
+ *
+ * @details
+ * El tiempo de kernel incluye el ocioso, así que el total es kernel + usuario y
+ * el tiempo ocupado es ese total menos el ocioso. Ambos crecen siempre, y
+ * RateEngine calcula Usage = 100 * rate(BusyTime) / rate(TotalTime): el
+ * cociente de los incrementos entre dos lecturas. Se pasan a milisegundos
+ * para que el valor quepa holgado en el double de Metric.
+ */
+std::size_t CpuMonitor::collect(std::vector<Metric>& out) {
+    FILETIME idleTime, kernelTime, userTime;
+    if (!GetSystemTimes(&idleTime, &kernelTime, &userTime)) return 0;
+
+    ULONGLONG idle = fileTimeToInt(idleTime).QuadPart;
+    ULONGLONG total = fileTimeToInt(kernelTime).QuadPart + fileTimeToInt(userTime).QuadPart;
+    ULONGLONG busy = total > idle ? total - idle : 0;
+
+    auto now = std::chrono::system_clock::now();
+    long long timestamp = std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count();
+
+    auto push = [&](const char* metric, ULONGLONG ticks) {
+        Metric m;
+        m.component = "CPU";
+        m.metric = metric;
+        m.unit = "ms";
+        m.value = static_cast<double>(ticks) / 10000.0;  // Ticks de 100 ns a ms.
+        m.timestamp = timestamp;
+        m.kind = MetricKind::Counter;
+        out.push_back(std::move(m));
+    };
+    push("BusyTime", busy);
+    push("TotalTime", total);
+    return 2;
+}
+
+std::vector<RateRatio> CpuMonitor::ratios() {
+    RateRatio usage;
+    usage.component = "CPU";
+    usage.numerator = "BusyTime";
+    usage.denominator = "TotalTime";
+    usage.metric = "Usage";
+    usage.unit = "%";
+    usage.scale = 100.0;
+    return {usage};
+}
+
+std::size_t RamMonitor::collect(std::vector<Metric>& out) {
+    auto m = getMetric();
+    if (!m.has_value()) return 0;
+    out.push_back(std::move(*m));
+    return 1;
+}
@@ -9,18 +9,9 @@
 #include <windows.h> // Necesario para FILETIME y ULARGE_INTEGER
 #include <string>
 #include <optional>
-
-/**
- * @struct Metric
- * @brief Estructura genérica para representar una medición del sistema.
- */
-struct Metric {
-    std::string component; ///< Componente medido (CPU, RAM, etc)
-    std::string metric;    ///< Nombre de la métrica (Usage, Temperature, etc)
-    double value;          ///< Valor numérico
-    std::string unit;      ///< Unidad de medida (%, MB, C)
-    long long timestamp;   ///< Timestamp Unix
-};
+#include <vector>
+#include "collector.hpp"
+#include "rate_engine.hpp"
 
 /**
  * @class CpuMonitor
@@ -32,17 +23,16 @@ struct Metric {
  * 1. Idle Time: Tiempo que el CPU estuvo "dormido".
  * 2. Kernel Time: Tiempo gastado en tareas del Sistema Operativo.
  * 3. User Time: Tiempo gastado en programas normales (como este).
- * Para calcular el porcentaje, tomamos una foto (snapshot) ahora y la comparamos
- * con una foto anterior. La diferencia (Delta) nos dice qué pasó en ese intervalo.
+ * Para calcular el porcentaje hay que comparar una foto (snapshot) con la
+ * anterior: la diferencia (Delta) dice qué pasó en ese intervalo.
+ *
+ * Este colector no guarda esa foto: publica los acumulados crudos
+ * `CPU/BusyTime` y `CPU/TotalTime` (contadores, en ms) y RateEngine deriva
+ * `CPU/Usage` con el cociente de ratios(), como los demás colectores de
+ * contadores.
  */
-class CpuMonitor {
+class CpuMonitor : public Collector {
 private:
-    // ULARGE_INTEGER es una estructura de 64 bits de Windows.
-    // Usamos esto para guardar los tiempos de la lectura ANTERIOR (Snapshot previo).
-    ULARGE_INTEGER lastIdleTime;
-    ULARGE_INTEGER lastKernelTime;
-    ULARGE_INTEGER lastUserTime;
-
     /**
      * @brief Helper para convertir la estructura FILETIME a un entero usable.
      * @details
@@ -55,18 +45,15 @@ private:
     ULARGE_INTEGER fileTimeToInt(const FILETIME& ft);
 
 public:
-    /**
-     * @brief Constructor.
-     * Inicializa los contadores a cero y realiza una primera lectura "falsa"
-     * para establecer la línea base de tiempo.
-     */
-    CpuMonitor();
+    const char* name() const override { return "CPU"; }
 
     /**
-     * @brief Obtiene una métrica completa del uso de CPU.
-     * @return std::optional<Metric> Objeto con valor si es válido, o nullopt si no (init/error).
+     * @brief Implementación de Collector: agrega los contadores crudos `BusyTime` y `TotalTime`.
      */
-    std::optional<Metric> getMetric();
+    std::size_t collect(std::vector<Metric>& out) override;
+
+    /** @brief Cociente que produce `CPU/Usage`, para registrarlo en RateEngine. */
+    static std::vector<RateRatio> ratios();
 };
 
 /**
@@ -94,7 +81,7 @@ public:
  *  - Refleja decisiones del gestor de memoria del SO (caché, compresión, swapping).
  *  - No representa actividad, sino ocupación.
  */
-class RamMonitor {
+class RamMonitor : public Collector {
 public:
     /**
      * @brief Constructor.
@@ -109,4 +96,11 @@ public:
      * @return std::optional<Metric> Objeto con valor si es válido.
      */
     std::optional<Metric> getMetric();
+
+    const char* name() const override { return "RAM"; }
+
+    /**
+     * @brief Implementación de Collector: agrega la métrica de getMetric() si es válida.
+     */
+    std::size_t collect(std::vector<Metric>& out) override;
 };
\ No newline at end of file
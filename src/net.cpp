@@ -0,0 +1,164 @@
+/**
+ * @file net.cpp
+ * @brief Implementación de las utilidades de sockets sobre Winsock.
+ * @author Sergio Gonzalez
+ * @date 2026-05-09
+ */
+
+#include <winsock2.h> // Debe ir antes que cualquier inclusión de windows.h
+#include <ws2tcpip.h>
+#include "net.hpp"
+#include <mutex>
+
+namespace net {
+
+const std::uintptr_t kInvalidSocket = static_cast<std::uintptr_t>(INVALID_SOCKET);
+
+namespace {
+
+SOCKET toSocket(std::uintptr_t handle) {
+    return static_cast<SOCKET>(handle);
+}
+
+} // namespace
+
+bool startup() {
+    static std::once_flag once;
+    static bool ok = false;
+    std::call_once(once, [] {
+        WSADATA data;
+        ok = WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    });
+    return ok;
+}
+
+/**
+ * @details
+ * - SO_SNDTIMEO / SO_RCVTIMEO limitan cuánto puede bloquear cada send/recv.
+ * - TCP_NODELAY desactiva el algoritmo de Nagle: enviamos mensajes completos y
+ *   no queremos que el sistema espere a juntar más datos.
+ */
+std::uintptr_t connectTcp(const std::string& host, const std::string& port, int timeoutMs) {
+    if (!startup()) return kInvalidSocket;
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_protocol = IPPROTO_TCP;
+
+    addrinfo* result = nullptr;
+    if (getaddrinfo(host.c_str(), port.c_str(), &hints, &result) != 0) {
+        return kInvalidSocket;
+    }
+
+    std::uintptr_t connected = kInvalidSocket;
+    for (addrinfo* ai = result; ai != nullptr; ai = ai->ai_next) {
+        SOCKET s = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (s == INVALID_SOCKET) continue;
+
+        DWORD timeout = static_cast<DWORD>(timeoutMs);
+        setsockopt(s, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+        setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+        int noDelay = 1;
+        setsockopt(s, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+
+        if (connect(s, ai->ai_addr, static_cast<int>(ai->ai_addrlen)) == 0) {
+            connected = static_cast<std::uintptr_t>(s);
+            break;
+        }
+        closesocket(s);
+    }
+    freeaddrinfo(result);
+    return connected;
+}
+
+std::uintptr_t listenTcp(const std::string& address, unsigned short port, std::string& error) {
+    if (!startup()) {
+        error = "WSAStartup falló";
+        return kInvalidSocket;
+    }
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_protocol = IPPROTO_TCP;
+    hints.ai_flags = AI_PASSIVE;
+
+    addrinfo* result = nullptr;
+    std::string service = std::to_string(port);
+    if (getaddrinfo(address.empty() ? nullptr : address.c_str(), service.c_str(), &hints, &result) != 0) {
+        error = "no se pudo resolver " + address;
+        return kInvalidSocket;
+    }
+
+    SOCKET s = socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+    if (s == INVALID_SOCKET) {
+        freeaddrinfo(result);
+        error = "socket() falló";
+        return kInvalidSocket;
+    }
+    int yes = 1;
+    setsockopt(s, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&yes), sizeof(yes));
+
+    bool ok = bind(s, result->ai_addr, static_cast<int>(result->ai_addrlen)) == 0;
+    freeaddrinfo(result);
+    if (!ok) {
+        error = "bind falló (código " + std::to_string(WSAGetLastError()) + ")";
+    } else if (listen(s, SOMAXCONN) != 0) {
+        error = "listen falló (código " + std::to_string(WSAGetLastError()) + ")";
+        ok = false;
+    } else if (!setNonBlocking(static_cast<std::uintptr_t>(s))) {
+        error = "no se pudo poner el socket en modo no bloqueante";
+        ok = false;
+    }
+    if (!ok) {
+        closesocket(s);
+        return kInvalidSocket;
+    }
+    return static_cast<std::uintptr_t>(s);
+}
+
+bool setNonBlocking(std::uintptr_t socket) {
+    u_long mode = 1;
+    return ioctlsocket(toSocket(socket), FIONBIO, &mode) == 0;
+}
+
+bool sendAll(std::uintptr_t socket, const char* data, std::size_t size) {
+    while (size > 0) {
+        int chunk = size > 0x7FFFFFFF ? 0x7FFFFFFF : static_cast<int>(size);
+        int sent = send(toSocket(socket), data, chunk, 0);
+        if (sent <= 0) return false;
+        data += sent;
+        size -= static_cast<std::size_t>(sent);
+    }
+    return true;
+}
+
+int receive(std::uintptr_t socket, std::string& out, int timeoutMs) {
+    WSAPOLLFD fd{};
+    fd.fd = toSocket(socket);
+    fd.events = POLLRDNORM;
+    int ready = WSAPoll(&fd, 1, timeoutMs);
+    if (ready == 0) return 0;
+    if (ready < 0) return -1;
+
+    // Hay datos, o la conexión se cerró (recv devuelve 0): no bloquea.
+    char chunk[4096];
+    int n = recv(toSocket(socket), chunk, static_cast<int>(sizeof(chunk)), 0);
+    if (n <= 0) return -1;
+    out.append(chunk, static_cast<std::size_t>(n));
+    return n;
+}
+
+void closeSocket(std::uintptr_t socket) {
+    if (socket != kInvalidSocket) closesocket(toSocket(socket));
+}
+
+std::string hostName() {
+    char name[256];
+    if (!startup() || gethostname(name, sizeof(name)) != 0) return std::string();
+    name[sizeof(name) - 1] = '\0';
+    return name;
+}
+
+} // namespace net
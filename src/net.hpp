@@ -0,0 +1,58 @@
+/**
+ * @file net.hpp
+ * @brief Utilidades de sockets TCP sobre Winsock compartidas por los clientes y el agregador.
+ * @details
+ * Los sockets se pasan como std::uintptr_t (el SOCKET de Winsock) para no
+ * exponer winsock2.h en las cabeceras: winsock2.h debe incluirse antes que
+ * windows.h y quien incluye estas cabeceras no puede garantizarlo.
+ * @author Sergio Gonzalez
+ * @date 2026-05-09
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace net {
+
+/// Valor de INVALID_SOCKET.
+extern const std::uintptr_t kInvalidSocket;
+
+/**
+ * @brief Inicializa Winsock una sola vez por proceso.
+ * @details No se llama a WSACleanup: el sistema libera todo al terminar el proceso.
+ */
+bool startup();
+
+/**
+ * @brief Abre una conexión TCP bloqueante con tiempo máximo por envío y recepción.
+ * @details Prueba cada dirección que resuelve getaddrinfo (IPv4 o IPv6) y
+ * desactiva Nagle: los llamadores envían mensajes completos.
+ * @return El socket, o kInvalidSocket si no se pudo conectar.
+ */
+std::uintptr_t connectTcp(const std::string& host, const std::string& port, int timeoutMs);
+
+/**
+ * @brief Abre un socket TCP no bloqueante escuchando en @p address:@p port.
+ * @param error Descripción del fallo (bind, listen...).
+ */
+std::uintptr_t listenTcp(const std::string& address, unsigned short port, std::string& error);
+
+/** @brief Pone el socket en modo no bloqueante. */
+bool setNonBlocking(std::uintptr_t socket);
+
+/** @brief Envía todo el buffer (bloqueante, respeta el tiempo máximo del socket). */
+bool sendAll(std::uintptr_t socket, const char* data, std::size_t size);
+
+/**
+ * @brief Espera hasta @p timeoutMs a que lleguen datos y agrega a @p out lo que haya.
+ * @return Bytes leídos, 0 si no llegó nada a tiempo, -1 si la conexión se cerró o falló.
+ */
+int receive(std::uintptr_t socket, std::string& out, int timeoutMs);
+
+void closeSocket(std::uintptr_t socket);
+
+/** @brief Nombre del equipo (vacío si no se pudo obtener). */
+std::string hostName();
+
+} // namespace net
@@ -0,0 +1,170 @@
+/**
+ * @file net_monitor.cpp
+ * @brief Implementación de NetMonitor.
+ * @author Sergio Gonzalez
+ * @date 2026-07-04
+ */
+
+#include "net_monitor.hpp"
+#include <winsock2.h> // Debe ir antes que cualquier inclusión de windows.h
+#include <ws2tcpip.h>
+#include <iphlpapi.h>
+#include <chrono>
+#include <cstring>
+#include "logger.hpp"
+
+namespace {
+
+/// Estadísticas que se pueden pedir en `[collector.net] stat = <nombre>`.
+const struct {
+    const char* key;
+    const char* unit;
+    int source;          ///< 0 = TCP, 1 = UDP, 2 = estado de conexión TCP.
+    std::size_t field;
+    std::size_t size;    ///< Bytes del campo: 4 (DWORD) u 8 (DWORD64); 0 en los estados.
+    MetricKind kind;
+} kNetStats[] = {
+    {"TcpActiveOpens", "connections", 0, offsetof(MIB_TCPSTATS2, dwActiveOpens), 4, MetricKind::Counter},
+    {"TcpPassiveOpens", "connections", 0, offsetof(MIB_TCPSTATS2, dwPassiveOpens), 4, MetricKind::Counter},
+    {"TcpAttemptFails", "connections", 0, offsetof(MIB_TCPSTATS2, dwAttemptFails), 4, MetricKind::Counter},
+    {"TcpEstabResets", "connections", 0, offsetof(MIB_TCPSTATS2, dwEstabResets), 4, MetricKind::Counter},
+    {"TcpCurrEstab", "connections", 0, offsetof(MIB_TCPSTATS2, dwCurrEstab), 4, MetricKind::Gauge},
+    {"TcpInSegs", "segments", 0, offsetof(MIB_TCPSTATS2, dw64InSegs), 8, MetricKind::Counter},
+    {"TcpOutSegs", "segments", 0, offsetof(MIB_TCPSTATS2, dw64OutSegs), 8, MetricKind::Counter},
+    {"TcpRetransSegs", "segments", 0, offsetof(MIB_TCPSTATS2, dwRetransSegs), 4, MetricKind::Counter},
+    {"TcpInErrs", "segments", 0, offsetof(MIB_TCPSTATS2, dwInErrs), 4, MetricKind::Counter},
+    {"TcpOutRsts", "segments", 0, offsetof(MIB_TCPSTATS2, dwOutRsts), 4, MetricKind::Counter},
+    {"TcpNumConns", "connections", 0, offsetof(MIB_TCPSTATS2, dwNumConns), 4, MetricKind::Gauge},
+    {"UdpInDatagrams", "datagrams", 1, offsetof(MIB_UDPSTATS2, dw64InDatagrams), 8, MetricKind::Counter},
+    {"UdpNoPorts", "datagrams", 1, offsetof(MIB_UDPSTATS2, dwNoPorts), 4, MetricKind::Counter},
+    {"UdpInErrors", "datagrams", 1, offsetof(MIB_UDPSTATS2, dwInErrors), 4, MetricKind::Counter},
+    {"UdpOutDatagrams", "datagrams", 1, offsetof(MIB_UDPSTATS2, dw64OutDatagrams), 8, MetricKind::Counter},
+    {"UdpNumAddrs", "endpoints", 1, offsetof(MIB_UDPSTATS2, dwNumAddrs), 4, MetricKind::Gauge},
+    {"TcpListen", "connections", 2, MIB_TCP_STATE_LISTEN, 0, MetricKind::Gauge},
+    {"TcpTimeWait", "connections", 2, MIB_TCP_STATE_TIME_WAIT, 0, MetricKind::Gauge},
+    {"TcpCloseWait", "connections", 2, MIB_TCP_STATE_CLOSE_WAIT, 0, MetricKind::Gauge},
+};
+
+const char* const kDefaultStats[] = {"TcpRetransSegs", "TcpInErrs", "TcpAttemptFails", "TcpCurrEstab",
+                                     "TcpTimeWait", "UdpNoPorts", "UdpInErrors"};
+
+/// Familias de direcciones consultadas y el valor de su etiqueta `family`.
+const struct {
+    ULONG family;
+    const char* label;
+} kFamilies[2] = {{AF_INET, "ipv4"}, {AF_INET6, "ipv6"}};
+
+/// Campo DWORD o DWORD64 de una estructura MIB por su desplazamiento y tamaño.
+double fieldAt(const void* mib, std::size_t offset, std::size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(mib) + offset;
+    if (size == sizeof(DWORD64)) {
+        DWORD64 value;
+        std::memcpy(&value, bytes, sizeof(value));
+        return static_cast<double>(value);
+    }
+    DWORD value;
+    std::memcpy(&value, bytes, sizeof(value));
+    return static_cast<double>(value);
+}
+
+} // namespace
+
+NetMonitor::NetMonitor(const std::vector<std::string>& keys) : needTcp(false), needUdp(false), needStates(false) {
+    std::vector<std::string> selected = keys;
+    if (selected.empty()) selected.assign(std::begin(kDefaultStats), std::end(kDefaultStats));
+
+    for (const std::string& key : selected) {
+        bool known = false;
+        for (const auto& s : kNetStats) {
+            if (key != s.key) continue;
+            known = true;
+            Source source = s.source == 0 ? Source::Tcp : s.source == 1 ? Source::Udp : Source::TcpState;
+            stats.push_back(Stat{source, s.field, s.size, s.key, s.unit, s.kind});
+            needTcp = needTcp || source == Source::Tcp;
+            needUdp = needUdp || source == Source::Udp;
+            needStates = needStates || source == Source::TcpState;
+            break;
+        }
+        if (!known) Logger::warn("Estadística de red desconocida; se ignora.", {{"stat", key}});
+    }
+}
+
+bool NetMonitor::countStates(unsigned long (&counts)[16]) {
+    std::memset(counts, 0, sizeof(counts));
+    bool any = false;
+
+    ULONG size = static_cast<ULONG>(table.size());
+    DWORD status = GetTcpTable(reinterpret_cast<PMIB_TCPTABLE>(table.data()), &size, FALSE);
+    if (status == ERROR_INSUFFICIENT_BUFFER) {
+        table.resize(size);
+        status = GetTcpTable(reinterpret_cast<PMIB_TCPTABLE>(table.data()), &size, FALSE);
+    }
+    if (status == NO_ERROR) {
+        const MIB_TCPTABLE* tcp = reinterpret_cast<const MIB_TCPTABLE*>(table.data());
+        for (DWORD i = 0; i < tcp->dwNumEntries; ++i) {
+            if (tcp->table[i].dwState < 16) ++counts[tcp->table[i].dwState];
+        }
+        any = true;
+    }
+
+    size = static_cast<ULONG>(table.size());
+    status = GetTcp6Table(reinterpret_cast<PMIB_TCP6TABLE>(table.data()), &size, FALSE);
+    if (status == ERROR_INSUFFICIENT_BUFFER) {
+        table.resize(size);
+        status = GetTcp6Table(reinterpret_cast<PMIB_TCP6TABLE>(table.data()), &size, FALSE);
+    }
+    if (status == NO_ERROR) {
+        const MIB_TCP6TABLE* tcp6 = reinterpret_cast<const MIB_TCP6TABLE*>(table.data());
+        for (DWORD i = 0; i < tcp6->dwNumEntries; ++i) {
+            DWORD state = static_cast<DWORD>(tcp6->table[i].State);
+            if (state < 16) ++counts[state];
+        }
+        any = true;
+    }
+    return any;
+}
+
+std::size_t NetMonitor::collect(std::vector<Metric>& out) {
+    auto now = std::chrono::system_clock::now();
+    long long timestamp = std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count();
+    std::size_t added = 0;
+
+    // Una llamada por tabla y familia; IPv6 puede no estar instalado. Cada
+    // familia es su propia serie: sus contadores de 32 bits dan la vuelta por
+    // separado, y una familia que falla en un ciclo no publica ceros.
+    MIB_TCPSTATS2 tcp[2] = {};
+    MIB_UDPSTATS2 udp[2] = {};
+    bool tcpOk[2] = {}, udpOk[2] = {};
+    bool statesOk = false;
+    for (int f = 0; f < 2; ++f) {
+        if (needTcp) tcpOk[f] = GetTcpStatisticsEx2(&tcp[f], kFamilies[f].family) == NO_ERROR;
+        if (needUdp) udpOk[f] = GetUdpStatisticsEx2(&udp[f], kFamilies[f].family) == NO_ERROR;
+    }
+    unsigned long states[16];
+    if (needStates) statesOk = countStates(states);
+
+    auto push = [&](const Stat& s, double value, const char* family) {
+        Metric m;
+        m.component = "Net";
+        m.metric = s.metric;
+        m.unit = s.unit;
+        m.value = value;
+        m.timestamp = timestamp;
+        m.kind = s.kind;
+        if (family) m.labels.emplace_back("family", family);
+        out.push_back(std::move(m));
+        ++added;
+    };
+
+    for (const Stat& s : stats) {
+        if (s.source == Source::TcpState) {
+            if (statesOk) push(s, static_cast<double>(states[s.field]), nullptr);
+            continue;
+        }
+        for (int f = 0; f < 2; ++f) {
+            if (s.source == Source::Tcp && tcpOk[f]) push(s, fieldAt(&tcp[f], s.field, s.size), kFamilies[f].label);
+            if (s.source == Source::Udp && udpOk[f]) push(s, fieldAt(&udp[f], s.field, s.size), kFamilies[f].label);
+        }
+    }
+    return added;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file net_monitor.hpp
+ * @brief Estadísticas de los protocolos TCP y UDP y conexiones por estado.
+ * @details
+ * Retransmisiones, conexiones rechazadas o miles de sockets en TIME_WAIT no se
+ * ven en ninguna métrica de CPU o memoria. NetMonitor publica (componente
+ * "Net") las estadísticas que el usuario elija en `[collector.net]`:
+ *
+ * @code{.ini}
+ * [collector.net]
+ * stat = TcpRetransSegs
+ * stat = TcpTimeWait
+ * @endcode
+ *
+ * Los nombres siguen los de las tablas SNMP (MIB-II) de TCP y UDP:
+ * `TcpActiveOpens`, `TcpPassiveOpens`, `TcpAttemptFails`, `TcpEstabResets`,
+ * `TcpInSegs`, `TcpOutSegs`, `TcpRetransSegs`, `TcpInErrs`, `TcpOutRsts`,
+ * `UdpInDatagrams`, `UdpNoPorts`, `UdpInErrors`, `UdpOutDatagrams` son
+ * contadores (RateEngine deriva sus tasas); `TcpCurrEstab`, `TcpNumConns` y
+ * `UdpNumAddrs` son gauges. Sin claves se usa un conjunto por defecto.
+ *
+ * Cada estadística de TCP/UDP es una serie por familia, con la etiqueta
+ * `family` (`ipv4`, `ipv6`): no se suman. Se leen con
+ * GetTcpStatisticsEx2/GetUdpStatisticsEx2 (Windows 10 1709 o posterior), que
+ * dan segmentos y datagramas en 64 bits; el resto de los contadores (errores,
+ * retransmisiones, aperturas) sigue en 32 bits, y al dar la vuelta en su
+ * propia serie RateEngine lo trata como un reinicio. Una familia sin pila
+ * instalada o cuya lectura falla no publica nada en ese ciclo.
+ *
+ * Además, conexiones TCP por estado (gauges, como `/proc/net/sockstat`, IPv4 e IPv6 juntas):
+ * `TcpListen`, `TcpTimeWait`, `TcpCloseWait`. Solo si se pidió alguna se
+ * recorre la tabla de conexiones, que en un servidor cargado es grande.
+ *
+ * Las claves se resuelven una vez al construir el colector a la estructura y
+ * el campo de donde se leen: cada ciclo es una llamada por tabla y familia y
+ * una lectura por desplazamiento.
+ *
+ * Windows no publica desbordes de la cola de listen ni sockets huérfanos.
+ * @author Sergio Gonzalez
+ * @date 2026-07-04
+ */
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "collector.hpp"
+
+/**
+ * @class NetMonitor
+ * @brief Colector de estadísticas de TCP y UDP.
+ */
+class NetMonitor : public Collector {
+private:
+    /// De dónde sale una estadística.
+    enum class Source : unsigned char { Tcp, Udp, TcpState };
+
+    /// Estadística elegida por el usuario, ya resuelta.
+    struct Stat {
+        Source source;
+        std::size_t field;   ///< Desplazamiento en MIB_TCPSTATS2/MIB_UDPSTATS2, o estado MIB_TCP_STATE.
+        std::size_t size;    ///< Bytes del campo (4 u 8).
+        const char* metric;
+        const char* unit;
+        MetricKind kind;
+    };
+
+    std::vector<Stat> stats;
+    bool needTcp;
+    bool needUdp;
+    bool needStates;
+    std::vector<unsigned char> table;   ///< Reutilizado para las tablas de conexiones.
+
+    /** @brief Cuenta las conexiones IPv4 + IPv6 en cada estado (índice = MIB_TCP_STATE). */
+    bool countStates(unsigned long (&counts)[16]);
+
+public:
+    /**
+     * @param keys Nombres de estadísticas; los desconocidos se ignoran con un aviso.
+     */
+    explicit NetMonitor(const std::vector<std::string>& keys = {});
+
+    const char* name() const override { return "Net"; }
+
+    std::size_t collect(std::vector<Metric>& out) override;
+};
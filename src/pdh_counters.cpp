@@ -0,0 +1,132 @@
+/**
+ * @file pdh_counters.cpp
+ * @brief Implementación de PdhCounterSet sobre la API de PDH.
+ * @author Sergio Gonzalez
+ * @date 2026-05-23
+ */
+
+#include "pdh_counters.hpp"
+#include <windows.h>
+#include <pdh.h>
+#include <cstdlib>
+
+namespace {
+
+std::wstring toWide(const std::string& text) {
+    int n = MultiByteToWideChar(CP_UTF8, 0, text.c_str(), -1, nullptr, 0);
+    if (n <= 0) return std::wstring();
+    std::vector<wchar_t> buffer(static_cast<size_t>(n));
+    MultiByteToWideChar(CP_UTF8, 0, text.c_str(), -1, buffer.data(), n);
+    return std::wstring(buffer.data());
+}
+
+/**
+ * @brief Copia un nombre de instancia UTF-16 a @p out reutilizando su capacidad.
+ * @details Los nombres de instancia de los contadores que usamos son ASCII
+ * (números de CPU, letras de unidad); cualquier otro carácter se reemplaza por '?'.
+ */
+void assignInstance(std::string& out, const wchar_t* name) {
+    out.clear();
+    for (; name && *name; ++name) {
+        out.push_back(*name < 0x80 ? static_cast<char>(*name) : '?');
+    }
+}
+
+} // namespace
+
+bool processorInstance(const std::string& instance, std::string& cpu) {
+    std::size_t comma = instance.find(',');
+    if (comma == std::string::npos || comma + 1 >= instance.size() || instance[comma + 1] == '_') return false;
+    long group = std::strtol(instance.c_str(), nullptr, 10);
+    long number = std::strtol(instance.c_str() + comma + 1, nullptr, 10);
+    cpu = std::to_string(group * 64 + number);
+    return true;
+}
+
+PdhCounterSet::PdhCounterSet() : query(nullptr) {
+    PDH_HQUERY handle = nullptr;
+    if (PdhOpenQueryW(nullptr, 0, &handle) == ERROR_SUCCESS) {
+        query = handle;
+    }
+}
+
+PdhCounterSet::~PdhCounterSet() {
+    if (query) PdhCloseQuery(static_cast<PDH_HQUERY>(query));
+}
+
+int PdhCounterSet::add(const std::string& englishPath) {
+    if (!query) return -1;
+    PDH_HCOUNTER counter = nullptr;
+    std::wstring path = toWide(englishPath);
+    if (PdhAddEnglishCounterW(static_cast<PDH_HQUERY>(query), path.c_str(), 0, &counter) != ERROR_SUCCESS) {
+        return -1;
+    }
+    counters.push_back(counter);
+    return static_cast<int>(counters.size() - 1);
+}
+
+bool PdhCounterSet::collect() {
+    return query && PdhCollectQueryData(static_cast<PDH_HQUERY>(query)) == ERROR_SUCCESS;
+}
+
+bool PdhCounterSet::raw(int index, long long& value) const {
+    if (index < 0 || static_cast<std::size_t>(index) >= counters.size()) return false;
+    PDH_RAW_COUNTER rawValue;
+    DWORD type = 0;
+    if (PdhGetRawCounterValue(static_cast<PDH_HCOUNTER>(counters[static_cast<std::size_t>(index)]), &type, &rawValue) !=
+            ERROR_SUCCESS ||
+        (rawValue.CStatus != PDH_CSTATUS_VALID_DATA && rawValue.CStatus != PDH_CSTATUS_NEW_DATA)) {
+        return false;
+    }
+    value = rawValue.FirstValue;
+    return true;
+}
+
+bool PdhCounterSet::formatted(int index, double& value) const {
+    if (index < 0 || static_cast<std::size_t>(index) >= counters.size()) return false;
+    PDH_FMT_COUNTERVALUE formattedValue;
+    DWORD type = 0;
+    if (PdhGetFormattedCounterValue(static_cast<PDH_HCOUNTER>(counters[static_cast<std::size_t>(index)]),
+                                    PDH_FMT_DOUBLE | PDH_FMT_NOCAP100, &type, &formattedValue) != ERROR_SUCCESS ||
+        formattedValue.CStatus != PDH_CSTATUS_VALID_DATA) {
+        return false;
+    }
+    value = formattedValue.doubleValue;
+    return true;
+}
+
+/**
+ * @details El tamaño necesario puede cambiar entre ciclos (se conecta un
+ * disco, se agrega una instancia): si PDH pide más espacio, se agranda el
+ * buffer y se reintenta. Después de los primeros ciclos no se reserva memoria.
+ */
+bool PdhCounterSet::rawArray(int index, std::vector<PdhInstanceValue>& out) {
+    if (index < 0 || static_cast<std::size_t>(index) >= counters.size()) {
+        out.clear();
+        return false;
+    }
+    PDH_HCOUNTER counter = static_cast<PDH_HCOUNTER>(counters[static_cast<std::size_t>(index)]);
+
+    DWORD size = static_cast<DWORD>(buffer.size());
+    DWORD count = 0;
+    PDH_STATUS status;
+    for (int attempt = 0; attempt < 3; ++attempt) {
+        status = PdhGetRawCounterArrayW(counter, &size, &count,
+                                        buffer.empty() ? nullptr : reinterpret_cast<PDH_RAW_COUNTER_ITEM_W*>(buffer.data()));
+        if (status != static_cast<PDH_STATUS>(PDH_MORE_DATA)) break;
+        buffer.resize(size);
+    }
+    if (status != ERROR_SUCCESS) {
+        out.clear();
+        return false;
+    }
+
+    // resize() y no clear(): los nombres ya asignados conservan su capacidad.
+    const PDH_RAW_COUNTER_ITEM_W* items = reinterpret_cast<const PDH_RAW_COUNTER_ITEM_W*>(buffer.data());
+    out.resize(count);
+    for (DWORD i = 0; i < count; ++i) {
+        assignInstance(out[i].instance, items[i].szName);
+        out[i].value = items[i].RawValue.FirstValue;
+    }
+    return true;
+}
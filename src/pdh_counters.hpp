@@ -0,0 +1,88 @@
+/**
+ * @file pdh_counters.hpp
+ * @brief Grupo de contadores de rendimiento de Windows (PDH) leídos con una sola consulta.
+ * @details
+ * PDH (Performance Data Helper) expone los mismos contadores que el Monitor
+ * de rendimiento: `\System\Context Switches/sec`, `\Memory\Page Faults/sec`,
+ * `\Processor(*)\Interrupts/sec`... Todos los contadores de un grupo se leen
+ * juntos con collect() (una llamada por ciclo, sin importar cuántos haya).
+ *
+ * Se usan los valores CRUDOS: en los contadores "/sec" el valor crudo es el
+ * total acumulado desde el arranque, que es justo lo que espera RateEngine
+ * (MetricKind::Counter). Así no hace falta guardar la lectura anterior ni
+ * esperar dos muestras para tener un valor.
+ *
+ * Las rutas se agregan en inglés (PdhAddEnglishCounter), así funcionan igual
+ * en un Windows en cualquier idioma. Una ruta con comodín (`\Processor(*)\...`)
+ * devuelve un valor por instancia con rawArray().
+ *
+ * Los handles de PDH se guardan como void* para no incluir pdh.h en la cabecera.
+ * @author Sergio Gonzalez
+ * @date 2026-05-23
+ */
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @struct PdhInstanceValue
+ * @brief Valor crudo de una instancia de un contador con comodín.
+ */
+struct PdhInstanceValue {
+    std::string instance;   ///< Nombre de la instancia (`0`, `1`, `_Total`, `C:`...).
+    long long value = 0;
+};
+
+/**
+ * @brief Convierte una instancia `<grupo>,<número>` de `\Processor Information(*)` en el número de CPU.
+ * @details Hasta 64 CPU por grupo: en el grupo 0 coincide con la numeración de PerfMonitor.
+ * @return false para los totales (`_Total`, `0,_Total`).
+ */
+bool processorInstance(const std::string& instance, std::string& cpu);
+
+/**
+ * @class PdhCounterSet
+ * @brief Consulta PDH con sus contadores.
+ */
+class PdhCounterSet {
+private:
+    void* query;                          ///< PDH_HQUERY
+    std::vector<void*> counters;          ///< PDH_HCOUNTER por índice de add().
+    std::vector<unsigned char> buffer;    ///< Reutilizado por rawArray().
+
+public:
+    PdhCounterSet();
+    ~PdhCounterSet();
+
+    PdhCounterSet(const PdhCounterSet&) = delete;
+    PdhCounterSet& operator=(const PdhCounterSet&) = delete;
+
+    /**
+     * @brief Agrega un contador por su ruta en inglés.
+     * @return Índice del contador, o -1 si este equipo no lo tiene (versión de
+     * Windows, permisos, proveedor deshabilitado).
+     */
+    int add(const std::string& englishPath);
+
+    /**
+     * @brief Lee todos los contadores del grupo. Se llama una vez por ciclo, antes de raw().
+     */
+    bool collect();
+
+    /** @brief Valor crudo (acumulado, en los contadores "/sec") de la última lectura. */
+    bool raw(int index, long long& value) const;
+
+    /**
+     * @brief Valor ya calculado por PDH (p. ej. una longitud de cola, que no es acumulada).
+     */
+    bool formatted(int index, double& value) const;
+
+    /**
+     * @brief Valores crudos de todas las instancias de un contador con comodín.
+     * @param out Se reutiliza entre ciclos sin liberar su capacidad.
+     */
+    bool rawArray(int index, std::vector<PdhInstanceValue>& out);
+
+    std::size_t size() const { return counters.size(); }
+};
@@ -0,0 +1,77 @@
+/**
+ * @file perf_monitor.cpp
+ * @brief Implementación de PerfMonitor.
+ * @author Sergio Gonzalez
+ * @date 2026-05-23
+ */
+
+#include "perf_monitor.hpp"
+#include <windows.h>
+#include <intrin.h>
+#include <chrono>
+
+PerfMonitor::PerfMonitor() : cyclesAvailable(false) {
+    static const struct {
+        const char* path;
+        const char* metric;
+        const char* unit;
+    } kCounters[] = {
+        {"\\System\\Context Switches/sec", "ContextSwitches", "switches"},
+        {"\\System\\System Calls/sec", "SystemCalls", "calls"},
+    };
+    for (const auto& c : kCounters) {
+        int index = pdh.add(c.path);
+        if (index >= 0) software.push_back(SoftwareCounter{index, c.metric, c.unit});
+    }
+
+    // Primera llamada solo para saber cuántas CPU hay (en el grupo de procesadores actual).
+    ULONG size = 0;
+    QueryIdleProcessorCycleTime(&size, nullptr);
+    if (size >= sizeof(ULONG64)) {
+        idleCycles.resize(size / sizeof(ULONG64));
+        cyclesAvailable = QueryIdleProcessorCycleTime(&size, reinterpret_cast<PULONG64>(idleCycles.data())) != 0;
+        for (std::size_t cpu = 0; cpu < idleCycles.size(); ++cpu) {
+            cpuLabels.push_back(std::to_string(cpu));
+        }
+    }
+}
+
+std::size_t PerfMonitor::collect(std::vector<Metric>& out) {
+    auto now = std::chrono::system_clock::now();
+    long long timestamp = std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count();
+    std::size_t added = 0;
+
+    auto push = [&](const char* metric, const char* unit, double value, const std::string* cpu) {
+        Metric m;
+        m.component = "Perf";
+        m.metric = metric;
+        m.unit = unit;
+        m.value = value;
+        m.timestamp = timestamp;
+        m.kind = MetricKind::Counter;
+        if (cpu) m.labels.emplace_back("cpu", *cpu);
+        out.push_back(std::move(m));
+        ++added;
+    };
+
+    if (!software.empty() && pdh.collect()) {
+        for (const SoftwareCounter& c : software) {
+            long long value;
+            if (pdh.raw(c.index, value)) push(c.metric, c.unit, static_cast<double>(value), nullptr);
+        }
+    }
+
+    if (cyclesAvailable) {
+        // El TSC se lee justo después de los ciclos ociosos: la diferencia entre
+        // ambas lecturas es despreciable frente a un intervalo de muestreo.
+        ULONG size = static_cast<ULONG>(idleCycles.size() * sizeof(ULONG64));
+        if (QueryIdleProcessorCycleTime(&size, reinterpret_cast<PULONG64>(idleCycles.data()))) {
+            std::uint64_t tsc = __rdtsc();
+            for (std::size_t cpu = 0; cpu < idleCycles.size(); ++cpu) {
+                if (idleCycles[cpu] > tsc) continue;  // TSC no sincronizado entre CPU: no hay dato fiable.
+                push("Cycles", "cycles", static_cast<double>(tsc - idleCycles[cpu]), &cpuLabels[cpu]);
+            }
+        }
+    }
+    return added;
+}
@@ -0,0 +1,62 @@
+/**
+ * @file perf_monitor.hpp
+ * @brief Contadores de actividad del sistema: ciclos por CPU, cambios de contexto, llamadas al sistema.
+ * @details
+ * El "Usage" de CpuMonitor dice cuánto tiempo NO estuvo ociosa la CPU, pero no
+ * qué pasó en ese tiempo. PerfMonitor publica los contadores crudos del
+ * sistema (MetricKind::Counter); RateEngine deriva sus tasas en la ingesta:
+ *
+ *  - `Perf/Cycles{cpu=N}`: ciclos de reloj de referencia (TSC) en los que la
+ *    CPU N no estuvo ociosa. Se obtiene del TSC menos los ciclos ociosos que
+ *    lleva Windows por procesador (QueryIdleProcessorCycleTime).
+ *  - `Perf/ContextSwitches`, `Perf/SystemCalls`: contadores de PDH del sistema.
+ *
+ * Los fallos de página son de VmMonitor (`Vm/PageFaults`, `Vm/MajorFaults`).
+ *
+ * Windows no expone a un proceso de usuario los contadores de hardware de la
+ * CPU (instrucciones retiradas, fallos de caché, de predicción de saltos): eso
+ * requiere un driver. Por eso no hay IPC; si los ciclos por CPU tampoco están
+ * disponibles (máquinas virtuales con TSC no fiable, Windows antiguos) quedan
+ * solo los contadores de software.
+ *
+ * Todos los contadores de PDH se leen con una sola consulta por ciclo (ver
+ * PdhCounterSet) y los ciclos de todas las CPU con una sola llamada.
+ * @author Sergio Gonzalez
+ * @date 2026-05-23
+ */
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "collector.hpp"
+#include "pdh_counters.hpp"
+
+/**
+ * @class PerfMonitor
+ * @brief Colector de contadores de actividad del sistema.
+ */
+class PerfMonitor : public Collector {
+private:
+    /// Contador de software del sistema y la métrica que lo publica.
+    struct SoftwareCounter {
+        int index;
+        const char* metric;
+        const char* unit;
+    };
+
+    PdhCounterSet pdh;
+    std::vector<SoftwareCounter> software;
+    bool cyclesAvailable;
+    std::vector<std::uint64_t> idleCycles;   ///< Reutilizado: ciclos ociosos por CPU.
+    std::vector<std::string> cpuLabels;      ///< "0", "1"... precalculados.
+
+public:
+    PerfMonitor();
+
+    const char* name() const override { return "Perf"; }
+
+    std::size_t collect(std::vector<Metric>& out) override;
+
+    /** @brief Hay ciclos por CPU (si no, solo contadores de software). */
+    bool hasCycles() const { return cyclesAvailable; }
+};
@@ -0,0 +1,419 @@
+/**
+ * @file push_sink.cpp
+ * @brief Implementación de HttpPushSink.
+ *
+ * @details
+ * Line protocol (una línea por muestra):
+ *
+ *     <component>[,unit=<unit>][,<etiqueta>=<valor>...] <metric>=<valor> <timestamp en segundos>
+ *
+ * OTLP: un ExportMetricsServiceRequest con un único ResourceMetrics
+ * (service.name = "syspulse") y un Metric de tipo gauge por muestra, con nombre
+ * "<component>.<metric>" y las etiquetas como atributos del punto. Los tamaños de cada mensaje se calculan antes de
+ * escribirlo, así que el protobuf se arma en una sola pasada sobre el buffer.
+ *
+ * Respuestas del servidor:
+ *  - 2xx: enviado.
+ *  - 4xx (salvo 408 y 429): el servidor rechaza el contenido; reintentar no
+ *    serviría, así que el lote se descarta y se cuenta en dropped().
+ *  - Error de red, 408, 429 o 5xx: se guarda y se reintenta más tarde.
+ *
+ * @author Sergio Gonzalez
+ * @date 2026-03-21
+ */
+
+#include "push_sink.hpp"
+#include "http_client.hpp"
+#include "logger.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+#ifdef SYSPULSE_WITH_ZLIB
+#include <zlib.h>
+#endif
+
+namespace {
+
+constexpr std::chrono::milliseconds kInitialBackoff(1000);
+constexpr std::chrono::milliseconds kMaxBackoff(60000);
+/// Pendientes que se reenvían como máximo en cada write(), para acotar su duración.
+constexpr int kMaxPendingPerWrite = 16;
+
+enum class SendResult { Sent, Rejected, Retry };
+
+SendResult classify(int status) {
+    if (status >= 200 && status < 300) return SendResult::Sent;
+    if (status >= 400 && status < 500 && status != 408 && status != 429) return SendResult::Rejected;
+    return SendResult::Retry;
+}
+
+/**
+ * @brief Agrega un texto escapando los caracteres especiales del line protocol.
+ * @param special Caracteres que llevan '\' delante (", " para medidas; ",= " para tags y campos).
+ */
+void appendEscaped(std::string& out, const std::string& text, const char* special) {
+    for (char c : text) {
+        if (c == '\n' || c == '\r') {
+            out.push_back(' ');
+            continue;
+        }
+        if (std::strchr(special, c)) out.push_back('\\');
+        out.push_back(c);
+    }
+}
+
+// --- Protobuf ---
+
+std::size_t varintSize(std::uint64_t value) {
+    std::size_t n = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        ++n;
+    }
+    return n;
+}
+
+void putVarint(std::string& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+/// Campo de tipo "length-delimited" (wire type 2): etiqueta y largo.
+void putLengthField(std::string& out, unsigned field, std::size_t length) {
+    putVarint(out, (field << 3) | 2);
+    putVarint(out, length);
+}
+
+/// Campo de 64 bits (wire type 1): fixed64 o double.
+void putFixed64Field(std::string& out, unsigned field, std::uint64_t bits) {
+    putVarint(out, (field << 3) | 1);
+    char bytes[8];
+    std::memcpy(bytes, &bits, 8);
+    out.append(bytes, 8);
+}
+
+std::size_t lengthFieldSize(std::size_t length) {
+    return 1 + varintSize(length) + length;
+}
+
+/// Resource { attributes: [ { key: "service.name", value: { string_value: "syspulse" } } ] }
+const std::string& otlpResource() {
+    static const std::string resource = [] {
+        std::string anyValue, keyValue, attributes;
+        putLengthField(anyValue, 1, 8);
+        anyValue += "syspulse";
+        putLengthField(keyValue, 1, 12);
+        keyValue += "service.name";
+        putLengthField(keyValue, 2, anyValue.size());
+        keyValue += anyValue;
+        putLengthField(attributes, 1, keyValue.size());
+        attributes += keyValue;
+        std::string field;
+        putLengthField(field, 1, attributes.size());
+        return field + attributes;
+    }();
+    return resource;
+}
+
+/// ScopeMetrics.scope = InstrumentationScope { name: "syspulse" }
+const std::string& otlpScope() {
+    static const std::string scope = [] {
+        std::string name;
+        putLengthField(name, 1, 8);
+        name += "syspulse";
+        std::string field;
+        putLengthField(field, 1, name.size());
+        return field + name;
+    }();
+    return scope;
+}
+
+/// NumberDataPoint con time_unix_nano y as_double: 2 campos de 1 + 8 bytes.
+constexpr std::size_t kDataPointSize = 18;
+/// Sum.aggregation_temporality (CUMULATIVE) + Sum.is_monotonic, 2 bytes cada uno.
+constexpr std::size_t kSumFieldsSize = 2 + 2;
+
+/// KeyValue { key, value: AnyValue { string_value } }
+std::size_t otlpAttributeSize(const Labels::value_type& label) {
+    return lengthFieldSize(label.first.size()) + lengthFieldSize(lengthFieldSize(label.second.size()));
+}
+
+void putOtlpAttribute(std::string& out, unsigned field, const Labels::value_type& label) {
+    putLengthField(out, field, otlpAttributeSize(label));
+    putLengthField(out, 1, label.first.size());              // KeyValue.key
+    out += label.first;
+    putLengthField(out, 2, lengthFieldSize(label.second.size())); // KeyValue.value
+    putLengthField(out, 1, label.second.size());             // AnyValue.string_value
+    out += label.second;
+}
+
+/// NumberDataPoint: tiempo, valor y una etiqueta por atributo.
+std::size_t otlpDataPointSize(const Metric& m) {
+    std::size_t size = kDataPointSize;
+    for (const auto& label : m.labels) {
+        size += lengthFieldSize(otlpAttributeSize(label));
+    }
+    return size;
+}
+
+/// Gauge o Sum: el punto y, en los contadores, los campos propios de Sum.
+std::size_t otlpPointsSize(const Metric& m) {
+    return lengthFieldSize(otlpDataPointSize(m)) + (m.kind == MetricKind::Counter ? kSumFieldsSize : 0);
+}
+
+std::size_t otlpMetricSize(const Metric& m) {
+    std::size_t size = lengthFieldSize(m.component.size() + 1 + m.metric.size());
+    if (!m.unit.empty()) size += lengthFieldSize(m.unit.size());
+    return size + lengthFieldSize(otlpPointsSize(m));
+}
+
+#ifdef SYSPULSE_WITH_ZLIB
+/**
+ * @brief Comprime en formato gzip (deflate con cabecera gzip: windowBits 15 + 16).
+ * @details Nivel 1: en datos de métricas comprime casi igual que el nivel por
+ * defecto y cuesta varias veces menos CPU.
+ */
+bool gzipCompress(const std::string& in, std::string& out) {
+    z_stream zs;
+    std::memset(&zs, 0, sizeof(zs));
+    if (deflateInit2(&zs, 1, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) return false;
+    out.resize(deflateBound(&zs, static_cast<uLong>(in.size())));
+    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in.data()));
+    zs.avail_in = static_cast<uInt>(in.size());
+    zs.next_out = reinterpret_cast<Bytef*>(&out[0]);
+    zs.avail_out = static_cast<uInt>(out.size());
+    int rc = deflate(&zs, Z_FINISH);
+    out.resize(zs.total_out);
+    deflateEnd(&zs);
+    return rc == Z_STREAM_END;
+}
+#endif
+
+} // namespace
+
+HttpPushSink::HttpPushSink(const PushConfig& c)
+    : config(c), client(std::make_unique<HttpClient>(c.host, c.port, c.timeoutMs)),
+      pendingBytes(0), nextPendingId(1), droppedBatches(0),
+      nextAttempt(std::chrono::steady_clock::now()), backoff(kInitialBackoff) {
+    contentType = config.format == PushFormat::OtlpProtobuf ? "application/x-protobuf" : "text/plain; charset=utf-8";
+    headers = config.extraHeaders;
+#ifdef SYSPULSE_WITH_ZLIB
+    if (config.compress) headers += "Content-Encoding: gzip\r\n";
+#endif
+    loadPending();
+}
+
+HttpPushSink::~HttpPushSink() = default;
+
+void HttpPushSink::serializeInflux(const std::vector<Metric>& batch) {
+    char number[64];
+    for (const Metric& m : batch) {
+        // NaN e infinito no son valores válidos en line protocol.
+        if (!std::isfinite(m.value)) continue;
+
+        if (m.component.empty()) payload += "syspulse";
+        else appendEscaped(payload, m.component, ", ");
+        if (!m.unit.empty()) {
+            payload += ",unit=";
+            appendEscaped(payload, m.unit, ",= ");
+        }
+        for (const auto& label : m.labels) {
+            if (label.second.empty()) continue;  // Line protocol no admite tags vacíos.
+            payload.push_back(',');
+            appendEscaped(payload, label.first, ",= ");
+            payload.push_back('=');
+            appendEscaped(payload, label.second, ",= ");
+        }
+        payload.push_back(' ');
+        if (m.metric.empty()) payload += "value";
+        else appendEscaped(payload, m.metric, ",= ");
+        int n = std::snprintf(number, sizeof(number), "=%.17g %lld\n", m.value, m.timestamp);
+        payload.append(number, static_cast<std::size_t>(n));
+    }
+}
+
+void HttpPushSink::serializeOtlp(const std::vector<Metric>& batch) {
+    const std::string& resource = otlpResource();
+    const std::string& scope = otlpScope();
+
+    std::size_t scopeMetricsSize = scope.size();
+    for (const Metric& m : batch) {
+        scopeMetricsSize += lengthFieldSize(otlpMetricSize(m));
+    }
+    std::size_t resourceMetricsSize = resource.size() + lengthFieldSize(scopeMetricsSize);
+
+    putLengthField(payload, 1, resourceMetricsSize);         // ExportMetricsServiceRequest.resource_metrics
+    payload += resource;                                     // ResourceMetrics.resource
+    putLengthField(payload, 2, scopeMetricsSize);            // ResourceMetrics.scope_metrics
+    payload += scope;                                        // ScopeMetrics.scope
+    for (const Metric& m : batch) {
+        putLengthField(payload, 2, otlpMetricSize(m));       // ScopeMetrics.metrics
+        putLengthField(payload, 1, m.component.size() + 1 + m.metric.size()); // Metric.name
+        payload += m.component;
+        payload.push_back('.');
+        payload += m.metric;
+        if (!m.unit.empty()) {
+            putLengthField(payload, 3, m.unit.size());       // Metric.unit
+            payload += m.unit;
+        }
+        // Los contadores crudos van como Sum acumulativa y monótona: el
+        // servidor calcula la tasa igual que RateEngine.
+        putLengthField(payload, m.kind == MetricKind::Counter ? 7 : 5, otlpPointsSize(m)); // Metric.sum / Metric.gauge
+        putLengthField(payload, 1, otlpDataPointSize(m));    // Gauge/Sum.data_points
+        putFixed64Field(payload, 3, static_cast<std::uint64_t>(m.timestamp) * 1000000000ull); // time_unix_nano
+        std::uint64_t bits;
+        std::memcpy(&bits, &m.value, 8);
+        putFixed64Field(payload, 4, bits);                   // as_double
+        for (const auto& label : m.labels) {
+            putOtlpAttribute(payload, 7, label);             // NumberDataPoint.attributes
+        }
+        if (m.kind == MetricKind::Counter) {
+            payload.push_back(0x10);                         // Sum.aggregation_temporality
+            payload.push_back(2);                            //   = AGGREGATION_TEMPORALITY_CUMULATIVE
+            payload.push_back(0x18);                         // Sum.is_monotonic
+            payload.push_back(1);
+        }
+    }
+}
+
+bool HttpPushSink::send(const std::string& body) {
+    SendResult result;
+#ifdef SYSPULSE_WITH_ZLIB
+    if (config.compress && gzipCompress(body, compressed)) {
+        result = classify(client->post(config.path, contentType, compressed.data(), compressed.size(), headers));
+    } else {
+        result = classify(client->post(config.path, contentType, body.data(), body.size(), config.extraHeaders));
+    }
+#else
+    result = classify(client->post(config.path, contentType, body.data(), body.size(), headers));
+#endif
+    if (result == SendResult::Rejected) {
+        ++droppedBatches;
+        Logger::error("El servidor rechazó un lote; se descarta.", {{"host", config.host}, {"port", config.port}});
+    }
+    return result != SendResult::Retry;
+}
+
+/**
+ * @brief Reconstruye la cola de pendientes a partir del directorio (sobrevive a reinicios).
+ */
+void HttpPushSink::loadPending() {
+    std::error_code ec;
+    std::filesystem::create_directories(config.pendingDir, ec);
+
+    std::vector<std::pair<std::uint64_t, PendingBatch>> found;
+    for (const auto& entry : std::filesystem::directory_iterator(config.pendingDir, ec)) {
+        unsigned long long id = 0;
+        std::string name = entry.path().filename().string();
+        if (std::sscanf(name.c_str(), "batch-%llu.pending", &id) != 1) continue;
+        std::uint64_t size = entry.file_size(ec);
+        if (ec) continue;
+        found.push_back({id, PendingBatch{entry.path().string(), size}});
+    }
+    std::sort(found.begin(), found.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    for (auto& f : found) {
+        pendingBytes += f.second.size;
+        nextPendingId = f.first + 1;
+        pending.push_back(std::move(f.second));
+    }
+}
+
+/**
+ * @brief Guarda un lote en el directorio de pendientes, descartando los más
+ * antiguos si se supera maxPendingBytes.
+ */
+bool HttpPushSink::store(const std::string& body) {
+    if (body.empty()) return true;
+    if (body.size() > config.maxPendingBytes) {
+        ++droppedBatches;
+        return false;
+    }
+    while (!pending.empty() && pendingBytes + body.size() > config.maxPendingBytes) {
+        std::remove(pending.front().path.c_str());
+        pendingBytes -= pending.front().size;
+        pending.pop_front();
+        ++droppedBatches;
+    }
+
+    char name[48];
+    std::snprintf(name, sizeof(name), "/batch-%016llu.pending", static_cast<unsigned long long>(nextPendingId));
+    std::string path = config.pendingDir + name;
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) {
+        ++droppedBatches;
+        return false;
+    }
+    bool ok = std::fwrite(body.data(), 1, body.size(), f) == body.size();
+    ok = std::fclose(f) == 0 && ok;
+    if (!ok) {
+        std::remove(path.c_str());
+        ++droppedBatches;
+        return false;
+    }
+
+    ++nextPendingId;
+    pendingBytes += body.size();
+    pending.push_back(PendingBatch{path, body.size()});
+    return true;
+}
+
+void HttpPushSink::onFailure() {
+    client->close();
+    nextAttempt = std::chrono::steady_clock::now() + backoff;
+    backoff = std::min(backoff * 2, kMaxBackoff);
+}
+
+bool HttpPushSink::write(const std::vector<Metric>& batch) {
+    payload.clear();
+    if (!batch.empty()) {
+        if (config.format == PushFormat::OtlpProtobuf) serializeOtlp(batch);
+        else serializeInflux(batch);
+    }
+
+    // Dentro de la espera exponencial no se toca la red.
+    if (std::chrono::steady_clock::now() < nextAttempt) {
+        return store(payload);
+    }
+
+    for (int i = 0; i < kMaxPendingPerWrite && !pending.empty(); ++i) {
+        const PendingBatch& oldest = pending.front();
+        fileBuffer.clear();
+        if (std::FILE* f = std::fopen(oldest.path.c_str(), "rb")) {
+            fileBuffer.resize(static_cast<std::size_t>(oldest.size));
+            fileBuffer.resize(std::fread(&fileBuffer[0], 1, fileBuffer.size(), f));
+            std::fclose(f);
+        }
+        if (!fileBuffer.empty() && !send(fileBuffer)) {
+            onFailure();
+            return store(payload);
+        }
+        std::remove(oldest.path.c_str());
+        pendingBytes -= oldest.size;
+        pending.pop_front();
+    }
+
+    if (!payload.empty() && !send(payload)) {
+        onFailure();
+        return store(payload);
+    }
+    backoff = kInitialBackoff;
+    return true;
+}
+
+bool HttpPushSink::flush() {
+    nextAttempt = std::chrono::steady_clock::now();
+    std::size_t rounds = (pending.size() + kMaxPendingPerWrite - 1) / kMaxPendingPerWrite;
+    static const std::vector<Metric> empty;
+    for (std::size_t i = 0; i < rounds && !pending.empty(); ++i) {
+        write(empty);
+        if (std::chrono::steady_clock::now() < nextAttempt) break;
+    }
+    return pending.empty();
+}
@@ -0,0 +1,107 @@
+/**
+ * @file push_sink.hpp
+ * @brief Envío de métricas a un servidor central por HTTP (InfluxDB line protocol u OTLP).
+ * @details
+ * Cada lote se serializa en un buffer reutilizado (sin reservas de memoria por
+ * muestra una vez que el buffer alcanzó su tamaño), se comprime con gzip si el
+ * proyecto se compiló con zlib y se envía por una conexión persistente.
+ *
+ * Si el servidor no responde, el lote se guarda en un directorio local acotado
+ * y se reintenta con espera exponencial (1 s, 2 s, 4 s... hasta 60 s). Cuando el
+ * servidor vuelve, los lotes pendientes se envían del más antiguo al más nuevo.
+ * @author Sergio Gonzalez
+ * @date 2026-03-21
+ */
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+#include "sink.hpp"
+
+class HttpClient;
+
+/**
+ * @enum PushFormat
+ * @brief Formato del cuerpo de las peticiones.
+ */
+enum class PushFormat {
+    InfluxLine,  ///< InfluxDB line protocol: `CPU,unit=% Usage=12.5 1700000000`.
+    OtlpProtobuf ///< OpenTelemetry OTLP/HTTP (ExportMetricsServiceRequest en protobuf), un gauge (o una sum monótona para los contadores) por muestra.
+};
+
+/**
+ * @struct PushConfig
+ * @brief Destino y límites del envío.
+ */
+struct PushConfig {
+    std::string host = "127.0.0.1";
+    unsigned short port = 8086;
+    std::string path = "/write?db=syspulse&precision=s"; ///< Para OTLP suele ser "/v1/metrics".
+    PushFormat format = PushFormat::InfluxLine;
+    std::string extraHeaders;                  ///< Por ejemplo "Authorization: Token ...\r\n".
+    int timeoutMs = 2000;                      ///< Tiempo máximo por operación de red.
+    std::string pendingDir = "data/push_pending";
+    std::uint64_t maxPendingBytes = 64ull << 20; ///< Tope del directorio de pendientes; se descartan los más antiguos.
+    bool compress = true;                      ///< gzip (solo si se compiló con SYSPULSE_WITH_ZLIB).
+};
+
+/**
+ * @class HttpPushSink
+ * @brief Sink que empuja cada lote a un servidor HTTP.
+ */
+class HttpPushSink : public MetricSink {
+private:
+    /**
+     * @struct PendingBatch
+     * @brief Lote guardado en disco a la espera de reintento.
+     */
+    struct PendingBatch {
+        std::string path;
+        std::uint64_t size;
+    };
+
+    PushConfig config;
+    std::unique_ptr<HttpClient> client;
+    std::string payload;            ///< Lote serializado (reutilizado).
+    std::string compressed;         ///< Lote comprimido (reutilizado).
+    std::string fileBuffer;         ///< Lectura de pendientes (reutilizado).
+    std::string contentType;
+    std::string headers;            ///< extraHeaders + Content-Encoding si corresponde.
+
+    std::deque<PendingBatch> pending;
+    std::uint64_t pendingBytes;
+    std::uint64_t nextPendingId;
+    std::uint64_t droppedBatches;
+
+    std::chrono::steady_clock::time_point nextAttempt;
+    std::chrono::milliseconds backoff;
+
+    void serializeInflux(const std::vector<Metric>& batch);
+    void serializeOtlp(const std::vector<Metric>& batch);
+    bool send(const std::string& body);
+    bool store(const std::string& body);
+    void loadPending();
+    void onFailure();
+
+public:
+    explicit HttpPushSink(const PushConfig& config);
+    ~HttpPushSink() override;
+
+    const char* name() const override { return "push"; }
+
+    /**
+     * @brief Envía el lote (y antes los pendientes). Si no se puede, lo guarda en disco.
+     * @return false solo si el lote no se pudo enviar NI guardar.
+     */
+    bool write(const std::vector<Metric>& batch) override;
+
+    /** @brief Intenta vaciar los pendientes ignorando la espera exponencial. */
+    bool flush() override;
+
+    std::size_t pendingCount() const { return pending.size(); }
+    std::uint64_t dropped() const { return droppedBatches; }
+};
@@ -0,0 +1,246 @@
+/**
+ * @file rate_engine.cpp
+ * @brief Implementación de RateEngine y del cálculo de tasas de contadores.
+ * @author Sergio Gonzalez
+ * @date 2026-04-25
+ */
+
+#include "rate_engine.hpp"
+#include <cmath>
+
+namespace {
+
+/// Tasa de un incremento en @p seconds segundos; false si el intervalo no es positivo.
+bool rateOver(double seconds, double v0, double v1, double& rate, bool* reset) {
+    if (!(seconds > 0.0) || !std::isfinite(v0) || !std::isfinite(v1)) return false;
+    bool restarted = v1 < v0;
+    double delta = restarted ? v1 : v1 - v0;
+    rate = delta / seconds;
+    if (reset) *reset = restarted;
+    return true;
+}
+
+/// La métrica es la tasa derivada (`<counter>.rate`) del contador @p counter de @p component.
+bool isRateOf(const Metric& m, const std::string& component, const std::string& counter) {
+    return m.component == component && m.metric.size() == counter.size() + 5 &&
+           m.metric.compare(0, counter.size(), counter) == 0 && m.metric.compare(counter.size(), 5, ".rate") == 0;
+}
+
+} // namespace
+
+bool counterRate(long long t0, double v0, long long t1, double v1, double& rate, bool* reset) {
+    if (t1 <= t0) return false;
+    return rateOver(static_cast<double>(t1 - t0), v0, v1, rate, reset);
+}
+
+std::size_t computeRates(const SeriesColumns& counters, SeriesColumns& rates) {
+    rates.clear();
+    if (counters.size() < 2) return 0;
+    rates.timestamps.reserve(counters.size() - 1);
+    rates.values.reserve(counters.size() - 1);
+
+    std::size_t resets = 0;
+    std::size_t previous = 0;
+    for (std::size_t i = 1; i < counters.size(); ++i) {
+        double rate;
+        bool reset;
+        if (!counterRate(counters.timestamps[previous], counters.values[previous],
+                         counters.timestamps[i], counters.values[i], rate, &reset)) {
+            continue;
+        }
+        rates.timestamps.push_back(counters.timestamps[i]);
+        rates.values.push_back(rate);
+        if (reset) ++resets;
+        previous = i;
+    }
+    return resets;
+}
+
+std::size_t RateEngine::derive(std::vector<Metric>& batch, std::size_t first) {
+    // Solo se recorren las métricas que trajo el lote, no las tasas que se van agregando.
+    std::size_t n = batch.size();
+    std::size_t added = 0;
+    for (std::size_t i = first; i < n; ++i) {
+        if (batch[i].kind != MetricKind::Counter) continue;
+        if (batch[i].timestamp > newestTimestamp) newestTimestamp = batch[i].timestamp;
+
+        keyBuffer.assign(batch[i].component);
+        keyBuffer.push_back('\x1f');
+        keyBuffer.append(batch[i].metric);
+        keyBuffer.push_back('\x1f');
+        keyBuffer.append(batch[i].unit);
+        if (!batch[i].labels.empty()) {
+            keyBuffer.push_back('\x1f');
+            appendLabels(keyBuffer, batch[i].labels);
+        }
+
+        const LastReading current{batch[i].timestamp, batch[i].collectedMs, batch[i].value};
+        auto it = last.find(keyBuffer);
+        if (it == last.end()) {
+            last.emplace(keyBuffer, current);
+            continue;
+        }
+
+        // Misma marca de tiempo (dos lecturas en el mismo segundo): se conserva
+        // la lectura anterior para que el próximo intervalo sea completo.
+        if (current.timestamp <= it->second.timestamp) continue;
+
+        // El timestamp redondea a segundos; si ambas lecturas traen el reloj
+        // monótono del scheduler, el intervalo real sale de ahí.
+        double seconds = static_cast<double>(current.timestamp - it->second.timestamp);
+        if (current.collectedMs > 0 && it->second.collectedMs > 0 && current.collectedMs > it->second.collectedMs) {
+            seconds = static_cast<double>(current.collectedMs - it->second.collectedMs) / 1000.0;
+        }
+
+        double rate;
+        bool reset;
+        if (!rateOver(seconds, it->second.value, current.value, rate, &reset)) continue;
+        if (reset) ++resetCount;
+        it->second = current;
+
+        // push_back puede reubicar el vector: se copia lo necesario antes.
+        Metric derived;
+        derived.component = batch[i].component;
+        derived.metric = batch[i].metric + ".rate";
+        derived.unit = batch[i].unit + "/s";
+        derived.value = rate;
+        derived.timestamp = batch[i].timestamp;
+        derived.labels = batch[i].labels;
+        batch.push_back(std::move(derived));
+        ++added;
+    }
+    if (added > 0) {
+        // Ambos miran solo las tasas recién agregadas, no los cocientes ni los repartos.
+        std::size_t end = batch.size();
+        if (!ratios.empty()) added += deriveRatios(batch, n);
+        if (!shares.empty()) added += deriveShares(batch, n, end);
+    }
+    if (++derivePass % kSweepEvery == 0) prune();
+    return added;
+}
+
+/**
+ * @details Las lecturas se juzgan por tiempo y no por cantidad de pasadas:
+ * derive() corre cada vez que vence algún colector, así que un colector con un
+ * intervalo largo puede no aparecer en cientos de pasadas seguidas. Las
+ * entradas de cocientes y repartos son solo memoria reutilizable: se borran
+ * las que ninguna pasada escribió desde la barrida anterior.
+ */
+void RateEngine::prune() {
+    for (auto it = last.begin(); it != last.end();) {
+        if (it->second.timestamp < newestTimestamp - kStaleSeconds) {
+            it = last.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (auto it = denominators.begin(); it != denominators.end();) {
+        if (it->second.pass <= sweptPass) {
+            it = denominators.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (auto it = shareGroups.begin(); it != shareGroups.end();) {
+        if (it->second.pass <= sweptPass) {
+            it = shareGroups.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    sweptPass = ratioPass;
+}
+
+/**
+ * @details Solo mira las tasas recién agregadas (desde @p firstRate). Por cada
+ * cociente, primero junta las tasas del denominador por etiquetas y después
+ * busca la pareja de cada tasa del numerador: lineal en el tamaño del lote.
+ */
+std::size_t RateEngine::deriveRatios(std::vector<Metric>& batch, std::size_t firstRate) {
+    std::size_t end = batch.size();
+    std::size_t added = 0;
+    for (const RateRatio& ratio : ratios) {
+        // En lugar de vaciar el mapa (y liberar sus claves) se marca cada
+        // entrada con la pasada que la escribió.
+        ++ratioPass;
+        bool any = false;
+        for (std::size_t i = firstRate; i < end; ++i) {
+            const Metric& m = batch[i];
+            if (isRateOf(m, ratio.component, ratio.denominator)) {
+                ratioKey.clear();
+                appendLabels(ratioKey, m.labels);
+                denominators[ratioKey] = Denominator{m.value, ratioPass};
+                any = true;
+            }
+        }
+        if (!any) continue;
+
+        for (std::size_t i = firstRate; i < end; ++i) {
+            if (!isRateOf(batch[i], ratio.component, ratio.numerator)) continue;
+            ratioKey.clear();
+            appendLabels(ratioKey, batch[i].labels);
+            auto it = denominators.find(ratioKey);
+            if (it == denominators.end() || it->second.pass != ratioPass || it->second.rate <= 0.0) continue;
+
+            Metric derived;
+            derived.component = ratio.component;
+            derived.metric = ratio.metric;
+            derived.unit = ratio.unit;
+            derived.value = ratio.scale * batch[i].value / it->second.rate;
+            derived.timestamp = batch[i].timestamp;
+            derived.labels = batch[i].labels;
+            batch.push_back(std::move(derived));
+            ++added;
+        }
+    }
+    return added;
+}
+
+/**
+ * @details Como deriveRatios(): una pasada junta las tasas por grupo (las
+ * etiquetas sin la del reparto) y otra publica un valor por grupo, en el orden
+ * en que aparecieron.
+ */
+std::size_t RateEngine::deriveShares(std::vector<Metric>& batch, std::size_t firstRate, std::size_t end) {
+    std::size_t added = 0;
+    for (const RateShare& share : shares) {
+        ++ratioPass;
+        touchedGroups.clear();
+        for (std::size_t i = firstRate; i < end; ++i) {
+            const Metric& m = batch[i];
+            if (!isRateOf(m, share.component, share.counter)) continue;
+            ratioKey.clear();
+            for (const auto& label : m.labels) {
+                if (label.first == share.label) continue;
+                ratioKey.append(label.first);
+                ratioKey.push_back('=');
+                ratioKey.append(label.second);
+                ratioKey.push_back('\x1f');
+            }
+            ShareGroup& group = shareGroups[ratioKey];
+            if (group.pass != ratioPass) {
+                group = ShareGroup{m.value, 0.0, i, ratioPass};
+                touchedGroups.push_back(&group);
+            }
+            if (m.value > group.max) group.max = m.value;
+            group.sum += m.value;
+        }
+
+        for (const ShareGroup* group : touchedGroups) {
+            if (group->sum <= 0.0) continue;
+            // push_back puede reubicar el vector: se copia lo necesario antes.
+            Metric derived;
+            derived.component = share.component;
+            derived.metric = share.metric;
+            derived.unit = share.unit;
+            derived.value = share.scale * group->max / group->sum;
+            derived.timestamp = batch[group->first].timestamp;
+            for (const auto& label : batch[group->first].labels) {
+                if (label.first != share.label) derived.labels.push_back(label);
+            }
+            batch.push_back(std::move(derived));
+            ++added;
+        }
+    }
+    return added;
+}
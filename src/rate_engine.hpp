@@ -0,0 +1,173 @@
+/**
+ * @file rate_engine.hpp
+ * @brief Tasas por segundo de contadores monótonos, compartidas por todos los colectores.
+ * @details
+ * Un colector de contadores (bytes de disco, paquetes de red, cambios de
+ * contexto) publica el valor acumulado que le da el sistema operativo, sin
+ * guardar la lectura anterior. La tasa se obtiene en un solo lugar:
+ *  - En la ingesta: RateEngine::derive() agrega al lote, por cada contador, la
+ *    serie `<metric>.rate` (gauge, unidad `<unit>/s`, mismas etiquetas), que
+ *    ven las alertas y todos los sinks. El contador crudo se guarda igual, sin
+ *    perder precisión.
+ *  - Al consultar: computeRates() calcula la misma tasa a partir de los
+ *    contadores crudos ya guardados (ver DatabaseManager::loadRates).
+ *
+ * Cocientes: addRatio() define series derivadas como el cociente de las tasas
+ * de dos contadores del mismo componente y etiquetas (fallos graves sobre el
+ * total de fallos de página, por ejemplo). Ambas tasas cubren el mismo
+ * intervalo, así que el cociente es el de los incrementos.
+ *
+ * Repartos: addShare() define series como la parte del total que se lleva la
+ * serie más cargada de un contador con una etiqueta por instancia (la CPU que
+ * atiende más interrupciones, por ejemplo). Se calcula sobre las tasas del
+ * mismo lote, así que el colector no guarda lecturas propias.
+ *
+ * Intervalo: en la ingesta el denominador de la tasa es el tiempo entre las
+ * dos lecturas medido por CollectorScheduler (Metric::collectedMs), no la
+ * resta de timestamps en segundos enteros, que puede valer 1 o 2 para el mismo
+ * intervalo de 1,5 s. Las tasas calculadas al consultar solo tienen los
+ * timestamps guardados.
+ *
+ * Reinicios: si un contador baja (reinicio del equipo, del servicio que lo
+ * expone o desborde de 32 bits) se asume que volvió a empezar desde cero, así
+ * que el incremento de ese intervalo es el valor nuevo. Nunca se publica una
+ * tasa negativa.
+ *
+ * Series que desaparecen (un proceso que terminó, un disco que se quitó, una
+ * serie de un agente que ya no la envía): cada kSweepEvery llamadas a derive()
+ * se olvidan las lecturas sin actualizar en kStaleSeconds, medidos contra el
+ * timestamp más nuevo visto, y las entradas de los cocientes y repartos que no
+ * se usaron desde la barrida anterior. Así un servicio que corre meses no
+ * acumula una entrada por cada serie que existió alguna vez.
+ * @author Sergio Gonzalez
+ * @date 2026-04-25
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "aggregation.hpp"
+#include "metric.hpp"
+
+/**
+ * @brief Tasa por segundo entre dos lecturas de un contador.
+ * @param rate Resultado (>= 0).
+ * @param reset Si no es nulo, indica si se detectó un reinicio del contador.
+ * @return false si el intervalo no es positivo (no hay tasa que calcular).
+ */
+bool counterRate(long long t0, double v0, long long t1, double v1, double& rate, bool* reset = nullptr);
+
+/**
+ * @brief Convierte una serie de contadores crudos en su serie de tasas.
+ * @details La tasa del intervalo (t[i-1], t[i]] se asigna a t[i]; la primera
+ * muestra no tiene tasa. Las muestras con el mismo timestamp que la anterior
+ * se omiten.
+ * @param counters Serie cruda, ordenada por tiempo.
+ * @param rates Destino; se vacía antes de calcular.
+ * @return Reinicios detectados.
+ */
+std::size_t computeRates(const SeriesColumns& counters, SeriesColumns& rates);
+
+/**
+ * @struct RateRatio
+ * @brief Serie derivada `<metric> = scale * rate(numerator) / rate(denominator)`.
+ */
+struct RateRatio {
+    std::string component;
+    std::string numerator;     ///< Métrica del contador de arriba.
+    std::string denominator;   ///< Métrica del contador de abajo; si su tasa es 0 no se publica nada.
+    std::string metric;        ///< Nombre de la serie derivada.
+    std::string unit;
+    double scale = 1.0;        ///< 100 para porcentajes.
+};
+
+/**
+ * @struct RateShare
+ * @brief Serie derivada `<metric> = scale * max(rate) / sum(rate)` entre las
+ * series de un contador que solo difieren en la etiqueta @p label.
+ * @details La serie derivada lleva las demás etiquetas; si la suma es 0 no se publica nada.
+ */
+struct RateShare {
+    std::string component;
+    std::string counter;       ///< Métrica del contador.
+    std::string label;         ///< Etiqueta que se agrega (`cpu`, por ejemplo).
+    std::string metric;        ///< Nombre de la serie derivada.
+    std::string unit;
+    double scale = 1.0;        ///< 100 para porcentajes.
+};
+
+/**
+ * @class RateEngine
+ * @brief Recuerda la última lectura de cada contador y deriva su tasa en la ingesta.
+ */
+class RateEngine {
+private:
+    struct LastReading {
+        long long timestamp;
+        long long collectedMs;   ///< Ver Metric::collectedMs; 0 = solo se conoce el segundo.
+        double value;
+    };
+
+    struct Denominator {
+        double rate;
+        std::uint64_t pass;      ///< Pasada de deriveRatios() que la escribió; las demás son viejas.
+    };
+
+    struct ShareGroup {
+        double max;
+        double sum;
+        std::size_t first;       ///< Tasa del lote de la que salen timestamp y etiquetas.
+        std::uint64_t pass;      ///< Como Denominator::pass.
+    };
+
+    std::unordered_map<std::string, LastReading> last; ///< Por serie (component, metric, unit y etiquetas).
+    std::string keyBuffer;                              ///< Reutilizado para no reservar memoria por muestra.
+    std::uint64_t resetCount = 0;
+
+    std::vector<RateRatio> ratios;
+    std::unordered_map<std::string, Denominator> denominators; ///< Reutilizado: etiquetas -> tasa del denominador.
+    std::string ratioKey;                                      ///< Reutilizado, como keyBuffer.
+    std::uint64_t ratioPass = 0;
+
+    std::vector<RateShare> shares;
+    std::unordered_map<std::string, ShareGroup> shareGroups;   ///< Reutilizado: demás etiquetas -> grupo.
+    std::vector<ShareGroup*> touchedGroups;                    ///< Grupos de la pasada, en orden de aparición.
+
+    std::uint64_t derivePass = 0;     ///< Llamadas a derive(), para espaciar las barridas.
+    long long newestTimestamp = 0;    ///< Timestamp más nuevo de un contador, referencia de kStaleSeconds.
+    std::uint64_t sweptPass = 0;      ///< ratioPass en la barrida anterior.
+
+    std::size_t deriveRatios(std::vector<Metric>& batch, std::size_t firstRate);
+    std::size_t deriveShares(std::vector<Metric>& batch, std::size_t firstRate, std::size_t end);
+    void prune();
+
+public:
+    /// Cada cuántas llamadas a derive() se buscan series desaparecidas.
+    static constexpr std::uint64_t kSweepEvery = 256;
+    /// Una lectura sin actualizar en este tiempo se olvida; debe superar el mayor interval_ms.
+    static constexpr long long kStaleSeconds = 3600;
+
+    /**
+     * @brief Agrega al final del lote la tasa de cada contador que ya tenía una
+     * lectura previa, y después los cocientes y repartos definidos con
+     * addRatio() y addShare().
+     * @param first Solo se miran las métricas desde esta posición (lo que trajo
+     *        un colector; CollectorScheduler deriva cada uno por separado).
+     * @return Series agregadas.
+     */
+    std::size_t derive(std::vector<Metric>& batch, std::size_t first = 0);
+
+    /** @brief Define un cociente de tasas que se calcula en cada derive(). */
+    void addRatio(const RateRatio& ratio) { ratios.push_back(ratio); }
+
+    /** @brief Define un reparto entre instancias que se calcula en cada derive(). */
+    void addShare(const RateShare& share) { shares.push_back(share); }
+
+    /** @brief Reinicios de contador detectados (acumulado). */
+    std::uint64_t resets() const { return resetCount; }
+
+    /** @brief Contadores con lectura previa registrada. */
+    std::size_t trackedSeries() const { return last.size(); }
+};
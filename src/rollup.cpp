@@ -0,0 +1,121 @@
+/**
+ * @file rollup.cpp
+ * @brief Implementación del gestor de rollups por serie.
+ *
+ * @author Sergio Gonzalez
+ * @date 2026-02-07
+ */
+
+#include "rollup.hpp"
+#include <algorithm>
+#include <cmath>
+
+RollupManager::RollupManager(int seconds) : bucketSeconds(seconds > 0 ? seconds : 60) {}
+
+long long RollupManager::bucketOf(long long timestamp) const {
+    // Redondeo hacia abajo también para timestamps negativos.
+    long long r = timestamp % bucketSeconds;
+    if (r < 0) r += bucketSeconds;
+    return timestamp - r;
+}
+
+/**
+ * @details La fila queda apuntando a la cubeta siguiente: una muestra de la
+ * que se cerró ya es atrasada y no la vuelve a abrir.
+ */
+void RollupManager::closeBucket(RollupRow& row) {
+    if (row.count > 0) {
+        completed.push_back(row);
+    }
+    row.bucketStart += bucketSeconds;
+    row.count = 0;
+    row.sum = 0.0;
+    row.sketch.clear();
+    row.histogram.clear();
+}
+
+void RollupManager::add(const Metric& m) {
+    if (!std::isfinite(m.value)) return;  // Arruinaría sum, min y max de toda la cubeta.
+
+    // Clave de la serie: component, metric, unit y etiquetas separados por un carácter de control.
+    keyBuffer.assign(m.component);
+    keyBuffer.push_back('\x1f');
+    keyBuffer.append(m.metric);
+    keyBuffer.push_back('\x1f');
+    keyBuffer.append(m.unit);
+    if (!m.labels.empty()) {
+        keyBuffer.push_back('\x1f');
+        appendLabels(keyBuffer, m.labels);
+    }
+
+    long long bucket = bucketOf(m.timestamp);
+
+    auto it = openBuckets.find(keyBuffer);
+    if (it == openBuckets.end()) {
+        RollupRow row;
+        row.component = m.component;
+        row.metric = m.metric;
+        row.unit = m.unit;
+        row.labels = m.labels;
+        row.bucketStart = bucket;
+        row.bucketSeconds = bucketSeconds;
+        it = openBuckets.emplace(keyBuffer, std::move(row)).first;
+    } else if (bucket > it->second.bucketStart) {
+        // La muestra pertenece a una cubeta posterior: cerramos la actual.
+        closeBucket(it->second);
+        it->second.bucketStart = bucket;
+    } else if (bucket < it->second.bucketStart) {
+        // Cubeta ya entregada: otra fila para el mismo intervalo partiría sus percentiles.
+        ++droppedCount;
+        return;
+    }
+
+    RollupRow& row = it->second;
+    if (m.histogram) {
+        const Histogram& h = *m.histogram;
+        if (h.count() == 0) return;
+        if (row.histogram.count() > 0 && !row.histogram.sameLayout(h)) {
+            ++droppedCount;
+            return;
+        }
+        row.histogram.merge(h);
+        row.min = row.count == 0 ? h.min() : std::min(row.min, h.min());
+        row.max = row.count == 0 ? h.max() : std::max(row.max, h.max());
+        row.count += h.count();
+        row.sum += h.sum();
+        return;
+    }
+
+    if (row.count == 0) {
+        row.min = m.value;
+        row.max = m.value;
+    } else {
+        row.min = std::min(row.min, m.value);
+        row.max = std::max(row.max, m.value);
+    }
+    ++row.count;
+    row.sum += m.value;
+    row.sketch.add(m.value);
+}
+
+void RollupManager::closeExpired(long long now) {
+    for (auto& entry : openBuckets) {
+        RollupRow& row = entry.second;
+        if (row.count > 0 && row.bucketStart + bucketSeconds <= now) {
+            closeBucket(row);
+        }
+    }
+}
+
+void RollupManager::flushAll() {
+    for (auto& entry : openBuckets) {
+        closeBucket(entry.second);
+    }
+}
+
+void RollupManager::takeCompleted(std::vector<RollupRow>& out) {
+    for (RollupRow& row : completed) {
+        out.push_back(std::move(row));
+    }
+    completed.clear();
+}
@@ -0,0 +1,104 @@
+/**
+ * @file rollup.hpp
+ * @brief Resúmenes (rollups) por serie y por intervalo de tiempo fijo.
+ * @details
+ * En lugar de consultar todas las filas crudas de `metrics` para obtener
+ * percentiles de un mes, cada serie acumula sus muestras en cubetas de tiempo
+ * (por defecto 60 s). Cada cubeta guarda count/sum/min/max y un DDSketch, y se
+ * escribe como UNA fila en `metric_rollups`.
+ *
+ * Una serie es component/metric/unit más sus etiquetas: cada núcleo o disco
+ * tiene su propia cubeta.
+ *
+ * Un percentil sobre cualquier rango cuesta entonces una combinación (merge) de
+ * sketches por cubeta: O(cubetas) en lugar de O(muestras).
+ * @author Sergio Gonzalez
+ * @date 2026-02-07
+ */
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ddsketch.hpp"
+#include "histogram.hpp"
+#include "metric.hpp"
+
+/**
+ * @struct RollupRow
+ * @brief Resumen de una serie en una cubeta de tiempo.
+ */
+struct RollupRow {
+    std::string component;      ///< Componente de la serie.
+    std::string metric;         ///< Nombre de la métrica.
+    std::string unit;           ///< Unidad de la métrica.
+    Labels labels;              ///< Etiquetas de la serie (normalizadas).
+    long long seriesId = 0;     ///< Fila de `series`; solo al leer (scanRollups), al guardar se resuelve desde las etiquetas.
+    long long bucketStart = 0;  ///< Inicio de la cubeta (timestamp Unix, múltiplo de bucketSeconds).
+    int bucketSeconds = 0;      ///< Duración de la cubeta.
+    std::uint64_t count = 0;    ///< Cantidad de muestras.
+    double sum = 0.0;           ///< Suma de valores.
+    double min = 0.0;           ///< Valor mínimo.
+    double max = 0.0;           ///< Valor máximo.
+    DDSketch sketch;            ///< Distribución de los valores de la cubeta.
+    Histogram histogram;        ///< Solo en series de distribución: sus histogramas combinados (count() == 0 si es escalar).
+};
+
+/**
+ * @class RollupManager
+ * @brief Mantiene la cubeta abierta de cada serie y entrega las que se van cerrando.
+ *
+ * @details
+ * Una cubeta se cierra cuando llega una muestra de la misma serie con un
+ * timestamp posterior a su fin, o cuando closeExpired() detecta que su tiempo
+ * ya pasó (series que dejaron de reportar). Cada cubeta de cada serie se
+ * entrega una sola vez: las muestras atrasadas de una cubeta ya cerrada (o
+ * anterior a la abierta), como las que reenvía un agente al reconectar, no
+ * entran en ningún rollup y se cuentan en dropped(). Siguen guardándose crudas.
+ *
+ * En las series de distribución (Metric::histogram) la cubeta combina los
+ * histogramas recibidos: count, sum, min y max cuentan observaciones, no
+ * muestras, y el sketch queda vacío. Si el colector cambia de cubetas a mitad
+ * de intervalo, los histogramas con la distribución nueva se descartan (y se
+ * cuentan) hasta la cubeta de tiempo siguiente, para no mezclarlas.
+ */
+class RollupManager {
+private:
+    int bucketSeconds;
+    std::unordered_map<std::string, RollupRow> openBuckets; ///< Cubeta en curso por serie.
+    std::vector<RollupRow> completed;                       ///< Cubetas cerradas pendientes de guardar.
+    std::string keyBuffer;                                  ///< Reutilizado para no reservar memoria en cada muestra.
+    std::uint64_t droppedCount = 0;
+
+    long long bucketOf(long long timestamp) const;
+    void closeBucket(RollupRow& row); ///< Pasa la cubeta a completed (si tiene datos) y la deja vacía en la siguiente.
+
+public:
+    /**
+     * @brief Constructor.
+     * @param bucketSeconds Duración de cada cubeta en segundos.
+     */
+    explicit RollupManager(int bucketSeconds = 60);
+
+    /** @brief Agrega una muestra a la cubeta de su serie. Un valor NaN o infinito se ignora. */
+    void add(const Metric& metric);
+
+    /**
+     * @brief Cierra las cubetas cuyo intervalo terminó antes de @p now.
+     * @param now Timestamp Unix actual.
+     */
+    void closeExpired(long long now);
+
+    /** @brief Cierra todas las cubetas abiertas (al apagar el servicio). */
+    void flushAll();
+
+    /**
+     * @brief Mueve las cubetas cerradas a @p out y las olvida.
+     */
+    void takeCompleted(std::vector<RollupRow>& out);
+
+    int getBucketSeconds() const { return bucketSeconds; }
+
+    /** @brief Muestras que no entraron en ningún rollup: atrasadas o con otra distribución (acumulado). */
+    std::uint64_t dropped() const { return droppedCount; }
+};
@@ -0,0 +1,329 @@
+/**
+ * @file sample_log.cpp
+ * @brief Implementación del catálogo de series y del escritor de segmentos.
+ *
+ * @details
+ * Orden de escritura de un registro, pensado para que un lector (o un reinicio
+ * tras una caída) nunca vea un registro a medias:
+ *  1. El registro.
+ *  2. Su entrada del índice disperso y el min/max de la cabecera.
+ *  3. recordCount.
+ *
+ * @author Sergio Gonzalez
+ * @date 2026-03-07
+ */
+
+#include "sample_log.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+
+namespace {
+
+void buildSeriesKey(std::string& key, const std::string& component, const std::string& metric, const std::string& unit,
+                    const Labels& labels) {
+    key.assign(component);
+    key.push_back('\x1f');
+    key.append(metric);
+    key.push_back('\x1f');
+    key.append(unit);
+    key.push_back('\x1f');
+    appendLabels(key, labels);
+}
+
+/// Los textos del catálogo no pueden contener los separadores del formato.
+std::string sanitize(const std::string& text) {
+    std::string out = text;
+    std::replace(out.begin(), out.end(), '\t', ' ');
+    std::replace(out.begin(), out.end(), '\n', ' ');
+    return out;
+}
+
+bool hasSeparator(const std::string& text) {
+    return text.find_first_of("\t\n") != std::string::npos;
+}
+
+/// true si algún texto de la serie cambia al guardarse (caso raro: la clave sale entonces del texto saneado).
+bool needsSanitize(const Metric& m) {
+    if (hasSeparator(m.component) || hasSeparator(m.metric) || hasSeparator(m.unit)) return true;
+    for (const auto& label : m.labels) {
+        if (hasSeparator(label.first) || hasSeparator(label.second)) return true;
+    }
+    return false;
+}
+
+std::uint64_t alignUp(std::uint64_t value, std::uint64_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+SeriesCatalog::SeriesCatalog() : file(nullptr) {}
+
+SeriesCatalog::~SeriesCatalog() {
+    close();
+}
+
+bool SeriesCatalog::open(const std::string& path, bool writable) {
+    close();
+    series.clear();
+    ids.clear();
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in && !writable) return false;
+
+    // Una caída a mitad de idFor deja la última línea sin '\n'. Esa serie nunca
+    // llegó a un segmento: se descarta, y en modo escritura se recorta del
+    // archivo para que la próxima serie no quede pegada a ella.
+    std::uint64_t completeBytes = 0;
+    bool torn = false;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (in.eof()) {
+            torn = true;
+            break;
+        }
+        completeBytes += line.size() + 1;
+        std::size_t t1 = line.find('\t');
+        std::size_t t2 = t1 == std::string::npos ? t1 : line.find('\t', t1 + 1);
+        std::size_t t3 = t2 == std::string::npos ? t2 : line.find('\t', t2 + 1);
+        if (t3 == std::string::npos) continue;
+        std::size_t t4 = line.find('\t', t3 + 1);
+        std::size_t t5 = t4 == std::string::npos ? t4 : line.find('\t', t4 + 1);
+
+        // Los ids se asignan en orden, así que la posición de la línea es el id.
+        std::uint32_t id = static_cast<std::uint32_t>(std::strtoul(line.c_str(), nullptr, 10));
+        if (id != series.size()) return false;
+
+        SeriesInfo info;
+        info.component = line.substr(t1 + 1, t2 - t1 - 1);
+        info.metric = line.substr(t2 + 1, t3 - t2 - 1);
+        if (t5 == std::string::npos) {
+            info.unit = line.substr(t3 + 1);
+        } else {
+            info.unit = line.substr(t3 + 1, t4 - t3 - 1);
+            info.kind = line.compare(t4 + 1, t5 - t4 - 1, "counter") == 0 ? MetricKind::Counter : MetricKind::Gauge;
+            if (!parseLabels(line.substr(t5 + 1), info.labels)) return false;
+        }
+        buildSeriesKey(keyBuffer, info.component, info.metric, info.unit, info.labels);
+        ids.emplace(keyBuffer, id);
+        series.push_back(std::move(info));
+    }
+
+    in.close();
+
+    if (writable) {
+        if (torn) {
+            std::error_code ec;
+            std::filesystem::resize_file(path, completeBytes, ec);
+            if (ec) return false;
+        }
+        file = std::fopen(path.c_str(), "ab");
+        if (!file) return false;
+    }
+    return true;
+}
+
+std::uint32_t SeriesCatalog::idFor(const Metric& m) {
+    // La clave se arma con el texto tal como queda en series.tsv, así la serie
+    // conserva su id al reabrir el catálogo.
+    SeriesInfo info;
+    bool sanitized = needsSanitize(m);
+    if (sanitized) {
+        info = SeriesInfo{sanitize(m.component), sanitize(m.metric), sanitize(m.unit), m.kind, m.labels};
+        for (auto& label : info.labels) {
+            label.first = sanitize(label.first);
+            label.second = sanitize(label.second);
+        }
+        buildSeriesKey(keyBuffer, info.component, info.metric, info.unit, info.labels);
+    } else {
+        buildSeriesKey(keyBuffer, m.component, m.metric, m.unit, m.labels);
+    }
+    auto it = ids.find(keyBuffer);
+    if (it != ids.end()) return it->second;
+
+    if (!file) return std::numeric_limits<std::uint32_t>::max();
+
+    // Serie nueva: se guarda en el catálogo antes de que aparezca en un segmento.
+    if (!sanitized) info = SeriesInfo{m.component, m.metric, m.unit, m.kind, m.labels};
+    std::string labels = formatLabels(info.labels);
+    std::uint32_t id = static_cast<std::uint32_t>(series.size());
+    if (std::fprintf(file, "%u\t%s\t%s\t%s\t%s\t%s\n", id, info.component.c_str(), info.metric.c_str(),
+                     info.unit.c_str(), info.kind == MetricKind::Counter ? "counter" : "gauge", labels.c_str()) < 0 ||
+        std::fflush(file) != 0) {
+        return std::numeric_limits<std::uint32_t>::max();
+    }
+    ids.emplace(keyBuffer, id);
+    series.push_back(std::move(info));
+    return id;
+}
+
+const SeriesInfo* SeriesCatalog::find(std::uint32_t id) const {
+    return id < series.size() ? &series[id] : nullptr;
+}
+
+void SeriesCatalog::close() {
+    if (file) {
+        std::fclose(file);
+        file = nullptr;
+    }
+}
+
+std::string sampleSegmentName(std::uint32_t number) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "segment-%08u.splog", number);
+    return name;
+}
+
+bool listSampleSegments(const std::string& directory, std::vector<std::uint32_t>& numbers) {
+    numbers.clear();
+    std::error_code ec;
+    std::filesystem::directory_iterator it(directory, ec);
+    if (ec) return false;
+
+    for (const auto& entry : it) {
+        std::string name = entry.path().filename().string();
+        unsigned number = 0;
+        char extension[8] = {};
+        if (std::sscanf(name.c_str(), "segment-%8u.%7s", &number, extension) == 2 &&
+            std::strcmp(extension, "splog") == 0 && name == sampleSegmentName(number)) {
+            numbers.push_back(number);
+        }
+    }
+    std::sort(numbers.begin(), numbers.end());
+    return true;
+}
+
+SampleLogWriter::SampleLogWriter(std::uint64_t records, std::uint32_t block)
+    : segmentRecords(records == 0 ? 1 : records), blockRecords(block == 0 ? 1 : block), segmentNumber(0) {}
+
+SampleLogWriter::~SampleLogWriter() {
+    close();
+}
+
+SampleSegmentHeader* SampleLogWriter::header() {
+    return reinterpret_cast<SampleSegmentHeader*>(segment.data());
+}
+
+bool SampleLogWriter::open(const std::string& dir) {
+    close();
+    directory = dir;
+
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    if (!catalog.open(directory + "/series.tsv", true)) return false;
+
+    std::vector<std::uint32_t> numbers;
+    if (!listSampleSegments(directory, numbers)) return false;
+
+    // Se continúa el último segmento si quedó abierto (por ejemplo, tras una caída).
+    if (!numbers.empty() && openSegment(numbers.back())) {
+        if (!header()->sealed && header()->recordCount < header()->capacity) return true;
+        segment.close();
+    }
+    return openSegment(numbers.empty() ? 1 : numbers.back() + 1);
+}
+
+/**
+ * @brief Abre (o crea) el segmento @p number.
+ * @details Un archivo nuevo se crea ya con su tamaño final relleno con ceros:
+ * cabecera + índice disperso + registros.
+ */
+bool SampleLogWriter::openSegment(std::uint32_t number) {
+    std::uint64_t blocks = (segmentRecords + blockRecords - 1) / blockRecords;
+    std::uint64_t recordsOffset = alignUp(sizeof(SampleSegmentHeader) + blocks * sizeof(SampleBlockIndex), 64);
+    std::uint64_t fileSize = recordsOffset + segmentRecords * sizeof(SampleRecord);
+
+    std::string path = directory + "/" + sampleSegmentName(number);
+    if (!segment.openReadWrite(path, static_cast<std::size_t>(fileSize))) return false;
+
+    SampleSegmentHeader* h = header();
+    if (std::memcmp(h->magic, kSampleSegmentMagic, sizeof(kSampleSegmentMagic)) != 0) {
+        // Segmento nuevo.
+        std::memcpy(h->magic, kSampleSegmentMagic, sizeof(kSampleSegmentMagic));
+        h->version = kSampleSegmentVersion;
+        h->recordSize = sizeof(SampleRecord);
+        h->capacity = segmentRecords;
+        h->recordCount = 0;
+        h->minTimestamp = 0;
+        h->maxTimestamp = 0;
+        h->blockRecords = blockRecords;
+        h->sealed = 0;
+        h->recordsOffset = recordsOffset;
+    } else if (h->version != kSampleSegmentVersion || h->recordSize != sizeof(SampleRecord) ||
+               h->blockRecords == 0 || h->recordCount > h->capacity ||
+               h->recordsOffset + h->capacity * sizeof(SampleRecord) > segment.size()) {
+        segment.close();
+        return false;
+    }
+
+    segmentNumber = number;
+    return true;
+}
+
+void SampleLogWriter::seal() {
+    if (!segment.isOpen()) return;
+    header()->sealed = 1;
+    segment.flush();
+    segment.close();
+}
+
+bool SampleLogWriter::append(const Metric& m) {
+    if (!segment.isOpen()) return false;
+
+    SampleSegmentHeader* h = header();
+    if (h->recordCount == h->capacity) {
+        seal();
+        if (!openSegment(segmentNumber + 1)) return false;
+        h = header();
+    }
+
+    std::uint32_t id = catalog.idFor(m);
+    if (id == std::numeric_limits<std::uint32_t>::max()) return false;
+
+    std::uint64_t index = h->recordCount;
+    SampleRecord* records = reinterpret_cast<SampleRecord*>(segment.data() + h->recordsOffset);
+    records[index] = SampleRecord{id, 0, m.timestamp, m.value};
+
+    SampleBlockIndex* blocks = reinterpret_cast<SampleBlockIndex*>(segment.data() + sizeof(SampleSegmentHeader));
+    SampleBlockIndex& block = blocks[index / h->blockRecords];
+    if (index % h->blockRecords == 0) {
+        block.minTimestamp = block.maxTimestamp = m.timestamp;
+    } else {
+        block.minTimestamp = std::min<std::int64_t>(block.minTimestamp, m.timestamp);
+        block.maxTimestamp = std::max<std::int64_t>(block.maxTimestamp, m.timestamp);
+    }
+    if (index == 0) {
+        h->minTimestamp = h->maxTimestamp = m.timestamp;
+    } else {
+        h->minTimestamp = std::min<std::int64_t>(h->minTimestamp, m.timestamp);
+        h->maxTimestamp = std::max<std::int64_t>(h->maxTimestamp, m.timestamp);
+    }
+
+    h->recordCount = index + 1;
+    return true;
+}
+
+bool SampleLogWriter::append(const std::vector<Metric>& batch) {
+    for (const Metric& m : batch) {
+        if (!append(m)) return false;
+    }
+    return true;
+}
+
+bool SampleLogWriter::write(const std::vector<Metric>& batch) {
+    bool ok = append(batch);
+    return flush() && ok;
+}
+
+bool SampleLogWriter::flush() {
+    return segment.isOpen() && segment.flush();
+}
+
+void SampleLogWriter::close() {
+    seal();
+    catalog.close();
+}
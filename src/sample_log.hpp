@@ -0,0 +1,202 @@
+/**
+ * @file sample_log.hpp
+ * @brief Registro binario de muestras en segmentos, alternativo a SQLite para análisis masivo.
+ * @details
+ * Cada muestra se guarda como un registro fijo {serie, timestamp, valor} de 24
+ * bytes en archivos de segmento de tamaño acotado. La identidad de la serie
+ * (componente, métrica, unidad, tipo y etiquetas) se guarda una sola vez en un
+ * catálogo aparte y los registros solo llevan su identificador numérico.
+ *
+ * Estructura de un segmento (`segment-NNNNNNNN.splog`):
+ *  - Cabecera de 64 bytes (SampleSegmentHeader) con min/max de timestamp.
+ *  - Índice disperso: un SampleBlockIndex {min, max} por cada bloque de
+ *    `blockRecords` registros, para saltar bloques fuera de un rango de tiempo.
+ *  - Los registros (SampleRecord), a partir de `recordsOffset`.
+ *
+ * Las estructuras se leen directamente desde el archivo proyectado en memoria
+ * (ver sample_log_reader.hpp), por eso tienen tamaño y alineación fijos.
+ * @author Sergio Gonzalez
+ * @date 2026-03-07
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "mapped_file.hpp"
+#include "metric.hpp"
+#include "sink.hpp"
+
+/**
+ * @struct SampleRecord
+ * @brief Un punto de una serie tal como queda en el segmento.
+ */
+struct SampleRecord {
+    std::uint32_t seriesId;  ///< Identificador en el catálogo de series.
+    std::uint32_t reserved;  ///< Relleno para alinear a 8 bytes (siempre 0).
+    std::int64_t timestamp;  ///< Timestamp Unix.
+    double value;
+};
+
+/**
+ * @struct SampleBlockIndex
+ * @brief Entrada del índice disperso: rango de timestamps de un bloque de registros.
+ */
+struct SampleBlockIndex {
+    std::int64_t minTimestamp;
+    std::int64_t maxTimestamp;
+};
+
+/**
+ * @struct SampleSegmentHeader
+ * @brief Cabecera de un segmento.
+ */
+struct SampleSegmentHeader {
+    char magic[8];               ///< "SPLOG001".
+    std::uint32_t version;
+    std::uint32_t recordSize;    ///< sizeof(SampleRecord).
+    std::uint64_t capacity;      ///< Registros que caben en el segmento.
+    std::uint64_t recordCount;   ///< Registros escritos (se actualiza después de cada registro).
+    std::int64_t minTimestamp;
+    std::int64_t maxTimestamp;
+    std::uint32_t blockRecords;  ///< Registros por entrada del índice disperso.
+    std::uint32_t sealed;        ///< 1 si el segmento se cerró y ya no crece.
+    std::uint64_t recordsOffset; ///< Desplazamiento del primer registro desde el inicio del archivo.
+};
+
+static_assert(sizeof(SampleRecord) == 24, "SampleRecord debe ocupar 24 bytes");
+static_assert(sizeof(SampleBlockIndex) == 16, "SampleBlockIndex debe ocupar 16 bytes");
+static_assert(sizeof(SampleSegmentHeader) == 64, "SampleSegmentHeader debe ocupar 64 bytes");
+
+/// Firma de los segmentos.
+constexpr char kSampleSegmentMagic[8] = {'S', 'P', 'L', 'O', 'G', '0', '0', '1'};
+/// Versión del formato de segmento.
+constexpr std::uint32_t kSampleSegmentVersion = 1;
+
+/**
+ * @struct SeriesInfo
+ * @brief Textos de una serie del catálogo.
+ */
+struct SeriesInfo {
+    std::string component;
+    std::string metric;
+    std::string unit;
+    MetricKind kind = MetricKind::Gauge;
+    Labels labels;
+};
+
+/**
+ * @class SeriesCatalog
+ * @brief Asignación estable serie <-> identificador numérico.
+ *
+ * @details Se persiste en `series.tsv` dentro del directorio del registro, una
+ * línea `id<TAB>component<TAB>metric<TAB>unit<TAB>kind<TAB>etiquetas` por serie
+ * (kind es `gauge` o `counter`; las etiquetas, en el texto canónico de
+ * formatLabels). Solo se agregan líneas, así que los identificadores nunca
+ * cambian. Las líneas de catálogos anteriores, con solo cuatro campos, se leen
+ * como gauges sin etiquetas.
+ */
+class SeriesCatalog {
+private:
+    std::vector<SeriesInfo> series;                        ///< Indexado por id.
+    std::unordered_map<std::string, std::uint32_t> ids;    ///< Clave "comp\x1fmetric\x1funit\x1fetiquetas" -> id.
+    std::string keyBuffer;                                 ///< Reutilizado entre muestras.
+    std::FILE* file;                                       ///< Abierto para agregar; nullptr en modo solo lectura.
+
+public:
+    SeriesCatalog();
+    ~SeriesCatalog();
+
+    SeriesCatalog(const SeriesCatalog&) = delete;
+    SeriesCatalog& operator=(const SeriesCatalog&) = delete;
+
+    /**
+     * @brief Carga el catálogo.
+     * @param path Ruta de series.tsv.
+     * @param writable Si es true, el archivo se crea si no existe y queda abierto para agregar series.
+     */
+    bool open(const std::string& path, bool writable);
+
+    /**
+     * @brief Devuelve el id de la serie, registrándola si es nueva.
+     * @return UINT32_MAX si la serie es nueva y no se pudo guardar.
+     */
+    std::uint32_t idFor(const Metric& metric);
+
+    /** @brief Serie con ese id, o nullptr si no existe. */
+    const SeriesInfo* find(std::uint32_t id) const;
+
+    std::size_t size() const { return series.size(); }
+    void close();
+};
+
+/**
+ * @class SampleLogWriter
+ * @brief Escritor del registro binario: agrega muestras y rota segmentos.
+ *
+ * @details Igual que MetricSpool, cada segmento se escribe sobre un archivo
+ * proyectado en memoria: agregar un registro no hace llamadas al sistema y
+ * flush() se llama una vez por ciclo.
+ *
+ * Como MetricSink, write() agrega el lote y hace flush().
+ */
+class SampleLogWriter : public MetricSink {
+private:
+    std::string directory;
+    std::uint64_t segmentRecords;   ///< Capacidad de cada segmento nuevo.
+    std::uint32_t blockRecords;     ///< Registros por entrada del índice disperso.
+    std::uint32_t segmentNumber;    ///< Número del segmento abierto.
+    SeriesCatalog catalog;
+    MappedFile segment;
+
+    SampleSegmentHeader* header();
+    bool openSegment(std::uint32_t number);
+    void seal();
+
+public:
+    /**
+     * @param segmentRecords Registros por segmento (1M registros = 24 MB).
+     * @param blockRecords Registros por entrada del índice disperso.
+     */
+    explicit SampleLogWriter(std::uint64_t segmentRecords = 1u << 20, std::uint32_t blockRecords = 4096);
+    ~SampleLogWriter() override;
+
+    const char* name() const override { return "sample_log"; }
+
+    /** @brief Agrega el lote y lleva las páginas al disco. */
+    bool write(const std::vector<Metric>& batch) override;
+
+    /**
+     * @brief Abre el registro en @p directory (se crea si no existe) y continúa
+     * el último segmento si no estaba cerrado.
+     */
+    bool open(const std::string& directory);
+
+    /** @brief Agrega una muestra. Rota al siguiente segmento si el actual está lleno. */
+    bool append(const Metric& metric);
+
+    /** @brief Agrega un lote completo. */
+    bool append(const std::vector<Metric>& batch);
+
+    /** @brief Lleva al disco las páginas modificadas del segmento abierto. */
+    bool flush() override;
+
+    /** @brief Cierra (sella) el segmento abierto. */
+    void close();
+
+    bool isOpen() const { return segment.isOpen(); }
+};
+
+/**
+ * @brief Nombre del archivo de un segmento ("segment-00000001.splog").
+ */
+std::string sampleSegmentName(std::uint32_t number);
+
+/**
+ * @brief Lista los segmentos de un directorio ordenados por número.
+ * @param directory Directorio del registro.
+ * @param numbers Números de segmento encontrados (salida).
+ */
+bool listSampleSegments(const std::string& directory, std::vector<std::uint32_t>& numbers);
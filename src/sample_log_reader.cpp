@@ -0,0 +1,51 @@
+/**
+ * @file sample_log_reader.cpp
+ * @brief Implementación de SampleSegmentReader y SampleLogReader.
+ * @author Sergio Gonzalez
+ * @date 2026-03-07
+ */
+
+#include "sample_log_reader.hpp"
+#include <cstring>
+
+bool SampleSegmentReader::open(const std::string& path) {
+    close();
+    if (!file.openReadOnly(path)) return false;
+
+    if (file.size() < sizeof(SampleSegmentHeader)) {
+        close();
+        return false;
+    }
+    const SampleSegmentHeader* h = reinterpret_cast<const SampleSegmentHeader*>(file.data());
+    std::uint64_t blocks = h->blockRecords == 0 ? 0 : (h->capacity + h->blockRecords - 1) / h->blockRecords;
+    if (std::memcmp(h->magic, kSampleSegmentMagic, sizeof(kSampleSegmentMagic)) != 0 ||
+        h->version != kSampleSegmentVersion || h->recordSize != sizeof(SampleRecord) ||
+        h->blockRecords == 0 || h->recordCount > h->capacity ||
+        h->recordsOffset < sizeof(SampleSegmentHeader) + blocks * sizeof(SampleBlockIndex) ||
+        h->recordsOffset % alignof(SampleRecord) != 0 ||
+        h->recordsOffset + h->capacity * sizeof(SampleRecord) > file.size()) {
+        close();
+        return false;
+    }
+
+    header = h;
+    count = h->recordCount;
+    return true;
+}
+
+void SampleSegmentReader::close() {
+    file.close();
+    header = nullptr;
+    count = 0;
+}
+
+bool SampleLogReader::open(const std::string& dir) {
+    directory = dir;
+    if (!listSampleSegments(directory, segments)) return false;
+    return catalog.open(directory + "/series.tsv", false);
+}
+
+bool SampleLogReader::openSegment(std::size_t index, SampleSegmentReader& out) const {
+    if (index >= segments.size()) return false;
+    return out.open(directory + "/" + sampleSegmentName(segments[index]));
+}
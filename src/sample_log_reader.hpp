@@ -0,0 +1,121 @@
+/**
+ * @file sample_log_reader.hpp
+ * @brief Lector del registro binario de muestras sin copias.
+ * @details
+ * Los segmentos se proyectan en memoria en modo solo lectura y los registros se
+ * recorren en el lugar: scan() entrega referencias a SampleRecord que apuntan al
+ * archivo proyectado, sin decodificar ni copiar. Con el índice disperso se
+ * saltan los bloques que no tocan el rango de tiempo pedido, y con el min/max de
+ * la cabecera, los segmentos completos.
+ *
+ * No depende de SQLite ni de Windows más allá de MappedFile, así que lo pueden
+ * usar herramientas fuera de línea.
+ * @author Sergio Gonzalez
+ * @date 2026-03-07
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "mapped_file.hpp"
+#include "sample_log.hpp"
+
+/**
+ * @class SampleSegmentReader
+ * @brief Vista de solo lectura de un segmento.
+ */
+class SampleSegmentReader {
+private:
+    MappedFile file;
+    const SampleSegmentHeader* header;
+    std::uint64_t count;  ///< recordCount al momento de abrir (el escritor puede seguir agregando).
+
+public:
+    SampleSegmentReader() : header(nullptr), count(0) {}
+
+    /**
+     * @brief Proyecta el segmento y valida su cabecera.
+     * @return false si no existe o no es un segmento válido.
+     */
+    bool open(const std::string& path);
+    void close();
+
+    std::uint64_t size() const { return count; }
+    std::int64_t minTimestamp() const { return header->minTimestamp; }
+    std::int64_t maxTimestamp() const { return header->maxTimestamp; }
+    bool sealed() const { return header->sealed != 0; }
+
+    /** @brief Primer registro; los registros son contiguos hasta end(). */
+    const SampleRecord* begin() const {
+        return reinterpret_cast<const SampleRecord*>(file.data() + header->recordsOffset);
+    }
+    const SampleRecord* end() const { return begin() + count; }
+
+    /**
+     * @brief Llama a @p fn con cada registro cuyo timestamp esté en [from, to].
+     * @details Los bloques cuyo rango del índice disperso no toca [from, to] se saltan completos.
+     * @return Cantidad de registros entregados.
+     */
+    template <typename Fn>
+    std::uint64_t scan(std::int64_t from, std::int64_t to, Fn&& fn) const {
+        if (count == 0 || header->maxTimestamp < from || header->minTimestamp > to) return 0;
+
+        const SampleBlockIndex* blocks = reinterpret_cast<const SampleBlockIndex*>(file.data() + sizeof(SampleSegmentHeader));
+        const SampleRecord* records = begin();
+        std::uint64_t delivered = 0;
+
+        for (std::uint64_t start = 0; start < count; start += header->blockRecords) {
+            const SampleBlockIndex& block = blocks[start / header->blockRecords];
+            if (block.maxTimestamp < from || block.minTimestamp > to) continue;
+
+            std::uint64_t stop = start + header->blockRecords < count ? start + header->blockRecords : count;
+            bool whole = block.minTimestamp >= from && block.maxTimestamp <= to;
+            for (std::uint64_t i = start; i < stop; ++i) {
+                if (whole || (records[i].timestamp >= from && records[i].timestamp <= to)) {
+                    fn(records[i]);
+                    ++delivered;
+                }
+            }
+        }
+        return delivered;
+    }
+};
+
+/**
+ * @class SampleLogReader
+ * @brief Acceso a todos los segmentos de un directorio y a su catálogo de series.
+ */
+class SampleLogReader {
+private:
+    std::string directory;
+    std::vector<std::uint32_t> segments;
+    SeriesCatalog catalog;
+
+public:
+    /** @brief Lee el catálogo y la lista de segmentos del directorio. */
+    bool open(const std::string& directory);
+
+    const SeriesCatalog& series() const { return catalog; }
+    std::size_t segmentCount() const { return segments.size(); }
+
+    /** @brief Abre el segmento en la posición @p index (0 = el más antiguo). */
+    bool openSegment(std::size_t index, SampleSegmentReader& out) const;
+
+    /**
+     * @brief Recorre todos los segmentos en orden, entregando los registros en [from, to].
+     * @details Solo hay un segmento proyectado a la vez. Los segmentos inválidos se omiten.
+     * @return Cantidad de registros entregados.
+     */
+    template <typename Fn>
+    std::uint64_t scan(std::int64_t from, std::int64_t to, Fn&& fn) const {
+        std::uint64_t delivered = 0;
+        SampleSegmentReader segment;
+        for (std::size_t i = 0; i < segments.size(); ++i) {
+            if (openSegment(i, segment)) {
+                delivered += segment.scan(from, to, fn);
+            }
+        }
+        return delivered;
+    }
+};
@@ -0,0 +1,103 @@
+/**
+ * @file sched_monitor.cpp
+ * @brief Implementación de SchedMonitor.
+ * @author Sergio Gonzalez
+ * @date 2026-05-30
+ */
+
+#include "sched_monitor.hpp"
+#include <windows.h>
+#include <chrono>
+#include "logger.hpp"
+
+namespace {
+
+ULONGLONG fileTimeValue(const FILETIME& ft) {
+    ULARGE_INTEGER value;
+    value.LowPart = ft.dwLowDateTime;
+    value.HighPart = ft.dwHighDateTime;
+    return value.QuadPart;
+}
+
+} // namespace
+
+SchedMonitor::SchedMonitor(const std::vector<unsigned long>& pids) : cpuCount(1.0) {
+    queueCounter = pdh.add("\\System\\Processor Queue Length");
+    wakeupCounter = pdh.add("\\Processor Information(*)\\Idle Break Events/sec");
+
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    if (info.dwNumberOfProcessors > 0) cpuCount = static_cast<double>(info.dwNumberOfProcessors);
+
+    for (unsigned long pid : pids) {
+        HANDLE handle = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid);
+        if (!handle) {
+            Logger::warn("No se pudo abrir el proceso; se ignora.", {{"pid", static_cast<long long>(pid)}});
+            continue;
+        }
+        processes.push_back(Process{pid, std::to_string(pid), handle});
+    }
+}
+
+SchedMonitor::~SchedMonitor() {
+    for (Process& p : processes) {
+        CloseHandle(p.handle);
+    }
+}
+
+std::size_t SchedMonitor::collect(std::vector<Metric>& out) {
+    auto now = std::chrono::system_clock::now();
+    long long timestamp = std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count();
+    std::size_t added = 0;
+
+    auto push = [&](const char* metric, const char* unit, double value, MetricKind kind, const char* label,
+                    const std::string* labelValue) {
+        Metric m;
+        m.component = "Sched";
+        m.metric = metric;
+        m.unit = unit;
+        m.value = value;
+        m.timestamp = timestamp;
+        m.kind = kind;
+        if (labelValue) m.labels.emplace_back(label, *labelValue);
+        out.push_back(std::move(m));
+        ++added;
+    };
+
+    if (pdh.collect()) {
+        double queue;
+        if (pdh.formatted(queueCounter, queue)) {
+            push("RunQueue", "threads", queue, MetricKind::Gauge, nullptr, nullptr);
+            push("RunQueuePerCpu", "threads", queue / cpuCount, MetricKind::Gauge, nullptr, nullptr);
+        }
+        if (pdh.rawArray(wakeupCounter, instances)) {
+            std::string cpu;
+            for (const PdhInstanceValue& instance : instances) {
+                if (!processorInstance(instance.instance, cpu)) continue;
+                push("Wakeups", "wakeups", static_cast<double>(instance.value), MetricKind::Counter, "cpu", &cpu);
+            }
+        }
+    }
+
+    for (std::size_t i = 0; i < processes.size();) {
+        Process& p = processes[i];
+        FILETIME creation, exit, kernel, user;
+        ULONG64 cycles = 0;
+        DWORD exitCode = 0;
+        if (!GetExitCodeProcess(static_cast<HANDLE>(p.handle), &exitCode) || exitCode != STILL_ACTIVE ||
+            !GetProcessTimes(static_cast<HANDLE>(p.handle), &creation, &exit, &kernel, &user)) {
+            Logger::warn("El proceso terminó; se deja de seguir.", {{"pid", static_cast<long long>(p.pid)}});
+            CloseHandle(static_cast<HANDLE>(p.handle));
+            processes.erase(processes.begin() + static_cast<std::ptrdiff_t>(i));
+            continue;
+        }
+        // FILETIME cuenta en unidades de 100 ns.
+        double cpuMs = static_cast<double>(fileTimeValue(kernel) + fileTimeValue(user)) / 10000.0;
+        push("ProcessCpuTime", "ms", cpuMs, MetricKind::Counter, "pid", &p.label);
+        if (QueryProcessCycleTime(static_cast<HANDLE>(p.handle), &cycles)) {
+            push("ProcessCycles", "cycles", static_cast<double>(cycles), MetricKind::Counter, "pid", &p.label);
+        }
+        ++i;
+    }
+    return added;
+}
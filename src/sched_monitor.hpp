@@ -0,0 +1,68 @@
+/**
+ * @file sched_monitor.hpp
+ * @brief Presión sobre el planificador: hilos esperando CPU, despertares por CPU y tiempo de CPU por proceso.
+ * @details
+ * Un servicio lento con la CPU al 60 % suele estar esperando turno, no
+ * trabajando: "Usage" no lo muestra. SchedMonitor publica (componente "Sched"):
+ *
+ *  - `RunQueue` (gauge): hilos listos para correr que esperan una CPU libre
+ *    (`\System\Processor Queue Length`).
+ *  - `RunQueuePerCpu` (gauge): lo mismo dividido por la cantidad de CPU. Más
+ *    de 2 sostenido indica que los hilos esperan turno.
+ *  - `Wakeups{cpu=N}` (contador): veces que la CPU N salió de reposo para
+ *    correr algo (`\Processor Information(*)\Idle Break Events/sec`): cuántos
+ *    turnos empiezan en cada CPU.
+ *  - Por cada proceso de `[collector.sched] pid = ...` (contadores, etiqueta
+ *    `pid`): `ProcessCpuTime` (ms de CPU, kernel + usuario) y `ProcessCycles`.
+ *    Si su tasa se aplana mientras RunQueue sube, el proceso espera CPU.
+ *
+ * Los contadores se publican acumulados; las diferencias entre lecturas las
+ * calcula RateEngine. Los handles de los procesos se abren una vez y se
+ * mantienen; si un proceso termina, se deja de publicar y se avisa una vez.
+ *
+ * Windows no expone el tiempo de espera en la cola de cada CPU sin una sesión
+ * ETW del kernel (permisos de administrador): la cola del sistema es la
+ * medida disponible.
+ * @author Sergio Gonzalez
+ * @date 2026-05-30
+ */
+#pragma once
+#include <string>
+#include <vector>
+#include "collector.hpp"
+#include "pdh_counters.hpp"
+
+/**
+ * @class SchedMonitor
+ * @brief Colector de la presión sobre el planificador.
+ */
+class SchedMonitor : public Collector {
+private:
+    /// Proceso seguido por pid.
+    struct Process {
+        unsigned long pid;
+        std::string label;
+        void* handle;   ///< HANDLE abierto con PROCESS_QUERY_LIMITED_INFORMATION.
+    };
+
+    PdhCounterSet pdh;
+    int queueCounter;
+    int wakeupCounter;
+    double cpuCount;
+    std::vector<PdhInstanceValue> instances;   ///< Reutilizado entre ciclos.
+    std::vector<Process> processes;
+
+public:
+    /**
+     * @param pids Procesos a seguir (pueden no existir todavía: se ignoran con un aviso).
+     */
+    explicit SchedMonitor(const std::vector<unsigned long>& pids = {});
+    ~SchedMonitor() override;
+
+    SchedMonitor(const SchedMonitor&) = delete;
+    SchedMonitor& operator=(const SchedMonitor&) = delete;
+
+    const char* name() const override { return "Sched"; }
+
+    std::size_t collect(std::vector<Metric>& out) override;
+};
@@ -0,0 +1,104 @@
+/**
+ * @file scheduler.cpp
+ * @brief Implementación de CollectorScheduler.
+ * @author Sergio Gonzalez
+ * @date 2026-04-11
+ */
+
+#include "scheduler.hpp"
+#include <algorithm>
+#include <cctype>
+#include "logger.hpp"
+
+void CollectorScheduler::add(std::unique_ptr<Collector> collector) {
+    Entry entry;
+    entry.key = collector->name();
+    std::transform(entry.key.begin(), entry.key.end(), entry.key.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    entry.collector = std::move(collector);
+    entry.interval = defaultInterval;
+    entry.due = Clock::now();
+    entries.push_back(std::move(entry));
+}
+
+std::size_t CollectorScheduler::apply(const ServiceConfig& config) {
+    auto now = Clock::now();
+    defaultInterval = std::chrono::milliseconds(config.defaultIntervalMs);
+
+    std::size_t changed = 0;
+    for (Entry& entry : entries) {
+        const CollectorSettings* settings = config.collector(entry.key);
+        bool enabled = settings ? settings->enabled : true;
+        std::chrono::milliseconds interval(config.intervalFor(entry.key));
+
+        if (enabled != entry.enabled || interval != entry.interval) {
+            ++changed;
+            Logger::info("Planificación de colector actualizada.",
+                         {{"collector", entry.key}, {"enabled", enabled ? "true" : "false"},
+                          {"interval_ms", static_cast<long long>(interval.count())}});
+        }
+        if (enabled && !entry.enabled) {
+            entry.due = now;  // Reactivado: se muestrea en el próximo ciclo.
+        } else if (interval < entry.interval) {
+            entry.due = std::min(entry.due, now + interval);
+        }
+        entry.enabled = enabled;
+        entry.interval = interval;
+        entry.include = settings ? settings->include : std::vector<std::string>();
+        entry.exclude = settings ? settings->exclude : std::vector<std::string>();
+    }
+    return changed;
+}
+
+bool CollectorScheduler::accepts(const Entry& entry, const Metric& m) const {
+    if (!entry.include.empty()) {
+        bool included = false;
+        for (const std::string& pattern : entry.include) {
+            if (matchSeriesPattern(pattern, m.component, m.metric)) {
+                included = true;
+                break;
+            }
+        }
+        if (!included) return false;
+    }
+    for (const std::string& pattern : entry.exclude) {
+        if (matchSeriesPattern(pattern, m.component, m.metric)) return false;
+    }
+    return true;
+}
+
+std::size_t CollectorScheduler::collectDue(Clock::time_point now, std::vector<Metric>& out, RateEngine* rates) {
+    std::size_t before = out.size();
+    for (Entry& entry : entries) {
+        if (!entry.enabled || entry.due > now) continue;
+
+        std::size_t start = out.size();
+        entry.collector->collect(out);
+        long long collectedMs = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now().time_since_epoch()).count();
+        for (std::size_t i = start; i < out.size(); ++i) {
+            out[i].collectedMs = collectedMs;
+        }
+        if (rates) rates->derive(out, start);
+        if (!entry.include.empty() || !entry.exclude.empty()) {
+            auto rejected = std::remove_if(out.begin() + static_cast<std::ptrdiff_t>(start), out.end(),
+                                           [&](const Metric& m) { return !accepts(entry, m); });
+            out.erase(rejected, out.end());
+        }
+
+        // Si el ciclo se atrasó más de un intervalo no se intenta "recuperar":
+        // se sigue desde ahora.
+        entry.due += entry.interval;
+        if (entry.due <= now) {
+            entry.due = now + entry.interval;
+        }
+    }
+    return out.size() - before;
+}
+
+CollectorScheduler::Clock::time_point CollectorScheduler::nextDue() const {
+    Clock::time_point next = Clock::now() + defaultInterval;
+    for (const Entry& entry : entries) {
+        if (entry.enabled && entry.due < next) next = entry.due;
+    }
+    return next;
+}
@@ -0,0 +1,81 @@
+/**
+ * @file scheduler.hpp
+ * @brief Planificación de los colectores, cada uno con su propio intervalo y filtros.
+ * @details
+ * El bucle principal ya no muestrea todo cada segundo: despierta cuando le toca
+ * al colector más próximo (nextDue()) y solo llama a los que vencieron.
+ *
+ * apply() cambia intervalos, filtros y colectores activos sin recrear ningún
+ * colector: RateEngine conserva la lectura anterior de cada contador (las tasas
+ * siguen sin salto) y los colectores que tienen archivos o contadores abiertos
+ * los mantienen. Al acortar un intervalo, el próximo vencimiento se adelanta; al
+ * alargarlo, se respeta el que ya estaba programado, así que no queda un hueco.
+ *
+ * Los filtros include/exclude de cada colector se aplican después de que
+ * RateEngine deriva sus tasas, cocientes y repartos: `include = CPU/Usage`
+ * deja pasar Usage aunque descarte los contadores de los que sale, y un
+ * exclude puede quitar las series `.rate` o los cocientes que no interesan.
+ * @author Sergio Gonzalez
+ * @date 2026-04-11
+ */
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include "collector.hpp"
+#include "config.hpp"
+#include "rate_engine.hpp"
+
+/**
+ * @class CollectorScheduler
+ * @brief Lista de colectores con su intervalo, su próximo vencimiento y sus filtros.
+ */
+class CollectorScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    struct Entry {
+        std::unique_ptr<Collector> collector;
+        std::string key;                       ///< name() en minúsculas, para buscar su sección.
+        bool enabled = true;
+        std::chrono::milliseconds interval{1000};
+        Clock::time_point due;
+        std::vector<std::string> include;
+        std::vector<std::string> exclude;
+    };
+
+    std::vector<Entry> entries;
+    std::chrono::milliseconds defaultInterval{1000};
+
+    bool accepts(const Entry& entry, const Metric& m) const;
+
+public:
+    /**
+     * @brief Agrega un colector; se muestrea en la próxima llamada a collectDue().
+     */
+    void add(std::unique_ptr<Collector> collector);
+
+    bool empty() const { return entries.empty(); }
+
+    /**
+     * @brief Aplica intervalos, filtros y `enabled` de la configuración (también en una recarga).
+     * @return Cantidad de colectores cuya planificación cambió.
+     */
+    std::size_t apply(const ServiceConfig& config);
+
+    /**
+     * @brief Muestrea los colectores vencidos, deriva con @p rates lo que trajo
+     * cada uno y agrega al lote lo que pasa sus filtros.
+     * @param rates nullptr = sin derivar (los filtros ven solo lo crudo).
+     * @return Métricas agregadas.
+     */
+    std::size_t collectDue(Clock::time_point now, std::vector<Metric>& out, RateEngine* rates = nullptr);
+
+    /**
+     * @brief Momento en que vence el próximo colector activo.
+     */
+    Clock::time_point nextDue() const;
+};
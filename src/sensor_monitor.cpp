@@ -0,0 +1,58 @@
+/**
+ * @file sensor_monitor.cpp
+ * @brief Implementación de SensorMonitor.
+ * @author Sergio Gonzalez
+ * @date 2026-06-20
+ */
+
+#include "sensor_monitor.hpp"
+#include <chrono>
+
+SensorMonitor::SensorMonitor(const SensorPaths& paths) {
+    temperatureCounter = paths.temperature.empty() ? -1 : pdh.add(paths.temperature);
+    frequencyCounter = paths.frequency.empty() ? -1 : pdh.add(paths.frequency);
+    powerCounter = paths.power.empty() ? -1 : pdh.add(paths.power);
+}
+
+std::size_t SensorMonitor::collect(std::vector<Metric>& out) {
+    if (pdh.size() == 0 || !pdh.collect()) return 0;
+
+    auto now = std::chrono::system_clock::now();
+    long long timestamp = std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count();
+    std::size_t added = 0;
+
+    auto push = [&](const char* metric, const char* unit, double value, const char* label, const std::string& labelValue) {
+        Metric m;
+        m.component = "Sensors";
+        m.metric = metric;
+        m.unit = unit;
+        m.value = value;
+        m.timestamp = timestamp;
+        m.labels.emplace_back(label, labelValue);
+        out.push_back(std::move(m));
+        ++added;
+    };
+
+    if (pdh.rawArray(temperatureCounter, instances)) {
+        for (const PdhInstanceValue& zone : instances) {
+            if (zone.value <= 0) continue;  // Zona sin lectura.
+            push("Temperature", "C", static_cast<double>(zone.value) - 273.15, "zone", zone.instance);
+        }
+    }
+
+    if (pdh.rawArray(frequencyCounter, instances)) {
+        std::string cpu;
+        for (const PdhInstanceValue& instance : instances) {
+            if (!processorInstance(instance.instance, cpu)) continue;
+            push("Frequency", "MHz", static_cast<double>(instance.value), "cpu", cpu);
+        }
+    }
+
+    if (pdh.rawArray(powerCounter, instances)) {
+        for (const PdhInstanceValue& meter : instances) {
+            if (meter.instance == "_Total") continue;
+            push("Power", "W", static_cast<double>(meter.value) / 1000.0, "meter", meter.instance);
+        }
+    }
+    return added;
+}
@@ -0,0 +1,66 @@
+/**
+ * @file sensor_monitor.hpp
+ * @brief Sensores de hardware: temperaturas, frecuencia de cada CPU y potencia.
+ * @details
+ * SensorMonitor publica (componente "Sensors"):
+ *
+ *  - `Temperature{zone}` (°C): zonas térmicas ACPI
+ *    (`\Thermal Zone Information(*)\Temperature`, en Kelvin).
+ *  - `Frequency{cpu=N}` (MHz): frecuencia actual de cada CPU
+ *    (`\Processor Information(*)\Processor Frequency`). Si baja con la CPU
+ *    caliente, el equipo está recortando por temperatura.
+ *  - `Power{meter}` (W): potencia medida por los contadores de energía del
+ *    procesador (RAPL en Intel/AMD, `\Energy Meter(*)\Power`, en mW). Windows
+ *    ya entrega el promedio del intervalo, que es la tasa del contador de
+ *    energía acumulada.
+ *
+ * Los contadores se agregan una sola vez al construir el colector y se leen
+ * juntos con una consulta por ciclo; las instancias (zonas, CPU, medidores)
+ * se descubren en cada lectura, así que un medidor que aparece tarde se toma
+ * sin reiniciar. Si el equipo no tiene un contador (máquinas virtuales, sin
+ * ACPI, Windows antiguos) sus métricas simplemente no se publican.
+ *
+ * Las rutas se pueden cambiar en `[collector.sensors]` (`temperature_counter`,
+ * `frequency_counter`, `power_counter`), por ejemplo para apuntar a un
+ * contador de un fabricante con las mismas unidades o a uno de prueba.
+ *
+ * No hay un contador estándar de ventiladores: solo lo exponen los drivers
+ * de cada fabricante.
+ * @author Sergio Gonzalez
+ * @date 2026-06-20
+ */
+#pragma once
+#include <string>
+#include <vector>
+#include "collector.hpp"
+#include "pdh_counters.hpp"
+
+/**
+ * @struct SensorPaths
+ * @brief Rutas PDH (en inglés) de cada sensor. Una ruta vacía desactiva ese sensor.
+ */
+struct SensorPaths {
+    std::string temperature = "\\Thermal Zone Information(*)\\Temperature";
+    std::string frequency = "\\Processor Information(*)\\Processor Frequency";
+    std::string power = "\\Energy Meter(*)\\Power";
+};
+
+/**
+ * @class SensorMonitor
+ * @brief Colector de sensores de hardware.
+ */
+class SensorMonitor : public Collector {
+private:
+    PdhCounterSet pdh;
+    int temperatureCounter;
+    int frequencyCounter;
+    int powerCounter;
+    std::vector<PdhInstanceValue> instances;   ///< Reutilizado entre ciclos.
+
+public:
+    explicit SensorMonitor(const SensorPaths& paths = SensorPaths());
+
+    const char* name() const override { return "Sensors"; }
+
+    std::size_t collect(std::vector<Metric>& out) override;
+};
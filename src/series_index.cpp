@@ -0,0 +1,176 @@
+/**
+ * @file series_index.cpp
+ * @brief Implementación de SeriesIndex.
+ * @author Sergio Gonzalez
+ * @date 2026-05-02
+ */
+
+#include "series_index.hpp"
+#include <algorithm>
+
+namespace {
+
+/**
+ * Términos del índice. El primer carácter separa los espacios de nombres, así
+ * que una etiqueta llamada "CPU" no choca con el componente CPU:
+ *  - 'c' + componente
+ *  - 'm' + métrica
+ *  - 'n' + nombre de etiqueta (existencia)
+ *  - 'v' + nombre + '\x1f' + valor
+ */
+void componentTerm(std::string& term, const std::string& component) {
+    term.assign(1, 'c');
+    term.append(component);
+}
+
+void metricTerm(std::string& term, const std::string& metric) {
+    term.assign(1, 'm');
+    term.append(metric);
+}
+
+void nameTerm(std::string& term, const std::string& name) {
+    term.assign(1, 'n');
+    term.append(name);
+}
+
+void valueTerm(std::string& term, const std::string& name, const std::string& value) {
+    term.assign(1, 'v');
+    term.append(name);
+    term.push_back('\x1f');
+    term.append(value);
+}
+
+/**
+ * @brief Primera posición >= @p from cuyo id no es menor que @p target.
+ * @details Galopa con saltos que se duplican hasta pasarse y termina con
+ * búsqueda binaria en el último salto.
+ */
+std::size_t gallop(const std::vector<long long>& list, std::size_t from, long long target) {
+    std::size_t step = 1;
+    std::size_t low = from;
+    std::size_t high = from;
+    while (high < list.size() && list[high] < target) {
+        low = high + 1;
+        high += step;
+        step *= 2;
+    }
+    high = std::min(high, list.size());
+    return static_cast<std::size_t>(std::lower_bound(list.begin() + static_cast<std::ptrdiff_t>(low),
+                                                     list.begin() + static_cast<std::ptrdiff_t>(high), target) -
+                                    list.begin());
+}
+
+void insertSorted(std::vector<long long>& list, long long id) {
+    if (list.empty() || list.back() < id) {
+        list.push_back(id);
+        return;
+    }
+    auto it = std::lower_bound(list.begin(), list.end(), id);
+    if (it == list.end() || *it != id) list.insert(it, id);
+}
+
+} // namespace
+
+void intersectPostings(const std::vector<long long>& shorter, const std::vector<long long>& longer,
+                       std::vector<long long>& out) {
+    out.clear();
+    std::size_t position = 0;
+    for (long long id : shorter) {
+        position = gallop(longer, position, id);
+        if (position == longer.size()) break;
+        if (longer[position] == id) out.push_back(id);
+    }
+}
+
+void SeriesIndex::seriesKey(std::string& key, const std::string& component, const std::string& metric,
+                            const Labels& labels) {
+    key.assign(component);
+    key.push_back('\x1f');
+    key.append(metric);
+    key.push_back('\x1f');
+    key.append(formatLabels(labels));
+}
+
+long long SeriesIndex::find(const std::string& key) const {
+    auto it = byKey.find(key);
+    return it == byKey.end() ? 0 : it->second;
+}
+
+const LabeledSeries* SeriesIndex::get(long long id) const {
+    auto it = series.find(id);
+    return it == series.end() ? nullptr : &it->second;
+}
+
+void SeriesIndex::post(const std::string& term, long long id) {
+    insertSorted(postings[term], id);
+}
+
+void SeriesIndex::add(const LabeledSeries& info) {
+    if (info.id <= 0 || series.count(info.id)) return;
+
+    std::string key;
+    seriesKey(key, info.component, info.metric, info.labels);
+    byKey[key] = info.id;
+    series.emplace(info.id, info);
+    insertSorted(allIds, info.id);
+
+    componentTerm(termBuffer, info.component);
+    post(termBuffer, info.id);
+    metricTerm(termBuffer, info.metric);
+    post(termBuffer, info.id);
+    for (const auto& label : info.labels) {
+        nameTerm(termBuffer, label.first);
+        post(termBuffer, info.id);
+        valueTerm(termBuffer, label.first, label.second);
+        post(termBuffer, info.id);
+    }
+}
+
+std::size_t SeriesIndex::select(const SeriesSelector& selector, std::vector<long long>& out) const {
+    out.clear();
+
+    // Se juntan las listas de todas las condiciones; si falta alguna, no hay resultado.
+    std::vector<const std::vector<long long>*> lists;
+    auto require = [&]() {
+        auto it = postings.find(termBuffer);
+        if (it == postings.end()) return false;
+        lists.push_back(&it->second);
+        return true;
+    };
+    if (!selector.component.empty()) {
+        componentTerm(termBuffer, selector.component);
+        if (!require()) return 0;
+    }
+    if (!selector.metric.empty()) {
+        metricTerm(termBuffer, selector.metric);
+        if (!require()) return 0;
+    }
+    for (const LabelMatcher& matcher : selector.matchers) {
+        if (matcher.anyValue) nameTerm(termBuffer, matcher.name);
+        else valueTerm(termBuffer, matcher.name, matcher.value);
+        if (!require()) return 0;
+    }
+
+    if (lists.empty()) {
+        out = allIds;
+        return out.size();
+    }
+
+    // De la más corta a la más larga: el resultado parcial nunca crece.
+    std::sort(lists.begin(), lists.end(),
+              [](const std::vector<long long>* a, const std::vector<long long>* b) { return a->size() < b->size(); });
+    out = *lists.front();
+    std::vector<long long> next;
+    for (std::size_t i = 1; i < lists.size() && !out.empty(); ++i) {
+        intersectPostings(out, *lists[i], next);
+        out.swap(next);
+    }
+    return out.size();
+}
+
+void SeriesIndex::clear() {
+    postings.clear();
+    byKey.clear();
+    series.clear();
+    allIds.clear();
+}
@@ -0,0 +1,82 @@
+/**
+ * @file series_index.hpp
+ * @brief Índice invertido en memoria de las series: de cada etiqueta a los ids de sus series.
+ * @details
+ * Para cada término (componente, métrica, nombre de etiqueta y par
+ * nombre=valor) se guarda la lista ordenada de ids de las series que lo tienen
+ * (posting list). Resolver `CPU/Usage{cpu=*,host=web01}` es intersecar cuatro
+ * listas, empezando por la más corta.
+ *
+ * La intersección usa búsqueda galopante: por cada id de la lista corta se
+ * avanza en la larga con saltos de 1, 2, 4, 8... y luego búsqueda binaria en el
+ * último tramo. Cuesta O(m log(n/m)) en lugar de O(m + n), así que un selector
+ * muy específico (una sola serie) no recorre la lista de "todas las CPU".
+ *
+ * Los ids son los de la tabla `series`, que SQLite asigna crecientes: agregar una
+ * serie nueva es un push_back en cada lista. El índice se reconstruye desde la
+ * base al conectar (ver DatabaseManager); no es seguro entre hilos por sí mismo.
+ * @author Sergio Gonzalez
+ * @date 2026-05-02
+ */
+#pragma once
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "labels.hpp"
+
+/**
+ * @brief Interseca dos listas ordenadas de ids con búsqueda galopante.
+ * @param out Ids presentes en ambas, en orden.
+ */
+void intersectPostings(const std::vector<long long>& shorter, const std::vector<long long>& longer,
+                       std::vector<long long>& out);
+
+/**
+ * @class SeriesIndex
+ * @brief Series conocidas, buscables por identidad exacta o por selector.
+ */
+class SeriesIndex {
+private:
+    std::unordered_map<std::string, std::vector<long long>> postings; ///< término -> ids ordenados
+    std::unordered_map<std::string, long long> byKey;                 ///< seriesKey() -> id
+    std::unordered_map<long long, LabeledSeries> series;
+    std::vector<long long> allIds;
+    mutable std::string termBuffer;
+
+    void post(const std::string& term, long long id);
+
+public:
+    /**
+     * @brief Clave única de una serie: component, metric y etiquetas canónicas.
+     * @param labels Etiquetas normalizadas (ver normalizeLabels).
+     */
+    static void seriesKey(std::string& key, const std::string& component, const std::string& metric,
+                          const Labels& labels);
+
+    /**
+     * @brief Id de la serie con esa clave.
+     * @return 0 si no existe (SQLite nunca asigna el id 0).
+     */
+    long long find(const std::string& key) const;
+
+    /** @brief Datos de la serie @p id, o nullptr si no existe. */
+    const LabeledSeries* get(long long id) const;
+
+    /**
+     * @brief Registra una serie. Si ya existía (mismo id) no hace nada.
+     * @details Los ids llegan normalmente en orden creciente; si no, se
+     * insertan en su posición para mantener ordenadas las listas.
+     */
+    void add(const LabeledSeries& info);
+
+    /**
+     * @brief Ids de las series que cumplen el selector, en orden.
+     * @return Cantidad de series encontradas.
+     */
+    std::size_t select(const SeriesSelector& selector, std::vector<long long>& out) const;
+
+    std::size_t size() const { return allIds.size(); }
+
+    void clear();
+};
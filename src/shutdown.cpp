@@ -0,0 +1,102 @@
+/**
+ * @file shutdown.cpp
+ * @brief Implementación del apagado ordenado con la API de consola de Windows.
+ *
+ * @details
+ * SetConsoleCtrlHandler ejecuta el manejador en un hilo NUEVO creado por el
+ * sistema, no interrumpiendo al hilo principal como las señales de Unix. Aun así
+ * el manejador hace lo mínimo: SetEvent sobre un evento de reinicio manual, que
+ * despierta a cualquiera que esté en WaitForSingleObject.
+ *
+ * std::signal(SIGTERM) se registra también para que herramientas que envían
+ * SIGTERM (o raise() desde el propio código) sigan el mismo camino.
+ *
+ * @author Sergio Gonzalez
+ * @date 2026-02-21
+ */
+
+#include "shutdown.hpp"
+#include <windows.h>
+#include <atomic>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+namespace {
+
+HANDLE gShutdownEvent = nullptr;   ///< Se marca al pedir el apagado.
+HANDLE gCompleteEvent = nullptr;   ///< Se marca cuando main() terminó la limpieza.
+std::atomic<bool> gRequested{false};
+
+BOOL WINAPI consoleHandler(DWORD type) {
+    switch (type) {
+    case CTRL_C_EVENT:
+    case CTRL_BREAK_EVENT:
+        ShutdownSignal::request();
+        return TRUE;
+    case CTRL_CLOSE_EVENT:
+    case CTRL_LOGOFF_EVENT:
+    case CTRL_SHUTDOWN_EVENT:
+        // Al retornar de estos eventos Windows termina el proceso: esperamos a main().
+        ShutdownSignal::request();
+        WaitForSingleObject(gCompleteEvent, static_cast<DWORD>(kShutdownCloseGrace.count()));
+        return TRUE;
+    default:
+        return FALSE;
+    }
+}
+
+void signalHandler(int) {
+    ShutdownSignal::request();
+}
+
+} // namespace
+
+bool ShutdownSignal::install() {
+    // Eventos de reinicio manual: una vez marcados quedan marcados.
+    gShutdownEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    gCompleteEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    if (!gShutdownEvent || !gCompleteEvent) return false;
+
+    std::signal(SIGINT, signalHandler);
+    std::signal(SIGTERM, signalHandler);
+    return SetConsoleCtrlHandler(consoleHandler, TRUE) != 0;
+}
+
+bool ShutdownSignal::requested() {
+    return gRequested.load(std::memory_order_acquire);
+}
+
+void ShutdownSignal::request() {
+    gRequested.store(true, std::memory_order_release);
+    if (gShutdownEvent) SetEvent(gShutdownEvent);
+}
+
+bool ShutdownSignal::waitFor(std::chrono::milliseconds timeout) {
+    if (requested()) return true;
+    if (!gShutdownEvent) {
+        std::this_thread::sleep_for(timeout);
+        return requested();
+    }
+    long long ms = timeout.count();
+    if (ms < 0) ms = 0;
+    WaitForSingleObject(gShutdownEvent, static_cast<DWORD>(ms));
+    return requested();
+}
+
+void ShutdownSignal::markComplete() {
+    if (gCompleteEvent) SetEvent(gCompleteEvent);
+}
+
+void ShutdownSignal::armWatchdog(std::chrono::milliseconds limit) {
+    std::thread([limit] {
+        if (gCompleteEvent && WaitForSingleObject(gCompleteEvent, static_cast<DWORD>(limit.count())) == WAIT_OBJECT_0) {
+            return;
+        }
+        std::fprintf(stderr, "[ERROR] El apagado excedió %lld ms; se fuerza la salida.\n",
+                     static_cast<long long>(limit.count()));
+        std::fflush(stderr);
+        std::_Exit(2);
+    }).detach();
+}
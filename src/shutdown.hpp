@@ -0,0 +1,67 @@
+/**
+ * @file shutdown.hpp
+ * @brief Apagado ordenado del servicio ante Ctrl+C, cierre de consola o SIGTERM.
+ * @details
+ * El manejador de señales NO hace limpieza: solo marca un evento de Windows.
+ * El bucle principal espera entre ciclos sobre ese mismo evento (en lugar de
+ * dormir), así que se despierta al instante, termina el ciclo en curso y ejecuta
+ * el apagado desde su propio hilo: vaciar lo pendiente, hacer checkpoint del WAL
+ * y cerrar la base de datos.
+ * @author Sergio Gonzalez
+ * @date 2026-02-21
+ */
+#pragma once
+#include <chrono>
+
+/// Tiempo que el manejador de cierre de consola retiene al proceso esperando la
+/// limpieza: Windows concede unos 5 s en CTRL_CLOSE_EVENT antes de matarlo.
+constexpr std::chrono::milliseconds kShutdownCloseGrace(4500);
+
+/**
+ * @class ShutdownSignal
+ * @brief Punto único de coordinación del apagado (estado global del proceso).
+ *
+ * @details
+ * Es una clase de métodos estáticos porque las señales son globales: solo puede
+ * haber un manejador instalado por proceso.
+ *
+ * En eventos de cierre de consola, cierre de sesión o apagado del equipo, Windows
+ * termina el proceso en cuanto el manejador retorna. Por eso en esos casos el
+ * manejador espera (con límite) a que main() llame a markComplete().
+ */
+class ShutdownSignal {
+public:
+    /**
+     * @brief Instala los manejadores de Ctrl+C / Ctrl+Break / cierre y SIGINT / SIGTERM.
+     * @return true si se pudieron instalar.
+     */
+    static bool install();
+
+    /**
+     * @brief Indica si ya se pidió el apagado.
+     */
+    static bool requested();
+
+    /**
+     * @brief Pide el apagado desde el propio programa.
+     */
+    static void request();
+
+    /**
+     * @brief Espera hasta @p timeout o hasta que se pida el apagado, lo que ocurra primero.
+     * @return true si se pidió el apagado.
+     */
+    static bool waitFor(std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Avisa que la limpieza terminó (libera al manejador de cierre de consola).
+     */
+    static void markComplete();
+
+    /**
+     * @brief Arranca un temporizador que termina el proceso si el apagado excede @p limit.
+     * @details Garantiza un tiempo de apagado acotado aunque un disco o un destino
+     * remoto se queden colgados.
+     */
+    static void armWatchdog(std::chrono::milliseconds limit);
+};
@@ -0,0 +1,36 @@
+/**
+ * @file sink.hpp
+ * @brief Interfaz común de los destinos de métricas.
+ * @details
+ * Un sink recibe los lotes que producen los colectores y los lleva a algún
+ * lugar: la base SQLite, un servidor remoto, la consola... Separarlos detrás de
+ * esta interfaz permite enviar el mismo lote a varios destinos.
+ * @author Sergio Gonzalez
+ * @date 2026-03-21
+ */
+#pragma once
+#include <vector>
+#include "metric.hpp"
+
+/**
+ * @class MetricSink
+ * @brief Destino de lotes de métricas.
+ */
+class MetricSink {
+public:
+    virtual ~MetricSink() = default;
+
+    /** @brief Nombre corto del destino (para mensajes y estadísticas). */
+    virtual const char* name() const = 0;
+
+    /**
+     * @brief Entrega un lote.
+     * @return true si el lote quedó a salvo (guardado, enviado o encolado para reintento).
+     */
+    virtual bool write(const std::vector<Metric>& batch) = 0;
+
+    /**
+     * @brief Termina lo que el destino tenga pendiente. Se llama al apagar.
+     */
+    virtual bool flush() { return true; }
+};
@@ -0,0 +1,353 @@
+/**
+ * @file spool.cpp
+ * @brief Implementación de MetricSpool.
+ *
+ * @details
+ * Orden de escritura de una muestra:
+ *  1. Registros de continuación (datos y número de secuencia de cada uno).
+ *  2. Registro de cabecera: timestamp, valor, tipo, principio de los datos y,
+ *     al final, su número de secuencia.
+ *  3. Índice de escritura en la cabecera del archivo.
+ *
+ * flush() se llama una vez por ciclo, no por registro. Las páginas ya
+ * pertenecen a la caché del sistema en cuanto se escriben en memoria, así que
+ * sobreviven a una caída del proceso; flush() (FlushViewOfFile más
+ * FlushFileBuffers, ver MappedFile) las protege además de un corte de energía.
+ *
+ * @author Sergio Gonzalez
+ * @date 2026-02-28
+ */
+
+#include "spool.hpp"
+#include <cstring>
+#include <memory>
+
+namespace {
+
+constexpr char kMagic[8] = {'S', 'P', 'S', 'P', 'O', 'O', 'L', '1'};
+constexpr std::uint32_t kVersion = 2;
+
+constexpr unsigned char kHeadRecord = 1;          ///< Primer registro de una muestra.
+constexpr unsigned char kContinuationRecord = 2;  ///< Resto de los datos de la muestra anterior.
+
+/// Bytes de datos de un registro y, en el de cabecera, los que ocupan timestamp, valor, tamaño y tipo.
+constexpr std::size_t kRecordData = 119;
+constexpr std::size_t kHeadFields = 8 + 8 + 4 + 1;
+constexpr std::size_t kHeadPayload = kRecordData - kHeadFields;
+
+/// Registros que ocupa una muestra con @p size bytes de datos variables.
+std::uint64_t recordsFor(std::size_t size) {
+    if (size <= kHeadPayload) return 1;
+    return 1 + (size - kHeadPayload + kRecordData - 1) / kRecordData;
+}
+
+/// Registro de la versión 1: una muestra sin etiquetas ni histograma, textos truncados.
+struct RecordV1 {
+    long long timestamp;
+    double value;
+    char component[32];
+    char metric[48];
+    char unit[16];
+    std::uint64_t sequence;
+    char reserved[8];
+};
+
+template <std::size_t N>
+std::string readField(const char (&field)[N]) {
+    std::size_t n = 0;
+    while (n < N && field[n] != '\0') ++n;
+    return std::string(field, n);
+}
+
+void putU32(std::string& out, std::uint32_t value) {
+    char bytes[4];
+    std::memcpy(bytes, &value, sizeof(bytes));
+    out.append(bytes, sizeof(bytes));
+}
+
+void putText(std::string& out, const std::string& text) {
+    putU32(out, static_cast<std::uint32_t>(text.size()));
+    out += text;
+}
+
+bool getU32(const std::string& in, std::size_t& pos, std::uint32_t& value) {
+    if (in.size() - pos < sizeof(value)) return false;
+    std::memcpy(&value, in.data() + pos, sizeof(value));
+    pos += sizeof(value);
+    return true;
+}
+
+bool getText(const std::string& in, std::size_t& pos, std::string& text) {
+    std::uint32_t size;
+    if (!getU32(in, pos, size) || in.size() - pos < size) return false;
+    text.assign(in, pos, size);
+    pos += size;
+    return true;
+}
+
+/**
+ * @brief Datos variables de una muestra: component, metric, unit, etiquetas e histograma.
+ */
+void encodePayload(std::string& out, const Metric& m) {
+    out.clear();
+    putText(out, m.component);
+    putText(out, m.metric);
+    putText(out, m.unit);
+    putU32(out, static_cast<std::uint32_t>(m.labels.size()));
+    for (const auto& label : m.labels) {
+        putText(out, label.first);
+        putText(out, label.second);
+    }
+    if (m.histogram && m.histogram->count() > 0) {
+        putText(out, m.histogram->serialize());
+    } else {
+        putU32(out, 0);
+    }
+}
+
+bool decodePayload(const std::string& in, Metric& m) {
+    std::size_t pos = 0;
+    std::uint32_t labelCount;
+    if (!getText(in, pos, m.component) || !getText(in, pos, m.metric) || !getText(in, pos, m.unit) ||
+        !getU32(in, pos, labelCount)) {
+        return false;
+    }
+    for (std::uint32_t i = 0; i < labelCount; ++i) {
+        std::pair<std::string, std::string> label;
+        if (!getText(in, pos, label.first) || !getText(in, pos, label.second)) return false;
+        m.labels.push_back(std::move(label));
+    }
+    std::string blob;
+    if (!getText(in, pos, blob)) return false;
+    if (!blob.empty()) {
+        auto histogram = std::make_shared<Histogram>();
+        if (!histogram->deserialize(blob.data(), blob.size())) return false;
+        m.histogram = std::move(histogram);
+    }
+    return true;
+}
+
+} // namespace
+
+struct MetricSpool::Header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t recordSize;
+    std::uint64_t capacity;
+    std::uint64_t readIndex;   ///< Primer registro pendiente.
+    std::uint64_t writeIndex;  ///< Siguiente registro a escribir.
+    char reserved[24];
+};
+
+/**
+ * @details En un registro de cabecera `data` empieza con timestamp, valor,
+ * tamaño de los datos variables (u32) y tipo de métrica (u8), y sigue con los
+ * primeros kHeadPayload bytes de los datos; en uno de continuación todo `data`
+ * son datos.
+ */
+struct MetricSpool::Record {
+    unsigned char data[kRecordData];
+    unsigned char type;        ///< kHeadRecord o kContinuationRecord.
+    std::uint64_t sequence;    ///< índice + 1; se escribe al final (0 = nunca escrito).
+};
+
+MetricSpool::MetricSpool() : capacity(0), droppedCount(0) {}
+
+MetricSpool::Header* MetricSpool::header() {
+    return reinterpret_cast<Header*>(file.data());
+}
+
+MetricSpool::Record* MetricSpool::recordAt(std::uint64_t index) {
+    return reinterpret_cast<Record*>(file.data() + sizeof(Header)) + (index % capacity);
+}
+
+std::uint64_t MetricSpool::spanAt(std::uint64_t index) {
+    const Record* r = recordAt(index);
+    if (r->type != kHeadRecord) return 1;
+    std::uint32_t size;
+    std::memcpy(&size, r->data + 16, sizeof(size));
+    return recordsFor(size);
+}
+
+bool MetricSpool::open(const std::string& path, std::size_t requestedCapacity) {
+    static_assert(sizeof(Header) == 64, "la cabecera del spool debe ocupar 64 bytes");
+    static_assert(sizeof(Record) == 128, "los registros del spool deben ocupar 128 bytes");
+    static_assert(sizeof(RecordV1) == 128, "los registros de la versión 1 ocupan 128 bytes");
+
+    if (requestedCapacity == 0) return false;
+    if (!file.openReadWrite(path, sizeof(Header) + requestedCapacity * sizeof(Record))) return false;
+
+    Header* h = header();
+    bool valid = std::memcmp(h->magic, kMagic, sizeof(kMagic)) == 0 && h->recordSize == sizeof(Record) &&
+                 h->capacity != 0 && sizeof(Header) + h->capacity * sizeof(Record) <= file.size() &&
+                 h->readIndex <= h->writeIndex;
+    if (h->version == 0 && std::memcmp(h->magic, "\0\0\0\0\0\0\0\0", 8) == 0) {
+        // Archivo nuevo (relleno con ceros al agrandarlo).
+        std::memcpy(h->magic, kMagic, sizeof(kMagic));
+        h->version = kVersion;
+        h->recordSize = sizeof(Record);
+        h->capacity = requestedCapacity;
+        h->readIndex = 0;
+        h->writeIndex = 0;
+    } else if (!valid || (h->version != kVersion && h->version != 1)) {
+        file.close();
+        return false;
+    }
+
+    capacity = h->capacity;
+    droppedCount = 0;
+    if (h->version == 1) return migrateV1();
+    recover();
+    return true;
+}
+
+/**
+ * @brief Avanza writeIndex sobre los registros que se escribieron completos pero
+ * cuya cabecera no llegó a actualizarse.
+ * @details Si eso pisó registros pendientes, readIndex se lleva al primer
+ * registro de cabecera que sigue, para no empezar a leer a mitad de una muestra.
+ */
+void MetricSpool::recover() {
+    Header* h = header();
+    while (recordAt(h->writeIndex)->sequence == h->writeIndex + 1) {
+        ++h->writeIndex;
+    }
+    if (h->writeIndex - h->readIndex > capacity) h->readIndex = h->writeIndex - capacity;
+    while (h->readIndex < h->writeIndex && recordAt(h->readIndex)->type != kHeadRecord) {
+        ++h->readIndex;
+    }
+}
+
+/**
+ * @brief Convierte un archivo de la versión 1 (misma cabecera y tamaño de registro).
+ * @details Se leen sus muestras pendientes, se vacían los registros (para que
+ * sus secuencias viejas no parezcan válidas) y se vuelven a agregar.
+ */
+bool MetricSpool::migrateV1() {
+    Header* h = header();
+    const RecordV1* old = reinterpret_cast<const RecordV1*>(file.data() + sizeof(Header));
+    while (old[h->writeIndex % capacity].sequence == h->writeIndex + 1) {
+        ++h->writeIndex;
+        if (h->writeIndex - h->readIndex > capacity) ++h->readIndex;
+    }
+
+    std::vector<Metric> pendingSamples;
+    pendingSamples.reserve(static_cast<std::size_t>(h->writeIndex - h->readIndex));
+    for (std::uint64_t i = h->readIndex; i < h->writeIndex; ++i) {
+        const RecordV1& r = old[i % capacity];
+        Metric m;
+        m.component = readField(r.component);
+        m.metric = readField(r.metric);
+        m.unit = readField(r.unit);
+        m.value = r.value;
+        m.timestamp = r.timestamp;
+        pendingSamples.push_back(std::move(m));
+    }
+
+    std::memset(file.data() + sizeof(Header), 0, static_cast<std::size_t>(capacity * sizeof(Record)));
+    h->version = kVersion;
+    h->readIndex = 0;
+    h->writeIndex = 0;
+    append(pendingSamples);
+    return flush();
+}
+
+void MetricSpool::append(const Metric& m) {
+    Header* h = header();
+    encodePayload(payload, m);
+    std::uint64_t span = recordsFor(payload.size());
+    if (span > capacity) {
+        ++droppedCount;
+        return;
+    }
+    while (capacity - (h->writeIndex - h->readIndex) < span) {
+        // Cola llena: se pierde la muestra más antigua.
+        std::uint64_t oldest = spanAt(h->readIndex);
+        h->readIndex += oldest < h->writeIndex - h->readIndex ? oldest : h->writeIndex - h->readIndex;
+        ++droppedCount;
+    }
+
+    // Primero las continuaciones; el registro de cabecera, con su secuencia, al final.
+    std::size_t offset = kHeadPayload;
+    for (std::uint64_t k = 1; k < span; ++k) {
+        Record* r = recordAt(h->writeIndex + k);
+        r->sequence = 0;
+        std::size_t n = payload.size() - offset < kRecordData ? payload.size() - offset : kRecordData;
+        std::memcpy(r->data, payload.data() + offset, n);
+        r->type = kContinuationRecord;
+        r->sequence = h->writeIndex + k + 1;
+        offset += n;
+    }
+
+    Record* r = recordAt(h->writeIndex);
+    r->sequence = 0;
+    std::uint32_t size = static_cast<std::uint32_t>(payload.size());
+    unsigned char kind = static_cast<unsigned char>(m.kind);
+    std::memcpy(r->data, &m.timestamp, 8);
+    std::memcpy(r->data + 8, &m.value, 8);
+    std::memcpy(r->data + 16, &size, 4);
+    r->data[20] = kind;
+    std::memcpy(r->data + kHeadFields, payload.data(), payload.size() < kHeadPayload ? payload.size() : kHeadPayload);
+    r->type = kHeadRecord;
+    r->sequence = h->writeIndex + 1;
+    h->writeIndex += span;
+}
+
+void MetricSpool::append(const std::vector<Metric>& batch) {
+    for (const Metric& m : batch) {
+        append(m);
+    }
+}
+
+std::size_t MetricSpool::pending() {
+    Header* h = header();
+    return static_cast<std::size_t>(h->writeIndex - h->readIndex);
+}
+
+/**
+ * @details Una muestra cuyos datos no se pueden interpretar (archivo dañado)
+ * se salta, pero sus registros cuentan en el valor devuelto para que consume()
+ * la descarte igual.
+ */
+std::size_t MetricSpool::peek(std::vector<Metric>& out, std::size_t max) {
+    Header* h = header();
+    std::uint64_t index = h->readIndex;
+    std::size_t copied = 0;
+    while (index < h->writeIndex && copied < max) {
+        const Record* r = recordAt(index);
+        std::uint64_t span = spanAt(index);
+        if (r->type != kHeadRecord || index + span > h->writeIndex) {
+            ++index;
+            continue;
+        }
+
+        std::uint32_t size;
+        std::memcpy(&size, r->data + 16, sizeof(size));
+        payload.assign(reinterpret_cast<const char*>(r->data + kHeadFields), size < kHeadPayload ? size : kHeadPayload);
+        for (std::uint64_t k = 1; k < span; ++k) {
+            std::size_t n = size - payload.size() < kRecordData ? size - payload.size() : kRecordData;
+            payload.append(reinterpret_cast<const char*>(recordAt(index + k)->data), n);
+        }
+
+        Metric m;
+        std::memcpy(&m.timestamp, r->data, 8);
+        std::memcpy(&m.value, r->data + 8, 8);
+        m.kind = r->data[20] == static_cast<unsigned char>(MetricKind::Counter) ? MetricKind::Counter : MetricKind::Gauge;
+        if (decodePayload(payload, m)) {
+            out.push_back(std::move(m));
+            ++copied;
+        }
+        index += span;
+    }
+    return static_cast<std::size_t>(index - h->readIndex);
+}
+
+void MetricSpool::consume(std::size_t records) {
+    Header* h = header();
+    std::size_t n = pending();
+    h->readIndex += records < n ? records : n;
+}
+
+bool MetricSpool::flush() {
+    return file.flush();
+}
@@ -0,0 +1,113 @@
+/**
+ * @file spool.hpp
+ * @brief Cola local en disco para las muestras que no se pudieron guardar en SQLite.
+ * @details
+ * Si la base de datos falla (disco lleno, base bloqueada, archivo dañado) las
+ * muestras del ciclo se escriben en un archivo proyectado en memoria con registros
+ * binarios de tamaño fijo. Cuando la base vuelve a aceptar escrituras, el servicio
+ * las reinserta por tramos y las descarta de la cola.
+ *
+ * Escribir una muestra es copiar uno o más registros de 128 bytes a memoria: no
+ * hay llamadas al sistema por muestra, así que una caída de la base no frena el
+ * muestreo. La muestra se guarda completa (etiquetas, tipo e histograma), así
+ * que al reinsertarla cae en la misma serie que si se hubiera guardado a tiempo.
+ * @author Sergio Gonzalez
+ * @date 2026-02-28
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "mapped_file.hpp"
+#include "metric.hpp"
+
+/**
+ * @class MetricSpool
+ * @brief Búfer circular persistente de muestras (write-ahead spool).
+ *
+ * @details
+ * Estructura del archivo:
+ *  - Cabecera de 64 bytes: firma, versión, tamaño de registro, capacidad e
+ *    índices de lectura y escritura.
+ *  - `capacity` registros de 128 bytes.
+ *
+ * Una muestra ocupa un registro de cabecera (timestamp, valor, tipo, tamaño y
+ * el principio de sus datos) seguido de los registros de continuación que
+ * hagan falta para el resto: textos, etiquetas e histograma serializado. Una
+ * muestra de CPU o RAM sin etiquetas cabe en la cabecera; una con histograma
+ * ocupa unos pocos registros.
+ *
+ * Los índices crecen sin límite; la posición física es índice % capacity. Cada
+ * registro lleva como último campo su número de secuencia (índice + 1), escrito
+ * después de los datos; el de cabecera de una muestra se escribe después de
+ * sus continuaciones. Si el proceso muere antes de actualizar la cabecera del
+ * archivo, al abrir se recuperan los registros siguientes cuya secuencia es
+ * correcta; una muestra a medio escribir conserva la secuencia vieja en su
+ * registro de cabecera y se descarta entera.
+ *
+ * Si la cola se llena se sobrescriben las muestras más antiguas (se cuentan en dropped()).
+ *
+ * Un archivo de la versión 1 (una muestra por registro, sin etiquetas) se
+ * convierte al abrirlo: sus muestras pendientes se conservan.
+ */
+class MetricSpool {
+private:
+    MappedFile file;
+    std::uint64_t capacity;
+    std::uint64_t droppedCount;
+    std::string payload;   ///< Datos variables de una muestra (reutilizado).
+
+    struct Header;
+    struct Record;
+
+    Header* header();
+    Record* recordAt(std::uint64_t index);
+    std::uint64_t spanAt(std::uint64_t index);  ///< Registros que ocupa la muestra que empieza en @p index.
+    void recover();
+    bool migrateV1();
+
+public:
+    MetricSpool();
+
+    /**
+     * @brief Abre o crea la cola.
+     * @param path Ruta del archivo.
+     * @param capacity Cantidad máxima de registros. Si el archivo ya existe se usa su capacidad.
+     * @return false si no se pudo crear el archivo o no es una cola válida.
+     */
+    bool open(const std::string& path, std::size_t capacity);
+
+    /**
+     * @brief Agrega una muestra al final. Sin llamadas al sistema.
+     * @details Una muestra que no cabe en toda la cola se descarta (y se cuenta en dropped()).
+     */
+    void append(const Metric& metric);
+
+    /** @brief Agrega un lote completo. */
+    void append(const std::vector<Metric>& batch);
+
+    /** @brief Registros pendientes de reinsertar (una muestra ocupa uno o más). */
+    std::size_t pending();
+
+    /**
+     * @brief Copia hasta @p max muestras pendientes (las más antiguas) a @p out, sin quitarlas.
+     * @return Registros que ocupan las muestras leídas: lo que hay que pasarle a consume().
+     */
+    std::size_t peek(std::vector<Metric>& out, std::size_t max);
+
+    /**
+     * @brief Descarta los @p records registros más antiguos (tras guardar sus muestras en la base).
+     */
+    void consume(std::size_t records);
+
+    /**
+     * @brief Lleva al disco las páginas modificadas. Se llama una vez por ciclo.
+     */
+    bool flush();
+
+    /** @brief Muestras perdidas por desbordamiento desde que se abrió la cola. */
+    std::uint64_t dropped() const { return droppedCount; }
+
+    bool isOpen() const { return file.isOpen(); }
+};
@@ -0,0 +1,272 @@
+/**
+ * @file synthetic_collector.cpp
+ * @brief Implementación de los colectores sintético y de reproducción.
+ *
+ * @details
+ * Ninguno de los dos toca el sistema operativo: todo el trabajo es generar (o
+ * copiar) objetos Metric. Eso es justamente lo que se busca en una prueba de
+ * carga: que el cuello de botella medido sea el almacenamiento y no la fuente.
+ *
+ * @author Sergio Gonzalez
+ * @date 2026-01-24
+ */
+
+#include "synthetic_collector.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+/// Tope de un ciclo medido: tras una suspensión no se generan horas de muestras en un solo lote.
+constexpr double kMaxTickSeconds = 10.0;
+
+} // namespace
+
+double TickClock::next() {
+    if (fixedSeconds > 0.0) return fixedSeconds;
+
+    auto now = std::chrono::steady_clock::now();
+    double elapsed = started ? std::chrono::duration<double>(now - last).count() : 0.0;
+    started = true;
+    last = now;
+    return std::min(elapsed, kMaxTickSeconds);
+}
+
+bool parseValueDistribution(const std::string& text, ValueDistribution& out) {
+    if (text == "constant") out = ValueDistribution::Constant;
+    else if (text == "uniform") out = ValueDistribution::Uniform;
+    else if (text == "normal") out = ValueDistribution::Normal;
+    else if (text == "random_walk") out = ValueDistribution::RandomWalk;
+    else return false;
+    return true;
+}
+
+/**
+ * @brief Constructor del colector sintético.
+ *
+ * @details
+ * Los nombres se generan aquí, una sola vez. Se mantienen cortos a propósito
+ * ("synth03", "s000042"): así caben en el buffer interno de std::string (SSO) y
+ * copiarlos al lote no reserva memoria en el heap.
+ */
+SyntheticCollector::SyntheticCollector(const SyntheticConfig& cfg)
+    : config(cfg), rng(cfg.seed), nextSeries(0), pendingSamples(0.0), virtualFraction(0.0), clock(cfg.tickSeconds) {
+    if (config.componentCount == 0) config.componentCount = 1;
+    if (config.maxValue < config.minValue) std::swap(config.minValue, config.maxValue);
+
+    virtualTimestamp = config.startTimestamp;
+    if (virtualTimestamp == 0) {
+        auto now = std::chrono::system_clock::now();
+        virtualTimestamp = std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count();
+    }
+
+    series.reserve(config.seriesCount);
+    char buffer[32];
+    double middle = (config.minValue + config.maxValue) / 2.0;
+    for (std::size_t i = 0; i < config.seriesCount; ++i) {
+        Series s;
+        std::snprintf(buffer, sizeof(buffer), "synth%02zu", i % config.componentCount);
+        s.component = buffer;
+        std::snprintf(buffer, sizeof(buffer), "s%06zu", i);
+        s.metric = buffer;
+        s.lastValue = middle;
+        series.push_back(std::move(s));
+    }
+}
+
+/**
+ * @brief Genera el próximo valor de una serie según la distribución configurada.
+ */
+double SyntheticCollector::nextValue(Series& s) {
+    double range = config.maxValue - config.minValue;
+    if (range <= 0.0) return config.minValue;  // Las distribuciones normales no admiten desviación 0.
+    double value;
+
+    switch (config.distribution) {
+    case ValueDistribution::Constant:
+        value = config.minValue;
+        break;
+    case ValueDistribution::Uniform:
+        value = std::uniform_real_distribution<double>(config.minValue, config.maxValue)(rng);
+        break;
+    case ValueDistribution::Normal:
+        // Desviación de 1/6 del rango: ~99.7% de los valores caen dentro sin recortar.
+        value = std::normal_distribution<double>((config.minValue + config.maxValue) / 2.0, range / 6.0)(rng);
+        break;
+    case ValueDistribution::RandomWalk:
+    default:
+        // Pasos pequeños (1% del rango) a partir del valor anterior de la misma serie.
+        value = s.lastValue + std::normal_distribution<double>(0.0, range / 100.0)(rng);
+        break;
+    }
+
+    value = std::clamp(value, config.minValue, config.maxValue);
+    s.lastValue = value;
+    return value;
+}
+
+std::size_t SyntheticCollector::collect(std::vector<Metric>& out) {
+    if (series.empty()) return 0;
+
+    // Cuántas muestras tocan en este ciclo. La fracción sobrante se arrastra al
+    // siguiente para que la tasa promedio sea exacta aunque no sea entera.
+    double tick = clock.next();
+    pendingSamples += config.samplesPerSecond * tick;
+    std::size_t count = static_cast<std::size_t>(pendingSamples);
+    pendingSamples -= static_cast<double>(count);
+
+    out.reserve(out.size() + count);
+    for (std::size_t i = 0; i < count; ++i) {
+        Series& s = series[nextSeries];
+        Metric m;
+        m.component = s.component;
+        m.metric = s.metric;
+        m.value = nextValue(s);
+        m.unit = "u";
+        m.timestamp = virtualTimestamp;
+        out.push_back(std::move(m));
+
+        if (++nextSeries == series.size()) nextSeries = 0;
+    }
+
+    // Avanzamos el reloj virtual (en segundos enteros, como el resto de métricas).
+    virtualFraction += tick;
+    long long whole = static_cast<long long>(virtualFraction);
+    virtualTimestamp += whole;
+    virtualFraction -= static_cast<double>(whole);
+
+    return count;
+}
+
+ReplayCollector::ReplayCollector(const ReplayConfig& cfg)
+    : config(cfg), cursor(0), loopOffset(0), traceClock(0.0), pendingSamples(0.0), clock(cfg.tickSeconds) {}
+
+namespace {
+
+/**
+ * @brief Quita comillas dobles externas (sqlite3 -csv las agrega si el texto lo requiere).
+ */
+std::string unquote(const std::string& field) {
+    if (field.size() >= 2 && field.front() == '"' && field.back() == '"') {
+        return field.substr(1, field.size() - 2);
+    }
+    return field;
+}
+
+} // namespace
+
+/**
+ * @brief Lee la traza completa en memoria.
+ *
+ * @details
+ * Las líneas que no tienen 5 columnas, cuyo timestamp no es numérico (por
+ * ejemplo una cabecera) o cuyo valor no es un número finito se ignoran. Al final se ordena por timestamp para que la
+ * reproducción respete el tiempo aunque el archivo venga desordenado.
+ */
+bool ReplayCollector::open() {
+    std::ifstream file(config.tracePath);
+    if (!file) return false;
+
+    records.clear();
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+
+        std::vector<std::string> fields;
+        std::stringstream ss(line);
+        std::string field;
+        while (std::getline(ss, field, ',')) {
+            fields.push_back(field);
+        }
+        if (fields.size() != 5) continue;
+
+        char* end = nullptr;
+        long long ts = std::strtoll(fields[0].c_str(), &end, 10);
+        if (end == fields[0].c_str()) continue;
+
+        // strtod acepta "nan" e "inf": se descartan igual que un texto no numérico.
+        std::string valueText = unquote(fields[3]);
+        double value = std::strtod(valueText.c_str(), &end);
+        if (end == valueText.c_str() || *end != '\0' || !std::isfinite(value)) continue;
+
+        Metric m;
+        m.timestamp = ts;
+        m.component = unquote(fields[1]);
+        m.metric = unquote(fields[2]);
+        m.value = value;
+        m.unit = unquote(fields[4]);
+        records.push_back(std::move(m));
+    }
+
+    std::stable_sort(records.begin(), records.end(),
+                     [](const Metric& a, const Metric& b) { return a.timestamp < b.timestamp; });
+
+    cursor = 0;
+    loopOffset = 0;
+    pendingSamples = 0.0;
+    traceClock = records.empty() ? 0.0 : static_cast<double>(records.front().timestamp);
+    return !records.empty();
+}
+
+/**
+ * @brief Emite las muestras que corresponden a este ciclo.
+ *
+ * @details
+ * Dos modos:
+ *  - samplesPerSecond == 0: se emiten los registros cuyo timestamp cae dentro de
+ *    la ventana [traceClock, traceClock + ciclo). La traza se reproduce a su
+ *    velocidad original.
+ *  - samplesPerSecond > 0: se emiten samplesPerSecond registros por segundo del
+ *    ciclo, en orden, sin importar su timestamp original.
+ *
+ * La duración del ciclo sale de TickClock, igual que en SyntheticCollector.
+ *
+ * Al llegar al final, si loop está activo, se vuelve al inicio sumando la
+ * duración de la traza a los timestamps para que sigan siendo crecientes.
+ */
+std::size_t ReplayCollector::collect(std::vector<Metric>& out) {
+    if (records.empty()) return 0;
+
+    const long long span = records.back().timestamp - records.front().timestamp + 1;
+    std::size_t emitted = 0;
+
+    auto wrapIfNeeded = [&]() -> bool {
+        if (cursor < records.size()) return true;
+        if (!config.loop) return false;
+        cursor = 0;
+        loopOffset += span;
+        return true;
+    };
+
+    double tick = clock.next();
+    if (config.samplesPerSecond > 0.0) {
+        pendingSamples += config.samplesPerSecond * tick;
+        std::size_t count = static_cast<std::size_t>(pendingSamples);
+        pendingSamples -= static_cast<double>(count);
+
+        out.reserve(out.size() + count);
+        while (emitted < count && wrapIfNeeded()) {
+            out.push_back(records[cursor++]);
+            out.back().timestamp += loopOffset;
+            ++emitted;
+        }
+        return emitted;
+    }
+
+    double windowEnd = traceClock + tick;
+    while (wrapIfNeeded()) {
+        const Metric& r = records[cursor];
+        if (static_cast<double>(r.timestamp + loopOffset) >= windowEnd) break;
+        out.push_back(r);
+        out.back().timestamp += loopOffset;
+        ++cursor;
+        ++emitted;
+    }
+    traceClock = windowEnd;
+    return emitted;
+}
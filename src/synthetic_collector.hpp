@@ -0,0 +1,178 @@
+/**
+ * @file synthetic_collector.hpp
+ * @brief Colectores deterministas para pruebas de carga del almacenamiento.
+ * @details
+ * Permiten ejercitar la ruta de escritura con miles de series y cientos de miles
+ * de muestras por segundo en una sola máquina, sin hardware real que las produzca:
+ *  - SyntheticCollector genera series con una distribución de valores configurable.
+ *  - ReplayCollector reproduce un archivo de traza grabado previamente.
+ *
+ * Ambos implementan Collector, así que el bucle de main() los trata igual que a
+ * CpuMonitor o RamMonitor.
+ * @author Sergio Gonzalez
+ * @date 2026-01-24
+ */
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include "collector.hpp"
+
+/**
+ * @enum ValueDistribution
+ * @brief Forma de los valores generados por SyntheticCollector.
+ */
+enum class ValueDistribution {
+    Constant,   ///< Siempre minValue (mejor caso para compresión).
+    Uniform,    ///< Uniforme en [minValue, maxValue].
+    Normal,     ///< Normal centrada en el punto medio del rango, recortada al rango.
+    RandomWalk  ///< Paseo aleatorio por serie, como una métrica real que cambia poco a poco.
+};
+
+/**
+ * @brief Distribución por nombre: `constant`, `uniform`, `normal` o `random_walk`.
+ * @return false si el nombre no es ninguno de esos.
+ */
+bool parseValueDistribution(const std::string& text, ValueDistribution& out);
+
+/**
+ * @struct SyntheticConfig
+ * @brief Parámetros de la carga sintética.
+ */
+struct SyntheticConfig {
+    std::size_t seriesCount = 1000;     ///< Cantidad de series distintas (component + metric).
+    std::size_t componentCount = 10;    ///< Cardinalidad de "component": las series se reparten entre estos valores.
+    double samplesPerSecond = 1000.0;   ///< Muestras a emitir por cada segundo de reloj virtual.
+    double tickSeconds = 0.0;           ///< Segundos que avanza cada collect(); 0 = el tiempo real transcurrido desde la llamada anterior.
+    ValueDistribution distribution = ValueDistribution::Uniform;
+    double minValue = 0.0;              ///< Límite inferior de los valores.
+    double maxValue = 100.0;            ///< Límite superior de los valores (mayor que minValue, ver config.cpp).
+    std::uint64_t seed = 42;            ///< Semilla: misma semilla, misma secuencia de muestras.
+    long long startTimestamp = 0;       ///< Timestamp del primer ciclo (0 = hora actual).
+};
+
+/**
+ * @class TickClock
+ * @brief Duración de cada ciclo de collect(): fija, o medida con el reloj monótono.
+ */
+class TickClock {
+private:
+    double fixedSeconds;
+    bool started;
+    std::chrono::steady_clock::time_point last;
+
+public:
+    explicit TickClock(double tickSeconds) : fixedSeconds(tickSeconds), started(false) {}
+
+    /**
+     * @brief Segundos que cubre este ciclo.
+     * @return tickSeconds si es > 0; si no, lo transcurrido desde la llamada
+     *         anterior (0 en la primera), con un tope para no generar de golpe
+     *         lo que no se emitió durante una suspensión del equipo.
+     */
+    double next();
+};
+
+/**
+ * @class SyntheticCollector
+ * @brief Genera muestras sintéticas reproducibles para un número configurable de series.
+ *
+ * @details
+ * Cada llamada a collect() representa un ciclo y emite samplesPerSecond
+ * muestras por cada segundo del ciclo, recorriendo las series en orden circular.
+ * Con tickSeconds = 0 (lo que usa el servicio) el ciclo dura lo que pasó en el
+ * reloj monótono desde la llamada anterior: la tasa se cumple con cualquier
+ * interval_ms, aunque cambie en una recarga o el planificador salte ciclos
+ * atrasados. La primera llamada solo pone en marcha ese reloj. Los nombres de
+ * las series se construyen una sola vez en el constructor para que el costo por
+ * muestra sea solo generar el valor.
+ *
+ * El timestamp avanza con un reloj VIRTUAL que suma la duración de cada ciclo.
+ * La secuencia de valores depende solo de la semilla; con un tickSeconds fijo,
+ * dos corridas con la misma configuración producen exactamente los mismos datos.
+ */
+class SyntheticCollector : public Collector {
+private:
+    /**
+     * @struct Series
+     * @brief Identidad y estado de una serie sintética.
+     */
+    struct Series {
+        std::string component;
+        std::string metric;
+        double lastValue;   ///< Último valor emitido (usado por RandomWalk).
+    };
+
+    SyntheticConfig config;
+    std::vector<Series> series;
+    std::mt19937_64 rng;
+    std::size_t nextSeries;       ///< Índice de la próxima serie a emitir (orden circular).
+    double pendingSamples;        ///< Fracción de muestra acumulada cuando la tasa no es entera.
+    long long virtualTimestamp;   ///< Reloj virtual en segundos.
+    double virtualFraction;       ///< Fracción de segundo acumulada cuando el ciclo no dura segundos enteros.
+    TickClock clock;
+
+    double nextValue(Series& s);
+
+public:
+    /**
+     * @brief Constructor. Precalcula los nombres de todas las series.
+     * @param config Parámetros de la carga.
+     */
+    explicit SyntheticCollector(const SyntheticConfig& config);
+
+    const char* name() const override { return "Synthetic"; }
+
+    std::size_t collect(std::vector<Metric>& out) override;
+};
+
+/**
+ * @struct ReplayConfig
+ * @brief Parámetros de la reproducción de una traza.
+ */
+struct ReplayConfig {
+    std::string tracePath;            ///< Archivo CSV: timestamp,component,metric,value,unit
+    double samplesPerSecond = 0.0;    ///< 0 = respetar los timestamps de la traza; >0 = emitir a esta tasa fija.
+    double tickSeconds = 0.0;         ///< Segundos que avanza cada collect(); 0 = el tiempo real transcurrido (ver TickClock).
+    bool loop = true;                 ///< Al terminar, volver a empezar desplazando los timestamps.
+};
+
+/**
+ * @class ReplayCollector
+ * @brief Reproduce una traza grabada como si las muestras llegaran en vivo.
+ *
+ * @details
+ * El formato de la traza es el mismo orden de columnas que la tabla `metrics`,
+ * por lo que se puede grabar directamente desde una base existente:
+ * @code
+ * sqlite3 -csv data/syspulse.db "SELECT timestamp, component, metric, value, unit FROM metrics ORDER BY timestamp" > traza.csv
+ * @endcode
+ *
+ * La traza completa se carga en memoria al abrirla; así la reproducción no
+ * incluye el costo de leer el archivo y solo mide la ruta de escritura.
+ */
+class ReplayCollector : public Collector {
+private:
+    ReplayConfig config;
+    std::vector<Metric> records;   ///< Traza completa, ordenada por timestamp.
+    std::size_t cursor;            ///< Próximo registro a emitir.
+    long long loopOffset;          ///< Desplazamiento acumulado de timestamps por cada vuelta.
+    double traceClock;             ///< Posición actual en el tiempo de la traza.
+    double pendingSamples;         ///< Fracción de muestra acumulada en modo de tasa fija.
+    TickClock clock;
+
+public:
+    explicit ReplayCollector(const ReplayConfig& config);
+
+    /**
+     * @brief Carga el archivo de traza.
+     * @return true si se leyó al menos un registro válido.
+     */
+    bool open();
+
+    const char* name() const override { return "Replay"; }
+
+    std::size_t collect(std::vector<Metric>& out) override;
+};
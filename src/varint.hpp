@@ -0,0 +1,124 @@
+/**
+ * @file varint.hpp
+ * @brief Codificación de enteros de longitud variable (varint / LEB128).
+ * @details
+ * Un varint guarda 7 bits por byte; el bit alto indica si sigue otro byte.
+ * Los números pequeños (lo más común en contadores de histogramas o deltas de
+ * tiempo) ocupan 1 byte en lugar de 8.
+ *
+ * Los enteros con signo se pasan antes por "zigzag" (0, -1, 1, -2, 2... -> 0, 1, 2, 3, 4...)
+ * para que los negativos pequeños también sean cortos.
+ * @author Sergio Gonzalez
+ * @date 2026-02-07
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace varint {
+
+/**
+ * @brief Agrega @p value codificado como varint al final de @p out.
+ */
+inline void put(std::string& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+/**
+ * @brief Convierte un entero con signo a su representación zigzag.
+ */
+inline std::uint64_t zigzag(std::int64_t value) {
+    return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+/**
+ * @brief Operación inversa de zigzag().
+ */
+inline std::int64_t unzigzag(std::uint64_t value) {
+    return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+/**
+ * @brief Agrega un entero con signo (zigzag + varint).
+ */
+inline void putSigned(std::string& out, std::int64_t value) {
+    put(out, zigzag(value));
+}
+
+/**
+ * @brief Agrega un double en sus 8 bytes crudos (little-endian en x86).
+ */
+inline void putDouble(std::string& out, double value) {
+    char bytes[sizeof(double)];
+    std::memcpy(bytes, &value, sizeof(double));
+    out.append(bytes, sizeof(double));
+}
+
+/**
+ * @class Reader
+ * @brief Lector secuencial sobre un buffer codificado.
+ * @details Todas las lecturas devuelven false si el buffer se termina antes de
+ * tiempo, así un BLOB truncado o corrupto nunca provoca lecturas fuera de rango.
+ */
+class Reader {
+private:
+    const unsigned char* cursor;
+    const unsigned char* end;
+
+public:
+    Reader(const void* data, std::size_t size)
+        : cursor(static_cast<const unsigned char*>(data)),
+          end(static_cast<const unsigned char*>(data) + size) {}
+
+    bool get(std::uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (cursor == end) return false;
+            unsigned char byte = *cursor++;
+            value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) return true;
+        }
+        return false; // Más de 10 bytes: no es un varint válido.
+    }
+
+    bool getSigned(std::int64_t& value) {
+        std::uint64_t raw;
+        if (!get(raw)) return false;
+        value = unzigzag(raw);
+        return true;
+    }
+
+    bool getDouble(double& value) {
+        if (static_cast<std::size_t>(end - cursor) < sizeof(double)) return false;
+        std::memcpy(&value, cursor, sizeof(double));
+        cursor += sizeof(double);
+        return true;
+    }
+
+    bool getByte(unsigned char& value) {
+        if (cursor == end) return false;
+        value = *cursor++;
+        return true;
+    }
+
+    /**
+     * @brief Devuelve un puntero a los próximos @p size bytes, sin copiarlos, y avanza.
+     */
+    bool getBytes(const char*& data, std::size_t size) {
+        if (static_cast<std::size_t>(end - cursor) < size) return false;
+        data = reinterpret_cast<const char*>(cursor);
+        cursor += size;
+        return true;
+    }
+
+    /** @brief Bytes que quedan por leer. */
+    std::size_t remaining() const { return static_cast<std::size_t>(end - cursor); }
+};
+
+} // namespace varint
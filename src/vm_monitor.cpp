@@ -0,0 +1,135 @@
+/**
+ * @file vm_monitor.cpp
+ * @brief Implementación de VmMonitor.
+ * @author Sergio Gonzalez
+ * @date 2026-06-06
+ */
+
+#include "vm_monitor.hpp"
+#include <windows.h>
+#include <cmath>
+#include "logger.hpp"
+
+namespace {
+
+/// Contadores que se pueden pedir en `[collector.vm] counter = <clave>`.
+const struct {
+    const char* key;
+    const char* path;
+    const char* metric;
+    const char* unit;
+    MetricKind kind;
+} kVmCounters[] = {
+    {"page_faults", "\\Memory\\Page Faults/sec", "PageFaults", "faults", MetricKind::Counter},
+    {"major_faults", "\\Memory\\Page Reads/sec", "MajorFaults", "reads", MetricKind::Counter},
+    {"transition_faults", "\\Memory\\Transition Faults/sec", "TransitionFaults", "faults", MetricKind::Counter},
+    {"demand_zero_faults", "\\Memory\\Demand Zero Faults/sec", "DemandZeroFaults", "faults", MetricKind::Counter},
+    {"cache_faults", "\\Memory\\Cache Faults/sec", "CacheFaults", "faults", MetricKind::Counter},
+    {"pages_in", "\\Memory\\Pages Input/sec", "PagesIn", "pages", MetricKind::Counter},
+    {"pages_out", "\\Memory\\Pages Output/sec", "PagesOut", "pages", MetricKind::Counter},
+    {"page_writes", "\\Memory\\Page Writes/sec", "PageWrites", "writes", MetricKind::Counter},
+    {"committed", "\\Memory\\Committed Bytes", "Committed", "bytes", MetricKind::Gauge},
+    {"commit_limit", "\\Memory\\Commit Limit", "CommitLimit", "bytes", MetricKind::Gauge},
+    {"modified", "\\Memory\\Modified Page List Bytes", "ModifiedList", "bytes", MetricKind::Gauge},
+    {"standby", "\\Memory\\Standby Cache Normal Priority Bytes", "Standby", "bytes", MetricKind::Gauge},
+    {"free_zero", "\\Memory\\Free & Zero Page List Bytes", "FreeZero", "bytes", MetricKind::Gauge},
+    {"pagefile_usage", "\\Paging File(_Total)\\% Usage", "PagefileUsage", "%", MetricKind::Gauge},
+    {"processes", "\\System\\Processes", "Processes", "processes", MetricKind::Gauge},
+    {"threads", "\\System\\Threads", "Threads", "threads", MetricKind::Gauge},
+};
+
+const char* const kDefaultKeys[] = {"page_faults", "major_faults", "pages_in", "pages_out", "committed"};
+
+/// Constantes de tiempo de Load1/Load5/Load15, en segundos.
+const double kLoadPeriods[3] = {60.0, 300.0, 900.0};
+
+} // namespace
+
+VmMonitor::VmMonitor(const std::vector<std::string>& keys) : cpuCount(1.0), load{0.0, 0.0, 0.0}, loadReady(false) {
+    std::vector<std::string> selected = keys;
+    if (selected.empty()) selected.assign(std::begin(kDefaultKeys), std::end(kDefaultKeys));
+
+    for (const std::string& key : selected) {
+        bool known = false;
+        for (const auto& c : kVmCounters) {
+            if (key != c.key) continue;
+            known = true;
+            int index = pdh.add(c.path);
+            if (index >= 0) counters.push_back(VmCounter{index, c.metric, c.unit, c.kind});
+            break;
+        }
+        if (!known) Logger::warn("Contador de memoria desconocido; se ignora.", {{"counter", key}});
+    }
+
+    busyCounter = pdh.add("\\Processor(_Total)\\% Processor Time");
+    queueCounter = pdh.add("\\System\\Processor Queue Length");
+
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    if (info.dwNumberOfProcessors > 0) cpuCount = static_cast<double>(info.dwNumberOfProcessors);
+}
+
+std::vector<RateRatio> VmMonitor::ratios() {
+    RateRatio majorFaults;
+    majorFaults.component = "Vm";
+    majorFaults.numerator = "MajorFaults";
+    majorFaults.denominator = "PageFaults";
+    majorFaults.metric = "MajorFaultRatio";
+    majorFaults.unit = "%";
+    majorFaults.scale = 100.0;
+    return {majorFaults};
+}
+
+std::size_t VmMonitor::collect(std::vector<Metric>& out) {
+    auto now = std::chrono::system_clock::now();
+    long long timestamp = std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count();
+    std::size_t added = 0;
+
+    if (!pdh.collect()) return 0;
+
+    auto push = [&](const char* metric, const char* unit, double value, MetricKind kind) {
+        Metric m;
+        m.component = "Vm";
+        m.metric = metric;
+        m.unit = unit;
+        m.value = value;
+        m.timestamp = timestamp;
+        m.kind = kind;
+        out.push_back(std::move(m));
+        ++added;
+    };
+
+    for (const VmCounter& c : counters) {
+        if (c.kind == MetricKind::Counter) {
+            long long value;
+            if (pdh.raw(c.index, value)) push(c.metric, c.unit, static_cast<double>(value), c.kind);
+        } else {
+            double value;
+            if (pdh.formatted(c.index, value)) push(c.metric, c.unit, value, c.kind);
+        }
+    }
+
+    // % Processor Time necesita dos lecturas: el primer ciclo no tiene Running ni carga.
+    double busy, queue;
+    if (!pdh.formatted(busyCounter, busy) || !pdh.formatted(queueCounter, queue)) return added;
+    double running = busy / 100.0 * cpuCount;
+    push("Running", "cpus", running, MetricKind::Gauge);
+
+    auto steadyNow = std::chrono::steady_clock::now();
+    double active = running + queue;
+    if (!loadReady) {
+        for (double& l : load) l = active;
+        loadReady = true;
+    } else {
+        double elapsed = std::chrono::duration<double>(steadyNow - lastLoad).count();
+        for (int i = 0; i < 3; ++i) {
+            double decay = std::exp(-elapsed / kLoadPeriods[i]);
+            load[i] = load[i] * decay + active * (1.0 - decay);
+        }
+    }
+    lastLoad = steadyNow;
+    push("Load1", "threads", load[0], MetricKind::Gauge);
+    push("Load5", "threads", load[1], MetricKind::Gauge);
+    push("Load15", "threads", load[2], MetricKind::Gauge);
+    return added;
+}
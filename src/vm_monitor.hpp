@@ -0,0 +1,80 @@
+/**
+ * @file vm_monitor.hpp
+ * @brief Actividad de la memoria virtual (paginación) y carga del sistema.
+ * @details
+ * RamMonitor da el porcentaje de memoria ocupada, pero no si el sistema está
+ * paginando. VmMonitor publica (componente "Vm") los contadores de memoria
+ * del sistema que el usuario elija en `[collector.vm]`:
+ *
+ * @code{.ini}
+ * [collector.vm]
+ * counter = page_faults
+ * counter = pages_in
+ * counter = committed
+ * @endcode
+ *
+ * Los nombres válidos están en la tabla de vm_monitor.cpp (fallos de página,
+ * lecturas y escrituras del archivo de paginación, memoria comprometida,
+ * listas de páginas, procesos e hilos). Este colector es el único dueño de
+ * `PageFaults` y `MajorFaults` (lecturas de disco para resolver fallos
+ * graves); con ambos pedidos, RateEngine deriva `Vm/MajorFaultRatio`: % de los
+ * fallos que fueron a disco, la tasa de "misses" de la memoria física. Los
+ * contadores acumulados se publican como MetricKind::Counter y RateEngine
+ * deriva sus tasas; los niveles (bytes, %) como gauges. Sin claves se usa un
+ * conjunto por defecto.
+ *
+ * Además, siempre, la carga al estilo de `/proc/loadavg`:
+ *  - `Running`: CPU ocupadas (uso total × cantidad de CPU).
+ *  - `Load1`, `Load5`, `Load15`: promedio exponencial de Running más los hilos
+ *    listos esperando CPU (`\System\Processor Queue Length`, publicado como
+ *    `Sched/RunQueue`) con constantes de 1, 5 y 15 minutos, como el kernel de Linux.
+ *
+ * Los contadores se agregan a PDH una vez al construir el colector: cada
+ * ciclo es una sola consulta y una lectura por índice, sin buscar nombres.
+ * @author Sergio Gonzalez
+ * @date 2026-06-06
+ */
+#pragma once
+#include <chrono>
+#include <string>
+#include <vector>
+#include "collector.hpp"
+#include "pdh_counters.hpp"
+#include "rate_engine.hpp"
+
+/**
+ * @class VmMonitor
+ * @brief Colector de paginación y carga del sistema.
+ */
+class VmMonitor : public Collector {
+private:
+    /// Contador elegido por el usuario, ya agregado a la consulta.
+    struct VmCounter {
+        int index;
+        const char* metric;
+        const char* unit;
+        MetricKind kind;
+    };
+
+    PdhCounterSet pdh;
+    std::vector<VmCounter> counters;
+    int busyCounter;
+    int queueCounter;
+    double cpuCount;
+    double load[3];
+    bool loadReady;
+    std::chrono::steady_clock::time_point lastLoad;
+
+public:
+    /**
+     * @param keys Nombres de la tabla de vm_monitor.cpp; los desconocidos se ignoran con un aviso.
+     */
+    explicit VmMonitor(const std::vector<std::string>& keys = {});
+
+    const char* name() const override { return "Vm"; }
+
+    std::size_t collect(std::vector<Metric>& out) override;
+
+    /** @brief Cocientes derivados que publica este colector, para registrarlos en RateEngine. */
+    static std::vector<RateRatio> ratios();
+};
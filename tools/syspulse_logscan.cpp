@@ -0,0 +1,93 @@
+/**
+ * @file syspulse_logscan.cpp
+ * @brief Herramienta fuera de línea: recorre el registro binario de muestras.
+ *
+ * @details
+ * Proyecta cada segmento en memoria y acumula count/min/max/mean por serie sin
+ * copiar registros, usando el índice disperso para saltar lo que queda fuera
+ * del rango pedido. Al final informa el rendimiento del recorrido.
+ *
+ * Uso: syspulse_logscan <directorio> [--from ts] [--to ts]
+ *
+ * @author Sergio Gonzalez
+ * @date 2026-03-07
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+#include "sample_log_reader.hpp"
+
+namespace {
+
+struct SeriesTotals {
+    std::uint64_t count = 0;
+    double sum = 0.0;
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const char* usage = "Uso: syspulse_logscan <directorio> [--from ts] [--to ts]";
+    if (argc < 2) {
+        std::cerr << usage << std::endl;
+        return 1;
+    }
+
+    std::string directory = argv[1];
+    std::int64_t from = std::numeric_limits<std::int64_t>::min();
+    std::int64_t to = std::numeric_limits<std::int64_t>::max();
+    for (int i = 2; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--from") {
+            from = std::atoll(argv[i + 1]);
+        } else if (arg == "--to") {
+            to = std::atoll(argv[i + 1]);
+        } else {
+            std::cerr << usage << std::endl;
+            return 1;
+        }
+    }
+
+    SampleLogReader reader;
+    if (!reader.open(directory)) {
+        std::cerr << "[ERROR] No se pudo abrir el registro en " << directory << std::endl;
+        return 1;
+    }
+
+    std::vector<SeriesTotals> totals(reader.series().size());
+    auto start = std::chrono::steady_clock::now();
+
+    std::uint64_t scanned = reader.scan(from, to, [&totals](const SampleRecord& r) {
+        if (r.seriesId >= totals.size()) return;
+        SeriesTotals& t = totals[r.seriesId];
+        ++t.count;
+        t.sum += r.value;
+        if (r.value < t.min) t.min = r.value;
+        if (r.value > t.max) t.max = r.value;
+    });
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (std::uint32_t id = 0; id < totals.size(); ++id) {
+        const SeriesTotals& t = totals[id];
+        if (t.count == 0) continue;
+        const SeriesInfo* info = reader.series().find(id);
+        std::string labels = info->labels.empty() ? std::string() : "{" + formatLabels(info->labels) + "}";
+        std::printf("%s/%s%s count=%llu min=%g max=%g mean=%g %s\n", info->component.c_str(), info->metric.c_str(),
+                    labels.c_str(), static_cast<unsigned long long>(t.count), t.min, t.max,
+                    t.sum / static_cast<double>(t.count), info->unit.c_str());
+    }
+
+    double bytes = static_cast<double>(scanned) * sizeof(SampleRecord);
+    std::printf("[INFO] %zu segmentos, %llu registros en %.3f s (%.1f M registros/s, %.2f GB/s)\n",
+                reader.segmentCount(), static_cast<unsigned long long>(scanned), seconds,
+                seconds > 0 ? scanned / seconds / 1e6 : 0.0, seconds > 0 ? bytes / seconds / 1e9 : 0.0);
+    return 0;
+}